@@ -0,0 +1,92 @@
+import glob
+import json
+import os
+import sys
+
+# Converts the built-in screens in assets/*.json into PROGMEM frame tables (include/Assets.h).
+#
+# An asset has a name, a size and a list of frames, each frame either as
+#   "data": [RGB565, ...]          (format of the PixelIt bitmap editor) or
+#   "rows": ["..XX..", ...]        (one character per pixel, colours from "palette")
+# and an optional "delay" in ms.
+#
+# Frames are stored as RGB565 in the firmware frame format. Every frame only holds the
+# rectangle that changed against the previous one, the first one against a cleared area.
+
+source = sys.argv[1] if len(sys.argv) > 1 else './assets'
+target = sys.argv[2] if len(sys.argv) > 2 else './include/Assets.h'
+
+
+def rgb565(color):
+    color = color.lstrip('#')
+    r, g, b = int(color[0:2], 16), int(color[2:4], 16), int(color[4:6], 16)
+    # Same as Adafruit_GFX Color(r, g, b)
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)
+
+
+def load_frame(asset, frame):
+    width, height = asset['width'], asset['height']
+    if 'data' in frame:
+        pixels = list(frame['data'])
+    else:
+        palette = dict((key, rgb565(value)) for key, value in asset['palette'].items())
+        pixels = [palette[key] for row in frame['rows'] for key in row]
+    if len(pixels) != width * height:
+        raise ValueError('%s: frame has %d pixels, expected %d' % (asset['name'], len(pixels), width * height))
+    return pixels
+
+
+def changed_rect(previous, pixels, width, height):
+    changed = [(i % width, i // width) for i in range(width * height) if previous[i] != pixels[i]]
+    if not changed:
+        return 0, 0, 0, 0
+    xs = [x for x, y in changed]
+    ys = [y for x, y in changed]
+    return min(xs), min(ys), max(xs) - min(xs) + 1, max(ys) - min(ys) + 1
+
+
+def words(values):
+    lines = []
+    for i in range(0, len(values), 16):
+        lines.append('    ' + ', '.join('0x%04X' % v for v in values[i:i + 16]) + ',')
+    return '\n'.join(lines)
+
+
+content = '// Generated by .github/assets.py from assets/*.json, do not edit\n'
+content += '#ifndef ASSETS_H_\n#define ASSETS_H_\n\n#include "Asset.h"\n'
+
+total = 0
+for path in sorted(glob.glob(os.path.join(source, '*.json'))):
+    asset = json.load(open(path, 'r'))
+    name, width, height = asset['name'], asset['width'], asset['height']
+    if width > 255 or height > 255 or len(asset['frames']) > 255:
+        raise ValueError('%s: asset too large' % name)
+
+    previous = [0] * (width * height)
+    pixels = []
+    frames = []
+    for frame in asset['frames']:
+        current = load_frame(asset, frame)
+        x, y, w, h = changed_rect(previous, current, width, height)
+        frames.append('    {%d, %d, %d, %d, %d, %d},' % (x, y, w, h, frame.get('delay', 0), len(pixels)))
+        for row in range(y, y + h):
+            pixels += current[row * width + x:row * width + x + w]
+        previous = current
+    if len(pixels) > 0xFFFF:
+        raise ValueError('%s: asset too large' % name)
+
+    size = len(pixels) * 2 + len(frames) * 8
+    total += size
+    print('Asset %s: %dx%d, %d frames, %d bytes' % (name, width, height, len(frames), size))
+
+    content += '\n// %s\n' % os.path.basename(path)
+    content += 'const uint16_t %sPixels[] PROGMEM = {\n%s\n};\n' % (name, words(pixels) if pixels else '    0x0000,')
+    content += 'const AssetFrame %sFrames[] PROGMEM = {\n%s\n};\n' % (name, '\n'.join(frames))
+    content += 'const Asset %s = {%d, %d, %d, %sFrames, %sPixels};\n' % (name, width, height, len(frames), name, name)
+
+content += '\n#endif\n'
+print('Assets: %d bytes' % total)
+
+header = open(target, 'w')
+header.write(content)
+header.close()
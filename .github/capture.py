@@ -0,0 +1,50 @@
+import json
+import sys
+
+# Prints a command capture (GET /api/capture) as one JSON object per line, e.g. to compare
+# the traffic of two sessions or to pick a command for a bug report.
+# The format is written by src/CommandCapture.cpp:
+#   "PXCP", version, 3 reserved bytes
+#   per command: varint ms since the previous one, transport, command length, command,
+#                varint payload length, payload
+#
+# Usage: python .github/capture.py capture.bin
+
+VERSION = 1
+TRANSPORTS = ['http', 'mqtt', 'websocket']
+
+
+def read_varint(data, position):
+    value = 0
+    shift = 0
+    while True:
+        b = data[position]
+        position += 1
+        value |= (b & 0x7F) << shift
+        if not b & 0x80:
+            return value, position
+        shift += 7
+
+
+def read(data):
+    if data[0:4] != b'PXCP' or data[4] != VERSION:
+        raise Exception('not a capture of version %d' % VERSION)
+    position = 8
+    time = 0
+    while position < len(data):
+        delta, position = read_varint(data, position)
+        time += delta
+        transport = data[position]
+        length = data[position + 1]
+        command = data[position + 2:position + 2 + length].decode()
+        position += 2 + length
+        length, position = read_varint(data, position)
+        payload = data[position:position + length].decode()
+        position += length
+        yield {'time': time, 'transport': TRANSPORTS[transport], 'command': command, 'payload': payload}
+
+
+if __name__ == '__main__':
+    with open(sys.argv[1], 'rb') as f:
+        for record in read(f.read()):
+            print(json.dumps(record))
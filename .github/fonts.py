@@ -0,0 +1,154 @@
+import re
+import sys
+
+# Converts the Adafruit GFX fonts in include/PixelItFont.h (plus the glyphs of
+# assets/fonts/pixelit.txt) into the Unicode glyph fonts of the text engine (include/GlyphFonts.h).
+#
+# Every glyph is trimmed to its pixels and packed bitwise, identical bitmaps are stored once.
+# Code points are grouped into ranges of consecutive characters, sorted for binary search.
+
+source = sys.argv[1] if len(sys.argv) > 1 else './include/PixelItFont.h'
+extension = sys.argv[2] if len(sys.argv) > 2 else './assets/fonts/pixelit.txt'
+target = sys.argv[3] if len(sys.argv) > 3 else './include/GlyphFonts.h'
+
+# Former private slots of PixelItFont (0xDE - 0xE9)
+SYMBOLS = [0x20AC, 0x2190, 0x2191, 0x2192, 0x2193, 0x2605, 0x1F4C4, 0x2665, 0x21A7, 0x1F697, 0x1F600, 0x1F4C1]
+
+
+def parse_gfx(text, bitmaps, glyphs):
+    block = text[text.index(bitmaps + '[]'):]
+    block = re.sub(r'//.*', '', block[block.index('{') + 1:block.index('};')])
+    data = [int(value, 16) for value in re.findall(r'0x[0-9A-Fa-f]{2}', block)]
+    block = text[text.index(glyphs + '[]'):]
+    block = re.sub(r'//.*', '', block[block.index('{') + 1:block.index('};')])
+    table = [tuple(int(v) for v in g) for g in re.findall(r'\{\s*(-?\d+),\s*(-?\d+),\s*(-?\d+),\s*(-?\d+),\s*(-?\d+),\s*(-?\d+)\s*\}', block)]
+
+    result = []
+    for offset, width, height, advance, x_offset, y_offset in table:
+        pixels = set()
+        bit = 0
+        for y in range(height):
+            for x in range(width):
+                if data[offset + bit // 8] & (0x80 >> (bit % 8)):
+                    pixels.add((x + x_offset, y + y_offset))
+                bit += 1
+        result.append((pixels, advance))
+    return result
+
+
+def parse_extension(path):
+    glyphs = {}
+    aliases = {}
+    code = None
+    for line in open(path, 'r', encoding='utf-8').read().split('\n'):
+        line = line.rstrip()
+        if line.startswith('#') and not re.match(r'^[#.]+$', line):
+            continue
+        match = re.match(r'^U\+([0-9A-Fa-f]+)(\s*=\s*(.))?', line)
+        if match:
+            code = int(match.group(1), 16)
+            if match.group(3):
+                aliases[code] = ord(match.group(3))
+                code = None
+            else:
+                glyphs[code] = []
+        elif line and code is not None:
+            glyphs[code].append(line)
+        elif not line:
+            code = None
+
+    result = {}
+    for code, rows in glyphs.items():
+        pixels = set((x, y - 5) for y, row in enumerate(rows) for x, c in enumerate(row) if c == '#')
+        result[code] = (pixels, max(len(row) for row in rows) + 1)
+    return result, aliases
+
+
+def pack(pixels):
+    if not pixels:
+        return 0, 0, 0, 0, b''
+    x0 = min(x for x, y in pixels)
+    y0 = min(y for x, y in pixels)
+    width = max(x for x, y in pixels) - x0 + 1
+    height = max(y for x, y in pixels) - y0 + 1
+    data = bytearray((width * height + 7) // 8)
+    bit = 0
+    for y in range(height):
+        for x in range(width):
+            if (x + x0, y + y0) in pixels:
+                data[bit // 8] |= 0x80 >> (bit % 8)
+            bit += 1
+    return width, height, x0, y0, bytes(data)
+
+
+def convert(name, glyphs):
+    bitmaps = bytearray()
+    offsets = {}
+    entries = []
+    ranges = []
+    for code in sorted(glyphs):
+        pixels, advance = glyphs[code]
+        width, height, x_offset, y_offset, data = pack(pixels)
+        if data not in offsets:
+            offsets[data] = len(bitmaps)
+            bitmaps += data
+        if ranges and ranges[-1][0] + ranges[-1][1] == code:
+            ranges[-1][1] += 1
+        else:
+            ranges.append([code, 1, len(entries)])
+        entries.append('    {%d, %d, %d, %d, %d, %d}, // U+%04X' % (offsets[data], width, height, advance, x_offset, y_offset, code))
+    if len(bitmaps) > 0xFFFF:
+        raise ValueError('%s: glyph atlas too large' % name)
+
+    size = len(bitmaps) + len(entries) * 7 + len(ranges) * 8
+    print('Font %s: %d glyphs, %d ranges, %d bytes' % (name, len(entries), len(ranges), size))
+
+    lines = []
+    for i in range(0, len(bitmaps), 16):
+        lines.append('    ' + ', '.join('0x%02X' % b for b in bitmaps[i:i + 16]) + ',')
+    content = '\nconst uint8_t %sBitmaps[] PROGMEM = {\n%s\n};\n' % (name, '\n'.join(lines))
+    content += 'const Glyph %sGlyphs[] PROGMEM = {\n%s\n};\n' % (name, '\n'.join(entries))
+    content += 'const GlyphRange %sRanges[] PROGMEM = {\n%s\n};\n' % (name, '\n'.join('    {0x%04X, %d, %d},' % tuple(r) for r in ranges))
+    content += 'const GlyphFont %s = {%sRanges, %d, %sGlyphs, %sBitmaps};\n' % (name, name, len(ranges), name, name)
+    return content
+
+
+text = open(source, 'r', encoding='utf-8').read()
+
+# PixelItFont: ASCII, Latin-1 (shifted by 34) and the symbols
+pixelit = {}
+for index, glyph in enumerate(parse_gfx(text, 'PixelItBitmaps', 'PixelItGlyphs')):
+    char = index + 0x20
+    if char < 0x7F:
+        pixelit[char] = glyph
+    elif char < 0xDE:
+        pixelit[char + 34] = glyph
+    else:
+        pixelit[SYMBOLS[char - 0xDE]] = glyph
+
+glyphs, aliases = parse_extension(extension)
+pixelit.update(glyphs)
+while aliases:
+    resolved = [code for code, char in aliases.items() if char in pixelit]
+    if not resolved:
+        raise ValueError('Unresolved aliases: ' + ', '.join('U+%04X' % code for code in aliases))
+    for code in resolved:
+        pixelit[code] = pixelit[aliases.pop(code)]
+
+content = '// Generated by .github/fonts.py from include/PixelItFont.h and assets/fonts/pixelit.txt, do not edit\n'
+content += '#ifndef GLYPHFONTS_H_\n#define GLYPHFONTS_H_\n\n#include "TextEngine.h"\n'
+content += convert('PixelItGlyphFont', pixelit)
+
+# Clock fonts, digits only
+for font in ['LargePixels', 'FatPixels']:
+    digits = {}
+    for index, glyph in enumerate(parse_gfx(text, font + '_Bitmaps', font + '_Glyphs')):
+        if glyph[1] > 0:
+            digits[index + 0x20] = glyph
+    content += convert(font + 'GlyphFont', digits)
+
+content += '\n#endif\n'
+
+header = open(target, 'w')
+header.write(content)
+header.close()
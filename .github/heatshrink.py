@@ -0,0 +1,139 @@
+import sys
+
+# heatshrink (LZSS) compression of firmware images for the OTA update, bit compatible with
+# the heatshrink library and its command line tool (heatshrink -e -w 10 -l 5).
+#
+# The stream is a sequence of MSB first bit fields without a header:
+#   1, 8 bit literal
+#   0, WINDOW_BITS bit (offset - 1), LOOKAHEAD_BITS bit (length - 1)
+# The decoder on the device (src/Heatshrink.cpp) has to use the same window and lookahead.
+#
+# Usage: python .github/heatshrink.py firmware.bin [firmware.bin.hs]
+
+WINDOW_BITS = 10
+LOOKAHEAD_BITS = 5
+MIN_MATCH = 2  # A back reference (16 bits) beats two literals (18 bits)
+MAX_CHAIN = 128  # Candidates tried per position
+
+
+class BitWriter:
+    def __init__(self):
+        self.data = bytearray()
+        self.bits = 0
+        self.count = 0
+
+    def write(self, value, count):
+        self.bits = (self.bits << count) | value
+        self.count += count
+        while self.count >= 8:
+            self.count -= 8
+            self.data.append((self.bits >> self.count) & 0xFF)
+        self.bits &= (1 << self.count) - 1
+
+    def finish(self):
+        if self.count > 0:
+            self.data.append((self.bits << (8 - self.count)) & 0xFF)
+        return bytes(self.data)
+
+
+def compress(data, window_bits=WINDOW_BITS, lookahead_bits=LOOKAHEAD_BITS):
+    window = 1 << window_bits
+    lookahead = 1 << lookahead_bits
+    out = BitWriter()
+    chains = {}
+    length = len(data)
+    i = 0
+    while i < length:
+        best_length = 0
+        best_offset = 0
+        if i + MIN_MATCH <= length:
+            candidates = chains.get(data[i:i + MIN_MATCH], [])
+            limit = min(lookahead, length - i)
+            tried = 0
+            for position in reversed(candidates):
+                if i - position > window or tried == MAX_CHAIN:
+                    break
+                tried += 1
+                match = MIN_MATCH
+                while match < limit and data[position + match] == data[i + match]:
+                    match += 1
+                if match > best_length:
+                    best_length = match
+                    best_offset = i - position
+                    if match == limit:
+                        break
+
+        step = best_length if best_length >= MIN_MATCH else 1
+        if step == 1:
+            out.write(0x100 | data[i], 9)
+        else:
+            out.write(0, 1)
+            out.write(best_offset - 1, window_bits)
+            out.write(best_length - 1, lookahead_bits)
+
+        for position in range(i, i + step):
+            key = data[position:position + MIN_MATCH]
+            chain = chains.setdefault(key, [])
+            chain.append(position)
+            # Drop positions that left the window
+            if len(chain) > 2 * MAX_CHAIN:
+                del chain[:MAX_CHAIN]
+        i += step
+    return out.finish()
+
+
+class BitReader:
+    def __init__(self, data):
+        self.data = data
+        self.position = 0
+        self.bits = 0
+        self.count = 0
+
+    def read(self, count):
+        # None at the end, the last byte is padded with up to 7 bits
+        while self.count < count:
+            if self.position == len(self.data):
+                return None
+            self.bits = (self.bits << 8) | self.data[self.position]
+            self.position += 1
+            self.count += 8
+        self.count -= count
+        value = self.bits >> self.count
+        self.bits &= (1 << self.count) - 1
+        return value
+
+
+def decompress(data, window_bits=WINDOW_BITS, lookahead_bits=LOOKAHEAD_BITS):
+    reader = BitReader(data)
+    out = bytearray()
+    while True:
+        tag = reader.read(1)
+        if tag is None:
+            break
+        if tag:
+            literal = reader.read(8)
+            if literal is None:
+                break
+            out.append(literal)
+        else:
+            offset = reader.read(window_bits)
+            match = reader.read(lookahead_bits)
+            if offset is None or match is None:
+                break
+            for _ in range(match + 1):
+                # The window starts zeroed
+                out.append(out[-offset - 1] if offset < len(out) else 0)
+    return bytes(out)
+
+
+if __name__ == '__main__':
+    source = sys.argv[1]
+    target = sys.argv[2] if len(sys.argv) > 2 else source + '.hs'
+    with open(source, 'rb') as f:
+        image = f.read()
+    packed = compress(image)
+    if decompress(packed) != image:
+        raise Exception('heatshrink round trip failed for %s' % source)
+    with open(target, 'wb') as f:
+        f.write(packed)
+    print('%s: %d -> %d bytes (%.1f%%)' % (target, len(image), len(packed), 100.0 * len(packed) / len(image)))
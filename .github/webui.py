@@ -1,5 +1,10 @@
+import gzip
+import hashlib
+import sys
+
 # Read content
-html = open('./pixelit-webui-artifact/index.html', 'r')
+path = sys.argv[1] if len(sys.argv) > 1 else './pixelit-webui-artifact/index.html'
+html = open(path, 'r')
 o = html.read()
 content = o.replace('\n', '')
 html.close()
@@ -7,11 +12,23 @@ html.close()
 # Print the content of the file
 print(content)
 
-# HTML content to C++ string
-content = "const char mainPage[] PROGMEM = R\"=====(" + content + ")=====\";"
+# Compress once at build time, the firmware sends it as is (Content-Encoding: gzip).
+# mtime=0 keeps the output (and so the ETag) stable for the same page.
+data = gzip.compress(content.encode('utf-8'), compresslevel=9, mtime=0)
+etag = hashlib.sha1(data).hexdigest()[:16]
+print('Web UI: %d bytes, gzip %d bytes, ETag %s' % (len(content), len(data), etag))
+
+# Compressed content to C++ array
+lines = []
+for i in range(0, len(data), 32):
+    lines.append('    ' + ', '.join('0x%02X' % b for b in data[i:i + 32]) + ',')
+
+content = '// Will be replaced via .github/webui.py script during build pipeline\n'
+content += '#define MAINPAGE_ETAG "\\"' + etag + '\\""\n'
+content += '#define MAINPAGE_LENGHT ' + str(len(data)) + '\n'
+content += 'const uint8_t mainPage[] PROGMEM = {\n' + '\n'.join(lines) + '\n};\n'
 
 # Write the content of the file
 webuih = open('./include/Webinterface.h', 'w')
 webuih.write(content)
 webuih.close()
-
@@ -32,3 +32,39 @@ if version == "":
 # Rename binary according to environnement/board
 # ex: firmware_esp32dev.bin or firmware_nodemcuv2.bin
 env.Replace(PROGNAME=f"firmware_v{version}_{build_tag}")
+
+
+# Compressed images for the OTA update next to the binary:
+# firmware_v<version>_<env>.bin.hs (heatshrink, all boards), .bin.gz (ESP8266 only,
+# unpacked by its boot loader) and the MD5 of every image in firmware_v<version>_<env>.md5
+def compress_firmware(source, target, env):
+    import gzip
+    import hashlib
+    import sys
+    sys.path.insert(0, os.path.join(env.subst("$PROJECT_DIR"), ".github"))
+    import heatshrink
+
+    binary = str(target[0])
+    with open(binary, "rb") as f:
+        image = f.read()
+
+    images = {binary: image}
+    packed = heatshrink.compress(image)
+    if heatshrink.decompress(packed) != image:
+        raise Exception(f"heatshrink round trip failed for {binary}")
+    images[binary + ".hs"] = packed
+    if env.get("PIOPLATFORM") == "espressif8266":
+        images[binary + ".gz"] = gzip.compress(image, 9, mtime=0)
+
+    md5 = ""
+    for path, data in images.items():
+        if path != binary:
+            with open(path, "wb") as f:
+                f.write(data)
+        md5 += f"{hashlib.md5(data).hexdigest()}  {os.path.basename(path)}\n"
+        print(f"{os.path.basename(path)}: {len(data)} bytes")
+    with open(os.path.splitext(binary)[0] + ".md5", "w") as f:
+        f.write(md5)
+
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.bin", compress_firmware)
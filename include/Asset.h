@@ -0,0 +1,34 @@
+#ifndef ASSET_H_
+#define ASSET_H_
+
+#include <Arduino.h>
+
+// One frame of a built-in screen: the rectangle that changed against the previous frame
+// (the first frame against a cleared area), its pixels start at offset in the pixel table.
+struct AssetFrame
+{
+    uint8_t x;
+    uint8_t y;
+    uint8_t width;
+    uint8_t height;
+    uint16_t delay;
+    uint16_t offset;
+};
+
+// Built-in screen, generated at build time by .github/assets.py (include/Assets.h).
+// Frames and pixels (RGB565) are in flash.
+struct Asset
+{
+    uint8_t width;
+    uint8_t height;
+    uint8_t frameCount;
+    const AssetFrame *frames;
+    const uint16_t *pixels;
+};
+
+AssetFrame AssetGetFrame(const Asset &asset, uint8_t frame);
+uint16_t AssetFrameDelay(const Asset &asset, uint8_t frame);
+// Applies a frame to a bitmap of width x height, frame by frame this gives the full images
+void AssetApplyFrame(const Asset &asset, uint8_t frame, uint16_t *bitmap);
+
+#endif
@@ -0,0 +1,62 @@
+// Generated by .github/assets.py from assets/*.json, do not edit
+#ifndef ASSETS_H_
+#define ASSETS_H_
+
+#include "Asset.h"
+
+// battery.json
+const uint16_t batteryScreenPixels[] PROGMEM = {
+    0x0000, 0xFFFF, 0xFFFF, 0xFFFF, 0x0000, 0x0000, 0xFFFF, 0x07E0, 0xFFFF, 0x0000, 0xFFFF, 0x07E0, 0x07E0, 0x07E0, 0xFFFF, 0xFFFF,
+    0x07E0, 0x07E0, 0x07E0, 0xFFFF, 0xFFFF, 0x07E0, 0x07E0, 0x07E0, 0xFFFF, 0xFFFF, 0x07E0, 0x07E0, 0x07E0, 0xFFFF, 0xFFFF, 0x07E0,
+    0x07E0, 0x07E0, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF,
+};
+const AssetFrame batteryScreenFrames[] PROGMEM = {
+    {1, 0, 5, 8, 0, 0},
+};
+const Asset batteryScreen = {8, 8, 1, batteryScreenFrames, batteryScreenPixels};
+
+// bootanimation.json
+const uint16_t bootAnimationPixels[] PROGMEM = {
+    0xF99F, 0xF99F, 0xF99F, 0xF99F, 0x0000, 0xF99F, 0xF99F, 0xF99F, 0x0000, 0xF99F, 0x0000, 0x0000, 0xF99F, 0x0000, 0x0000, 0x07E5,
+    0x07E5, 0x07E5, 0x07E5, 0x07E5, 0xF8C3, 0x0000, 0xF8C3, 0xF8C3, 0x0000, 0xF8C3, 0x0000, 0xF8C3, 0x0000, 0xF8C3, 0x0000, 0xF8C3,
+    0xF8C3, 0x0000, 0xF8C3, 0x1FFF, 0x1FFF, 0x1FFF, 0x1FFF, 0x0000, 0x0000, 0x1FFF, 0x1FFF, 0x1FFF, 0x1FFF, 0x0000, 0x0000, 0x1FFF,
+    0x1FFF, 0x1FFF, 0xFEE6, 0x0000, 0x0000, 0xFEE6, 0x0000, 0x0000, 0xFEE6, 0x0000, 0x0000, 0xFEE6, 0x0000, 0x0000, 0xFEE6, 0xFEE6,
+    0xFEE6, 0xFFFF, 0x0000, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0x0000, 0x0000, 0xFFFF, 0x0000, 0xFFFF, 0x0000, 0x0000, 0xFFFF, 0x0000,
+    0xFFFF, 0x0000, 0x0000, 0xFFFF, 0x0000, 0xFFFF, 0x0000, 0x0000, 0xFFFF, 0x0000,
+};
+const AssetFrame bootAnimationFrames[] PROGMEM = {
+    {4, 1, 3, 5, 200, 0},
+    {8, 1, 1, 5, 200, 15},
+    {10, 1, 3, 5, 200, 20},
+    {14, 1, 3, 5, 200, 35},
+    {18, 1, 3, 5, 500, 50},
+    {22, 1, 5, 5, 1000, 65},
+};
+const Asset bootAnimation = {32, 8, 6, bootAnimationFrames, bootAnimationPixels};
+
+// updatescreen.json
+const uint16_t updateScreenPixels[] PROGMEM = {
+    0xF800, 0xF800, 0x0000, 0x0000, 0xFFC0, 0xFFC0, 0x0000, 0x0000, 0x0000, 0xFD80, 0xFD80, 0xFD80, 0xFD80, 0x0000, 0xF800, 0xF800,
+    0xF800, 0xF800, 0xF800, 0xF800, 0x0000, 0x0000, 0x07DD, 0x07DD, 0x0000, 0x0000, 0x0000, 0x07C2, 0x07C2, 0x07C2, 0x07C2, 0x0000,
+    0xFFC0, 0xFFC0, 0xFFC0, 0xFFC0, 0xFFC0, 0xFFC0, 0x0000, 0x0000, 0xFD80, 0xFD80, 0x0000, 0x0000, 0x0000, 0x0000, 0xF800, 0xF800,
+    0x0000, 0x0000, 0x0000, 0x0000, 0xA81F, 0xA81F, 0x0000, 0x0000, 0x0000, 0x017F, 0x017F, 0x017F, 0x017F, 0x0000, 0x07DD, 0x07DD,
+    0x07DD, 0x07DD, 0x07DD, 0x07DD, 0x0000, 0x0000, 0x07C2, 0x07C2, 0x0000, 0x0000, 0x0000, 0x0000, 0xFFC0, 0xFFC0, 0x0000, 0x0000,
+    0x0000, 0xF81D, 0xF81D, 0xF81D, 0xF81D, 0x0000, 0xA81F, 0xA81F, 0xA81F, 0xA81F, 0xA81F, 0xA81F, 0x0000, 0x0000, 0x017F, 0x017F,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x07DD, 0x07DD, 0x0000, 0x0000, 0x0000, 0x0000, 0x07C2, 0x07C2, 0x0000, 0x0000, 0x0000, 0x0000,
+    0xFFC0, 0xFFC0, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0xF81D, 0xF81D, 0x0000, 0x0000, 0x0000, 0x0000, 0xA81F, 0xA81F, 0x0000, 0x0000, 0x0000, 0x0000, 0x017F, 0x017F,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x07DD, 0x07DD, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+};
+const AssetFrame updateScreenFrames[] PROGMEM = {
+    {3, 7, 2, 1, 400, 0},
+    {1, 5, 6, 3, 400, 2},
+    {1, 3, 6, 5, 400, 20},
+    {1, 1, 6, 5, 400, 50},
+    {1, 0, 6, 8, 400, 80},
+    {1, 0, 6, 6, 400, 128},
+    {3, 2, 2, 2, 400, 164},
+};
+const Asset updateScreen = {8, 8, 7, updateScreenFrames, updateScreenPixels};
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef BLITTER_H_
+#define BLITTER_H_
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+#include <FastLED_NeoMatrix.h>
+#include "MatrixGeometry.h"
+#include "Asset.h"
+
+// Direct RGB565 drawing into the LED buffer. The XY remap of the configured matrix type and
+// the 565 -> 888 expansion (incl. the gamma of FastLED_NeoMatrix) are table lookups,
+// built once at boot from the matrix itself, so the result is identical to drawPixel().
+class Blitter
+{
+public:
+    Blitter();
+    void begin(FastLED_NeoMatrix *matrix, CRGB *leds);
+    void drawPixel(int16_t x, int16_t y, uint16_t color);
+
+    inline void drawPixel(int16_t x, int16_t y, const CRGB &color)
+    {
+        if (x >= 0 && y >= 0 && x < Geometry::width && y < Geometry::height)
+        {
+            _leds[index(x, y)] = color;
+        }
+    }
+    void drawRow(int16_t x, int16_t y, const uint16_t *data, int16_t w);
+    void drawBitmap(int16_t x, int16_t y, const uint16_t *bitmap, int16_t w, int16_t h);
+    // Draws the changed rectangle of an asset frame straight from flash
+    void drawAsset(int16_t x, int16_t y, const Asset &asset, uint8_t frame);
+    const uint16_t *map() const;
+    CRGB *leds() const;
+
+    // LED index of pixel x/y, no range check
+    inline uint16_t index(uint16_t x, uint16_t y) const
+    {
+        return _map[y * Geometry::width + x];
+    }
+
+    inline CRGB color(uint16_t color) const
+    {
+        return CRGB(_red[color >> 11], _green[(color >> 5) & 0x3F], _blue[color & 0x1F]);
+    }
+
+protected:
+    CRGB *_leds;
+    uint16_t _map[Geometry::pixels];
+    uint8_t _red[32];
+    uint8_t _green[64];
+    uint8_t _blue[32];
+};
+
+#endif
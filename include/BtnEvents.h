@@ -0,0 +1,14 @@
+#ifndef BTNEVENTS_H
+#define BTNEVENTS_H
+
+enum btnEvents
+{
+    btnEvent_Released = 0,
+    btnEvent_Pressed = 1,
+    btnEvent_Short = 2,
+    btnEvent_Long = 3,
+    btnEvent_Double = 4,
+    btnEvent_Repeat = 5,
+};
+
+#endif // BTNEVENTS_H
\ No newline at end of file
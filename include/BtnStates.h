@@ -1,11 +0,0 @@
-#ifndef BTNSTATES_H
-#define BTNSTATES_H
-
-enum btnStates
-{
-    btnState_Released,
-    btnState_PressedNew,
-    btnState_PressedBefore,
-};
-
-#endif // BTNSTATES_H
\ No newline at end of file
@@ -0,0 +1,72 @@
+#ifndef BUTTONS_H_
+#define BUTTONS_H_
+
+#include <Arduino.h>
+#include "BtnEvents.h"
+
+#define BUTTONS_COUNT 3
+#define BUTTONS_QUEUE_SIZE 32 // Must be a power of two
+#define BUTTONS_DEBOUNCE_MS 30
+#define BUTTONS_LONGPRESS_MS 800
+#define BUTTONS_DOUBLEPRESS_MS 300
+#define BUTTONS_REPEAT_MS 250
+
+typedef struct
+{
+    uint8_t button;
+    uint8_t level;
+    uint32_t millis;
+} ButtonEdge;
+
+class Buttons
+{
+public:
+    Buttons();
+    void begin(const uint8_t *pins, const int *pressedLevels, const bool *enabled);
+    void setCallback(void (*func)(uint8_t, btnEvents));
+    void setDoublePressEnabled(uint8_t button, bool enabled);
+    void loop();
+
+    // Raw, possibly bouncing level change. Called from the ISR, also usable to feed recorded traces.
+    void IRAM_ATTR edge(uint8_t button, uint8_t level, uint32_t timestamp);
+
+protected:
+    static Buttons *_instance;
+    static void IRAM_ATTR isr0();
+    static void IRAM_ATTR isr1();
+    static void IRAM_ATTR isr2();
+    void IRAM_ATTR handleInterrupt(uint8_t button);
+
+    // Single producer (ISR) / single consumer (loop) ring buffer, no locking needed
+    volatile ButtonEdge _queue[BUTTONS_QUEUE_SIZE];
+    volatile uint8_t _queueHead;
+    volatile uint8_t _queueTail;
+    volatile bool _queueOverflow;
+
+    uint8_t _pins[BUTTONS_COUNT];
+    int _pressedLevels[BUTTONS_COUNT];
+    bool _enabled[BUTTONS_COUNT];
+    bool _polled[BUTTONS_COUNT];
+    bool _doublePressEnabled[BUTTONS_COUNT];
+
+    // Debouncer
+    uint8_t _rawLevel[BUTTONS_COUNT];
+    uint32_t _rawSince[BUTTONS_COUNT];
+    bool _pressed[BUTTONS_COUNT];
+
+    // Gestures
+    uint32_t _pressedSince[BUTTONS_COUNT];
+    uint32_t _releasedSince[BUTTONS_COUNT];
+    uint32_t _lastRepeat[BUTTONS_COUNT];
+    uint8_t _clicks[BUTTONS_COUNT];
+    bool _longFired[BUTTONS_COUNT];
+
+    void (*callbackFunction)(uint8_t, btnEvents);
+
+    void debounce(uint8_t button, uint32_t now);
+    void gestures(uint8_t button, uint32_t now);
+    void stableChanged(uint8_t button, bool pressed, uint32_t now);
+    void emit(uint8_t button, btnEvents event);
+};
+
+#endif
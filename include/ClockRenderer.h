@@ -0,0 +1,78 @@
+#ifndef CLOCKRENDERER_H_
+#define CLOCKRENDERER_H_
+
+#include <Arduino.h>
+#include "Blitter.h"
+#include "TextEngine.h"
+
+#define CLOCKRENDERER_MAX_LENGHT 12
+#define CLOCKRENDERER_SPRITES " 0123456789:./AMP"
+#define CLOCKRENDERER_STEP_INTERVAL 35 // ms per transition step
+
+// Pre-rasterised character, rows[0] is 7 rows above the base line, bit 7 is the left column
+struct ClockSprite
+{
+    uint8_t rows[8];
+    uint8_t advance;
+};
+
+// Incremental clock renderer. The characters of the clock are cached as sprites for the
+// selected font, a new text only redraws the cells that changed. Switching between time and
+// date slides the whole line, changed digits can roll in, both without blocking.
+// The clock band is everything between the highest and lowest sprite row.
+class ClockRenderer
+{
+public:
+    ClockRenderer();
+    void begin(Blitter *blitter, TextEngine *textEngine);
+    void setFont(const GlyphFont *font);
+    void setColor(uint16_t color);
+    void setRollDigits(bool rollDigits);
+    uint16_t textWidth(const char *text);
+    // Next update draws everything, the caller has to clear the matrix
+    void invalidate();
+    // False if something else has drawn on the matrix since the last update
+    bool intact();
+    // y is the base line, returns true if pixels changed
+    bool update(const char *text, int16_t x, int16_t y, bool slide);
+    // Advances a running transition, returns true if pixels changed
+    bool loop();
+    bool inTransition() const;
+    // millis() of the next transition step
+    unsigned long nextStep() const;
+
+protected:
+    Blitter *_blitter;
+    TextEngine *_textEngine;
+    const GlyphFont *_font;
+    uint16_t _color;
+    CRGB _rgb;
+    bool _rollDigits;
+    ClockSprite _sprites[sizeof(CLOCKRENDERER_SPRITES) - 1];
+    uint8_t _bandTop;
+    uint8_t _bandHeight;
+
+    bool _valid;
+    char _text[CLOCKRENDERER_MAX_LENGHT + 1];
+    int16_t _x;
+    int16_t _y;
+    uint32_t _checksum;
+
+    // Transition
+    char _oldText[CLOCKRENDERER_MAX_LENGHT + 1];
+    int16_t _oldX;
+    bool _sliding;
+    uint16_t _rolling;
+    uint8_t _step;
+    unsigned long _lastStep;
+
+    const ClockSprite *sprite(char c) const;
+    int16_t cellX(const char *text, int16_t x, uint8_t index) const;
+    void clearBand(int16_t x, uint8_t width);
+    void drawSprite(const ClockSprite *sprite, int16_t x, int8_t shift);
+    void drawLine(const char *text, int16_t x, int8_t shift);
+    void step();
+    uint32_t checksum() const;
+};
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef COMMANDCAPTURE_H_
+#define COMMANDCAPTURE_H_
+
+#include <Arduino.h>
+#include <FS.h>
+
+#define CAPTURE_PATH "/capture.bin"
+#define CAPTURE_MAX_LENGHT 65536 // Recording stops at this file size
+#define CAPTURE_VERSION 1
+#define CAPTURE_HEADER_LENGHT 8
+#define CAPTURE_COMMAND_LENGHT 24
+#define CAPTURE_FRAME_INTERVAL 33 // ms, a loop pass longer than this drops frames
+#define CAPTURE_HISTOGRAM_BUCKETS 124
+
+enum CaptureTransport
+{
+    CaptureTransport_Http,
+    CaptureTransport_Mqtt,
+    CaptureTransport_WebSocket,
+    CaptureTransport_Count,
+};
+
+enum CaptureState
+{
+    CaptureState_Idle,
+    CaptureState_Recording,
+    CaptureState_Replaying,
+};
+
+struct CaptureRecord
+{
+    uint32_t time; // ms since the start of the recording
+    CaptureTransport transport;
+    char command[CAPTURE_COMMAND_LENGHT]; // HTTP route or MQTT topic, empty for the websocket
+    String payload;
+};
+
+// Records inbound commands with their transport and arrival time into a file and replays
+// them with the original timing, e.g. to reproduce a stutter or compare firmware versions.
+// File: "PXCP", version, 3 reserved bytes, then per command the varint ms since the previous
+// one, the transport, the command length and text, the varint payload length and payload.
+// While replaying the render time of every command, loop passes that drop frames and the
+// lowest free heap are collected for report().
+class CommandCapture
+{
+public:
+    CommandCapture();
+    bool record();
+    // Speed in percent, 200 replays twice as fast
+    bool replay(uint16_t speed);
+    void stop();
+    CaptureState state() const;
+
+    void add(CaptureTransport transport, const char *command, const char *payload, size_t length);
+    // The next command that is due while replaying
+    bool next(CaptureRecord &record);
+    void loop();
+    // Before the handler frees its buffers, the heap is sampled as well
+    void renderTime(uint32_t micros);
+    void skipped();
+
+    size_t length() const;
+    uint16_t records() const;
+    String report() const;
+    File open() const;
+
+    static const char *transportName(CaptureTransport transport);
+    static const char *stateName(CaptureState state);
+
+protected:
+    CaptureState _state;
+    File _file;
+    size_t _length;
+    uint16_t _records;
+    uint16_t _lost;
+    uint32_t _startMillis;
+    uint32_t _lastTime;
+
+    // Replay
+    uint16_t _speed;
+    bool _pending; // Header of the next record is read, the payload not yet
+    CaptureRecord _next;
+    size_t _nextLength;
+    uint16_t _replayed;
+    uint16_t _skipped;
+    uint32_t _dropped;
+    uint32_t _lastLoop;
+    uint32_t _heapStart;
+    uint32_t _heapMin;
+    uint32_t _renderMax;
+    uint16_t _histogram[CAPTURE_HISTOGRAM_BUCKETS];
+
+    bool readHeader();
+    bool readVarint(uint32_t &value);
+    void writeVarint(uint32_t value);
+    void sampleHeap();
+    uint32_t percentile(uint8_t percent) const;
+    void finish();
+};
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef DFPLAYER_H_
+#define DFPLAYER_H_
+
+#include <Arduino.h>
+
+#define DFPLAYER_FRAME_LENGHT 10
+#define DFPLAYER_QUEUE_LENGHT 8
+#define DFPLAYER_STARTUP_DELAY 1000 // The module ignores commands until it has read the SD card
+#define DFPLAYER_COMMAND_SPACING 100 // Between two commands, the module drops commands sent faster
+#define DFPLAYER_VOLUME_SPACING 200 // After a volume change
+#define DFPLAYER_ACK_TIMEOUT 300
+#define DFPLAYER_DETECT_TIMEOUT 5000 // Since begin(), a large SD card takes the module seconds to read
+#define DFPLAYER_MAX_RETRIES 2
+
+enum DFPlayerState
+{
+    DFPlayerState_Offline,
+    DFPlayerState_Stopped,
+    DFPlayerState_Playing,
+    DFPlayerState_Paused,
+    DFPlayerState_Count,
+};
+
+struct DFPlayerCommand
+{
+    uint8_t command;
+    uint16_t param;
+    uint8_t retries;
+};
+
+// DFPlayer Mini driver without waiting. Commands are queued and sent from loop() with the
+// spacing the module needs, acknowledgements, errors and status frames are parsed from
+// whatever the serial port has received. Busy, checksum and serial errors as well as
+// missing acknowledgements are retried. A queued volume change is replaced by a newer one.
+// Sending a frame still takes ~10 ms at 9600 baud on a software serial.
+class DFPlayer
+{
+public:
+    DFPlayer();
+    void begin(Stream &serial);
+    void loop();
+    // Called on every state change, also when the module is not found
+    void setCallback(void (*func)(DFPlayerState state));
+
+    void play(uint16_t track);
+    void playFolder(uint8_t folder, uint8_t track);
+    void playNext();
+    void playPrevious();
+    void pause();
+    void resume();
+    void stop();
+    void volume(uint8_t volume);
+
+    DFPlayerState state() const;
+    bool isPlaying() const;
+    // Commands queued or not yet acknowledged
+    bool busy() const;
+    uint16_t errors() const;
+    uint8_t lastError() const;
+    uint16_t timeouts() const;
+    uint16_t dropped() const;
+
+    static const char *stateName(DFPlayerState state);
+
+protected:
+    Stream *_serial;
+    DFPlayerState _state;
+    bool _detected; // Any valid frame received
+    unsigned long _beginMillis;
+    bool _starting; // Nothing sent since begin()
+
+    DFPlayerCommand _queue[DFPLAYER_QUEUE_LENGHT];
+    uint8_t _head;
+    uint8_t _count;
+    DFPlayerCommand _sent;
+    bool _awaiting;
+    unsigned long _sentMillis;
+    unsigned long _nextMillis;
+
+    uint8_t _frame[DFPLAYER_FRAME_LENGHT];
+    uint8_t _frameLength;
+
+    uint16_t _errors;
+    uint8_t _lastError;
+    uint16_t _timeouts;
+    uint16_t _dropped;
+
+    void (*callbackFunction)(DFPlayerState state);
+
+    void enqueue(uint8_t command, uint16_t param);
+    void retry();
+    void send(const DFPlayerCommand &command);
+    void receive(uint8_t b);
+    void handleFrame(uint8_t command, uint16_t param);
+    void acknowledged();
+    void setState(DFPlayerState state);
+};
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef DEADBAND_H_
+#define DEADBAND_H_
+
+#include <Arduino.h>
+
+#define DEADBAND_MAX_FIELDS 8
+
+struct DeadbandField
+{
+    float absolute;
+    float relative; // Fraction of the published value
+    float published;
+    uint32_t publishedMillis;
+    bool hasPublished;
+};
+
+// Numeric change detection for publishing. A value is due when it left the band around the
+// last published value and the minimum interval has passed, or when the maximum interval
+// (0 = never) has passed. NAN stands for an unavailable value, becoming (un)available is a change.
+class Deadband
+{
+public:
+    Deadband();
+    void begin(uint8_t fields, uint32_t minInterval, uint32_t maxInterval);
+    void setBand(uint8_t field, float absolute, float relative);
+    // Next check is due for every field
+    void reset();
+
+    bool changed(uint8_t field, float value) const;
+    bool due(uint8_t field, float value) const;
+    // Any field of a combined payload is due
+    bool due(const float *values) const;
+    void published(uint8_t field, float value);
+    void published(const float *values);
+
+protected:
+    DeadbandField _fields[DEADBAND_MAX_FIELDS];
+    uint8_t _count;
+    uint32_t _minInterval;
+    uint32_t _maxInterval;
+};
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef EFFECTENGINE_H_
+#define EFFECTENGINE_H_
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include "Blitter.h"
+
+#define EFFECT_DEFAULT_INTERVAL 33 // ms, 30 FPS
+#define EFFECT_DEFAULT_DENSITY 128
+#define EFFECT_MAX_STARS 32
+#define EFFECT_MAX_BANDS Geometry::width
+#define EFFECT_SPECTRUM_TIMEOUT 2000 // Bars fall when no values came for this long
+
+enum EffectType
+{
+    EffectType_None,
+    EffectType_Fire,
+    EffectType_Plasma,
+    EffectType_Rain,
+    EffectType_Starfield,
+    EffectType_Spectrum,
+    EffectType_Count,
+};
+
+struct EffectStar
+{
+    uint16_t x; // 8.8 fixed point
+    uint8_t y;
+    uint8_t speed; // 1/256 pixel per step, also the brightness
+};
+
+// Procedural animations computed on the device, drawn into a zone of the matrix.
+// The kernels only use 8 bit math and tables (sin8, random8, palettes). step() advances the
+// state by one frame, draw() renders the state and may be repeated, e.g. when the foreground
+// changes in between. In background mode the lit pixels of the screen captured with
+// capture() stay on top, so text and bitmaps can be drawn over the effect.
+class EffectEngine
+{
+public:
+    EffectEngine();
+    void begin(Blitter *blitter);
+
+    // Zone is clipped to the matrix, parameters are reset to the defaults of the effect
+    void start(EffectType type, int16_t x, int16_t y, int16_t width, int16_t height);
+    void stop();
+    bool active() const;
+    EffectType type() const;
+
+    bool setPalette(const char *name);
+    // Gradient black - color - white instead of a palette
+    void setColor(const CRGB &color);
+    // Sparks, drops, stars or the plasma scale
+    void setDensity(uint8_t density);
+    void setInterval(uint16_t interval);
+    void setBackground(bool background);
+    // Band levels 0-255 for the spectrum bars
+    void setSpectrum(const uint8_t *values, uint8_t count);
+    uint16_t interval() const;
+
+    void step();
+    void draw();
+    // Foreground of the background mode, taken from / put back into the LED buffer
+    void capture();
+    void restore();
+
+    static const char *typeName(EffectType type);
+    static int8_t typeFromName(const char *name);
+
+protected:
+    Blitter *_blitter;
+    CRGB *_leds;
+    EffectType _type;
+    int16_t _x;
+    int16_t _y;
+    uint16_t _width;
+    uint16_t _height;
+    uint16_t _interval;
+    uint8_t _density;
+    bool _background;
+    CRGBPalette16 _palette;
+    uint16_t _time;
+
+    // Fire heat or rain brightness, row by row of the zone
+    uint8_t _cells[Geometry::pixels];
+    // Snapshot of the whole LED buffer in LED order
+    CRGB _overlay[Geometry::pixels];
+
+    uint16_t _drops[Geometry::width]; // 8.8 fixed point, 0 = no drop
+    uint8_t _dropSpeeds[Geometry::width];
+    EffectStar _stars[EFFECT_MAX_STARS];
+
+    uint8_t _bands;
+    uint8_t _targets[EFFECT_MAX_BANDS];
+    uint8_t _levels[EFFECT_MAX_BANDS];
+    uint8_t _peaks[EFFECT_MAX_BANDS];
+    uint8_t _peakHolds[EFFECT_MAX_BANDS];
+    uint32_t _spectrumMillis;
+
+    void stepFire();
+    void stepRain();
+    void stepStarfield();
+    void stepSpectrum();
+    void drawCells();
+    void drawPlasma();
+    void drawStarfield();
+    void drawSpectrum();
+    void drawOverlay();
+
+    inline void setPixel(uint16_t x, uint16_t y, const CRGB &color)
+    {
+        _leds[_blitter->index(_x + x, _y + y)] = color;
+    }
+};
+
+#endif
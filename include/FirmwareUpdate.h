@@ -0,0 +1,57 @@
+#ifndef FIRMWAREUPDATE_H_
+#define FIRMWAREUPDATE_H_
+
+#include <Arduino.h>
+#include <MD5Builder.h>
+#include "Heatshrink.h"
+
+enum FirmwareFormat
+{
+    FirmwareFormat_Raw,
+    FirmwareFormat_Gzip,
+    FirmwareFormat_Heatshrink,
+};
+
+// Firmware or file system image written to flash while it is uploaded.
+// Heatshrink images (.bin.hs) are decompressed on the fly through a 1 KB window. Gzip images
+// (.bin.gz) are written as they are, the ESP8266 boot loader unpacks them, so they are
+// rejected on ESP32. The MD5 of the uploaded file is checked before the new image is
+// activated, on a mismatch the old one stays.
+class FirmwareUpdate
+{
+public:
+    FirmwareUpdate();
+    // uploadLength is the request body (file plus form framing), used for the progress
+    bool begin(bool filesystem, bool heatshrink, const String &md5, size_t uploadLength);
+    void write(const uint8_t *data, size_t length);
+    bool end();
+    void abort();
+    bool active() const;
+    bool success() const;
+    String error() const;
+    // Percent of the upload received
+    uint8_t progress() const;
+    // Called whenever the progress changes
+    void setCallback(void (*func)(uint8_t progress));
+
+protected:
+    HeatshrinkDecoder _decoder;
+    MD5Builder _md5;
+    String _expectedMd5;
+    String _error;
+    FirmwareFormat _format;
+    bool _active;
+    bool _success;
+    bool _filesystem;
+    bool _started; // Format detected, first bytes written
+    size_t _uploadLength;
+    size_t _received;
+    uint8_t _progress;
+    void (*callbackFunction)(uint8_t progress);
+
+    void fail(const String &error);
+    void flashAbort();
+    static void writeDecoded(const uint8_t *data, size_t length);
+};
+
+#endif
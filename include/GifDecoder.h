@@ -0,0 +1,131 @@
+#ifndef GIFDECODER_H_
+#define GIFDECODER_H_
+
+#include <Arduino.h>
+#include "MatrixGeometry.h"
+
+// Largest frame (width * height) the decoder accepts, matches animationBmpList (Geometry::bitmapPixels)
+#define GIFDECODER_MAX_PIXELS (MATRIX_HEIGHT * MATRIX_HEIGHT)
+// Every LZW code outputs at least one pixel, so a frame of GIFDECODER_MAX_PIXELS
+// never adds more entries than that to the code table. No 4096 entry table needed.
+#define GIFDECODER_TABLE_SIZE (256 + 2 + GIFDECODER_MAX_PIXELS + 2)
+#define GIFDECODER_STACK_SIZE (GIFDECODER_MAX_PIXELS + 2)
+#define GIFDECODER_BUFFER_LENGHT 16
+
+enum GifDecoderStatus
+{
+    GifDecoderStatus_Decoding,
+    GifDecoderStatus_Done,
+    GifDecoderStatus_ErrorFormat,
+    GifDecoderStatus_ErrorTooLarge,
+};
+
+enum GifDecoderState
+{
+    GifDecoderState_Header,
+    GifDecoderState_ScreenDescriptor,
+    GifDecoderState_GlobalColorTable,
+    GifDecoderState_BlockIntro,
+    GifDecoderState_ExtensionLabel,
+    GifDecoderState_ExtensionBlockSize,
+    GifDecoderState_ExtensionBlock,
+    GifDecoderState_ImageDescriptor,
+    GifDecoderState_LocalColorTable,
+    GifDecoderState_LzwMinCodeSize,
+    GifDecoderState_ImageBlockSize,
+    GifDecoderState_ImageBlock,
+    GifDecoderState_Trailer,
+};
+
+// Streaming GIF decoder, the data can be passed in chunks of any size.
+// Frames are composed (disposal, transparency) and written as RGB565 straight
+// into the caller's frame store, one frame after another.
+class GifDecoder
+{
+public:
+    GifDecoder();
+    void begin(uint16_t *frames, uint16_t frameSize, uint8_t maxFrames, uint16_t *delays);
+    GifDecoderStatus write(const uint8_t *data, size_t length);
+    GifDecoderStatus status() const;
+    uint8_t frameCount() const;
+    uint16_t width() const;
+    uint16_t height() const;
+    uint16_t loops() const;
+
+protected:
+    uint16_t *_frames;
+    uint16_t _frameSize;
+    uint8_t _maxFrames;
+    uint16_t *_delays;
+
+    GifDecoderStatus _status;
+    GifDecoderState _state;
+    uint8_t _buffer[GIFDECODER_BUFFER_LENGHT];
+    uint16_t _need;
+    uint16_t _have;
+    uint16_t _blockRemaining;
+
+    uint16_t _width;
+    uint16_t _height;
+    uint16_t _loops;
+    uint8_t _frameCount;
+
+    uint16_t _globalColors[256];
+    uint16_t _localColors[256];
+    uint16_t _globalColorCount;
+    uint16_t _localColorCount;
+    uint16_t _colorIndex;
+
+    // Graphic control extension, valid for the next image
+    uint8_t _extensionLabel;
+    uint8_t _extensionBlock;
+    uint16_t _delay;
+    int16_t _transparent;
+    uint8_t _disposal;
+    uint8_t _previousDisposal;
+    uint16_t _previousLeft;
+    uint16_t _previousTop;
+    uint16_t _previousWidth;
+    uint16_t _previousHeight;
+
+    // Current image
+    uint16_t _imageLeft;
+    uint16_t _imageTop;
+    uint16_t _imageWidth;
+    uint16_t _imageHeight;
+    bool _interlaced;
+    bool _skipImage;
+    bool _imageDone;
+    uint16_t *_canvas;
+    uint16_t _pixelX;
+    uint16_t _pixelY;
+    uint8_t _pass;
+    uint16_t _pixelCount;
+
+    // LZW
+    uint16_t _prefix[GIFDECODER_TABLE_SIZE];
+    uint8_t _suffix[GIFDECODER_TABLE_SIZE];
+    uint8_t _stack[GIFDECODER_STACK_SIZE];
+    uint8_t _minCodeSize;
+    uint8_t _codeSize;
+    uint16_t _clearCode;
+    uint16_t _nextCode;
+    int16_t _previousCode;
+    uint8_t _firstChar;
+    uint32_t _bits;
+    uint8_t _bitCount;
+
+    void expect(GifDecoderState state, uint16_t bytes);
+    bool collect(uint8_t value);
+    void parse(uint8_t value);
+    void colorTableEntry(uint16_t *colors, uint16_t count, GifDecoderState next);
+    void extensionBlock();
+    void beginImage();
+    void endImage();
+    void lzwByte(uint8_t value);
+    bool lzwCode(uint16_t code);
+    void outputPixel(uint8_t index);
+    void fail(GifDecoderStatus status);
+};
+
+#endif
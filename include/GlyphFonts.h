@@ -0,0 +1,580 @@
+// Generated by .github/fonts.py from include/PixelItFont.h and assets/fonts/pixelit.txt, do not edit
+#ifndef GLYPHFONTS_H_
+#define GLYPHFONTS_H_
+
+#include "TextEngine.h"
+
+const uint8_t PixelItGlyphFontBitmaps[] PROGMEM = {
+    0xE8, 0xB4, 0xBE, 0xFA, 0x79, 0xE4, 0xA5, 0x4A, 0xDB, 0xD6, 0xC0, 0x6A, 0x40, 0x95, 0x80, 0xAA,
+    0x80, 0x5D, 0x00, 0x60, 0xE0, 0x80, 0x25, 0x48, 0xF6, 0xDE, 0x59, 0x2E, 0xE7, 0xCE, 0xE7, 0x9E,
+    0xB7, 0x92, 0xF3, 0x9E, 0xF3, 0xDE, 0xE4, 0x92, 0xF7, 0xDE, 0xF7, 0x9E, 0xA0, 0x46, 0x2A, 0x22,
+    0xE3, 0x80, 0x88, 0xA8, 0xE5, 0x04, 0x57, 0xC6, 0xD7, 0xDA, 0xD7, 0x5C, 0x56, 0x54, 0xD6, 0xDC,
+    0xF3, 0xCE, 0xF3, 0xC8, 0x72, 0xD6, 0xB7, 0xDA, 0xF8, 0x24, 0xD4, 0xB7, 0x5A, 0x92, 0x4E, 0x8E,
+    0xEB, 0x18, 0x80, 0x9D, 0xB9, 0x90, 0x56, 0xD4, 0xF7, 0x48, 0x4A, 0xAA, 0x70, 0xF7, 0x5A, 0xE9,
+    0x24, 0xB6, 0xDE, 0xB6, 0xD4, 0x8C, 0x63, 0x55, 0x00, 0xB5, 0x5A, 0xB7, 0x9C, 0xE5, 0x4E, 0xF2,
+    0x4E, 0x88, 0x80, 0xE4, 0x9E, 0x54, 0x90, 0xCE, 0xF0, 0x9A, 0xDC, 0x72, 0x30, 0x2E, 0xD6, 0x77,
+    0x30, 0x2B, 0xA4, 0x77, 0x94, 0x9A, 0xDA, 0xB8, 0x20, 0x9A, 0x80, 0x97, 0x6A, 0xC9, 0x2E, 0xFF,
+    0xD0, 0xD6, 0xD0, 0x56, 0xA0, 0xD6, 0xE8, 0x76, 0xB2, 0x72, 0x40, 0x79, 0xE0, 0x5D, 0x26, 0xB6,
+    0xB0, 0xB7, 0xA0, 0xBF, 0xF0, 0xA9, 0x50, 0xB5, 0x94, 0xEF, 0x70, 0x6A, 0x26, 0xD8, 0xC8, 0xAC,
+    0x78, 0x5E, 0x74, 0x6B, 0xAE, 0xAB, 0xAA, 0xB5, 0x74, 0x6A, 0xAC, 0x71, 0x80, 0x77, 0x8E, 0x64,
+    0xE4, 0xDA, 0x80, 0xF0, 0x5D, 0x0E, 0xC9, 0x80, 0xEF, 0x80, 0xB6, 0xE8, 0x75, 0xB6, 0xFF, 0x80,
+    0x47, 0x00, 0x55, 0x0E, 0x98, 0x90, 0x32, 0x90, 0x66, 0xD8, 0x32, 0x41, 0x4E, 0x45, 0x7A, 0x51,
+    0x7A, 0xE1, 0x7A, 0x79, 0x7A, 0xAA, 0xFA, 0xDA, 0xFA, 0x7B, 0xEE, 0x72, 0x32, 0x80, 0x47, 0xEE,
+    0x53, 0xEE, 0xE3, 0xEE, 0xA3, 0xEE, 0x47, 0xAE, 0x53, 0xAE, 0xE3, 0xAE, 0xA3, 0xAE, 0xD7, 0xDC,
+    0xCE, 0xFA, 0x47, 0xDE, 0x53, 0xDE, 0xE3, 0xDE, 0xCF, 0xDE, 0xA3, 0xDE, 0x77, 0xDC, 0x8A, 0xDE,
+    0x2A, 0xDE, 0xE2, 0xDE, 0xA2, 0xDE, 0x2A, 0xF4, 0x9E, 0xF8, 0x77, 0x5D, 0x00, 0x45, 0xDE, 0x51,
+    0xDE, 0xE1, 0xDE, 0x79, 0xDE, 0xA1, 0xDE, 0x6D, 0xDE, 0x7F, 0xE0, 0x71, 0x94, 0x45, 0xF6, 0x51,
+    0xF6, 0xE1, 0xF6, 0xA1, 0xF6, 0x9A, 0x80, 0x65, 0x40, 0xE1, 0x24, 0xA1, 0x24, 0x79, 0xD6, 0xCF,
+    0x5A, 0x45, 0x54, 0x51, 0x54, 0xE1, 0x54, 0xCD, 0x54, 0xA1, 0x54, 0x43, 0x84, 0x7E, 0xE0, 0x8A,
+    0xD6, 0x2A, 0xD6, 0xE2, 0xD6, 0xA2, 0xD6, 0x2A, 0xB2, 0x80, 0x9A, 0xE8, 0xA2, 0xB2, 0x80, 0x57,
+    0xDA, 0x40, 0xCE, 0xF2, 0x2E, 0x46, 0x21, 0xC6, 0xAE, 0x46, 0xA1, 0xC6, 0xF3, 0xCE, 0x40, 0x77,
+    0x32, 0xBF, 0x4E, 0xAE, 0x56, 0xA1, 0xD6, 0x50, 0x93, 0x4E, 0xC9, 0xAE, 0x29, 0xDB, 0x90, 0x23,
+    0x5A, 0x59, 0xDB, 0x90, 0xA3, 0x5A, 0x54, 0xAA, 0x40, 0x50, 0x4A, 0x40, 0xBA, 0xEA, 0xA1, 0xC8,
+    0x2F, 0x1C, 0x21, 0xAC, 0xF3, 0x9E, 0x80, 0xAF, 0x1C, 0xA1, 0xAC, 0x56, 0xDE, 0x42, 0xD6, 0x5A,
+    0xAA, 0xE0, 0x50, 0xAA, 0x60, 0x3D, 0x4E, 0x23, 0x26, 0x5D, 0x4E, 0x43, 0x26, 0xBD, 0x4E, 0xA3,
+    0x26, 0x74, 0x62, 0xAD, 0x80, 0xF2, 0x48, 0x4A, 0xDE, 0x57, 0xD4, 0x4A, 0xDA, 0xE1, 0x0E, 0xF6,
+    0xDA, 0xF1, 0x4E, 0x5E, 0xF4, 0xB7, 0xA4, 0x5A, 0xA5, 0x7A, 0x30, 0xD6, 0xD2, 0xA9, 0x57, 0x5D,
+    0x00, 0xB5, 0x24, 0x71, 0x54, 0xEA, 0x46, 0x40, 0xBB, 0x50, 0x89, 0x5A, 0xB6, 0xF8, 0xB6, 0xA0,
+    0xF3, 0x46, 0x40, 0xF6, 0xD0, 0x56, 0xE8, 0x71, 0x14, 0x7A, 0xA4, 0xE9, 0x10, 0x8C, 0x6A, 0xA0,
+    0x73, 0x46, 0xF3, 0x5C, 0x56, 0xDF, 0x40, 0xAD, 0x5D, 0x5A, 0x80, 0xC5, 0x1C, 0x99, 0xBD, 0x90,
+    0x69, 0xBD, 0x90, 0x76, 0xDA, 0xB5, 0x9C, 0xB6, 0xDE, 0x40, 0xB5, 0x92, 0xAD, 0x6B, 0x5F, 0x80,
+    0xAD, 0x6B, 0x5F, 0x84, 0xC4, 0x65, 0x60, 0x8C, 0x73, 0x5C, 0x80, 0x93, 0x5C, 0xC5, 0x9C, 0x95,
+    0x7B, 0x59, 0x00, 0x75, 0xDA, 0x73, 0xDE, 0xDA, 0xE0, 0xF2, 0x40, 0x56, 0xFA, 0xAB, 0x9D, 0x50,
+    0xCC, 0xE0, 0x9B, 0xD9, 0x76, 0xD0, 0x8E, 0xEB, 0x10, 0xBE, 0xD0, 0xE9, 0x20, 0xB6, 0xF2, 0xB5,
+    0x90, 0xAD, 0x6B, 0xF0, 0xAD, 0x6B, 0xF0, 0x80, 0xC6, 0x56, 0x8E, 0x6B, 0x90, 0x9A, 0xE0, 0xC5,
+    0xE0, 0x97, 0x6B, 0x20, 0x75, 0xD0, 0x3E, 0x48, 0xA8, 0x7B, 0xE6, 0x23, 0xFE, 0xF2, 0x00, 0x23,
+    0xBE, 0xE7, 0x00, 0x27, 0xBF, 0xE2, 0x00, 0x73, 0xBE, 0xE2, 0x00, 0x73, 0xBE, 0xE2, 0x7C, 0xAB,
+    0xBE, 0xEA, 0x80, 0x67, 0xBE, 0x77, 0xC8, 0x46, 0x00, 0x21, 0x3E, 0xE5, 0x00, 0x57, 0xFE, 0xE2,
+    0x00, 0x69, 0x6C, 0x2B, 0xA8, 0x08, 0xA8, 0x80, 0x25, 0x5D, 0x52, 0x00, 0x49, 0x7E, 0x23, 0xBE,
+    0xA5, 0x00, 0x5F, 0xA0, 0xE3, 0xF8, 0x61, 0xFC, 0xCA, 0x99, 0xF0, 0x5E, 0xFE, 0x23, 0x9D, 0xF2,
+    0x00, 0x52, 0x89, 0x17, 0x00, 0x3B, 0x3F, 0xD2,
+};
+const Glyph PixelItGlyphFontGlyphs[] PROGMEM = {
+    {0, 0, 0, 2, 0, 0}, // U+0020
+    {0, 1, 5, 2, 0, -5}, // U+0021
+    {1, 3, 2, 4, 0, -5}, // U+0022
+    {2, 3, 5, 4, 0, -5}, // U+0023
+    {4, 3, 5, 4, 0, -5}, // U+0024
+    {6, 3, 5, 4, 0, -5}, // U+0025
+    {8, 3, 5, 4, 0, -5}, // U+0026
+    {10, 1, 2, 2, 0, -5}, // U+0027
+    {11, 2, 5, 3, 0, -5}, // U+0028
+    {13, 2, 5, 3, 0, -5}, // U+0029
+    {15, 3, 3, 4, 0, -5}, // U+002A
+    {17, 3, 3, 4, 0, -4}, // U+002B
+    {19, 2, 2, 3, 0, -2}, // U+002C
+    {20, 3, 1, 4, 0, -3}, // U+002D
+    {21, 1, 1, 2, 0, -1}, // U+002E
+    {22, 3, 5, 4, 0, -5}, // U+002F
+    {24, 3, 5, 4, 0, -5}, // U+0030
+    {26, 3, 5, 4, 0, -5}, // U+0031
+    {28, 3, 5, 4, 0, -5}, // U+0032
+    {30, 3, 5, 4, 0, -5}, // U+0033
+    {32, 3, 5, 4, 0, -5}, // U+0034
+    {34, 3, 5, 4, 0, -5}, // U+0035
+    {36, 3, 5, 4, 0, -5}, // U+0036
+    {38, 3, 5, 4, 0, -5}, // U+0037
+    {40, 3, 5, 4, 0, -5}, // U+0038
+    {42, 3, 5, 4, 0, -5}, // U+0039
+    {44, 1, 3, 2, 0, -4}, // U+003A
+    {45, 2, 4, 3, 0, -4}, // U+003B
+    {46, 3, 5, 4, 0, -5}, // U+003C
+    {48, 3, 3, 4, 0, -4}, // U+003D
+    {50, 3, 5, 4, 0, -5}, // U+003E
+    {52, 3, 5, 4, 0, -5}, // U+003F
+    {54, 3, 5, 4, 0, -5}, // U+0040
+    {56, 3, 5, 4, 0, -5}, // U+0041
+    {58, 3, 5, 4, 0, -5}, // U+0042
+    {60, 3, 5, 4, 0, -5}, // U+0043
+    {62, 3, 5, 4, 0, -5}, // U+0044
+    {64, 3, 5, 4, 0, -5}, // U+0045
+    {66, 3, 5, 4, 0, -5}, // U+0046
+    {68, 3, 5, 4, 0, -5}, // U+0047
+    {70, 3, 5, 4, 0, -5}, // U+0048
+    {72, 1, 5, 2, 0, -5}, // U+0049
+    {73, 3, 5, 4, 0, -5}, // U+004A
+    {75, 3, 5, 4, 0, -5}, // U+004B
+    {77, 3, 5, 4, 0, -5}, // U+004C
+    {79, 5, 5, 6, 0, -5}, // U+004D
+    {83, 4, 5, 5, 0, -5}, // U+004E
+    {86, 3, 5, 4, 0, -5}, // U+004F
+    {88, 3, 5, 4, 0, -5}, // U+0050
+    {90, 4, 5, 5, 0, -5}, // U+0051
+    {93, 3, 5, 4, 0, -5}, // U+0052
+    {34, 3, 5, 4, 0, -5}, // U+0053
+    {95, 3, 5, 4, 0, -5}, // U+0054
+    {97, 3, 5, 4, 0, -5}, // U+0055
+    {99, 3, 5, 4, 0, -5}, // U+0056
+    {101, 5, 5, 6, 0, -5}, // U+0057
+    {105, 3, 5, 4, 0, -5}, // U+0058
+    {107, 3, 5, 4, 0, -5}, // U+0059
+    {109, 3, 5, 4, 0, -5}, // U+005A
+    {111, 3, 5, 4, 0, -5}, // U+005B
+    {113, 3, 3, 4, 0, -4}, // U+005C
+    {115, 3, 5, 4, 0, -5}, // U+005D
+    {117, 3, 2, 4, 0, -5}, // U+005E
+    {20, 3, 1, 4, 0, -1}, // U+005F
+    {118, 2, 2, 3, 0, -5}, // U+0060
+    {119, 3, 4, 4, 0, -4}, // U+0061
+    {121, 3, 5, 4, 0, -5}, // U+0062
+    {123, 3, 4, 4, 0, -4}, // U+0063
+    {125, 3, 5, 4, 0, -5}, // U+0064
+    {127, 3, 4, 4, 0, -4}, // U+0065
+    {129, 3, 5, 4, 0, -5}, // U+0066
+    {131, 3, 5, 4, 0, -4}, // U+0067
+    {133, 3, 5, 4, 0, -5}, // U+0068
+    {135, 1, 5, 2, 0, -5}, // U+0069
+    {136, 3, 6, 4, 0, -5}, // U+006A
+    {139, 3, 5, 4, 0, -5}, // U+006B
+    {141, 3, 5, 4, 0, -5}, // U+006C
+    {143, 3, 4, 4, 0, -4}, // U+006D
+    {145, 3, 4, 4, 0, -4}, // U+006E
+    {147, 3, 4, 4, 0, -4}, // U+006F
+    {149, 3, 5, 4, 0, -4}, // U+0070
+    {151, 3, 5, 4, 0, -4}, // U+0071
+    {153, 3, 4, 4, 0, -4}, // U+0072
+    {155, 3, 4, 4, 0, -4}, // U+0073
+    {157, 3, 5, 4, 0, -5}, // U+0074
+    {159, 3, 4, 4, 0, -4}, // U+0075
+    {161, 3, 4, 4, 0, -4}, // U+0076
+    {163, 3, 4, 4, 0, -4}, // U+0077
+    {165, 3, 4, 4, 0, -4}, // U+0078
+    {167, 3, 5, 4, 0, -4}, // U+0079
+    {169, 3, 4, 4, 0, -4}, // U+007A
+    {171, 3, 5, 4, 0, -5}, // U+007B
+    {173, 1, 5, 2, 0, -5}, // U+007C
+    {174, 3, 5, 4, 0, -5}, // U+007D
+    {176, 3, 2, 4, 0, -5}, // U+007E
+    {135, 1, 5, 2, 0, -5}, // U+00A1
+    {177, 3, 5, 4, 0, -5}, // U+00A2
+    {179, 3, 5, 4, 0, -5}, // U+00A3
+    {181, 3, 5, 4, 0, -5}, // U+00A4
+    {183, 3, 5, 4, 0, -5}, // U+00A5
+    {173, 1, 5, 2, 0, -5}, // U+00A6
+    {185, 3, 5, 4, 0, -5}, // U+00A7
+    {44, 3, 1, 4, 0, -5}, // U+00A8
+    {187, 3, 3, 4, 0, -5}, // U+00A9
+    {189, 3, 5, 4, 0, -5}, // U+00AA
+    {191, 2, 3, 3, 0, -5}, // U+00AB
+    {192, 3, 2, 4, 0, -4}, // U+00AC
+    {10, 2, 1, 3, 0, -3}, // U+00AD
+    {193, 3, 3, 4, 0, -5}, // U+00AE
+    {20, 3, 1, 4, 0, -5}, // U+00AF
+    {195, 2, 2, 4, 0, -5}, // U+00B0
+    {196, 3, 5, 4, 0, -5}, // U+00B1
+    {198, 3, 3, 4, 0, -5}, // U+00B2
+    {200, 3, 3, 4, 0, -5}, // U+00B3
+    {19, 2, 2, 3, 0, -5}, // U+00B4
+    {202, 3, 5, 4, 0, -5}, // U+00B5
+    {204, 3, 5, 4, 0, -5}, // U+00B6
+    {206, 3, 3, 4, 0, -4}, // U+00B7
+    {208, 3, 3, 4, 0, -3}, // U+00B8
+    {20, 1, 3, 2, 0, -5}, // U+00B9
+    {210, 3, 5, 4, 0, -5}, // U+00BA
+    {212, 2, 3, 3, 0, -5}, // U+00BB
+    {213, 3, 5, 4, 0, -5}, // U+00BC
+    {215, 3, 5, 4, 0, -5}, // U+00BD
+    {217, 3, 5, 4, 0, -5}, // U+00BE
+    {219, 3, 5, 4, 0, -5}, // U+00BF
+    {221, 3, 5, 4, 0, -5}, // U+00C0
+    {223, 3, 5, 4, 0, -5}, // U+00C1
+    {225, 3, 5, 4, 0, -5}, // U+00C2
+    {227, 3, 5, 4, 0, -5}, // U+00C3
+    {229, 3, 5, 4, 0, -5}, // U+00C4
+    {231, 3, 5, 4, 0, -5}, // U+00C5
+    {233, 3, 5, 4, 0, -5}, // U+00C6
+    {235, 3, 6, 4, 0, -5}, // U+00C7
+    {238, 3, 5, 4, 0, -5}, // U+00C8
+    {240, 3, 5, 4, 0, -5}, // U+00C9
+    {242, 3, 5, 4, 0, -5}, // U+00CA
+    {244, 3, 5, 4, 0, -5}, // U+00CB
+    {246, 3, 5, 4, 0, -5}, // U+00CC
+    {248, 3, 5, 4, 0, -5}, // U+00CD
+    {250, 3, 5, 4, 0, -5}, // U+00CE
+    {252, 3, 5, 4, 0, -5}, // U+00CF
+    {254, 3, 5, 4, 0, -5}, // U+00D0
+    {256, 3, 5, 4, 0, -5}, // U+00D1
+    {258, 3, 5, 4, 0, -5}, // U+00D2
+    {260, 3, 5, 4, 0, -5}, // U+00D3
+    {262, 3, 5, 4, 0, -5}, // U+00D4
+    {264, 3, 5, 4, 0, -5}, // U+00D5
+    {266, 3, 5, 4, 0, -5}, // U+00D6
+    {15, 3, 3, 4, 0, -4}, // U+00D7
+    {268, 3, 5, 4, 0, -5}, // U+00D8
+    {270, 3, 5, 4, 0, -5}, // U+00D9
+    {272, 3, 5, 4, 0, -5}, // U+00DA
+    {274, 3, 5, 4, 0, -5}, // U+00DB
+    {276, 3, 5, 4, 0, -5}, // U+00DC
+    {278, 3, 5, 4, 0, -5}, // U+00DD
+    {280, 3, 5, 4, 0, -5}, // U+00DE
+    {282, 3, 6, 4, 0, -5}, // U+00DF
+    {285, 3, 5, 4, 0, -5}, // U+00E0
+    {287, 3, 5, 4, 0, -5}, // U+00E1
+    {289, 3, 5, 4, 0, -5}, // U+00E2
+    {291, 3, 5, 4, 0, -5}, // U+00E3
+    {293, 3, 5, 4, 0, -5}, // U+00E4
+    {295, 3, 5, 4, 0, -5}, // U+00E5
+    {297, 3, 4, 4, 0, -4}, // U+00E6
+    {299, 3, 5, 4, 0, -4}, // U+00E7
+    {301, 3, 5, 4, 0, -5}, // U+00E8
+    {303, 3, 5, 4, 0, -5}, // U+00E9
+    {305, 3, 5, 4, 0, -5}, // U+00EA
+    {307, 3, 5, 4, 0, -5}, // U+00EB
+    {309, 2, 5, 3, 0, -5}, // U+00EC
+    {311, 2, 5, 3, 0, -5}, // U+00ED
+    {313, 3, 5, 4, 0, -5}, // U+00EE
+    {315, 3, 5, 4, 0, -5}, // U+00EF
+    {317, 3, 5, 4, 0, -5}, // U+00F0
+    {319, 3, 5, 4, 0, -5}, // U+00F1
+    {321, 3, 5, 4, 0, -5}, // U+00F2
+    {323, 3, 5, 4, 0, -5}, // U+00F3
+    {325, 3, 5, 4, 0, -5}, // U+00F4
+    {327, 3, 5, 4, 0, -5}, // U+00F5
+    {329, 3, 5, 4, 0, -5}, // U+00F6
+    {331, 3, 5, 4, 0, -5}, // U+00F7
+    {333, 3, 4, 4, 0, -4}, // U+00F8
+    {335, 3, 5, 4, 0, -5}, // U+00F9
+    {337, 3, 5, 4, 0, -5}, // U+00FA
+    {339, 3, 5, 4, 0, -5}, // U+00FB
+    {341, 3, 5, 4, 0, -5}, // U+00FC
+    {343, 3, 6, 4, 0, -5}, // U+00FD
+    {346, 3, 5, 4, 0, -4}, // U+00FE
+    {348, 3, 6, 4, 0, -5}, // U+00FF
+    {351, 3, 6, 4, 0, -5}, // U+0104
+    {354, 3, 5, 4, 0, -4}, // U+0105
+    {356, 3, 5, 4, 0, -5}, // U+0106
+    {358, 3, 5, 4, 0, -5}, // U+0107
+    {360, 3, 5, 4, 0, -5}, // U+010C
+    {362, 3, 5, 4, 0, -5}, // U+010D
+    {364, 3, 6, 4, 0, -5}, // U+0118
+    {367, 3, 5, 4, 0, -4}, // U+0119
+    {369, 3, 5, 4, 0, -5}, // U+011A
+    {244, 3, 5, 4, 0, -5}, // U+011B
+    {371, 3, 5, 4, 0, -5}, // U+011E
+    {373, 3, 7, 4, 0, -5}, // U+011F
+    {135, 1, 5, 2, 0, -5}, // U+0130
+    {195, 1, 4, 2, 0, -4}, // U+0131
+    {376, 3, 5, 4, 0, -5}, // U+0141
+    {378, 3, 5, 4, 0, -5}, // U+0142
+    {380, 4, 5, 5, 0, -5}, // U+0143
+    {383, 3, 5, 4, 0, -5}, // U+0144
+    {385, 4, 5, 5, 0, -5}, // U+0147
+    {388, 3, 5, 4, 0, -5}, // U+0148
+    {390, 4, 5, 5, 0, -5}, // U+0150
+    {393, 4, 5, 5, 0, -5}, // U+0151
+    {396, 3, 5, 4, 0, -5}, // U+0158
+    {398, 3, 5, 4, 0, -5}, // U+0159
+    {400, 3, 5, 4, 0, -5}, // U+015A
+    {402, 3, 5, 4, 0, -5}, // U+015B
+    {404, 3, 6, 4, 0, -5}, // U+015E
+    {4, 3, 5, 4, 0, -4}, // U+015F
+    {407, 3, 5, 4, 0, -5}, // U+0160
+    {409, 3, 5, 4, 0, -5}, // U+0161
+    {411, 3, 5, 4, 0, -5}, // U+016E
+    {413, 3, 5, 4, 0, -5}, // U+016F
+    {415, 4, 5, 5, 0, -5}, // U+0170
+    {418, 4, 5, 5, 0, -5}, // U+0171
+    {421, 3, 5, 4, 0, -5}, // U+0179
+    {423, 3, 5, 4, 0, -5}, // U+017A
+    {425, 3, 5, 4, 0, -5}, // U+017B
+    {427, 3, 5, 4, 0, -5}, // U+017C
+    {429, 3, 5, 4, 0, -5}, // U+017D
+    {431, 3, 5, 4, 0, -5}, // U+017E
+    {56, 3, 5, 4, 0, -5}, // U+0386
+    {64, 3, 5, 4, 0, -5}, // U+0388
+    {70, 3, 5, 4, 0, -5}, // U+0389
+    {72, 1, 5, 2, 0, -5}, // U+038A
+    {86, 3, 5, 4, 0, -5}, // U+038C
+    {107, 3, 5, 4, 0, -5}, // U+038E
+    {433, 5, 5, 6, 0, -5}, // U+038F
+    {56, 3, 5, 4, 0, -5}, // U+0391
+    {58, 3, 5, 4, 0, -5}, // U+0392
+    {437, 3, 5, 4, 0, -5}, // U+0393
+    {439, 3, 5, 4, 0, -5}, // U+0394
+    {64, 3, 5, 4, 0, -5}, // U+0395
+    {109, 3, 5, 4, 0, -5}, // U+0396
+    {70, 3, 5, 4, 0, -5}, // U+0397
+    {441, 3, 5, 4, 0, -5}, // U+0398
+    {72, 1, 5, 2, 0, -5}, // U+0399
+    {75, 3, 5, 4, 0, -5}, // U+039A
+    {443, 3, 5, 4, 0, -5}, // U+039B
+    {79, 5, 5, 6, 0, -5}, // U+039C
+    {83, 4, 5, 5, 0, -5}, // U+039D
+    {445, 3, 5, 4, 0, -5}, // U+039E
+    {86, 3, 5, 4, 0, -5}, // U+039F
+    {447, 3, 5, 4, 0, -5}, // U+03A0
+    {88, 3, 5, 4, 0, -5}, // U+03A1
+    {449, 3, 5, 4, 0, -5}, // U+03A3
+    {95, 3, 5, 4, 0, -5}, // U+03A4
+    {107, 3, 5, 4, 0, -5}, // U+03A5
+    {451, 3, 5, 4, 0, -5}, // U+03A6
+    {105, 3, 5, 4, 0, -5}, // U+03A7
+    {453, 3, 5, 4, 0, -5}, // U+03A8
+    {433, 5, 5, 6, 0, -5}, // U+03A9
+    {455, 4, 4, 5, 0, -4}, // U+03AC
+    {457, 3, 4, 4, 0, -4}, // U+03AD
+    {459, 3, 5, 4, 0, -4}, // U+03AE
+    {461, 2, 4, 3, 0, -4}, // U+03AF
+    {455, 4, 4, 5, 0, -4}, // U+03B1
+    {462, 3, 6, 4, 0, -5}, // U+03B2
+    {465, 3, 5, 4, 0, -4}, // U+03B3
+    {467, 3, 5, 4, 0, -5}, // U+03B4
+    {457, 3, 4, 4, 0, -4}, // U+03B5
+    {469, 3, 6, 4, 0, -5}, // U+03B6
+    {459, 3, 5, 4, 0, -4}, // U+03B7
+    {441, 3, 5, 4, 0, -5}, // U+03B8
+    {461, 2, 4, 3, 0, -4}, // U+03B9
+    {472, 3, 4, 4, 0, -4}, // U+03BA
+    {474, 3, 5, 4, 0, -5}, // U+03BB
+    {476, 3, 5, 4, 0, -4}, // U+03BC
+    {478, 3, 4, 4, 0, -4}, // U+03BD
+    {480, 3, 6, 4, 0, -5}, // U+03BE
+    {147, 3, 4, 4, 0, -4}, // U+03BF
+    {483, 3, 4, 4, 0, -4}, // U+03C0
+    {485, 3, 5, 4, 0, -4}, // U+03C1
+    {487, 3, 5, 4, 0, -4}, // U+03C2
+    {489, 4, 4, 5, 0, -4}, // U+03C3
+    {491, 3, 4, 4, 0, -4}, // U+03C4
+    {478, 3, 4, 4, 0, -4}, // U+03C5
+    {451, 3, 5, 4, 0, -5}, // U+03C6
+    {165, 3, 4, 4, 0, -4}, // U+03C7
+    {453, 3, 5, 4, 0, -4}, // U+03C8
+    {493, 5, 4, 6, 0, -4}, // U+03C9
+    {147, 3, 4, 4, 0, -4}, // U+03CC
+    {478, 3, 4, 4, 0, -4}, // U+03CD
+    {493, 5, 4, 6, 0, -4}, // U+03CE
+    {244, 3, 5, 4, 0, -5}, // U+0401
+    {496, 3, 5, 4, 0, -5}, // U+0404
+    {72, 1, 5, 2, 0, -5}, // U+0406
+    {252, 3, 5, 4, 0, -5}, // U+0407
+    {56, 3, 5, 4, 0, -5}, // U+0410
+    {498, 3, 5, 4, 0, -5}, // U+0411
+    {58, 3, 5, 4, 0, -5}, // U+0412
+    {437, 3, 5, 4, 0, -5}, // U+0413
+    {500, 3, 6, 4, 0, -5}, // U+0414
+    {64, 3, 5, 4, 0, -5}, // U+0415
+    {503, 5, 5, 6, 0, -5}, // U+0416
+    {507, 3, 5, 4, 0, -5}, // U+0417
+    {509, 4, 5, 5, 0, -5}, // U+0418
+    {512, 4, 5, 5, 0, -5}, // U+0419
+    {75, 3, 5, 4, 0, -5}, // U+041A
+    {515, 3, 5, 4, 0, -5}, // U+041B
+    {79, 5, 5, 6, 0, -5}, // U+041C
+    {70, 3, 5, 4, 0, -5}, // U+041D
+    {86, 3, 5, 4, 0, -5}, // U+041E
+    {447, 3, 5, 4, 0, -5}, // U+041F
+    {88, 3, 5, 4, 0, -5}, // U+0420
+    {60, 3, 5, 4, 0, -5}, // U+0421
+    {95, 3, 5, 4, 0, -5}, // U+0422
+    {517, 3, 5, 4, 0, -5}, // U+0423
+    {451, 3, 5, 4, 0, -5}, // U+0424
+    {105, 3, 5, 4, 0, -5}, // U+0425
+    {519, 3, 6, 4, 0, -5}, // U+0426
+    {522, 3, 5, 4, 0, -5}, // U+0427
+    {524, 5, 5, 6, 0, -5}, // U+0428
+    {528, 5, 6, 6, 0, -5}, // U+0429
+    {532, 4, 5, 5, 0, -5}, // U+042A
+    {535, 5, 5, 6, 0, -5}, // U+042B
+    {539, 3, 5, 4, 0, -5}, // U+042C
+    {541, 3, 5, 4, 0, -5}, // U+042D
+    {543, 5, 5, 6, 0, -5}, // U+042E
+    {547, 3, 5, 4, 0, -5}, // U+042F
+    {119, 3, 4, 4, 0, -4}, // U+0430
+    {549, 3, 5, 4, 0, -5}, // U+0431
+    {551, 3, 4, 4, 0, -4}, // U+0432
+    {553, 3, 4, 4, 0, -4}, // U+0433
+    {555, 3, 5, 4, 0, -4}, // U+0434
+    {127, 3, 4, 4, 0, -4}, // U+0435
+    {557, 5, 4, 6, 0, -4}, // U+0436
+    {560, 3, 4, 4, 0, -4}, // U+0437
+    {562, 4, 4, 5, 0, -4}, // U+0438
+    {512, 4, 5, 5, 0, -5}, // U+0439
+    {472, 3, 4, 4, 0, -4}, // U+043A
+    {564, 3, 4, 4, 0, -4}, // U+043B
+    {566, 5, 4, 6, 0, -4}, // U+043C
+    {569, 3, 4, 4, 0, -4}, // U+043D
+    {147, 3, 4, 4, 0, -4}, // U+043E
+    {483, 3, 4, 4, 0, -4}, // U+043F
+    {149, 3, 5, 4, 0, -4}, // U+0440
+    {123, 3, 4, 4, 0, -4}, // U+0441
+    {571, 3, 4, 4, 0, -4}, // U+0442
+    {167, 3, 5, 4, 0, -4}, // U+0443
+    {451, 3, 5, 4, 0, -5}, // U+0444
+    {165, 3, 4, 4, 0, -4}, // U+0445
+    {573, 3, 5, 4, 0, -4}, // U+0446
+    {575, 3, 4, 4, 0, -4}, // U+0447
+    {577, 5, 4, 6, 0, -4}, // U+0448
+    {580, 5, 5, 6, 0, -4}, // U+0449
+    {584, 4, 4, 5, 0, -4}, // U+044A
+    {586, 5, 4, 6, 0, -4}, // U+044B
+    {589, 3, 4, 4, 0, -4}, // U+044C
+    {591, 3, 4, 4, 0, -4}, // U+044D
+    {593, 5, 4, 6, 0, -4}, // U+044E
+    {596, 3, 4, 4, 0, -4}, // U+044F
+    {307, 3, 5, 4, 0, -5}, // U+0451
+    {457, 3, 4, 4, 0, -4}, // U+0454
+    {135, 1, 5, 2, 0, -5}, // U+0456
+    {315, 3, 5, 4, 0, -5}, // U+0457
+    {598, 3, 5, 4, 0, -5}, // U+0490
+    {598, 3, 5, 4, 0, -5}, // U+0491
+    {20, 3, 1, 4, 0, -3}, // U+2013
+    {20, 3, 1, 4, 0, -3}, // U+2014
+    {10, 1, 2, 2, 0, -5}, // U+2018
+    {10, 1, 2, 2, 0, -5}, // U+2019
+    {19, 2, 2, 3, 0, -2}, // U+201A
+    {1, 3, 2, 4, 0, -5}, // U+201C
+    {1, 3, 2, 4, 0, -5}, // U+201D
+    {19, 2, 2, 3, 0, -2}, // U+201E
+    {195, 2, 2, 3, 0, -3}, // U+2022
+    {600, 5, 1, 6, 0, -1}, // U+2026
+    {601, 3, 5, 4, 0, -5}, // U+20AC
+    {603, 5, 5, 6, 0, -5}, // U+2190
+    {607, 5, 5, 6, 0, -5}, // U+2191
+    {611, 5, 5, 6, 0, -5}, // U+2192
+    {615, 5, 5, 6, 0, -5}, // U+2193
+    {619, 5, 6, 6, 0, -5}, // U+21A7
+    {623, 5, 5, 6, 0, -5}, // U+2600
+    {627, 5, 3, 6, 0, -3}, // U+2601
+    {629, 5, 5, 6, 0, -5}, // U+2602
+    {633, 5, 5, 6, 0, -5}, // U+2605
+    {629, 5, 5, 6, 0, -5}, // U+2614
+    {637, 5, 5, 6, 0, -5}, // U+2665
+    {641, 3, 5, 4, 0, -5}, // U+266A
+    {643, 3, 5, 4, 0, -5}, // U+26A1
+    {645, 5, 4, 6, 0, -4}, // U+2713
+    {15, 3, 3, 4, 0, -4}, // U+2717
+    {648, 5, 5, 6, 0, -5}, // U+2744
+    {637, 5, 5, 6, 0, -5}, // U+2764
+    {24, 3, 5, 4, 0, -5}, // U+FFFD
+    {652, 3, 5, 4, 0, -5}, // U+1F321
+    {654, 5, 5, 6, 0, -5}, // U+1F3E0
+    {658, 3, 4, 4, 0, -4}, // U+1F4A7
+    {660, 6, 5, 7, 0, -5}, // U+1F4C1
+    {664, 4, 5, 5, 0, -5}, // U+1F4C4
+    {667, 3, 5, 4, 0, -5}, // U+1F50B
+    {669, 5, 5, 6, 0, -5}, // U+1F514
+    {673, 5, 5, 6, 0, -5}, // U+1F600
+    {673, 5, 5, 6, 0, -5}, // U+1F642
+    {677, 6, 4, 7, 0, -4}, // U+1F697
+};
+const GlyphRange PixelItGlyphFontRanges[] PROGMEM = {
+    {0x0020, 95, 0},
+    {0x00A1, 95, 95},
+    {0x0104, 4, 190},
+    {0x010C, 2, 194},
+    {0x0118, 4, 196},
+    {0x011E, 2, 200},
+    {0x0130, 2, 202},
+    {0x0141, 4, 204},
+    {0x0147, 2, 208},
+    {0x0150, 2, 210},
+    {0x0158, 4, 212},
+    {0x015E, 4, 216},
+    {0x016E, 4, 220},
+    {0x0179, 6, 224},
+    {0x0386, 1, 230},
+    {0x0388, 3, 231},
+    {0x038C, 1, 234},
+    {0x038E, 2, 235},
+    {0x0391, 17, 237},
+    {0x03A3, 7, 254},
+    {0x03AC, 4, 261},
+    {0x03B1, 25, 265},
+    {0x03CC, 3, 290},
+    {0x0401, 1, 293},
+    {0x0404, 1, 294},
+    {0x0406, 2, 295},
+    {0x0410, 64, 297},
+    {0x0451, 1, 361},
+    {0x0454, 1, 362},
+    {0x0456, 2, 363},
+    {0x0490, 2, 365},
+    {0x2013, 2, 367},
+    {0x2018, 3, 369},
+    {0x201C, 3, 372},
+    {0x2022, 1, 375},
+    {0x2026, 1, 376},
+    {0x20AC, 1, 377},
+    {0x2190, 4, 378},
+    {0x21A7, 1, 382},
+    {0x2600, 3, 383},
+    {0x2605, 1, 386},
+    {0x2614, 1, 387},
+    {0x2665, 1, 388},
+    {0x266A, 1, 389},
+    {0x26A1, 1, 390},
+    {0x2713, 1, 391},
+    {0x2717, 1, 392},
+    {0x2744, 1, 393},
+    {0x2764, 1, 394},
+    {0xFFFD, 1, 395},
+    {0x1F321, 1, 396},
+    {0x1F3E0, 1, 397},
+    {0x1F4A7, 1, 398},
+    {0x1F4C1, 1, 399},
+    {0x1F4C4, 1, 400},
+    {0x1F50B, 1, 401},
+    {0x1F514, 1, 402},
+    {0x1F600, 1, 403},
+    {0x1F642, 1, 404},
+    {0x1F697, 1, 405},
+};
+const GlyphFont PixelItGlyphFont = {PixelItGlyphFontRanges, 60, PixelItGlyphFontGlyphs, PixelItGlyphFontBitmaps};
+
+const uint8_t LargePixelsGlyphFontBitmaps[] PROGMEM = {
+    0x80, 0x74, 0x63, 0x18, 0xC6, 0x2E, 0x59, 0x24, 0x97, 0x74, 0x42, 0x22, 0x22, 0x1F, 0x74, 0x42,
+    0x60, 0x86, 0x2E, 0x19, 0x53, 0x1F, 0x84, 0x21, 0xFC, 0x21, 0xE0, 0x86, 0x2E, 0x74, 0x61, 0xE8,
+    0xC6, 0x2E, 0xF8, 0x42, 0x22, 0x21, 0x08, 0x74, 0x62, 0xE8, 0xC6, 0x2E, 0x74, 0x63, 0x17, 0x86,
+    0x2E, 0x90,
+};
+const Glyph LargePixelsGlyphFontGlyphs[] PROGMEM = {
+    {0, 0, 0, 2, 0, 0}, // U+0020
+    {0, 1, 1, 2, 0, 0}, // U+002E
+    {1, 5, 8, 6, 0, -7}, // U+0030
+    {6, 3, 8, 4, 0, -7}, // U+0031
+    {9, 5, 8, 6, 0, -7}, // U+0032
+    {14, 5, 8, 6, 0, -7}, // U+0033
+    {19, 5, 8, 6, 0, -7}, // U+0034
+    {24, 5, 8, 6, 0, -7}, // U+0035
+    {29, 5, 8, 6, 0, -7}, // U+0036
+    {34, 5, 8, 6, 0, -7}, // U+0037
+    {39, 5, 8, 6, 0, -7}, // U+0038
+    {44, 5, 8, 6, 0, -7}, // U+0039
+    {49, 1, 4, 2, 0, -5}, // U+003A
+};
+const GlyphRange LargePixelsGlyphFontRanges[] PROGMEM = {
+    {0x0020, 1, 0},
+    {0x002E, 1, 1},
+    {0x0030, 11, 2},
+};
+const GlyphFont LargePixelsGlyphFont = {LargePixelsGlyphFontRanges, 3, LargePixelsGlyphFontGlyphs, LargePixelsGlyphFontBitmaps};
+
+const uint8_t FatPixelsGlyphFontBitmaps[] PROGMEM = {
+    0x80, 0x77, 0xF7, 0xBD, 0xEF, 0xEE, 0x7F, 0xB6, 0xDB, 0x77, 0xF6, 0x77, 0x73, 0xFF, 0x77, 0xF6,
+    0x73, 0xEF, 0xEE, 0x19, 0xDF, 0xBF, 0xFC, 0x63, 0xFF, 0xF1, 0xEF, 0x8F, 0xEE, 0x77, 0xF1, 0xEF,
+    0xEF, 0xEE, 0xFF, 0xC6, 0x31, 0x8C, 0x63, 0x77, 0xF6, 0xEF, 0xEF, 0xEE, 0x77, 0xF7, 0xF7, 0x8F,
+    0xEE, 0x90,
+};
+const Glyph FatPixelsGlyphFontGlyphs[] PROGMEM = {
+    {0, 0, 0, 2, 0, 0}, // U+0020
+    {0, 1, 1, 2, 0, 0}, // U+002E
+    {1, 5, 8, 6, 0, -7}, // U+0030
+    {6, 3, 8, 4, 0, -7}, // U+0031
+    {9, 5, 8, 6, 0, -7}, // U+0032
+    {14, 5, 8, 6, 0, -7}, // U+0033
+    {19, 5, 8, 6, 0, -7}, // U+0034
+    {24, 5, 8, 6, 0, -7}, // U+0035
+    {29, 5, 8, 6, 0, -7}, // U+0036
+    {34, 5, 8, 6, 0, -7}, // U+0037
+    {39, 5, 8, 6, 0, -7}, // U+0038
+    {44, 5, 8, 6, 0, -7}, // U+0039
+    {49, 1, 4, 2, 0, -5}, // U+003A
+};
+const GlyphRange FatPixelsGlyphFontRanges[] PROGMEM = {
+    {0x0020, 1, 0},
+    {0x002E, 1, 1},
+    {0x0030, 11, 2},
+};
+const GlyphFont FatPixelsGlyphFont = {FatPixelsGlyphFontRanges, 3, FatPixelsGlyphFontGlyphs, FatPixelsGlyphFontBitmaps};
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef HEATSHRINK_H_
+#define HEATSHRINK_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Same parameters as the encoder (.github/heatshrink.py, heatshrink -w 10 -l 5)
+#define HEATSHRINK_WINDOW_BITS 10
+#define HEATSHRINK_LOOKAHEAD_BITS 5
+#define HEATSHRINK_WINDOW_LENGHT (1 << HEATSHRINK_WINDOW_BITS)
+
+// Streaming heatshrink (LZSS) decoder. Input can be split anywhere, the output goes to the
+// callback straight from the window, at least at the end of every write() and whenever the
+// window wraps. Plain code without hardware access, so it also runs on the host.
+class HeatshrinkDecoder
+{
+public:
+    HeatshrinkDecoder();
+    void reset();
+    void write(const uint8_t *data, size_t length);
+    void setCallback(void (*func)(const uint8_t *data, size_t length));
+    // Decoded bytes so far
+    size_t total() const;
+
+protected:
+    enum State
+    {
+        State_Tag,
+        State_Literal,
+        State_Offset,
+        State_Length,
+    };
+
+    uint8_t _window[HEATSHRINK_WINDOW_LENGHT];
+    uint16_t _head;    // Next byte of the window
+    uint16_t _flushed; // First byte not passed on yet
+    uint32_t _bits;
+    uint8_t _bitCount;
+    State _state;
+    uint16_t _offset;
+    size_t _total;
+    void (*callbackFunction)(const uint8_t *data, size_t length);
+
+    void put(uint8_t value);
+    void flush();
+};
+
+#endif
@@ -0,0 +1,198 @@
+#ifndef HTTPSERVER_H_
+#define HTTPSERVER_H_
+
+#include <Arduino.h>
+#include <FS.h>
+#if defined(ESP8266)
+#include <ESP8266WiFi.h>
+#elif defined(ESP32)
+#include <WiFi.h>
+#endif
+
+#define HTTPSERVER_MAX_CONNECTIONS 4
+#define HTTPSERVER_MAX_ROUTES 28
+#define HTTPSERVER_MAX_HEADERS 2
+#define HTTPSERVER_LINE_LENGHT 384 // Longer header lines are skipped, unless the server needs them
+#define HTTPSERVER_BODY_LENGHT 8192 // Largest buffered request body, uploads are streamed
+#define HTTPSERVER_CHUNK_LENGHT 512 // Upload chunk size, also the read and file write size per loop and connection
+#define HTTPSERVER_REQUEST_TIMEOUT 5000 // A started request has to be complete within this time
+#define HTTPSERVER_KEEPALIVE_TIMEOUT 10000 // Idle keep-alive connections are closed after this time
+#define HTTPSERVER_KEEPALIVE_MAX_REQUESTS 100
+
+enum HttpServerMethod
+{
+    HttpServerMethod_Any,
+    HttpServerMethod_Get,
+    HttpServerMethod_Post,
+    HttpServerMethod_Put,
+    HttpServerMethod_Delete,
+    HttpServerMethod_Options,
+    HttpServerMethod_Head,
+    HttpServerMethod_Other,
+};
+
+enum HttpServerUploadStatus
+{
+    HttpServerUpload_Start,
+    HttpServerUpload_Write,
+    HttpServerUpload_End,
+    HttpServerUpload_Aborted,
+};
+
+struct HttpServerUpload
+{
+    HttpServerUploadStatus status;
+    String name;     // Form field of the file, empty for a raw body
+    String filename; // Empty for a raw body
+    uint8_t buf[HTTPSERVER_CHUNK_LENGHT];
+    size_t currentSize;
+    size_t totalSize;
+    size_t contentLength; // Whole request body, incl. the multipart framing
+};
+
+// Event driven HTTP/1.1 server, polled from loop(). Every connection is a small state machine,
+// so a slow client never blocks the loop and every pass only reads what is already received.
+// Keep-alive and pipelined requests are supported, the number of connections is bounded.
+// Request bodies are read into one buffer (parse in place via body()) or, for routes with an
+// upload handler, streamed in chunks (multipart/form-data file part or a raw body).
+// Files are sent the same way, a chunk per loop as far as the send buffer has room.
+class HttpServer
+{
+public:
+    HttpServer(uint16_t port);
+    void begin();
+    void loop();
+    // A request is being received or a file sent
+    bool active() const;
+    void on(const String &path, HttpServerMethod method, void (*handler)());
+    void on(const String &path, HttpServerMethod method, void (*handler)(), void (*uploadHandler)());
+    void onNotFound(void (*handler)());
+    // The keys are copied, up to HTTPSERVER_MAX_HEADERS
+    void collectHeaders(const char *headerKeys[], size_t count);
+    // Request bodies come from here instead of malloc(), e.g. a reserved buffer. acquire returns
+    // room for length bytes and the terminator, nullptr rejects the request before it is read.
+    void setBodyAllocator(char *(*acquire)(size_t length), void (*release)(char *body));
+
+    // Request, valid in a handler
+    HttpServerMethod method() const;
+    const String &uri() const;
+    String arg(const String &name) const;
+    bool hasArg(const String &name) const;
+    String header(const String &name) const;
+    char *body();
+    size_t bodyLength() const;
+    HttpServerUpload &upload();
+
+    // Response
+    void sendHeader(const String &name, const String &value);
+    void send(int code);
+    void send(int code, const String &contentType, const String &content);
+    void send(int code, const String &contentType, const char *content, size_t contentLength);
+    void send_P(int code, PGM_P contentType, PGM_P content, size_t contentLength);
+    // Takes over the file and sends contentLength bytes of it from loop(), it is closed when done
+    void send(int code, const String &contentType, File &content, size_t contentLength);
+
+protected:
+    enum ConnectionState
+    {
+        ConnectionState_Idle,
+        ConnectionState_Headers,
+        ConnectionState_Body,
+        ConnectionState_Upload,
+        ConnectionState_Response,
+    };
+
+    enum PartState
+    {
+        PartState_Preamble,
+        PartState_Headers,
+        PartState_Data,
+        PartState_Delimiter,
+        PartState_Epilogue,
+    };
+
+    struct Connection
+    {
+        WiFiClient client;
+        bool open;
+        ConnectionState state;
+        unsigned long lastActivity;
+        uint8_t requests;
+        char line[HTTPSERVER_LINE_LENGHT];
+        uint16_t lineLength;
+        bool skipLine;
+        HttpServerMethod method;
+        String uri;
+        String query;
+        String headers[HTTPSERVER_MAX_HEADERS];
+        String boundary;
+        bool keepAlive;
+        bool expectContinue;
+        bool lengthKnown;
+        size_t contentLength;
+        size_t received;
+        char *body;
+        int8_t route;
+        File file;
+        size_t remaining;
+    };
+
+    struct Route
+    {
+        String path;
+        HttpServerMethod method;
+        void (*handler)();
+        void (*uploadHandler)();
+    };
+
+    WiFiServer _server;
+    Connection _connections[HTTPSERVER_MAX_CONNECTIONS];
+    Route _routes[HTTPSERVER_MAX_ROUTES];
+    uint8_t _routeCount;
+    void (*_notFoundHandler)();
+    String _headerKeys[HTTPSERVER_MAX_HEADERS];
+    size_t _headerCount;
+    char *(*_acquireBody)(size_t length);
+    void (*_releaseBody)(char *body);
+
+    Connection *_current;
+    bool _responded;
+    String _responseHeaders;
+
+    // Streamed upload, only one at a time
+    Connection *_uploadConnection;
+    HttpServerUpload _upload;
+    PartState _partState;
+    String _delimiter;
+    uint8_t _matched;
+    uint8_t _afterDelimiter[2];
+    uint8_t _afterDelimiterLength;
+    bool _partIsFile;
+
+    void accept();
+    void process(Connection &c);
+    bool processByte(Connection &c, uint8_t b);
+    bool processLine(Connection &c);
+    bool needsHeader(const Connection &c) const;
+    bool headersDone(Connection &c);
+    void dispatch(Connection &c);
+    void respond(Connection &c);
+    void finishRequest(Connection &c);
+    void reset(Connection &c);
+    void close(Connection &c);
+    void reject(Connection &c, int code);
+
+    void uploadData(const uint8_t *data, size_t length);
+    void uploadPartByte(uint8_t b);
+    void uploadPartHeader();
+    void uploadFlush();
+    void uploadEvent(HttpServerUploadStatus status);
+    void uploadAbort();
+
+    void writeHead(int code, const String &contentType, size_t contentLength);
+    static HttpServerMethod parseMethod(const char *method);
+    static const char *statusText(int code);
+    static String urlDecode(const String &text);
+};
+
+#endif
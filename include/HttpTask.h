@@ -0,0 +1,130 @@
+#ifndef HTTPTASK_H_
+#define HTTPTASK_H_
+
+#include <Arduino.h>
+
+#if defined(ESP8266)
+#include <lwip/ip_addr.h>
+struct tcp_pcb;
+struct pbuf;
+#elif defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+#define HTTPTASK_QUEUE_SIZE 4
+#define HTTPTASK_HOST_LENGHT 64
+#define HTTPTASK_PATH_LENGHT 48
+#define HTTPTASK_RESPONSE_LENGHT 512 // Body only, the headers are skipped while they arrive
+#define HTTPTASK_STATUS_LENGHT 16   // Start of the status line, "HTTP/1.1 200"
+#define HTTPTASK_DEFAULT_TIMEOUT 5000
+
+enum HttpTaskMethod
+{
+    HttpTaskMethod_Get,
+    HttpTaskMethod_Post,
+};
+
+enum HttpTaskResult
+{
+    HttpTaskResult_Ok,
+    HttpTaskResult_DnsFailed,
+    HttpTaskResult_ConnectFailed,
+    HttpTaskResult_Timeout,
+    HttpTaskResult_Aborted,
+};
+
+enum HttpTaskState
+{
+    HttpTaskState_Idle,
+    HttpTaskState_Resolving,
+    HttpTaskState_Connecting,
+    HttpTaskState_Sending,
+    HttpTaskState_Receiving,
+    HttpTaskState_Done,
+};
+
+typedef struct
+{
+    HttpTaskResult result;
+    int statusCode;    // -1 if no valid status line was received
+    const char *body;  // Null terminated, cut to HTTPTASK_RESPONSE_LENGHT
+    size_t bodyLength;
+    size_t receivedLength; // Whole body, more than bodyLength if truncated
+    bool truncated;
+} HttpTaskResponse;
+
+typedef void (*HttpTaskCallback)(const HttpTaskResponse &);
+
+typedef struct
+{
+    HttpTaskMethod method;
+    char host[HTTPTASK_HOST_LENGHT];
+    uint16_t port;
+    char path[HTTPTASK_PATH_LENGHT];
+    String body;
+    HttpTaskCallback callback;
+} HttpTaskRequest;
+
+// Outbound HTTP/1.0 requests without blocking loop().
+// Requests are queued and handled one after another. On the ESP8266 a
+// state machine on top of the raw lwIP API is driven by loop(), on the
+// ESP32 a worker task does the network part. In both cases the callback
+// is invoked from loop(), never from a network or worker context.
+class HttpTask
+{
+public:
+    HttpTask();
+    void begin(uint32_t timeout = HTTPTASK_DEFAULT_TIMEOUT);
+    void setTimeout(uint32_t timeout);
+    bool get(const char *host, uint16_t port, const char *path, HttpTaskCallback callback);
+    bool post(const char *host, uint16_t port, const char *path, const String &body, HttpTaskCallback callback);
+    void loop();
+    bool busy() const;
+
+protected:
+    HttpTaskRequest _queue[HTTPTASK_QUEUE_SIZE];
+    uint8_t _queueHead;
+    uint8_t _queueCount;
+
+    // Active request, owned by the network side until _state is HttpTaskState_Done
+    volatile HttpTaskState _state;
+    HttpTaskResult _result;
+    uint32_t _timeout;
+    unsigned long _startedAt;
+    String _request;
+    size_t _sendOffset;
+    char _response[HTTPTASK_RESPONSE_LENGHT];
+    size_t _responseLength;
+    size_t _receivedLength;
+    bool _truncated;
+    // Header parser, runs over the data as it arrives
+    char _status[HTTPTASK_STATUS_LENGHT];
+    uint8_t _statusLength;
+    uint16_t _lineLength;
+    uint16_t _lineCount;
+    bool _headerDone;
+
+    bool enqueue(HttpTaskMethod method, const char *host, uint16_t port, const char *path, const String &body, HttpTaskCallback callback);
+    void start();
+    void finish();
+    void appendResponse(const char *data, size_t length);
+
+#if defined(ESP8266)
+    ip_addr_t _address;
+    tcp_pcb *_pcb;
+    void connect();
+    void send();
+    void close();
+    static void dnsFound(const char *name, const ip_addr_t *address, void *arg);
+    static signed char tcpConnected(void *arg, tcp_pcb *pcb, signed char err);
+    static signed char tcpReceived(void *arg, tcp_pcb *pcb, pbuf *p, signed char err);
+    static void tcpError(void *arg, signed char err);
+#elif defined(ESP32)
+    TaskHandle_t _worker;
+    static void workerTask(void *arg);
+    void work();
+#endif
+};
+
+#endif
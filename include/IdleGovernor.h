@@ -0,0 +1,93 @@
+#ifndef IDLEGOVERNOR_H_
+#define IDLEGOVERNOR_H_
+
+#include <Arduino.h>
+
+#define IDLE_MAX_SLEEP 20               // ms, bounds the added latency of incoming requests
+#define IDLE_MAX_SLEEP_DISPLAY_OFF 100  // ms, with the display off
+#define IDLE_ENTER_DELAY 2000           // ms without activity before the power is lowered
+#define IDLE_STATISTICS_WINDOW 10000    // ms
+
+// Frame rate caps on battery, the render interval at or below a battery level
+#define IDLE_BATTERY_LOW 20
+#define IDLE_BATTERY_LOW_FRAME_INTERVAL 66 // 15 fps
+#define IDLE_BATTERY_MEDIUM 50
+#define IDLE_BATTERY_MEDIUM_FRAME_INTERVAL 33 // 30 fps
+
+// CPU speeds, idle only differs if the build runs faster than 80 MHz
+#ifndef IDLE_BUSY_CPU_MHZ
+#define IDLE_BUSY_CPU_MHZ (F_CPU / 1000000L)
+#endif
+#ifndef IDLE_CPU_MHZ
+#define IDLE_CPU_MHZ 80
+#endif
+
+// Rough controller currents in mA for the estimate, LEDs not included
+#if defined(ESP8266)
+#define IDLE_CURRENT_AWAKE 70
+#define IDLE_CURRENT_MODEM_SLEEP 16
+#define IDLE_CURRENT_LIGHT_SLEEP 3
+#elif defined(ESP32)
+#define IDLE_CURRENT_AWAKE 95
+#define IDLE_CURRENT_MODEM_SLEEP 30
+#define IDLE_CURRENT_LIGHT_SLEEP 3
+#endif
+
+enum IdleState
+{
+    IdleState_Busy,       // Streams or transfers, radio always on, no sleep
+    IdleState_Animating,  // Frames are rendered, sleep until the next frame
+    IdleState_Idle,       // Static screen, lower CPU speed
+    IdleState_DisplayOff, // sleepMode, light sleep if allowed
+};
+
+// Lowers the power while nothing happens. The loop reports activity and its next deadline,
+// at the end of the loop the governor sleeps until the deadline, at most IDLE_MAX_SLEEP.
+// Radio power save and CPU speed follow the state, with a delay against flapping.
+class IdleGovernor
+{
+public:
+    IdleGovernor();
+    void begin(bool enabled, bool lightSleep);
+    // Latency or throughput matters (stream, upload, wall)
+    void busy();
+    // Frames are rendered, next one at deadline (millis())
+    void animating(uint32_t deadline);
+    void setDisplayOff(bool displayOff);
+    // -1 without battery
+    void setBatteryLevel(int8_t level);
+    // Minimum ms between rendered frames, 0 = no cap
+    uint16_t frameInterval() const;
+    // End of the loop
+    void loop();
+
+    IdleState state() const;
+    // Percentage of the last window spent sleeping
+    uint8_t sleepResidency() const;
+    // Average current of the controller in the last window, mA
+    uint16_t currentEstimate() const;
+
+protected:
+    bool _enabled;
+    bool _lightSleep;
+    bool _displayOff;
+    int8_t _batteryLevel;
+    IdleState _state;
+    IdleState _applied;
+    uint32_t _busySince;
+    uint32_t _animatingSince;
+    uint32_t _deadline;
+    bool _hasDeadline;
+
+    uint32_t _windowStart;
+    uint32_t _windowSlept;
+    uint32_t _windowCharge; // mA * ms
+    uint32_t _lastLoop;
+    uint8_t _residency;
+    uint16_t _current;
+
+    void apply(IdleState state);
+    uint16_t sleepCurrent() const;
+};
+
+#endif
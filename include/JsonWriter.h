@@ -0,0 +1,83 @@
+#ifndef JSONWRITER_H_
+#define JSONWRITER_H_
+
+#include <Arduino.h>
+
+#define JSONWRITER_MAX_DEPTH 16
+#define JSONWRITER_DEFAULT_DECIMALS 2
+
+// Writes JSON straight into a caller provided buffer, nothing is allocated. Commas are added
+// as needed, strings are escaped, the text is always zero terminated. Output that does not fit
+// is cut off and overflowed() is set.
+// Headroom bytes are kept free in front of the text, e.g. for a websocket frame header, so
+// the text is sent without a copy. An envelope ({"name":...}) can be written around the
+// document, document() is the part without it (MQTT, HTTP), c_str() the whole (websocket).
+class JsonWriter
+{
+public:
+    JsonWriter(char *buffer, size_t size, size_t headroom = 0);
+    void reset();
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+    void beginEnvelope(const char *name);
+    void endEnvelope();
+    // Key of the next value or nested object/array
+    void key(const char *name);
+
+    void value(const char *value);
+    void value(const String &value);
+    void value(int value);
+    void value(unsigned int value);
+    void value(long value);
+    void value(unsigned long value);
+    // Trailing zeros are left out, NAN and infinity are written as null
+    void value(double value, uint8_t decimals = JSONWRITER_DEFAULT_DECIMALS);
+    void value(bool value);
+    void null();
+    // Already serialised JSON
+    void raw(const char *json, size_t length);
+    void raw(Stream &json, size_t length);
+    // Continues the object that was just written with raw()
+    void extend();
+
+    template <typename T>
+    void add(const char *name, T value)
+    {
+        key(name);
+        this->value(value);
+    }
+
+    const char *c_str() const;
+    size_t length() const;
+    const char *document() const;
+    size_t documentLength() const;
+    // Start of the headroom
+    char *frame();
+    bool overflowed() const;
+
+protected:
+    char *_buffer;
+    size_t _size;
+    size_t _headroom;
+    size_t _length;
+    size_t _documentStart;
+    size_t _documentEnd;
+    uint8_t _depth;
+    uint16_t _first; // Bit per depth, nothing written at this depth yet
+    bool _afterKey;
+    bool _overflowed;
+
+    void separator();
+    void write(char c);
+    void write(const char *text, size_t length);
+    void writeString(const char *text, size_t length);
+    void writeUnsigned(unsigned long value);
+    void writeSigned(long value);
+    void push(char c);
+    void pop(char c);
+};
+
+#endif
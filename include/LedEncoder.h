@@ -0,0 +1,35 @@
+#ifndef LEDENCODER_H_
+#define LEDENCODER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Bit encoding of the WS2812 (800 kHz) waveform for the background LED output.
+// Plain functions without hardware access, the output backends run them from their
+// interrupts, so they are in IRAM on the device.
+
+// RMT, 40 MHz (25 ns ticks): 0 = 400 ns high, 850 ns low; 1 = 800 ns high, 450 ns low
+#define LEDENCODER_RMT_T0H 16
+#define LEDENCODER_RMT_T0L 34
+#define LEDENCODER_RMT_T1H 32
+#define LEDENCODER_RMT_T1L 18
+
+// UART, 3.2 Mbaud 6N1 with inverted TX: one character (start, 6 data, stop bit) are 8 slots
+// of 312.5 ns and carry 2 LED bits, 0 = 1 slot high, 3 low; 1 = 3 slots high, 1 low
+// (937.5 ns high, within the 650..950 ns of a WS2812B 1 bit)
+#define LEDENCODER_UART_BAUD 3200000
+#define LEDENCODER_UART_CHARS_PER_BYTE 4
+
+#if defined(ESP8266) || defined(ESP32)
+#include <Arduino.h>
+#define LEDENCODER_ATTR IRAM_ATTR
+#else
+#define LEDENCODER_ATTR
+#endif
+
+// 8 RMT items (rmt_item32_t: duration0:15, level0:1, duration1:15, level1:1) per byte, MSB first
+void LedEncodeRmt(const uint8_t *data, size_t length, uint32_t *items);
+// 4 UART characters per byte, MSB first
+void LedEncodeUart(uint8_t value, uint8_t *chars);
+
+#endif
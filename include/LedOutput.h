@@ -0,0 +1,37 @@
+#ifndef LEDOUTPUT_H_
+#define LEDOUTPUT_H_
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include "LedEncoder.h"
+
+#define LEDOUTPUT_BUFFER_LENGHT (MATRIX_WIDTH * MATRIX_HEIGHT * 3)
+#define LEDOUTPUT_RESET_MICROS 300 // Low time that latches a frame
+#define LEDOUTPUT_RMT_CHANNEL RMT_CHANNEL_0
+#define LEDOUTPUT_UART_FIFO_LENGHT 128
+#define LEDOUTPUT_UART_FIFO_THRESHOLD 32 // Refill below this many characters
+
+// Background LED output for FastLED, enabled with build_flags = -D LED_OUTPUT_DMA.
+// show() scales leds[] into one of two byte buffers and hands it to the hardware, which sends it
+// while the next frame is rendered. Only a show() during a running transfer waits, after its
+// frame is encoded. ESP32 uses the RMT on any pin, the bits are encoded in the RMT interrupt.
+// ESP8266 uses UART1 with an interrupt refilling the FIFO: the matrix has to be on GPIO2 (D4)
+// and the shared UART interrupt is taken over, Serial stays TX only.
+class LedOutput : public CPixelLEDController<GRB>
+{
+public:
+    LedOutput();
+    virtual void init();
+    virtual void showPixels(PixelController<GRB> &pixels);
+    // A frame is being sent
+    bool busy() const;
+
+protected:
+    uint8_t _buffers[2][LEDOUTPUT_BUFFER_LENGHT];
+    uint8_t _next;
+
+    void waitDone();
+    void start(const uint8_t *data, size_t length);
+};
+
+#endif
@@ -2,8 +2,7 @@
 #define LIVEVIEW_H_
 
 #include <Arduino.h>
-#include <Adafruit_GFX.h>
-#include <FastLED_NeoMatrix.h>
+#include <FastLED.h>
 #include <CRC32.h>
 
 #define _LIVEVIEW_PREFIX "{\"liveview\":\""
@@ -16,12 +15,12 @@ class Liveview
 {
 public:
     Liveview();
-    void begin(FastLED_NeoMatrix *matrix, CRGB *leds, uint16_t interval);
+    void begin(const uint16_t *map, CRGB *leds, uint16_t interval);
     void setCallback(void (*func)(const char *, size_t));
     void loop();
 
 protected:
-    FastLED_NeoMatrix *_matrix;
+    const uint16_t *_map;
     CRGB *_leds;
     uint16_t _interval;
     unsigned long _lastUpdate;
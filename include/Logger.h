@@ -0,0 +1,115 @@
+#ifndef LOGGER_H_
+#define LOGGER_H_
+
+#include <Arduino.h>
+#include <WiFiUdp.h>
+
+enum LogLevel
+{
+    LogLevel_Debug,
+    LogLevel_Info,
+    LogLevel_Warning,
+    LogLevel_Error,
+};
+
+// Messages below this level are removed at compile time (build_flags = -D LOG_LEVEL=LogLevel_Debug),
+// callers check it before they build the message
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LogLevel_Info
+#endif
+
+#define LOG_RECORDS 16
+#define LOG_MODULE_LENGHT 24
+#define LOG_MESSAGE_LENGHT 104
+#define LOG_DELIVER_PER_LOOP 4
+
+// Fixed-size log record, the time stamp is formatted on delivery
+struct LogRecord
+{
+    uint32_t millis;
+    uint8_t level;
+    char module[LOG_MODULE_LENGHT];
+    char message[LOG_MESSAGE_LENGHT];
+};
+
+// Allocation-free logger. Writing only copies module and message into a ring of records,
+// formatting and delivery (Serial, callback, syslog) happen in loop(), a few records per call.
+// If the writer laps the delivery the oldest records are dropped and counted.
+// Until setDeferred(true) every record is delivered immediately (setup, crashes during boot).
+class Logger
+{
+public:
+    Logger();
+    void setCallback(void (*func)(const String &payload));
+    void setSyslog(const String &server, uint16_t port, const String &hostname);
+    void setDeferred(bool deferred);
+
+    inline void log(LogLevel level, const __FlashStringHelper *module, const char *message)
+    {
+        if (level < LOG_LEVEL)
+            return;
+        LogRecord &record = next(level);
+        strncpy_P(record.module, (const char *)module, LOG_MODULE_LENGHT - 1);
+        strncpy(record.message, message, LOG_MESSAGE_LENGHT - 1);
+        commit();
+    }
+    inline void log(LogLevel level, const __FlashStringHelper *module, const __FlashStringHelper *message)
+    {
+        if (level < LOG_LEVEL)
+            return;
+        LogRecord &record = next(level);
+        strncpy_P(record.module, (const char *)module, LOG_MODULE_LENGHT - 1);
+        strncpy_P(record.message, (const char *)message, LOG_MESSAGE_LENGHT - 1);
+        commit();
+    }
+    inline void log(LogLevel level, const char *module, const char *message)
+    {
+        if (level < LOG_LEVEL)
+            return;
+        LogRecord &record = next(level);
+        strncpy(record.module, module, LOG_MODULE_LENGHT - 1);
+        strncpy(record.message, message, LOG_MESSAGE_LENGHT - 1);
+        commit();
+    }
+    // printf() like, the format is in flash (PSTR) and written straight into the record
+    void logf(LogLevel level, const __FlashStringHelper *module, PGM_P format, ...);
+
+    void loop();
+    // Records still in the ring as {"log":[...]}
+    String history();
+
+protected:
+    LogRecord _records[LOG_RECORDS];
+    uint32_t _written;
+    uint32_t _delivered;
+    uint32_t _dropped;
+    bool _deferred;
+    void (*callbackFunction)(const String &payload);
+
+    WiFiUDP _udp;
+    String _syslogServer;
+    uint16_t _syslogPort;
+    String _hostname;
+
+    inline LogRecord &next(LogLevel level)
+    {
+        LogRecord &record = _records[_written % LOG_RECORDS];
+        record.millis = millis();
+        record.level = level;
+        record.module[LOG_MODULE_LENGHT - 1] = 0;
+        record.message[LOG_MESSAGE_LENGHT - 1] = 0;
+        return record;
+    }
+    inline void commit()
+    {
+        _written++;
+        if (!_deferred)
+            loop();
+    }
+    void deliver(const LogRecord &record);
+    void formatTimeStamp(const LogRecord &record, char *buffer);
+    void appendJson(String &target, const LogRecord &record, const char *timeStamp);
+    static void appendEscaped(String &target, const char *text);
+};
+
+#endif
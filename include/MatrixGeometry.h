@@ -0,0 +1,61 @@
+#ifndef MATRIXGEOMETRY_H_
+#define MATRIXGEOMETRY_H_
+
+#include <Arduino.h>
+
+// Display size in pixels, set per environment in platformio.ini
+#ifndef MATRIX_WIDTH
+#define MATRIX_WIDTH 32
+#endif
+#ifndef MATRIX_HEIGHT
+#define MATRIX_HEIGHT 8
+#endif
+
+// Size of one physical panel. Larger displays are built from chained panels,
+// e.g. two 32x8 panels for 64x8 or four for 64x16. Default is a single panel.
+#ifndef MATRIX_PANEL_WIDTH
+#define MATRIX_PANEL_WIDTH MATRIX_WIDTH
+#endif
+#ifndef MATRIX_PANEL_HEIGHT
+#define MATRIX_PANEL_HEIGHT MATRIX_HEIGHT
+#endif
+
+// Order of the chained panels (NEO_TILE_* flags of FastLED_NeoMatrix)
+#ifndef MATRIX_TILE_LAYOUT
+#define MATRIX_TILE_LAYOUT (NEO_TILE_TOP + NEO_TILE_LEFT + NEO_TILE_ROWS + NEO_TILE_PROGRESSIVE)
+#endif
+
+// Everything the renderer needs to know about the display, resolved at compile time.
+// The clock and week day layout is designed for 32x8 and placed per geometry.
+template <uint16_t Width, uint16_t Height, uint16_t PanelWidth, uint16_t PanelHeight>
+struct MatrixGeometry
+{
+    static_assert(Width >= 32 && Height >= 8, "Matrix must be at least 32x8");
+    static_assert(PanelWidth <= 255 && PanelHeight <= 255, "FastLED_NeoMatrix supports panels up to 255x255");
+    static_assert(Width % PanelWidth == 0 && Height % PanelHeight == 0, "Matrix size must be a multiple of the panel size");
+
+    static constexpr uint16_t width = Width;
+    static constexpr uint16_t height = Height;
+    static constexpr uint16_t pixels = Width * Height;
+
+    static constexpr uint8_t panelWidth = PanelWidth;
+    static constexpr uint8_t panelHeight = PanelHeight;
+    static constexpr uint8_t panelsX = Width / PanelWidth;
+    static constexpr uint8_t panelsY = Height / PanelHeight;
+
+    // Bitmaps and animation frames are icons, up to the full height square
+    static constexpr uint16_t bitmapPixels = Height * Height;
+
+    // Clock and date (32x8 layout), centered
+    static constexpr int16_t clockX = (Width - 32) / 2;
+    static constexpr int16_t clockY = (Height - 8) / 2;
+
+    // Week day bars, on the bottom row or with a gap below the clock on taller matrices
+    static constexpr int16_t weekDaySpacing = Width >= 64 ? 8 : 4;
+    static constexpr int16_t weekDayX = (Width - 7 * weekDaySpacing) / 2;
+    static constexpr int16_t weekDayY = Height >= 16 ? clockY + 9 : Height - 1;
+};
+
+typedef MatrixGeometry<MATRIX_WIDTH, MATRIX_HEIGHT, MATRIX_PANEL_WIDTH, MATRIX_PANEL_HEIGHT> Geometry;
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef MEMORYBUDGET_H_
+#define MEMORYBUDGET_H_
+
+#include <Arduino.h>
+
+#define MEMORY_SAMPLE_INTERVAL 1000 // ms
+// Pressure levels by the largest free block, allocations fail on it long before the heap is empty
+#define MEMORY_TIGHT_BLOCK 10240
+#define MEMORY_LOW_BLOCK 6144
+#define MEMORY_CRITICAL_BLOCK 3072
+#define MEMORY_HYSTERESIS 1024 // A level is left only with this much more
+// Largest inbound message (HTTP body, MQTT, websocket) per level, parsing needs about as much again
+#define MEMORY_MESSAGE_LENGHT 8192
+#define MEMORY_LOW_MESSAGE_LENGHT 2048
+#define MEMORY_CRITICAL_MESSAGE_LENGHT 512
+// Reserved at boot for inbound messages, larger ones are allocated while the memory allows it
+#if defined(ESP8266)
+#define MEMORY_MESSAGE_POOL_LENGHT 2048
+#elif defined(ESP32)
+#define MEMORY_MESSAGE_POOL_LENGHT 8192
+#endif
+
+enum MemoryLevel
+{
+    MemoryLevel_Normal,
+    MemoryLevel_Tight,    // Liveview paused
+    MemoryLevel_Low,      // Large messages rejected
+    MemoryLevel_Critical, // Log streaming dropped, only small messages
+    MemoryLevel_Count,
+};
+
+// Watches the heap and sheds optional load step by step as it gets tight. The level follows
+// the largest free block with a hysteresis, the consumers ask before they allocate.
+// Inbound messages are read into a buffer reserved at boot, before the heap is fragmented,
+// the other big consumers (liveview, animation frames, status JSON) have static buffers.
+class MemoryBudget
+{
+public:
+    MemoryBudget();
+    void begin();
+    void loop();
+    // Called on every level change
+    void setCallback(void (*func)(MemoryLevel level));
+
+    MemoryLevel level() const;
+    bool liveviewAllowed() const;
+    bool logStreamAllowed() const;
+    size_t messageLimit() const;
+    // Counts a rejection if the message is too large for the current level
+    bool acceptMessage(size_t length);
+    // Buffer for an inbound message, nullptr if it is too large for the current level
+    char *acquireMessage(size_t length);
+    void releaseMessage(char *buffer);
+
+    uint32_t freeHeap() const;
+    uint32_t freeHeapMin() const;
+    uint32_t maxBlock() const;
+    uint32_t maxBlockMin() const;
+    uint8_t fragmentation() const;
+    uint16_t rejected() const;
+    uint16_t levelChanges() const;
+    // Inbound messages that did not fit into the pool
+    uint16_t allocated() const;
+
+    static const char *levelName(MemoryLevel level);
+
+protected:
+    MemoryLevel _level;
+    unsigned long _lastSample;
+    uint32_t _freeHeap;
+    uint32_t _freeHeapMin;
+    uint32_t _maxBlock;
+    uint32_t _maxBlockMin;
+    uint8_t _fragmentation;
+
+    char *_pool;
+    bool _poolUsed;
+
+    uint16_t _rejected;
+    uint16_t _levelChanges;
+    uint16_t _allocated;
+
+    void (*callbackFunction)(MemoryLevel level);
+
+    void sample();
+    static MemoryLevel levelFor(uint32_t block);
+};
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef PLAYLIST_H_
+#define PLAYLIST_H_
+
+#include <Arduino.h>
+#include <time.h>
+
+#define PLAYLIST_MAX_ITEMS 16
+#define PLAYLIST_NAME_LENGHT 21 // 20 chars + \0, keeps "/pl_<name>.json" below the 31 char FS limit
+
+enum PlaylistCondition
+{
+    PlaylistCondition_Always,
+    PlaylistCondition_Day,
+    PlaylistCondition_Night,
+};
+
+typedef struct
+{
+    char name[PLAYLIST_NAME_LENGHT];
+    uint16_t duration; // Seconds
+    uint8_t priority;  // Higher priority items are shown first in every cycle
+    time_t expires;    // 0 = never
+    PlaylistCondition condition;
+} PlaylistItem;
+
+class Playlist
+{
+public:
+    Playlist();
+    void begin(uint32_t interruptDuration);
+    void setCallback(void (*func)(const PlaylistItem &));
+    void setConditionCallback(bool (*func)(PlaylistCondition));
+    // Called for every item removeExpired() drops, e.g. to delete its stored screen
+    void setExpiredCallback(void (*func)(const PlaylistItem &));
+    void setInterruptDuration(uint32_t interruptDuration);
+    void loop(time_t currentTime);
+
+    int set(const char *name, uint16_t duration, uint8_t priority, time_t expires, PlaylistCondition condition);
+    bool remove(const char *name);
+    void clear();
+    int find(const char *name) const;
+    bool removeExpired(time_t currentTime);
+
+    void interrupt();
+    void restart();
+
+    uint8_t count() const;
+    const PlaylistItem &item(uint8_t index) const;
+    int current() const;
+    bool isInterrupted() const;
+
+protected:
+    PlaylistItem _items[PLAYLIST_MAX_ITEMS];
+    uint8_t _count;
+    int _current;
+    unsigned long _currentSince;
+    unsigned long _interruptedSince;
+    uint32_t _interruptDuration;
+    bool _interrupted;
+
+    void (*callbackFunction)(const PlaylistItem &);
+    bool (*conditionFunction)(PlaylistCondition);
+    void (*expiredFunction)(const PlaylistItem &);
+
+    bool isEligible(uint8_t index, time_t currentTime) const;
+    int next(time_t currentTime) const;
+};
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef REALTIME_H_
+#define REALTIME_H_
+
+#include <Arduino.h>
+#include <WiFiUdp.h>
+#include <Adafruit_GFX.h>
+#include <FastLED_NeoMatrix.h>
+
+#define REALTIME_DDP_PORT 4048
+#define REALTIME_E131_PORT 5568
+#define REALTIME_PACKET_LENGHT 1460
+#define REALTIME_DEFAULT_TIMEOUT 2500
+#define REALTIME_MAX_PACKETS_PER_LOOP 8
+#define REALTIME_E131_CHANNELS_PER_UNIVERSE 510 // 170 RGB pixels
+#define REALTIME_E131_MAX_UNIVERSES 8
+
+// Realtime pixel streams (DDP and E1.31/sACN, as sent by xLights, Hyperion, WLED, ...).
+// Pixel data is copied from the packet buffer into the LED buffer, nothing is allocated per frame.
+class Realtime
+{
+public:
+    Realtime();
+    void begin(FastLED_NeoMatrix *matrix, CRGB *leds, const uint16_t *map, bool ddp, bool e131, uint16_t universe, uint32_t timeout);
+    void setCallback(void (*func)(bool));
+    void loop(bool render);
+    bool isActive() const;
+    uint32_t frames() const;
+    uint32_t dropped() const;
+
+protected:
+    FastLED_NeoMatrix *_matrix;
+    CRGB *_leds;
+    const uint16_t *_map;
+    uint32_t _pixels;
+    WiFiUDP _ddp;
+    WiFiUDP _e131;
+    bool _ddpEnabled;
+    bool _e131Enabled;
+    uint16_t _universe;
+    uint8_t _universes;
+    uint32_t _timeout;
+
+    bool _active;
+    bool _dirty;
+    unsigned long _lastPacket;
+    uint32_t _frames;
+    uint32_t _dropped;
+
+    uint8_t _ddpSequence;
+    uint8_t _e131Sequence[REALTIME_E131_MAX_UNIVERSES];
+    uint8_t _e131Seen;
+    uint16_t _e131SyncUniverse;
+
+    uint8_t _packet[REALTIME_PACKET_LENGHT];
+
+    void (*callbackFunction)(bool);
+
+    void receive(WiFiUDP &udp, bool ddp, bool render);
+    bool handleDDP(size_t length, bool render);
+    bool handleE131(size_t length, bool render);
+    void writeChannels(uint32_t channel, const uint8_t *data, uint32_t length);
+    void show();
+    void activate();
+};
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef RULES_H_
+#define RULES_H_
+
+#include <Arduino.h>
+#include "BtnEvents.h"
+
+#define RULES_MAX 16
+#define RULES_TARGET_LENGHT 24
+#define RULES_PAYLOAD_LENGHT 32
+#define RULES_BUTTONS 3
+
+// Every rule listens to exactly one source. Rules are chained per source,
+// so an event only visits the rules that are interested in it.
+enum RuleSource
+{
+    RuleSource_Button0,
+    RuleSource_Button1,
+    RuleSource_Button2,
+    RuleSource_Temperature,
+    RuleSource_Humidity,
+    RuleSource_Pressure,
+    RuleSource_Gas,
+    RuleSource_Lux,
+    RuleSource_Battery,
+    RuleSource_Time,
+    RuleSource_Count,
+};
+
+enum RuleCompare
+{
+    RuleCompare_Above,
+    RuleCompare_Below,
+};
+
+enum RuleActionType
+{
+    RuleActionType_None,
+    RuleActionType_ShowScreen,
+    RuleActionType_SetBrightness,
+    RuleActionType_SetGpio,
+    RuleActionType_PlaySound,
+    RuleActionType_Publish,
+};
+
+typedef struct
+{
+    RuleActionType type;
+    int32_t value;    // brightness, gpio value, sound file
+    int32_t param;    // gpio number, sound folder
+    uint32_t duration; // gpio reset in ms
+    char target[RULES_TARGET_LENGHT];   // screen name, topic
+    char payload[RULES_PAYLOAD_LENGHT]; // publish payload
+} RuleAction;
+
+typedef struct
+{
+    RuleSource source;
+    uint8_t buttonEvent;   // RuleSource_Button*, btnEvents
+    RuleCompare compare;   // Sensor sources
+    float threshold;
+    float hysteresis;
+    int16_t fromMinute;    // Time window in minutes of the day, -1 = always
+    int16_t toMinute;
+    RuleAction action;
+} Rule;
+
+class RuleEngine
+{
+public:
+    RuleEngine();
+    void begin();
+    void setCallback(void (*func)(const RuleAction &));
+
+    void clear();
+    int add(const Rule &rule);
+    uint8_t count() const;
+    const Rule &rule(uint8_t index) const;
+    bool hasRules(RuleSource source) const;
+    bool hasButtonRules(uint8_t button, btnEvents event) const;
+
+    void buttonEvent(uint8_t button, btnEvents event);
+    void sensorValue(RuleSource source, float value);
+    void timeTick(int16_t minuteOfDay);
+
+protected:
+    Rule _rules[RULES_MAX];
+    bool _armed[RULES_MAX];
+    int8_t _next[RULES_MAX];
+    int8_t _first[RuleSource_Count];
+    uint8_t _count;
+    int16_t _minuteOfDay;
+
+    void (*callbackFunction)(const RuleAction &);
+
+    bool inTimeWindow(const Rule &rule) const;
+    void fire(uint8_t index);
+};
+
+#endif
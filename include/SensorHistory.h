@@ -0,0 +1,96 @@
+#ifndef SENSORHISTORY_H_
+#define SENSORHISTORY_H_
+
+#include <Arduino.h>
+
+#define SENSORHISTORY_MISSING INT32_MIN
+#define SENSORHISTORY_SCALE 100 // Fixed point, two decimals
+#define SENSORHISTORY_MINUTE_INTERVAL 60000
+
+enum SensorField
+{
+    SensorField_Temperature,
+    SensorField_Humidity,
+    SensorField_Pressure,
+    SensorField_Gas,
+    SensorField_Battery,
+    SensorField_Lux,
+    SensorField_Count,
+};
+
+enum SensorResolution
+{
+    SensorResolution_Minute,
+    SensorResolution_Quarter,
+    SensorResolution_Hour,
+    SensorResolution_Count,
+};
+
+// Samples (1 h, 24 h, 3 days) and encoded bytes per resolution
+#define SENSORHISTORY_MINUTE_SAMPLES 60
+#define SENSORHISTORY_MINUTE_LENGHT 640
+#define SENSORHISTORY_QUARTER_SAMPLES 96
+#define SENSORHISTORY_QUARTER_LENGHT 960
+#define SENSORHISTORY_HOUR_SAMPLES 72
+#define SENSORHISTORY_HOUR_LENGHT 720
+#define SENSORHISTORY_MAX_SAMPLES 96
+
+// One resolution. Every sample is a byte with the fields present in it, followed by the
+// zigzag varint deltas of these fields against their previous value. base holds the values
+// in front of the oldest sample, so dropping it only has to decode one sample.
+struct SensorSeries
+{
+    uint8_t *data;
+    uint16_t size;
+    uint16_t length;
+    uint16_t maxSamples;
+    uint16_t samples;
+    int32_t base[SensorField_Count];
+    int32_t last[SensorField_Count];
+    // Running average of the next sample
+    int64_t sum[SensorField_Count];
+    uint16_t sumCount[SensorField_Count];
+    uint16_t periods; // Closed samples of the finer resolution since the last one
+    uint32_t closedMillis;
+};
+
+// Downsampled sensor readings in RAM. Readings are averaged per minute, minutes per quarter
+// hour and quarters per hour, each resolution keeps its own delta-compressed ring.
+class SensorHistory
+{
+public:
+    SensorHistory();
+    void begin();
+    void add(SensorField field, float value);
+    void loop();
+
+    uint16_t samples(SensorResolution resolution) const;
+    // Interval of a resolution in seconds
+    uint32_t interval(SensorResolution resolution) const;
+    // Age of the newest sample in ms
+    uint32_t age(SensorResolution resolution) const;
+    // Whether any stored sample of the resolution has the field
+    bool hasField(SensorResolution resolution, SensorField field) const;
+    // Decodes the newest samples of a field (oldest first) as fixed point, SENSORHISTORY_MISSING if the field was missing
+    uint16_t values(SensorResolution resolution, SensorField field, int32_t *target, uint16_t maxCount) const;
+
+    static const char *fieldName(SensorField field);
+    static int8_t fieldFromName(const char *name);
+    static const char *resolutionName(SensorResolution resolution);
+    static int8_t resolutionFromName(const char *name);
+
+protected:
+    SensorSeries _series[SensorResolution_Count];
+    uint8_t _minuteData[SENSORHISTORY_MINUTE_LENGHT];
+    uint8_t _quarterData[SENSORHISTORY_QUARTER_LENGHT];
+    uint8_t _hourData[SENSORHISTORY_HOUR_LENGHT];
+    uint8_t _fields[SensorResolution_Count]; // Fields seen since begin()
+
+    void initSeries(SensorSeries &series, uint8_t *data, uint16_t size, uint16_t maxSamples);
+    void close(uint8_t resolution);
+    void append(SensorSeries &series, uint8_t mask, const int32_t *values);
+    void dropOldest(SensorSeries &series);
+    static uint16_t decode(const uint8_t *data, int32_t *values, uint8_t &mask);
+};
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef TEXTENGINE_H_
+#define TEXTENGINE_H_
+
+#include <Arduino.h>
+#include "Blitter.h"
+
+// Glyph of a GlyphFont, the bitmap is trimmed to the pixels and packed bitwise (row by row)
+struct Glyph
+{
+    uint16_t offset;
+    uint8_t width;
+    uint8_t height;
+    uint8_t xAdvance;
+    int8_t xOffset;
+    int8_t yOffset; // From the base line
+};
+
+// Consecutive code points, sorted by first
+struct GlyphRange
+{
+    uint32_t first;
+    uint16_t count;
+    uint16_t glyph;
+};
+
+// Unicode font, generated at build time by .github/fonts.py (include/GlyphFonts.h).
+// All tables are in flash.
+struct GlyphFont
+{
+    const GlyphRange *ranges;
+    uint16_t rangeCount;
+    const Glyph *glyphs;
+    const uint8_t *bitmaps;
+};
+
+// Returns the next code point and moves text behind it, 0 at the end of the text.
+// Invalid sequences return U+FFFD and skip one byte.
+uint32_t Utf8Decode(const char *&text);
+// Copy of a UTF-8 text in the 8 bit encoding of the classic font: ASCII, Latin-1 and its
+// symbols at their glyph slots, anything else becomes '?'
+String Utf8ToAscii(const String &text);
+
+// Draws UTF-8 text with a GlyphFont. Glyph lookup is a binary search over the code point
+// ranges, characters without a glyph are drawn as U+FFFD (if the font has it).
+class TextEngine
+{
+public:
+    TextEngine();
+    void begin(Blitter *blitter);
+    void setFont(const GlyphFont *font);
+    void setColor(uint16_t color);
+    // Sum of the advances
+    uint16_t textWidth(const char *text);
+    // y is the base line, returns the x position behind the text
+    int16_t drawText(int16_t x, int16_t y, const char *text);
+    bool findGlyph(uint32_t codePoint, Glyph &glyph);
+    // Renders a glyph into rows of bits (bit 7 = left column), the last row is the base line.
+    // Returns the advance, 0 if the font has no glyph.
+    uint8_t rasterize(uint32_t codePoint, uint8_t *rows, uint8_t rowCount);
+
+protected:
+    Blitter *_blitter;
+    const GlyphFont *_font;
+    uint16_t _range; // Range of the last glyph found
+    CRGB _color;
+
+    bool lookup(uint32_t codePoint, Glyph &glyph);
+    void drawGlyph(int16_t x, int16_t y, const Glyph &glyph);
+};
+
+#endif
@@ -1,482 +0,0 @@
-#include <ArduinoJson.h>
-
-void BuildUpdateScreenJSON(JsonObject &root)
-{
-
-    JsonObject &text = root.createNestedObject("text");
-    text["textString"] = "New FW available";
-    text["hexColor"] = "#FFFFFF";
-    text["scrollText"] = true;
-
-    JsonObject &text_position = text.createNestedObject("position");
-    text_position["x"] = 7;
-    text_position["y"] = 1;
-
-    JsonObject &bitmapAnimation = root.createNestedObject("bitmapAnimation");
-    bitmapAnimation["animationDelay"] = 400;
-    bitmapAnimation["limitLoops"] = 0;
-
-    JsonArray &bitmapAnimation_data = bitmapAnimation.createNestedArray("data");
-
-    JsonArray &bitmapAnimation_data_0 = bitmapAnimation_data.createNestedArray();
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(63488);
-    bitmapAnimation_data_0.add(63488);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-    bitmapAnimation_data_0.add(0);
-
-    JsonArray &bitmapAnimation_data_1 = bitmapAnimation_data.createNestedArray();
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(65472);
-    bitmapAnimation_data_1.add(65472);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(64896);
-    bitmapAnimation_data_1.add(64896);
-    bitmapAnimation_data_1.add(64896);
-    bitmapAnimation_data_1.add(64896);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(0);
-    bitmapAnimation_data_1.add(63488);
-    bitmapAnimation_data_1.add(63488);
-    bitmapAnimation_data_1.add(63488);
-    bitmapAnimation_data_1.add(63488);
-    bitmapAnimation_data_1.add(63488);
-    bitmapAnimation_data_1.add(63488);
-    bitmapAnimation_data_1.add(0);
-
-    JsonArray &bitmapAnimation_data_2 = bitmapAnimation_data.createNestedArray();
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(2013);
-    bitmapAnimation_data_2.add(2013);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(1986);
-    bitmapAnimation_data_2.add(1986);
-    bitmapAnimation_data_2.add(1986);
-    bitmapAnimation_data_2.add(1986);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(65472);
-    bitmapAnimation_data_2.add(65472);
-    bitmapAnimation_data_2.add(65472);
-    bitmapAnimation_data_2.add(65472);
-    bitmapAnimation_data_2.add(65472);
-    bitmapAnimation_data_2.add(65472);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(64896);
-    bitmapAnimation_data_2.add(64896);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(63488);
-    bitmapAnimation_data_2.add(63488);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-    bitmapAnimation_data_2.add(0);
-
-    JsonArray &bitmapAnimation_data_3 = bitmapAnimation_data.createNestedArray();
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(43039);
-    bitmapAnimation_data_3.add(43039);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(383);
-    bitmapAnimation_data_3.add(383);
-    bitmapAnimation_data_3.add(383);
-    bitmapAnimation_data_3.add(383);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(2013);
-    bitmapAnimation_data_3.add(2013);
-    bitmapAnimation_data_3.add(2013);
-    bitmapAnimation_data_3.add(2013);
-    bitmapAnimation_data_3.add(2013);
-    bitmapAnimation_data_3.add(2013);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(1986);
-    bitmapAnimation_data_3.add(1986);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(65472);
-    bitmapAnimation_data_3.add(65472);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(64896);
-    bitmapAnimation_data_3.add(64896);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(63488);
-    bitmapAnimation_data_3.add(63488);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-    bitmapAnimation_data_3.add(0);
-
-    JsonArray &bitmapAnimation_data_4 = bitmapAnimation_data.createNestedArray();
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(63517);
-    bitmapAnimation_data_4.add(63517);
-    bitmapAnimation_data_4.add(63517);
-    bitmapAnimation_data_4.add(63517);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(43039);
-    bitmapAnimation_data_4.add(43039);
-    bitmapAnimation_data_4.add(43039);
-    bitmapAnimation_data_4.add(43039);
-    bitmapAnimation_data_4.add(43039);
-    bitmapAnimation_data_4.add(43039);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(383);
-    bitmapAnimation_data_4.add(383);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(2013);
-    bitmapAnimation_data_4.add(2013);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(1986);
-    bitmapAnimation_data_4.add(1986);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(65472);
-    bitmapAnimation_data_4.add(65472);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-    bitmapAnimation_data_4.add(0);
-
-    JsonArray &bitmapAnimation_data_5 = bitmapAnimation_data.createNestedArray();
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(63517);
-    bitmapAnimation_data_5.add(63517);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(43039);
-    bitmapAnimation_data_5.add(43039);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(383);
-    bitmapAnimation_data_5.add(383);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(2013);
-    bitmapAnimation_data_5.add(2013);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-    bitmapAnimation_data_5.add(0);
-
-    JsonArray &bitmapAnimation_data_6 = bitmapAnimation_data.createNestedArray();
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(63517);
-    bitmapAnimation_data_6.add(63517);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(43039);
-    bitmapAnimation_data_6.add(43039);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-    bitmapAnimation_data_6.add(0);
-}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#ifndef WALL_H_
+#define WALL_H_
+
+#include <Arduino.h>
+#include <WiFiUdp.h>
+
+#define WALL_PORT 4210
+#define WALL_MULTICAST_ADDRESS 239, 255, 80, 73
+#define WALL_SYNC_INTERVAL 500
+#define WALL_CONTENT_INTERVAL 2000
+#define WALL_SYNC_WINDOW 8
+#define WALL_SLEW_INTERVAL 50 // The wall time is corrected by 1 ms per interval
+#define WALL_STEP_LIMIT 250   // Larger errors (leader restarted) are corrected at once
+#define WALL_START_DELAY 300
+#define WALL_HEADER_LENGHT 18
+#define WALL_CONTENT_LENGHT 512
+
+enum WallRole
+{
+    WallRole_Off,
+    WallRole_Leader,
+    WallRole_Member,
+};
+
+// Video wall over UDP multicast. The leader (a PixelIt or any host tool) sends:
+//   "PXW" 0x01 'S' <group> <leader ms BE32>                                                 clock sync
+//   "PXW" 0x01 'C' <group> <leader ms BE32> <id BE16> <start ms BE32> <len BE16> <json>     wall screen
+// Members follow the leader clock, so every panel derives the same frame from the same wall time.
+// Small corrections are slewed, the wall time of a member never jumps or runs backwards.
+class Wall
+{
+public:
+    Wall();
+    void begin(WallRole role, uint8_t group);
+    void setCallback(void (*func)(const char *, uint32_t));
+    void loop();
+    bool publish(const char *content);
+    uint32_t time() const;
+    bool isSynced() const;
+    int32_t offset() const;
+    WallRole role() const;
+
+protected:
+    WiFiUDP _udp;
+    IPAddress _address;
+    WallRole _role;
+    uint8_t _group;
+
+    bool _synced;
+    int32_t _offset;
+    int32_t _targetOffset;
+    unsigned long _lastSlew;
+    int32_t _windowMax;
+    uint8_t _windowSamples;
+    unsigned long _lastSync;
+    unsigned long _lastContent;
+
+    uint16_t _contentId;
+    uint32_t _contentStart;
+    uint16_t _contentLength;
+    uint8_t _packet[WALL_HEADER_LENGHT + WALL_CONTENT_LENGHT];
+
+    void (*callbackFunction)(const char *, uint32_t);
+
+    void bind();
+    void send(bool content);
+    void receive();
+    void slew();
+    void sample(uint32_t leaderTime);
+};
+
+#endif
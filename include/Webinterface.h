@@ -1,2 +1,24 @@
 // Will be replaced via .github/webui.py script during build pipeline
-const char mainPage[] PROGMEM = R"=====(<!DOCTYPE html><html lang="en"><head><meta charset="utf-8"><meta http-equiv="X-UA-Compatible" content="IE=edge"><meta name="viewport" content="width=device-width,initial-scale=1,shrink-to-fit=no"><meta name="apple-mobile-web-app-capable" content="yes"><meta name="mobile-web-app-capable" content="yes"><link rel="icon" href="https://pixelit-project.github.io/PixelIt/webui/favicon.ico"><title>PixelIt WebUI</title><link rel="stylesheet" href="https://fonts.googleapis.com/css?family=Roboto:100,300,400,500,700,900"><link rel="stylesheet" href="https://cdn.jsdelivr.net/npm/@mdi/font@latest/css/materialdesignicons.min.css"><link href="https://pixelit-project.github.io/PixelIt/webui/css/app.06728995.css" rel="preload" as="style"><link href="https://pixelit-project.github.io/PixelIt/webui/css/chunk-vendors.d0ec1288.css" rel="preload" as="style"><link href="https://pixelit-project.github.io/PixelIt/webui/js/app.70de4aeb.js" rel="preload" as="script"><link href="https://pixelit-project.github.io/PixelIt/webui/js/chunk-vendors.e308edae.js" rel="preload" as="script"><link href="https://pixelit-project.github.io/PixelIt/webui/css/chunk-vendors.d0ec1288.css" rel="stylesheet"><link href="https://pixelit-project.github.io/PixelIt/webui/css/app.06728995.css" rel="stylesheet"></head><body><noscript><strong>We're sorry but Pixel It the Matrix Display doesn't work properly without JavaScript enabled. Please enable it to continue.</strong></noscript><div id="app"></div><script src="https://pixelit-project.github.io/PixelIt/webui/js/chunk-vendors.e308edae.js"></script><script src="https://pixelit-project.github.io/PixelIt/webui/js/app.70de4aeb.js"></script></body></html>)=====";
\ No newline at end of file
+#define MAINPAGE_ETAG "\"907c0735c14e5b7c\""
+#define MAINPAGE_LENGHT 605
+const uint8_t mainPage[] PROGMEM = {
+    0x1F, 0x8B, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xB5, 0x55, 0x4D, 0x53, 0xDC, 0x30, 0x0C, 0xFD, 0x2B, 0x6E, 0x2E, 0x5C, 0x48, 0x1C, 0xBE, 0xCA, 0xC2, 0x24, 0x5B, 0x3A, 0xC0, 0x81,
+    0xCE, 0x74, 0x60, 0xDA, 0x32, 0xB4, 0x47, 0x27, 0xD6, 0x26, 0x02, 0xC7, 0x4E, 0x6D, 0x6D, 0x96, 0xFC, 0xFB, 0x2A, 0xC9, 0xD2, 0xEE, 0x32, 0x3D, 0x30, 0xA5, 0x1C, 0xE4, 0x44, 0xB6, 0xF5, 0xDE,
+    0x93, 0x22, 0x3B, 0xD9, 0xBB, 0x8B, 0xEB, 0xF3, 0x6F, 0x3F, 0x6E, 0x2E, 0x45, 0x4D, 0x8D, 0x99, 0x67, 0xC3, 0x28, 0x8C, 0xB2, 0x55, 0x1E, 0x81, 0x8D, 0xD8, 0x07, 0xA5, 0xE7, 0x59, 0x03, 0xA4,
+    0x44, 0x59, 0x2B, 0x1F, 0x80, 0xF2, 0x68, 0x49, 0x8B, 0x78, 0x16, 0xAD, 0x67, 0x6B, 0xA2, 0x36, 0x86, 0x9F, 0x4B, 0xEC, 0xF2, 0xE8, 0x7B, 0x7C, 0xFB, 0x31, 0x3E, 0x77, 0x4D, 0xAB, 0x08, 0x0B,
+    0x03, 0x91, 0x28, 0x9D, 0x25, 0xB0, 0x1C, 0x72, 0x75, 0x99, 0x83, 0xAE, 0xE0, 0x29, 0xC8, 0xAA, 0x06, 0xF2, 0xA8, 0x43, 0x58, 0xB5, 0xCE, 0xD3, 0xC6, 0xBE, 0x15, 0x6A, 0xAA, 0x73, 0x0D, 0x1D,
+    0x96, 0x10, 0x8F, 0xCE, 0x2E, 0x5A, 0x24, 0x54, 0x26, 0x0E, 0xA5, 0x32, 0x90, 0xEF, 0xED, 0x86, 0xDA, 0xA3, 0x7D, 0x88, 0xC9, 0xC5, 0x0B, 0xA4, 0xDC, 0xBA, 0x6D, 0x4C, 0xD5, 0xB6, 0x06, 0xE2,
+    0xC6, 0x15, 0xC8, 0x8F, 0x15, 0x14, 0x31, 0x4F, 0xC4, 0xA5, 0x6A, 0xD5, 0xB6, 0x9E, 0x1E, 0xC2, 0x76, 0xDC, 0x0B, 0x23, 0x0C, 0x53, 0x0B, 0x0F, 0x26, 0x8F, 0x90, 0x57, 0x22, 0x51, 0x7B, 0x58,
+    0xE4, 0xD1, 0x50, 0x83, 0x70, 0x2A, 0x65, 0x8B, 0x8F, 0x60, 0x90, 0xE2, 0xD6, 0xBB, 0x7B, 0x28, 0x29, 0xA9, 0x90, 0xEA, 0x65, 0x91, 0xA0, 0x93, 0x37, 0xC3, 0xCA, 0x15, 0x49, 0xC6, 0x5F, 0xA2,
+    0x5C, 0xA8, 0x6E, 0x08, 0x4F, 0x78, 0x60, 0x4C, 0x42, 0x32, 0x30, 0x5F, 0xEF, 0x10, 0x77, 0x50, 0xDC, 0x5E, 0x65, 0x72, 0x9A, 0xDC, 0xE0, 0x0B, 0xD4, 0x1B, 0x08, 0x35, 0x00, 0x3D, 0x67, 0x5D,
+    0xB0, 0xC4, 0x90, 0x54, 0xCE, 0x55, 0x06, 0x54, 0x8B, 0x21, 0x29, 0x5D, 0x23, 0xCB, 0x10, 0x3E, 0x2C, 0x54, 0x83, 0xA6, 0xCF, 0xBF, 0xB8, 0xC2, 0x91, 0x3B, 0xDD, 0x4B, 0xD3, 0xDD, 0x03, 0xB6,
+    0x43, 0xB6, 0x23, 0xB6, 0x63, 0xB6, 0x93, 0x34, 0x8D, 0x5E, 0x46, 0x52, 0x6A, 0x9B, 0xDC, 0x07, 0xCD, 0xE9, 0x75, 0x3E, 0xB1, 0x40, 0xD2, 0xB6, 0x8D, 0x3C, 0x6B, 0x34, 0x8E, 0xF4, 0x67, 0x46,
+    0x11, 0x04, 0x1A, 0x58, 0x65, 0xC3, 0xAF, 0x9E, 0x3F, 0x98, 0x86, 0x80, 0x95, 0x1D, 0xF2, 0x0C, 0x49, 0x83, 0x36, 0xE1, 0xB5, 0x27, 0xAE, 0x7F, 0xAB, 0xDA, 0x00, 0xCE, 0xDF, 0x26, 0x49, 0xDF,
+    0x1F, 0xEF, 0xCF, 0x4E, 0x4E, 0x8E, 0x46, 0xC4, 0x49, 0x77, 0xCB, 0xA3, 0x53, 0x3A, 0x12, 0x2A, 0xAC, 0x93, 0x78, 0x3D, 0x55, 0x59, 0x2F, 0xB9, 0xCD, 0x3A, 0xB0, 0xDA, 0xF9, 0x90, 0xE8, 0x14,
+    0xCA, 0xBD, 0xFD, 0xD9, 0xEC, 0x0D, 0x49, 0xEF, 0xA7, 0xF4, 0x8E, 0x53, 0x0D, 0x87, 0x0A, 0x0A, 0x2E, 0xF7, 0x5F, 0x89, 0x4A, 0x8F, 0x2D, 0xBD, 0x9A, 0x69, 0x3B, 0x3B, 0x38, 0x48, 0x67, 0xA0,
+    0x15, 0xBC, 0x21, 0xE7, 0x8B, 0x4A, 0xBA, 0xD1, 0x7F, 0x6F, 0xD5, 0x2A, 0x5B, 0x14, 0x72, 0xBA, 0xDE, 0x0A, 0xA7, 0xFB, 0x79, 0x66, 0xDD, 0x94, 0xE7, 0x3C, 0x0B, 0xE4, 0x9D, 0xAD, 0xE6, 0x77,
+    0xB0, 0xE3, 0x41, 0x04, 0xE7, 0x7D, 0x2F, 0x8A, 0x25, 0x89, 0x91, 0x43, 0xF0, 0x19, 0xA5, 0x1A, 0xC4, 0x67, 0x45, 0x1E, 0x1F, 0xC5, 0x05, 0x86, 0xD6, 0xA8, 0x5E, 0x68, 0x07, 0xC1, 0xEE, 0x90,
+    0x58, 0x39, 0xFF, 0x20, 0x58, 0x5E, 0x0B, 0xDE, 0xF4, 0x62, 0xC5, 0xFA, 0x1C, 0x47, 0x7E, 0x52, 0x9D, 0xFA, 0x3A, 0x82, 0x0B, 0xB0, 0xC3, 0xC5, 0xA2, 0x13, 0x71, 0xC3, 0xA7, 0x35, 0xC0, 0xDA,
+    0x17, 0xC8, 0xA8, 0x6E, 0xBC, 0x6D, 0xD0, 0x2E, 0x21, 0xC9, 0xE4, 0x5A, 0x43, 0x26, 0xFF, 0xC8, 0xD2, 0xD8, 0x09, 0xD4, 0xE3, 0x1D, 0x37, 0x68, 0x67, 0x97, 0xA5, 0x4E, 0xA8, 0xC1, 0x97, 0xFF,
+    0xB9, 0x0D, 0x98, 0xE0, 0x77, 0x39, 0x5E, 0xC7, 0xF1, 0xBC, 0xA9, 0x37, 0x90, 0xE5, 0x54, 0x79, 0x39, 0xFE, 0x7B, 0x7E, 0x01, 0x3A, 0x12, 0x30, 0xE5, 0x8B, 0x06, 0x00, 0x00,
+};
@@ -0,0 +1,27 @@
+#include "Asset.h"
+
+AssetFrame AssetGetFrame(const Asset &asset, uint8_t frame)
+{
+    AssetFrame result;
+    memcpy_P(&result, &asset.frames[frame], sizeof(AssetFrame));
+    return result;
+}
+
+uint16_t AssetFrameDelay(const Asset &asset, uint8_t frame)
+{
+    return AssetGetFrame(asset, frame).delay;
+}
+
+void AssetApplyFrame(const Asset &asset, uint8_t frame, uint16_t *bitmap)
+{
+    AssetFrame f = AssetGetFrame(asset, frame);
+    const uint16_t *pixels = asset.pixels + f.offset;
+    for (uint8_t y = 0; y < f.height; y++)
+    {
+        uint16_t *row = bitmap + (f.y + y) * asset.width + f.x;
+        for (uint8_t x = 0; x < f.width; x++)
+        {
+            row[x] = pgm_read_word(pixels++);
+        }
+    }
+}
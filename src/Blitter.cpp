@@ -0,0 +1,119 @@
+#include "Blitter.h"
+#include <Arduino.h>
+
+Blitter::Blitter()
+{
+}
+
+void Blitter::begin(FastLED_NeoMatrix *matrix, CRGB *leds)
+{
+    _leds = leds;
+
+    for (uint16_t y = 0; y < Geometry::height; y++)
+    {
+        for (uint16_t x = 0; x < Geometry::width; x++)
+        {
+            _map[y * Geometry::width + x] = matrix->XY(x, y);
+        }
+    }
+
+    // Sample the color expansion of the matrix on the first pixel, one channel at a time
+    CRGB &probe = _leds[_map[0]];
+    CRGB saved = probe;
+    for (uint8_t i = 0; i < 64; i++)
+    {
+        if (i < 32)
+        {
+            matrix->drawPixel(0, 0, (uint16_t)(i << 11));
+            _red[i] = probe.r;
+            matrix->drawPixel(0, 0, (uint16_t)i);
+            _blue[i] = probe.b;
+        }
+        matrix->drawPixel(0, 0, (uint16_t)(i << 5));
+        _green[i] = probe.g;
+    }
+    probe = saved;
+}
+
+void Blitter::drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+    if (x < 0 || y < 0 || x >= Geometry::width || y >= Geometry::height)
+    {
+        return;
+    }
+    _leds[index(x, y)] = this->color(color);
+}
+
+void Blitter::drawRow(int16_t x, int16_t y, const uint16_t *data, int16_t w)
+{
+    if (y < 0 || y >= Geometry::height)
+    {
+        return;
+    }
+
+    // Clip once per row, the loop itself has no checks
+    int16_t start = x < 0 ? -x : 0;
+    int16_t end = x + w > Geometry::width ? Geometry::width - x : w;
+    // Through locals: the byte stores into leds[] may alias the members, the compiler
+    // would reload _leds and the tables for every pixel. Two pixels per pass.
+    const uint16_t *map = _map + y * Geometry::width + x;
+    CRGB *leds = _leds;
+    const uint8_t *red = _red;
+    const uint8_t *green = _green;
+    const uint8_t *blue = _blue;
+    int16_t i = start;
+    for (; i + 1 < end; i += 2)
+    {
+        uint16_t c = data[i];
+        uint16_t d = data[i + 1];
+        CRGB &led = leds[map[i]];
+        CRGB &next = leds[map[i + 1]];
+        led.r = red[c >> 11];
+        led.g = green[(c >> 5) & 0x3F];
+        led.b = blue[c & 0x1F];
+        next.r = red[d >> 11];
+        next.g = green[(d >> 5) & 0x3F];
+        next.b = blue[d & 0x1F];
+    }
+    if (i < end)
+    {
+        uint16_t c = data[i];
+        CRGB &led = leds[map[i]];
+        led.r = red[c >> 11];
+        led.g = green[(c >> 5) & 0x3F];
+        led.b = blue[c & 0x1F];
+    }
+}
+
+void Blitter::drawBitmap(int16_t x, int16_t y, const uint16_t *bitmap, int16_t w, int16_t h)
+{
+    for (int16_t j = 0; j < h; j++)
+    {
+        drawRow(x, y + j, bitmap + j * w, w);
+    }
+}
+
+void Blitter::drawAsset(int16_t x, int16_t y, const Asset &asset, uint8_t frame)
+{
+    AssetFrame f = AssetGetFrame(asset, frame);
+    const uint16_t *pixels = asset.pixels + f.offset;
+    uint16_t row[255];
+    for (uint8_t j = 0; j < f.height; j++)
+    {
+        for (uint8_t i = 0; i < f.width; i++)
+        {
+            row[i] = pgm_read_word(pixels++);
+        }
+        drawRow(x + f.x, y + f.y + j, row, f.width);
+    }
+}
+
+const uint16_t *Blitter::map() const
+{
+    return _map;
+}
+
+CRGB *Blitter::leds() const
+{
+    return _leds;
+}
@@ -0,0 +1,225 @@
+#include "Buttons.h"
+#include <Arduino.h>
+
+Buttons *Buttons::_instance = nullptr;
+
+Buttons::Buttons()
+{
+}
+
+void Buttons::begin(const uint8_t *pins, const int *pressedLevels, const bool *enabled)
+{
+    _instance = this;
+    _queueHead = 0;
+    _queueTail = 0;
+    _queueOverflow = false;
+    callbackFunction = nullptr;
+
+    void (*isrs[BUTTONS_COUNT])() = {isr0, isr1, isr2};
+    uint32_t now = millis();
+
+    for (uint8_t button = 0; button < BUTTONS_COUNT; button++)
+    {
+        _pins[button] = pins[button];
+        _pressedLevels[button] = pressedLevels[button];
+        _enabled[button] = enabled[button];
+        _doublePressEnabled[button] = false;
+        _polled[button] = false;
+        _clicks[button] = 0;
+        _longFired[button] = false;
+
+        if (!_enabled[button])
+        {
+            continue;
+        }
+
+        _rawLevel[button] = digitalRead(_pins[button]);
+        _rawSince[button] = now;
+        _pressed[button] = _rawLevel[button] == _pressedLevels[button];
+
+        // Some pins (e.g. GPIO16 on the ESP8266) can not raise interrupts, these are polled in loop()
+        int interrupt = digitalPinToInterrupt(_pins[button]);
+        if (interrupt < 0)
+        {
+            _polled[button] = true;
+        }
+        else
+        {
+            attachInterrupt(interrupt, isrs[button], CHANGE);
+        }
+    }
+}
+
+void Buttons::setCallback(void (*func)(uint8_t, btnEvents))
+{
+    callbackFunction = func;
+}
+
+void Buttons::setDoublePressEnabled(uint8_t button, bool enabled)
+{
+    _doublePressEnabled[button] = enabled;
+}
+
+void Buttons::loop()
+{
+    uint32_t now = millis();
+
+    // Drain the edges recorded by the ISRs
+    while (_queueTail != _queueHead)
+    {
+        uint8_t button = _queue[_queueTail].button;
+        uint8_t level = _queue[_queueTail].level;
+        uint32_t timestamp = _queue[_queueTail].millis;
+        _queueTail = (_queueTail + 1) & (BUTTONS_QUEUE_SIZE - 1);
+
+        if (level != _rawLevel[button])
+        {
+            _rawLevel[button] = level;
+            _rawSince[button] = timestamp;
+        }
+    }
+
+    bool resync = _queueOverflow;
+    _queueOverflow = false;
+
+    for (uint8_t button = 0; button < BUTTONS_COUNT; button++)
+    {
+        if (!_enabled[button])
+        {
+            continue;
+        }
+
+        // Lost edges (queue overflow) and pins without interrupt are read directly
+        if (_polled[button] || resync)
+        {
+            uint8_t level = digitalRead(_pins[button]);
+            if (level != _rawLevel[button])
+            {
+                _rawLevel[button] = level;
+                _rawSince[button] = now;
+            }
+        }
+
+        debounce(button, now);
+        gestures(button, now);
+    }
+}
+
+void IRAM_ATTR Buttons::edge(uint8_t button, uint8_t level, uint32_t timestamp)
+{
+    uint8_t next = (_queueHead + 1) & (BUTTONS_QUEUE_SIZE - 1);
+    if (next == _queueTail)
+    {
+        _queueOverflow = true;
+        return;
+    }
+
+    _queue[_queueHead].button = button;
+    _queue[_queueHead].level = level;
+    _queue[_queueHead].millis = timestamp;
+    _queueHead = next;
+}
+
+void IRAM_ATTR Buttons::isr0()
+{
+    _instance->handleInterrupt(0);
+}
+
+void IRAM_ATTR Buttons::isr1()
+{
+    _instance->handleInterrupt(1);
+}
+
+void IRAM_ATTR Buttons::isr2()
+{
+    _instance->handleInterrupt(2);
+}
+
+void IRAM_ATTR Buttons::handleInterrupt(uint8_t button)
+{
+    edge(button, digitalRead(_pins[button]), millis());
+}
+
+void Buttons::debounce(uint8_t button, uint32_t now)
+{
+    // The level has to be stable for BUTTONS_DEBOUNCE_MS, every bounce restarts the wait
+    bool rawPressed = _rawLevel[button] == _pressedLevels[button];
+    if (rawPressed != _pressed[button] && (now - _rawSince[button]) >= BUTTONS_DEBOUNCE_MS)
+    {
+        _pressed[button] = rawPressed;
+        stableChanged(button, rawPressed, now);
+    }
+}
+
+void Buttons::stableChanged(uint8_t button, bool pressed, uint32_t now)
+{
+    if (pressed)
+    {
+        _pressedSince[button] = now;
+        _longFired[button] = false;
+        emit(button, btnEvent_Pressed);
+        return;
+    }
+
+    emit(button, btnEvent_Released);
+
+    if (_longFired[button])
+    {
+        _clicks[button] = 0;
+        return;
+    }
+
+    _clicks[button]++;
+    if (_clicks[button] >= 2)
+    {
+        _clicks[button] = 0;
+        emit(button, btnEvent_Double);
+    }
+    else if (!_doublePressEnabled[button])
+    {
+        // Nobody waits for a double press, no need to delay the short press
+        _clicks[button] = 0;
+        emit(button, btnEvent_Short);
+    }
+    else
+    {
+        _releasedSince[button] = now;
+    }
+}
+
+void Buttons::gestures(uint8_t button, uint32_t now)
+{
+    if (_pressed[button])
+    {
+        if (!_longFired[button] && (now - _pressedSince[button]) >= BUTTONS_LONGPRESS_MS)
+        {
+            // A pending click is not part of this long press
+            if (_clicks[button] > 0)
+            {
+                _clicks[button] = 0;
+                emit(button, btnEvent_Short);
+            }
+            _longFired[button] = true;
+            _lastRepeat[button] = now;
+            emit(button, btnEvent_Long);
+        }
+        else if (_longFired[button] && (now - _lastRepeat[button]) >= BUTTONS_REPEAT_MS)
+        {
+            _lastRepeat[button] = now;
+            emit(button, btnEvent_Repeat);
+        }
+    }
+    else if (_clicks[button] == 1 && (now - _releasedSince[button]) >= BUTTONS_DOUBLEPRESS_MS)
+    {
+        _clicks[button] = 0;
+        emit(button, btnEvent_Short);
+    }
+}
+
+void Buttons::emit(uint8_t button, btnEvents event)
+{
+    if (callbackFunction != nullptr)
+    {
+        callbackFunction(button, event);
+    }
+}
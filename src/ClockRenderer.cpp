@@ -0,0 +1,294 @@
+#include "ClockRenderer.h"
+
+ClockRenderer::ClockRenderer()
+{
+}
+
+void ClockRenderer::begin(Blitter *blitter, TextEngine *textEngine)
+{
+    _blitter = blitter;
+    _textEngine = textEngine;
+    _font = NULL;
+    _color = 0;
+    _rgb = blitter->color(0);
+    _rollDigits = false;
+    _valid = false;
+    _sliding = false;
+    _rolling = 0;
+}
+
+void ClockRenderer::setFont(const GlyphFont *font)
+{
+    if (font == _font)
+    {
+        return;
+    }
+    _font = font;
+    _valid = false;
+
+    // Rasterise the clock characters once
+    _textEngine->setFont(font);
+    uint8_t top = 8;
+    uint8_t bottom = 0;
+    const char *chars = CLOCKRENDERER_SPRITES;
+    for (uint8_t i = 0; i < sizeof(_sprites) / sizeof(ClockSprite); i++)
+    {
+        _sprites[i].advance = _textEngine->rasterize(chars[i], _sprites[i].rows, 8);
+        for (uint8_t row = 0; row < 8; row++)
+        {
+            if (_sprites[i].rows[row] != 0)
+            {
+                top = row < top ? row : top;
+                bottom = row > bottom ? row : bottom;
+            }
+        }
+    }
+    _bandTop = top < 8 ? top : 0;
+    _bandHeight = top < 8 ? bottom - top + 1 : 0;
+}
+
+void ClockRenderer::setColor(uint16_t color)
+{
+    if (color != _color)
+    {
+        _color = color;
+        _rgb = _blitter->color(color);
+        _valid = false;
+    }
+}
+
+void ClockRenderer::setRollDigits(bool rollDigits)
+{
+    _rollDigits = rollDigits;
+}
+
+uint16_t ClockRenderer::textWidth(const char *text)
+{
+    uint16_t width = 0;
+    for (; *text; text++)
+    {
+        const ClockSprite *s = sprite(*text);
+        width += s ? s->advance : 0;
+    }
+    return width;
+}
+
+void ClockRenderer::invalidate()
+{
+    _valid = false;
+}
+
+bool ClockRenderer::intact()
+{
+    return _valid && checksum() == _checksum;
+}
+
+bool ClockRenderer::update(const char *text, int16_t x, int16_t y, bool slide)
+{
+    bool changed = false;
+    bool sameLayout = _valid && x == _x && y == _y && strlen(text) == strlen(_text);
+    for (uint8_t i = 0; sameLayout && text[i]; i++)
+    {
+        const ClockSprite *a = sprite(text[i]);
+        const ClockSprite *b = sprite(_text[i]);
+        sameLayout = (a ? a->advance : 0) == (b ? b->advance : 0);
+    }
+
+    // A running transition ends here, the new text starts from its final state
+    if ((_sliding || _rolling) && _valid)
+    {
+        clearBand(0, Geometry::width);
+        drawLine(_text, _x, 0);
+        changed = true;
+    }
+    _sliding = false;
+    _rolling = 0;
+    _y = y;
+
+    if (!_valid || (!sameLayout && !slide))
+    {
+        clearBand(0, Geometry::width);
+        drawLine(text, x, 0);
+        changed = true;
+    }
+    else if (slide)
+    {
+        strcpy(_oldText, _text);
+        _oldX = _x;
+        _sliding = true;
+    }
+    else
+    {
+        for (uint8_t i = 0; text[i]; i++)
+        {
+            if (text[i] == _text[i])
+            {
+                continue;
+            }
+            if (_rollDigits && isdigit(text[i]) && isdigit(_text[i]))
+            {
+                _rolling |= 1 << i;
+            }
+            else
+            {
+                const ClockSprite *s = sprite(text[i]);
+                int16_t cx = cellX(text, x, i);
+                clearBand(cx, s ? s->advance : 0);
+                drawSprite(s, cx, 0);
+                changed = true;
+            }
+        }
+        if (_rolling)
+        {
+            strcpy(_oldText, _text);
+            _oldX = _x;
+        }
+    }
+
+    strncpy(_text, text, CLOCKRENDERER_MAX_LENGHT);
+    _text[CLOCKRENDERER_MAX_LENGHT] = 0;
+    _x = x;
+    _valid = true;
+
+    if (_sliding || _rolling)
+    {
+        _step = 0;
+        _lastStep = millis();
+        step();
+        changed = true;
+    }
+
+    _checksum = checksum();
+    return changed;
+}
+
+bool ClockRenderer::loop()
+{
+    if ((!_sliding && !_rolling) || millis() - _lastStep < CLOCKRENDERER_STEP_INTERVAL)
+    {
+        return false;
+    }
+    _lastStep = millis();
+    step();
+    _checksum = checksum();
+    return true;
+}
+
+bool ClockRenderer::inTransition() const
+{
+    return _sliding || _rolling;
+}
+
+unsigned long ClockRenderer::nextStep() const
+{
+    return _lastStep + CLOCKRENDERER_STEP_INTERVAL;
+}
+
+void ClockRenderer::step()
+{
+    // The old text leaves downwards, the new one comes in from above, one empty row between them
+    uint8_t distance = _bandHeight + 1;
+    _step++;
+
+    if (_sliding)
+    {
+        clearBand(0, Geometry::width);
+        drawLine(_oldText, _oldX, _step);
+        drawLine(_text, _x, _step - distance);
+    }
+    else
+    {
+        for (uint8_t i = 0; _text[i]; i++)
+        {
+            if (_rolling & (1 << i))
+            {
+                const ClockSprite *s = sprite(_text[i]);
+                int16_t cx = cellX(_text, _x, i);
+                clearBand(cx, s ? s->advance : 0);
+                drawSprite(sprite(_oldText[i]), cx, _step);
+                drawSprite(s, cx, _step - distance);
+            }
+        }
+    }
+
+    if (_step >= distance)
+    {
+        _sliding = false;
+        _rolling = 0;
+    }
+}
+
+const ClockSprite *ClockRenderer::sprite(char c) const
+{
+    const char *position = strchr(CLOCKRENDERER_SPRITES, c);
+    return c != 0 && position ? &_sprites[position - CLOCKRENDERER_SPRITES] : NULL;
+}
+
+int16_t ClockRenderer::cellX(const char *text, int16_t x, uint8_t index) const
+{
+    for (uint8_t i = 0; i < index; i++)
+    {
+        const ClockSprite *s = sprite(text[i]);
+        x += s ? s->advance : 0;
+    }
+    return x;
+}
+
+void ClockRenderer::clearBand(int16_t x, uint8_t width)
+{
+    int16_t top = _y - 7 + _bandTop;
+    for (uint8_t j = 0; j < _bandHeight; j++)
+    {
+        for (uint8_t i = 0; i < width; i++)
+        {
+            _blitter->drawPixel(x + i, top + j, CRGB(0, 0, 0));
+        }
+    }
+}
+
+void ClockRenderer::drawSprite(const ClockSprite *sprite, int16_t x, int8_t shift)
+{
+    if (sprite == NULL)
+    {
+        return;
+    }
+    // Clipped to the band
+    for (int8_t row = _bandTop; row < _bandTop + _bandHeight; row++)
+    {
+        int8_t source = row - shift;
+        if (source < 0 || source > 7)
+        {
+            continue;
+        }
+        uint8_t bits = sprite->rows[source];
+        for (uint8_t i = 0; bits; i++, bits <<= 1)
+        {
+            if (bits & 0x80)
+            {
+                _blitter->drawPixel(x + i, _y - 7 + row, _rgb);
+            }
+        }
+    }
+}
+
+void ClockRenderer::drawLine(const char *text, int16_t x, int8_t shift)
+{
+    for (; *text; text++)
+    {
+        const ClockSprite *s = sprite(*text);
+        drawSprite(s, x, shift);
+        x += s ? s->advance : 0;
+    }
+}
+
+uint32_t ClockRenderer::checksum() const
+{
+    // FNV-1a over the whole LED buffer
+    const uint8_t *data = (const uint8_t *)_blitter->leds();
+    uint32_t hash = 2166136261UL;
+    for (uint16_t i = 0; i < Geometry::pixels * sizeof(CRGB); i++)
+    {
+        hash = (hash ^ data[i]) * 16777619UL;
+    }
+    return hash;
+}
@@ -0,0 +1,335 @@
+#include "CommandCapture.h"
+#if defined(ESP8266)
+#include <LittleFS.h>
+#define CAPTURE_FS LittleFS
+#elif defined(ESP32)
+#include <SPIFFS.h>
+#define CAPTURE_FS SPIFFS
+#endif
+
+static const char *const captureTransportNames[] = {"http", "mqtt", "websocket"};
+static const char *const captureStateNames[] = {"idle", "recording", "replaying"};
+static const uint8_t captureMagic[4] = {'P', 'X', 'C', 'P'};
+
+// Four buckets per power of two, about 20 % resolution
+static uint8_t CaptureBucket(uint32_t value)
+{
+    if (value < 4)
+    {
+        return value;
+    }
+    uint8_t bit = 31 - __builtin_clz(value);
+    return (bit - 1) * 4 + ((value >> (bit - 2)) & 3);
+}
+
+static uint32_t CaptureBucketLimit(uint8_t bucket)
+{
+    if (bucket < 4)
+    {
+        return bucket;
+    }
+    uint8_t bit = bucket / 4 + 1;
+    return (((uint32_t)(4 + bucket % 4) + 1) << (bit - 2)) - 1;
+}
+
+CommandCapture::CommandCapture()
+{
+    _state = CaptureState_Idle;
+    _length = 0;
+    _records = 0;
+    _lost = 0;
+    _replayed = 0;
+    _skipped = 0;
+    _dropped = 0;
+    _heapStart = 0;
+    _heapMin = 0;
+    _renderMax = 0;
+    memset(_histogram, 0, sizeof(_histogram));
+}
+
+bool CommandCapture::record()
+{
+    stop();
+    _file = CAPTURE_FS.open(CAPTURE_PATH, "w");
+    if (!_file)
+    {
+        return false;
+    }
+    uint8_t header[CAPTURE_HEADER_LENGHT] = {captureMagic[0], captureMagic[1], captureMagic[2], captureMagic[3], CAPTURE_VERSION, 0, 0, 0};
+    _file.write(header, sizeof(header));
+    _length = sizeof(header);
+    _records = 0;
+    _lost = 0;
+    _startMillis = millis();
+    _lastTime = 0;
+    _state = CaptureState_Recording;
+    return true;
+}
+
+bool CommandCapture::replay(uint16_t speed)
+{
+    stop();
+    _file = CAPTURE_FS.open(CAPTURE_PATH, "r");
+    if (!_file || !readHeader())
+    {
+        finish();
+        return false;
+    }
+    _speed = speed > 0 ? speed : 100;
+    _pending = false;
+    _lastTime = 0;
+    _replayed = 0;
+    _skipped = 0;
+    _dropped = 0;
+    _renderMax = 0;
+    memset(_histogram, 0, sizeof(_histogram));
+    _heapStart = ESP.getFreeHeap();
+    _heapMin = _heapStart;
+    _startMillis = millis();
+    _lastLoop = millis();
+    _state = CaptureState_Replaying;
+    return true;
+}
+
+void CommandCapture::stop()
+{
+    finish();
+}
+
+CaptureState CommandCapture::state() const
+{
+    return _state;
+}
+
+void CommandCapture::add(CaptureTransport transport, const char *command, const char *payload, size_t length)
+{
+    if (_state != CaptureState_Recording)
+    {
+        return;
+    }
+    uint8_t commandLength = strnlen(command, CAPTURE_COMMAND_LENGHT - 1);
+    // Varints take up to 5 bytes
+    if (_length + 12 + commandLength + length > CAPTURE_MAX_LENGHT)
+    {
+        _lost++;
+        return;
+    }
+
+    uint32_t time = millis() - _startMillis;
+    size_t start = _file.size();
+    writeVarint(time - _lastTime);
+    _file.write((uint8_t)transport);
+    _file.write(commandLength);
+    _file.write((const uint8_t *)command, commandLength);
+    writeVarint(length);
+    _file.write((const uint8_t *)payload, length);
+    _length += _file.size() - start;
+    _lastTime = time;
+    _records++;
+}
+
+bool CommandCapture::next(CaptureRecord &record)
+{
+    if (_state != CaptureState_Replaying)
+    {
+        return false;
+    }
+
+    if (!_pending)
+    {
+        uint32_t delta;
+        uint32_t length;
+        int transport;
+        if (!readVarint(delta) || (transport = _file.read()) < 0 || transport >= CaptureTransport_Count)
+        {
+            finish();
+            return false;
+        }
+        int commandLength = _file.read();
+        if (commandLength < 0 || commandLength >= CAPTURE_COMMAND_LENGHT || _file.read((uint8_t *)_next.command, commandLength) != (size_t)commandLength || !readVarint(length))
+        {
+            finish();
+            return false;
+        }
+        _next.command[commandLength] = '\0';
+        _next.transport = static_cast<CaptureTransport>(transport);
+        _next.time = _lastTime + delta;
+        _nextLength = length;
+        _lastTime = _next.time;
+        _pending = true;
+    }
+
+    if ((uint64_t)(millis() - _startMillis) * _speed / 100 < _next.time)
+    {
+        return false;
+    }
+
+    record.time = _next.time;
+    record.transport = _next.transport;
+    memcpy(record.command, _next.command, sizeof(record.command));
+    record.payload = "";
+    record.payload.reserve(_nextLength);
+    // JSON payloads, so no zero bytes inside
+    char buffer[129];
+    for (size_t remaining = _nextLength; remaining > 0;)
+    {
+        size_t count = _file.read((uint8_t *)buffer, remaining < sizeof(buffer) - 1 ? remaining : sizeof(buffer) - 1);
+        if (count == 0)
+        {
+            finish();
+            return false;
+        }
+        buffer[count] = '\0';
+        record.payload += buffer;
+        remaining -= count;
+    }
+    _pending = false;
+    _replayed++;
+    // The payload is freed before the next loop pass samples the heap
+    sampleHeap();
+    return true;
+}
+
+void CommandCapture::loop()
+{
+    if (_state != CaptureState_Replaying)
+    {
+        return;
+    }
+    uint32_t now = millis();
+    _dropped += (now - _lastLoop) / CAPTURE_FRAME_INTERVAL;
+    _lastLoop = now;
+    sampleHeap();
+}
+
+void CommandCapture::renderTime(uint32_t micros)
+{
+    uint8_t bucket = CaptureBucket(micros);
+    if (_histogram[bucket] < UINT16_MAX)
+    {
+        _histogram[bucket]++;
+    }
+    _renderMax = micros > _renderMax ? micros : _renderMax;
+    // The handler still holds its JsonBuffer
+    sampleHeap();
+}
+
+void CommandCapture::skipped()
+{
+    _skipped++;
+}
+
+size_t CommandCapture::length() const
+{
+    return _length;
+}
+
+uint16_t CommandCapture::records() const
+{
+    return _records;
+}
+
+String CommandCapture::report() const
+{
+    String json = "{\"state\":\"" + String(stateName(_state)) + "\",\"records\":" + String(_records) + ",\"bytes\":" + String(_length) + ",\"lost\":" + String(_lost);
+    json += ",\"replay\":{\"commands\":" + String(_replayed) + ",\"skipped\":" + String(_skipped);
+    json += ",\"renderP50\":" + String(percentile(50)) + ",\"renderP90\":" + String(percentile(90)) + ",\"renderP99\":" + String(percentile(99)) + ",\"renderMax\":" + String(_renderMax);
+    json += ",\"droppedFrames\":" + String(_dropped) + ",\"heapMin\":" + String(_heapMin) + ",\"heapPeak\":" + String(_heapStart - _heapMin) + "}}";
+    return json;
+}
+
+File CommandCapture::open() const
+{
+    return CAPTURE_FS.open(CAPTURE_PATH, "r");
+}
+
+const char *CommandCapture::transportName(CaptureTransport transport)
+{
+    return captureTransportNames[transport];
+}
+
+const char *CommandCapture::stateName(CaptureState state)
+{
+    return captureStateNames[state];
+}
+
+bool CommandCapture::readHeader()
+{
+    uint8_t header[CAPTURE_HEADER_LENGHT];
+    if (_file.read(header, sizeof(header)) != sizeof(header) || memcmp(header, captureMagic, sizeof(captureMagic)) != 0 || header[4] != CAPTURE_VERSION)
+    {
+        return false;
+    }
+    _length = _file.size();
+    return true;
+}
+
+bool CommandCapture::readVarint(uint32_t &value)
+{
+    value = 0;
+    for (uint8_t shift = 0; shift < 35; shift += 7)
+    {
+        int b = _file.read();
+        if (b < 0)
+        {
+            return false;
+        }
+        value |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void CommandCapture::writeVarint(uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        _file.write((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    _file.write((uint8_t)value);
+}
+
+void CommandCapture::sampleHeap()
+{
+    uint32_t heap = ESP.getFreeHeap();
+    _heapMin = heap < _heapMin ? heap : _heapMin;
+}
+
+uint32_t CommandCapture::percentile(uint8_t percent) const
+{
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < CAPTURE_HISTOGRAM_BUCKETS; i++)
+    {
+        total += _histogram[i];
+    }
+    if (total == 0)
+    {
+        return 0;
+    }
+    // Upper limit of the bucket that holds the percentile
+    uint32_t rank = (total * percent + 99) / 100;
+    uint32_t count = 0;
+    for (uint8_t i = 0; i < CAPTURE_HISTOGRAM_BUCKETS; i++)
+    {
+        count += _histogram[i];
+        if (count >= rank)
+        {
+            uint32_t limit = CaptureBucketLimit(i);
+            return limit < _renderMax ? limit : _renderMax;
+        }
+    }
+    return _renderMax;
+}
+
+void CommandCapture::finish()
+{
+    if (_file)
+    {
+        _file.close();
+    }
+    _state = CaptureState_Idle;
+}
@@ -0,0 +1,395 @@
+#include "DFPlayer.h"
+
+enum DFPlayerCode
+{
+    DFPlayerCode_Next = 0x01,
+    DFPlayerCode_Previous = 0x02,
+    DFPlayerCode_Track = 0x03,
+    DFPlayerCode_Volume = 0x06,
+    DFPlayerCode_Resume = 0x0D,
+    DFPlayerCode_Pause = 0x0E,
+    DFPlayerCode_Folder = 0x0F,
+    DFPlayerCode_Stop = 0x16,
+    DFPlayerCode_Removed = 0x3B,
+    DFPlayerCode_FinishedUsb = 0x3C,
+    DFPlayerCode_FinishedSd = 0x3D,
+    DFPlayerCode_FinishedFlash = 0x3E,
+    DFPlayerCode_Ready = 0x3F,
+    DFPlayerCode_Error = 0x40,
+    DFPlayerCode_Ack = 0x41,
+    DFPlayerCode_Status = 0x42,
+};
+
+enum DFPlayerError
+{
+    DFPlayerError_Busy = 0x01,
+    DFPlayerError_Serial = 0x03,
+    DFPlayerError_Checksum = 0x04,
+    DFPlayerError_TrackRange = 0x05,
+    DFPlayerError_TrackNotFound = 0x06,
+};
+
+static const char *const stateNames[] = {"offline", "stopped", "playing", "paused"};
+
+DFPlayer::DFPlayer()
+{
+    _serial = nullptr;
+    _state = DFPlayerState_Offline;
+    _detected = false;
+    _starting = false;
+    _head = 0;
+    _count = 0;
+    _awaiting = false;
+    _frameLength = 0;
+    _errors = 0;
+    _lastError = 0;
+    _timeouts = 0;
+    _dropped = 0;
+    callbackFunction = nullptr;
+}
+
+void DFPlayer::begin(Stream &serial)
+{
+    _serial = &serial;
+    _state = DFPlayerState_Offline;
+    _detected = false;
+    _head = 0;
+    _count = 0;
+    _awaiting = false;
+    _frameLength = 0;
+    _beginMillis = millis();
+    _starting = true;
+    _nextMillis = _beginMillis + DFPLAYER_STARTUP_DELAY;
+    // The answer tells whether a module is connected
+    enqueue(DFPlayerCode_Status, 0);
+}
+
+void DFPlayer::setCallback(void (*func)(DFPlayerState state))
+{
+    callbackFunction = func;
+}
+
+void DFPlayer::loop()
+{
+    if (_serial == nullptr)
+    {
+        return;
+    }
+
+    while (_serial->available() > 0)
+    {
+        receive(_serial->read());
+    }
+
+    unsigned long now = millis();
+    if (_awaiting && now - _sentMillis >= DFPLAYER_ACK_TIMEOUT)
+    {
+        _awaiting = false;
+        _timeouts++;
+        // Next and previous may have been executed, a second one would skip a track
+        if (_sent.command != DFPlayerCode_Next && _sent.command != DFPlayerCode_Previous)
+        {
+            retry();
+        }
+    }
+
+    if (!_awaiting && _count > 0 && (long)(now - _nextMillis) >= 0)
+    {
+        _sent = _queue[_head];
+        _head = (_head + 1) % DFPLAYER_QUEUE_LENGHT;
+        _count--;
+        send(_sent);
+    }
+}
+
+void DFPlayer::play(uint16_t track)
+{
+    enqueue(DFPlayerCode_Track, track);
+}
+
+void DFPlayer::playFolder(uint8_t folder, uint8_t track)
+{
+    enqueue(DFPlayerCode_Folder, (folder << 8) | track);
+}
+
+void DFPlayer::playNext()
+{
+    enqueue(DFPlayerCode_Next, 0);
+}
+
+void DFPlayer::playPrevious()
+{
+    enqueue(DFPlayerCode_Previous, 0);
+}
+
+void DFPlayer::pause()
+{
+    enqueue(DFPlayerCode_Pause, 0);
+}
+
+void DFPlayer::resume()
+{
+    enqueue(DFPlayerCode_Resume, 0);
+}
+
+void DFPlayer::stop()
+{
+    enqueue(DFPlayerCode_Stop, 0);
+}
+
+void DFPlayer::volume(uint8_t volume)
+{
+    enqueue(DFPlayerCode_Volume, volume < 30 ? volume : 30);
+}
+
+DFPlayerState DFPlayer::state() const
+{
+    return _state;
+}
+
+bool DFPlayer::isPlaying() const
+{
+    return _state == DFPlayerState_Playing;
+}
+
+bool DFPlayer::busy() const
+{
+    return _count > 0 || _awaiting;
+}
+
+uint16_t DFPlayer::errors() const
+{
+    return _errors;
+}
+
+uint8_t DFPlayer::lastError() const
+{
+    return _lastError;
+}
+
+uint16_t DFPlayer::timeouts() const
+{
+    return _timeouts;
+}
+
+uint16_t DFPlayer::dropped() const
+{
+    return _dropped;
+}
+
+const char *DFPlayer::stateName(DFPlayerState state)
+{
+    return stateNames[state];
+}
+
+void DFPlayer::enqueue(uint8_t command, uint16_t param)
+{
+    if (command == DFPlayerCode_Volume)
+    {
+        for (uint8_t i = 0; i < _count; i++)
+        {
+            DFPlayerCommand &queued = _queue[(_head + i) % DFPLAYER_QUEUE_LENGHT];
+            if (queued.command == DFPlayerCode_Volume)
+            {
+                queued.param = param;
+                return;
+            }
+        }
+    }
+
+    if (_count == DFPLAYER_QUEUE_LENGHT)
+    {
+        _dropped++;
+        return;
+    }
+    DFPlayerCommand &queued = _queue[(_head + _count) % DFPLAYER_QUEUE_LENGHT];
+    queued.command = command;
+    queued.param = param;
+    queued.retries = 0;
+    _count++;
+}
+
+void DFPlayer::retry()
+{
+    if (!_detected && _sent.command == DFPlayerCode_Status)
+    {
+        if (millis() - _beginMillis >= DFPLAYER_DETECT_TIMEOUT)
+        {
+            // Nothing connected, forget what was queued for it
+            _count = 0;
+            if (callbackFunction != nullptr)
+            {
+                callbackFunction(DFPlayerState_Offline);
+            }
+            return;
+        }
+        // Still reading the SD card, asked again until the timeout
+        _sent.retries = 0;
+    }
+    else if (_sent.retries >= DFPLAYER_MAX_RETRIES || !_detected)
+    {
+        return;
+    }
+
+    // Back to the front, if the queue is full the last command is dropped
+    _head = (_head + DFPLAYER_QUEUE_LENGHT - 1) % DFPLAYER_QUEUE_LENGHT;
+    if (_count < DFPLAYER_QUEUE_LENGHT)
+    {
+        _count++;
+    }
+    else
+    {
+        _dropped++;
+    }
+    _queue[_head] = _sent;
+    _queue[_head].retries++;
+}
+
+void DFPlayer::send(const DFPlayerCommand &command)
+{
+    // Queries are answered with the status instead of an acknowledgement
+    uint8_t frame[DFPLAYER_FRAME_LENGHT] = {0x7E, 0xFF, 0x06, command.command, command.command != DFPlayerCode_Status, (uint8_t)(command.param >> 8), (uint8_t)command.param, 0, 0, 0xEF};
+    uint16_t checksum = 0;
+    for (uint8_t i = 1; i < 7; i++)
+    {
+        checksum -= frame[i];
+    }
+    frame[7] = checksum >> 8;
+    frame[8] = checksum;
+    _serial->write(frame, sizeof(frame));
+
+    _awaiting = true;
+    _starting = false;
+    _sentMillis = millis();
+    _nextMillis = _sentMillis + (command.command == DFPlayerCode_Volume ? DFPLAYER_VOLUME_SPACING : DFPLAYER_COMMAND_SPACING);
+}
+
+void DFPlayer::receive(uint8_t b)
+{
+    if (_frameLength == 0 && b != 0x7E)
+    {
+        return;
+    }
+    _frame[_frameLength++] = b;
+    if (_frameLength < DFPLAYER_FRAME_LENGHT)
+    {
+        return;
+    }
+
+    uint16_t checksum = (_frame[7] << 8) | _frame[8];
+    for (uint8_t i = 1; i < 7; i++)
+    {
+        checksum += _frame[i];
+    }
+    if (_frame[1] == 0xFF && _frame[2] == 0x06 && _frame[9] == 0xEF && checksum == 0)
+    {
+        _frameLength = 0;
+        handleFrame(_frame[3], (_frame[5] << 8) | _frame[6]);
+        return;
+    }
+
+    // Lost a byte, continue at the next start byte
+    uint8_t start = 1;
+    while (start < DFPLAYER_FRAME_LENGHT && _frame[start] != 0x7E)
+    {
+        start++;
+    }
+    _frameLength = DFPLAYER_FRAME_LENGHT - start;
+    memmove(_frame, _frame + start, _frameLength);
+}
+
+void DFPlayer::handleFrame(uint8_t command, uint16_t param)
+{
+    _detected = true;
+    switch (command)
+    {
+    case DFPlayerCode_Ack:
+        acknowledged();
+        break;
+    case DFPlayerCode_Error:
+        _errors++;
+        _lastError = param;
+        if (_awaiting)
+        {
+            _awaiting = false;
+            // Not executed, so it is safe to send again
+            if (_lastError == DFPlayerError_Busy || _lastError == DFPlayerError_Serial || _lastError == DFPlayerError_Checksum)
+            {
+                retry();
+            }
+            else if (_lastError == DFPlayerError_TrackRange || _lastError == DFPlayerError_TrackNotFound)
+            {
+                setState(DFPlayerState_Stopped);
+            }
+        }
+        break;
+    case DFPlayerCode_Status:
+        if (_awaiting && _sent.command == DFPlayerCode_Status)
+        {
+            _awaiting = false;
+        }
+        // Low byte 1 playing, 2 paused
+        setState((param & 0xFF) == 1 ? DFPlayerState_Playing : ((param & 0xFF) == 2 ? DFPlayerState_Paused : DFPlayerState_Stopped));
+        break;
+    case DFPlayerCode_Ready:
+        // Queued commands do not have to wait for the startup delay any longer, the spacing
+        // after a command sent while the module was starting still applies
+        if (_starting && (long)(_nextMillis - millis()) > 0)
+        {
+            _nextMillis = millis();
+        }
+        setState(DFPlayerState_Stopped);
+        break;
+    case DFPlayerCode_FinishedUsb:
+    case DFPlayerCode_FinishedSd:
+    case DFPlayerCode_FinishedFlash:
+    case DFPlayerCode_Removed:
+        setState(DFPlayerState_Stopped);
+        break;
+    }
+
+    // Any valid frame means a module is connected
+    if (_state == DFPlayerState_Offline)
+    {
+        setState(DFPlayerState_Stopped);
+    }
+}
+
+void DFPlayer::acknowledged()
+{
+    if (!_awaiting)
+    {
+        return;
+    }
+    _awaiting = false;
+
+    switch (_sent.command)
+    {
+    case DFPlayerCode_Track:
+    case DFPlayerCode_Folder:
+    case DFPlayerCode_Next:
+    case DFPlayerCode_Previous:
+    case DFPlayerCode_Resume:
+        setState(DFPlayerState_Playing);
+        break;
+    case DFPlayerCode_Pause:
+        setState(DFPlayerState_Paused);
+        break;
+    case DFPlayerCode_Stop:
+        setState(DFPlayerState_Stopped);
+        break;
+    }
+}
+
+void DFPlayer::setState(DFPlayerState state)
+{
+    if (state == _state)
+    {
+        return;
+    }
+    _state = state;
+    if (callbackFunction != nullptr)
+    {
+        callbackFunction(_state);
+    }
+}
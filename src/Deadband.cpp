@@ -0,0 +1,96 @@
+#include "Deadband.h"
+
+Deadband::Deadband()
+{
+    _count = 0;
+}
+
+void Deadband::begin(uint8_t fields, uint32_t minInterval, uint32_t maxInterval)
+{
+    _count = fields < DEADBAND_MAX_FIELDS ? fields : DEADBAND_MAX_FIELDS;
+    _minInterval = minInterval;
+    _maxInterval = maxInterval;
+    for (uint8_t i = 0; i < DEADBAND_MAX_FIELDS; i++)
+    {
+        _fields[i].absolute = 0;
+        _fields[i].relative = 0;
+    }
+    reset();
+}
+
+void Deadband::setBand(uint8_t field, float absolute, float relative)
+{
+    if (field >= _count)
+    {
+        return;
+    }
+    _fields[field].absolute = absolute;
+    _fields[field].relative = relative;
+}
+
+void Deadband::reset()
+{
+    for (uint8_t i = 0; i < DEADBAND_MAX_FIELDS; i++)
+    {
+        _fields[i].hasPublished = false;
+    }
+}
+
+bool Deadband::changed(uint8_t field, float value) const
+{
+    const DeadbandField &f = _fields[field];
+    if (!f.hasPublished)
+    {
+        return true;
+    }
+    if (isnan(value) || isnan(f.published))
+    {
+        return isnan(value) != isnan(f.published);
+    }
+    float band = f.relative * fabsf(f.published);
+    band = band > f.absolute ? band : f.absolute;
+    return fabsf(value - f.published) > band;
+}
+
+bool Deadband::due(uint8_t field, float value) const
+{
+    const DeadbandField &f = _fields[field];
+    if (!f.hasPublished)
+    {
+        return true;
+    }
+    uint32_t elapsed = millis() - f.publishedMillis;
+    if (_maxInterval > 0 && elapsed >= _maxInterval)
+    {
+        return true;
+    }
+    return elapsed >= _minInterval && changed(field, value);
+}
+
+bool Deadband::due(const float *values) const
+{
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        if (due(i, values[i]))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Deadband::published(uint8_t field, float value)
+{
+    DeadbandField &f = _fields[field];
+    f.published = value;
+    f.publishedMillis = millis();
+    f.hasPublished = true;
+}
+
+void Deadband::published(const float *values)
+{
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        published(i, values[i]);
+    }
+}
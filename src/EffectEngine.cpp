@@ -0,0 +1,449 @@
+#include "EffectEngine.h"
+
+static const char *const effectTypeNames[] = {"none", "fire", "plasma", "rain", "starfield", "spectrum"};
+static const char *const effectPaletteNames[] = {"heat", "rainbow", "ocean", "forest", "lava", "party", "cloud"};
+static const TProgmemRGBPalette16 *const effectPalettes[] = {&HeatColors_p, &RainbowColors_p, &OceanColors_p, &ForestColors_p, &LavaColors_p, &PartyColors_p, &CloudColors_p};
+
+EffectEngine::EffectEngine()
+{
+    _type = EffectType_None;
+}
+
+void EffectEngine::begin(Blitter *blitter)
+{
+    _blitter = blitter;
+    _leds = blitter->leds();
+}
+
+void EffectEngine::start(EffectType type, int16_t x, int16_t y, int16_t width, int16_t height)
+{
+    // Clip the zone to the matrix
+    if (x < 0)
+    {
+        width += x;
+        x = 0;
+    }
+    if (y < 0)
+    {
+        height += y;
+        y = 0;
+    }
+    width = x + width > Geometry::width ? Geometry::width - x : width;
+    height = y + height > Geometry::height ? Geometry::height - y : height;
+    if (width <= 0 || height <= 0)
+    {
+        stop();
+        return;
+    }
+
+    _type = type;
+    _x = x;
+    _y = y;
+    _width = width;
+    _height = height;
+    _interval = EFFECT_DEFAULT_INTERVAL;
+    _density = EFFECT_DEFAULT_DENSITY;
+    _background = false;
+    _time = 0;
+
+    switch (type)
+    {
+    case EffectType_Fire:
+        _palette = HeatColors_p;
+        break;
+    case EffectType_Rain:
+        _palette = CRGBPalette16(CRGB::Black, CRGB::Green, CRGB::White);
+        break;
+    case EffectType_Starfield:
+        _palette = CRGBPalette16(CRGB::Black, CRGB::White);
+        break;
+    case EffectType_Spectrum:
+        _palette = CRGBPalette16(CRGB::Green, CRGB::Yellow, CRGB::Red);
+        break;
+    default:
+        _palette = RainbowColors_p;
+        break;
+    }
+
+    memset(_cells, 0, sizeof(_cells));
+    memset(_drops, 0, sizeof(_drops));
+    for (uint8_t i = 0; i < EFFECT_MAX_STARS; i++)
+    {
+        _stars[i].x = random16(_width << 8);
+        _stars[i].y = random8(_height);
+        _stars[i].speed = random8(48, 255);
+    }
+    _bands = 0;
+    memset(_levels, 0, sizeof(_levels));
+    memset(_peaks, 0, sizeof(_peaks));
+    _spectrumMillis = millis();
+}
+
+void EffectEngine::stop()
+{
+    _type = EffectType_None;
+}
+
+bool EffectEngine::active() const
+{
+    return _type != EffectType_None;
+}
+
+EffectType EffectEngine::type() const
+{
+    return _type;
+}
+
+bool EffectEngine::setPalette(const char *name)
+{
+    for (uint8_t i = 0; i < sizeof(effectPaletteNames) / sizeof(effectPaletteNames[0]); i++)
+    {
+        if (strcmp(name, effectPaletteNames[i]) == 0)
+        {
+            _palette = *effectPalettes[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+void EffectEngine::setColor(const CRGB &color)
+{
+    _palette = CRGBPalette16(CRGB::Black, color, CRGB::White);
+}
+
+void EffectEngine::setDensity(uint8_t density)
+{
+    _density = density;
+}
+
+void EffectEngine::setInterval(uint16_t interval)
+{
+    _interval = interval;
+}
+
+void EffectEngine::setBackground(bool background)
+{
+    _background = background;
+}
+
+void EffectEngine::setSpectrum(const uint8_t *values, uint8_t count)
+{
+    _bands = count < EFFECT_MAX_BANDS ? count : EFFECT_MAX_BANDS;
+    memcpy(_targets, values, _bands);
+    _spectrumMillis = millis();
+}
+
+uint16_t EffectEngine::interval() const
+{
+    return _interval;
+}
+
+void EffectEngine::step()
+{
+    _time++;
+    switch (_type)
+    {
+    case EffectType_Fire:
+        stepFire();
+        break;
+    case EffectType_Rain:
+        stepRain();
+        break;
+    case EffectType_Starfield:
+        stepStarfield();
+        break;
+    case EffectType_Spectrum:
+        stepSpectrum();
+        break;
+    default:
+        break;
+    }
+}
+
+void EffectEngine::draw()
+{
+    switch (_type)
+    {
+    case EffectType_Fire:
+    case EffectType_Rain:
+        drawCells();
+        break;
+    case EffectType_Plasma:
+        drawPlasma();
+        break;
+    case EffectType_Starfield:
+        drawStarfield();
+        break;
+    case EffectType_Spectrum:
+        drawSpectrum();
+        break;
+    default:
+        return;
+    }
+    if (_background)
+    {
+        drawOverlay();
+    }
+}
+
+void EffectEngine::capture()
+{
+    if (_background)
+    {
+        memcpy(_overlay, _leds, sizeof(_overlay));
+    }
+}
+
+void EffectEngine::restore()
+{
+    if (_background)
+    {
+        memcpy(_leds, _overlay, sizeof(_overlay));
+    }
+}
+
+// Fire2012 per column: every cell cools down, heat drifts up, new sparks near the bottom
+void EffectEngine::stepFire()
+{
+    // Less than the 550 of Fire2012, it was made for long strips
+    uint16_t cooling = 400 / _height + 2;
+    cooling = cooling < 255 ? cooling : 255;
+    uint8_t sparkRows = _height < 3 ? _height : 3;
+    for (uint16_t x = 0; x < _width; x++)
+    {
+        // Cells of the column from the bottom row up
+        uint8_t *bottom = _cells + (_height - 1) * _width + x;
+        int16_t up = -(int16_t)_width;
+
+        for (uint16_t k = 0; k < _height; k++)
+        {
+            bottom[k * up] = qsub8(bottom[k * up], random8(cooling));
+        }
+        for (uint16_t k = _height - 1; k >= 2; k--)
+        {
+            bottom[k * up] = (bottom[(k - 1) * up] + bottom[(k - 2) * up] * 2) / 3;
+        }
+        if (random8() < _density)
+        {
+            uint8_t k = random8(sparkRows);
+            bottom[k * up] = qadd8(bottom[k * up], random8(160, 255));
+        }
+    }
+}
+
+// Drops fall with their own speed and leave a fading trail
+void EffectEngine::stepRain()
+{
+    for (uint16_t i = 0; i < _width * _height; i++)
+    {
+        _cells[i] = scale8(_cells[i], 192);
+    }
+    for (uint16_t x = 0; x < _width; x++)
+    {
+        if (_drops[x] == 0)
+        {
+            if (random8() < _density / 16)
+            {
+                _drops[x] = 1 << 8;
+                _dropSpeeds[x] = random8(96, 255);
+            }
+            continue;
+        }
+        uint16_t y = (_drops[x] >> 8) - 1;
+        if (y >= _height)
+        {
+            _drops[x] = 0;
+            continue;
+        }
+        _cells[y * _width + x] = 255;
+        _drops[x] += _dropSpeeds[x];
+    }
+}
+
+// Stars move to the left, the fast ones are brighter (parallax)
+void EffectEngine::stepStarfield()
+{
+    uint8_t count = 1 + (uint16_t)_density * (EFFECT_MAX_STARS - 1) / 255;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        EffectStar &star = _stars[i];
+        if (star.x < star.speed)
+        {
+            star.x = _width << 8;
+            star.y = random8(_height);
+            star.speed = random8(48, 255);
+        }
+        else
+        {
+            star.x -= star.speed;
+        }
+    }
+}
+
+// Levels jump up and fall smoothly, the peaks are held for a moment
+void EffectEngine::stepSpectrum()
+{
+    if (millis() - _spectrumMillis > EFFECT_SPECTRUM_TIMEOUT)
+    {
+        memset(_targets, 0, _bands);
+    }
+    uint8_t fall = 4 + _density / 16;
+    for (uint8_t i = 0; i < _bands; i++)
+    {
+        if (_targets[i] >= _levels[i])
+        {
+            _levels[i] = _targets[i];
+        }
+        else
+        {
+            uint8_t difference = _levels[i] - _targets[i];
+            _levels[i] -= difference < fall ? difference : fall;
+        }
+
+        if (_levels[i] >= _peaks[i])
+        {
+            _peaks[i] = _levels[i];
+            _peakHolds[i] = 10;
+        }
+        else if (_peakHolds[i] > 0)
+        {
+            _peakHolds[i]--;
+        }
+        else
+        {
+            _peaks[i] = qsub8(_peaks[i], 4);
+        }
+    }
+}
+
+void EffectEngine::drawCells()
+{
+    const uint8_t *cell = _cells;
+    for (uint16_t y = 0; y < _height; y++)
+    {
+        for (uint16_t x = 0; x < _width; x++)
+        {
+            // The top of the heat palette is white, keep fire in the colours
+            uint8_t value = _type == EffectType_Fire ? scale8(*cell, 240) : *cell;
+            setPixel(x, y, ColorFromPalette(_palette, value));
+            cell++;
+        }
+    }
+}
+
+// Sum of three moving sine waves, the palette cycles slowly on top
+void EffectEngine::drawPlasma()
+{
+    uint8_t scale = 4 + _density / 16;
+    uint8_t t1 = _time * 2;
+    uint8_t t2 = _time * 3;
+    uint8_t t3 = _time;
+    for (uint16_t y = 0; y < _height; y++)
+    {
+        uint8_t row = sin8(y * scale + t2);
+        for (uint16_t x = 0; x < _width; x++)
+        {
+            uint16_t sum = sin8(x * scale + t1) + row + sin8((x + y) * scale / 2 - t3);
+            uint8_t index = sum / 3 + (_time >> 2);
+            setPixel(x, y, ColorFromPalette(_palette, index));
+        }
+    }
+}
+
+void EffectEngine::drawStarfield()
+{
+    CRGB black = ColorFromPalette(_palette, 0);
+    for (uint16_t y = 0; y < _height; y++)
+    {
+        for (uint16_t x = 0; x < _width; x++)
+        {
+            setPixel(x, y, black);
+        }
+    }
+
+    // Sub pixel positions are split between two pixels
+    uint8_t count = 1 + (uint16_t)_density * (EFFECT_MAX_STARS - 1) / 255;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        const EffectStar &star = _stars[i];
+        uint16_t x = star.x >> 8;
+        uint8_t fraction = star.x & 0xFF;
+        if (x < _width)
+        {
+            _leds[_blitter->index(_x + x, _y + star.y)] += ColorFromPalette(_palette, scale8(star.speed, 255 - fraction));
+        }
+        if (x + 1 < _width)
+        {
+            _leds[_blitter->index(_x + x + 1, _y + star.y)] += ColorFromPalette(_palette, scale8(star.speed, fraction));
+        }
+    }
+}
+
+void EffectEngine::drawSpectrum()
+{
+    CRGB black = CRGB::Black;
+    uint8_t bands = _bands < _width ? _bands : _width;
+    uint16_t bandWidth = bands > 0 ? _width / bands : _width;
+    // Bars of 3 pixels and more get a gap
+    uint16_t barWidth = bandWidth >= 3 ? bandWidth - 1 : bandWidth;
+    uint16_t left = (_width - bands * bandWidth) / 2;
+
+    for (uint16_t x = 0; x < _width; x++)
+    {
+        uint8_t band = x >= left ? (x - left) / bandWidth : bands;
+        bool bar = band < bands && (x - left) % bandWidth < barWidth;
+        uint16_t height = bar ? (_levels[band] * _height + 127) / 255 : 0;
+        uint16_t peak = bar ? (_peaks[band] * _height + 127) / 255 : 0;
+
+        for (uint16_t row = 0; row < _height; row++)
+        {
+            // Rows counted from the bottom, coloured by their height
+            uint16_t y = _height - 1 - row;
+            if (row < height)
+            {
+                setPixel(x, y, ColorFromPalette(_palette, _height > 1 ? row * 255 / (_height - 1) : 255));
+            }
+            else if (peak > 0 && row == peak - 1)
+            {
+                setPixel(x, y, ColorFromPalette(_palette, 255));
+            }
+            else
+            {
+                setPixel(x, y, black);
+            }
+        }
+    }
+}
+
+void EffectEngine::drawOverlay()
+{
+    for (uint16_t y = 0; y < _height; y++)
+    {
+        for (uint16_t x = 0; x < _width; x++)
+        {
+            uint16_t index = _blitter->index(_x + x, _y + y);
+            if (_overlay[index])
+            {
+                _leds[index] = _overlay[index];
+            }
+        }
+    }
+}
+
+const char *EffectEngine::typeName(EffectType type)
+{
+    return effectTypeNames[type];
+}
+
+int8_t EffectEngine::typeFromName(const char *name)
+{
+    for (uint8_t i = 0; i < EffectType_Count; i++)
+    {
+        if (strcmp(name, effectTypeNames[i]) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
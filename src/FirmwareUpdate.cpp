@@ -0,0 +1,195 @@
+#include "FirmwareUpdate.h"
+#if defined(ESP8266)
+#include <LittleFS.h>
+#include <Updater.h>
+extern "C" uint32_t _FS_start;
+extern "C" uint32_t _FS_end;
+#elif defined(ESP32)
+#include <SPIFFS.h>
+#include <Update.h>
+#endif
+
+FirmwareUpdate::FirmwareUpdate()
+{
+    _active = false;
+    _success = false;
+    callbackFunction = nullptr;
+    _decoder.setCallback(writeDecoded);
+}
+
+void FirmwareUpdate::setCallback(void (*func)(uint8_t progress))
+{
+    callbackFunction = func;
+}
+
+bool FirmwareUpdate::begin(bool filesystem, bool heatshrink, const String &md5, size_t uploadLength)
+{
+    _active = true;
+    _success = false;
+    _filesystem = filesystem;
+    _started = false;
+    _format = heatshrink ? FirmwareFormat_Heatshrink : FirmwareFormat_Raw;
+    _expectedMd5 = md5;
+    _error = "";
+    _uploadLength = uploadLength;
+    _received = 0;
+    _progress = 0;
+    _decoder.reset();
+    _md5.begin();
+
+    bool started;
+#if defined(ESP8266)
+    size_t space = filesystem ? ((size_t)&_FS_end - (size_t)&_FS_start) : ((ESP.getFreeSketchSpace() - 0x1000) & 0xFFFFF000);
+    if (filesystem)
+    {
+        LittleFS.end();
+    }
+    started = Update.begin(space, filesystem ? U_FS : U_FLASH);
+#elif defined(ESP32)
+    if (filesystem)
+    {
+        SPIFFS.end();
+    }
+    started = Update.begin(UPDATE_SIZE_UNKNOWN, filesystem ? U_SPIFFS : U_FLASH);
+#endif
+    if (!started)
+    {
+        fail(F("Not enough space"));
+    }
+    return started;
+}
+
+void FirmwareUpdate::write(const uint8_t *data, size_t length)
+{
+    if (!_active || length == 0)
+    {
+        return;
+    }
+    _md5.add(const_cast<uint8_t *>(data), length);
+    _received += length;
+
+    if (!_started)
+    {
+        _started = true;
+        if (_format == FirmwareFormat_Raw && length >= 2 && data[0] == 0x1F && data[1] == 0x8B)
+        {
+            _format = FirmwareFormat_Gzip;
+#if defined(ESP32)
+            fail(F("Gzip images need the ESP8266 boot loader, upload the .bin.hs image"));
+#endif
+        }
+    }
+
+    if (_error.length() == 0 && !Update.hasError())
+    {
+        if (_format == FirmwareFormat_Heatshrink)
+        {
+            _decoder.write(data, length);
+        }
+        else
+        {
+            Update.write(const_cast<uint8_t *>(data), length);
+        }
+    }
+
+    uint8_t progress = _uploadLength > 0 ? (uint64_t)_received * 100 / _uploadLength : 0;
+    progress = progress < 100 ? progress : 100;
+    if (progress != _progress)
+    {
+        _progress = progress;
+        if (callbackFunction != nullptr)
+        {
+            callbackFunction(_progress);
+        }
+    }
+}
+
+bool FirmwareUpdate::end()
+{
+    if (!_active)
+    {
+        return false;
+    }
+
+    _md5.calculate();
+    if (_error.length() == 0 && _expectedMd5.length() > 0 && !_md5.toString().equalsIgnoreCase(_expectedMd5))
+    {
+        fail("MD5 mismatch, received " + _md5.toString());
+    }
+
+    if (_error.length() > 0)
+    {
+        flashAbort();
+        _active = false;
+        return false;
+    }
+
+    // Only now the new image is activated for the next boot
+    _success = Update.end(true);
+    _active = false;
+    return _success;
+}
+
+void FirmwareUpdate::abort()
+{
+    if (_active)
+    {
+        fail(F("Upload aborted"));
+        flashAbort();
+        _active = false;
+    }
+}
+
+bool FirmwareUpdate::active() const
+{
+    return _active;
+}
+
+bool FirmwareUpdate::success() const
+{
+    return _success;
+}
+
+String FirmwareUpdate::error() const
+{
+    if (_error.length() > 0)
+    {
+        return _error;
+    }
+#if defined(ESP8266)
+    return Update.getErrorString();
+#elif defined(ESP32)
+    return Update.errorString();
+#endif
+}
+
+uint8_t FirmwareUpdate::progress() const
+{
+    return _progress;
+}
+
+void FirmwareUpdate::fail(const String &error)
+{
+    if (_error.length() == 0)
+    {
+        _error = error;
+    }
+}
+
+void FirmwareUpdate::flashAbort()
+{
+#if defined(ESP8266)
+    // Not finished, so nothing is activated
+    Update.end();
+#elif defined(ESP32)
+    Update.abort();
+#endif
+}
+
+void FirmwareUpdate::writeDecoded(const uint8_t *data, size_t length)
+{
+    if (!Update.hasError())
+    {
+        Update.write(const_cast<uint8_t *>(data), length);
+    }
+}
@@ -0,0 +1,496 @@
+#include "GifDecoder.h"
+#include <Arduino.h>
+
+GifDecoder::GifDecoder()
+{
+}
+
+void GifDecoder::begin(uint16_t *frames, uint16_t frameSize, uint8_t maxFrames, uint16_t *delays)
+{
+    _frames = frames;
+    _frameSize = frameSize > GIFDECODER_MAX_PIXELS ? GIFDECODER_MAX_PIXELS : frameSize;
+    _maxFrames = maxFrames;
+    _delays = delays;
+
+    _status = GifDecoderStatus_Decoding;
+    _width = 0;
+    _height = 0;
+    _loops = 0;
+    _frameCount = 0;
+    _globalColorCount = 0;
+    _localColorCount = 0;
+    _delay = 0;
+    _transparent = -1;
+    _disposal = 0;
+    _previousDisposal = 0;
+    _skipImage = false;
+
+    expect(GifDecoderState_Header, 6);
+}
+
+GifDecoderStatus GifDecoder::write(const uint8_t *data, size_t length)
+{
+    for (size_t i = 0; i < length && _status == GifDecoderStatus_Decoding; i++)
+    {
+        parse(data[i]);
+    }
+    return _status;
+}
+
+GifDecoderStatus GifDecoder::status() const
+{
+    return _status;
+}
+
+uint8_t GifDecoder::frameCount() const
+{
+    return _frameCount;
+}
+
+uint16_t GifDecoder::width() const
+{
+    return _width;
+}
+
+uint16_t GifDecoder::height() const
+{
+    return _height;
+}
+
+uint16_t GifDecoder::loops() const
+{
+    return _loops;
+}
+
+void GifDecoder::expect(GifDecoderState state, uint16_t bytes)
+{
+    _state = state;
+    _need = bytes;
+    _have = 0;
+}
+
+bool GifDecoder::collect(uint8_t value)
+{
+    _buffer[_have++] = value;
+    return _have == _need;
+}
+
+void GifDecoder::parse(uint8_t value)
+{
+    switch (_state)
+    {
+    case GifDecoderState_Header:
+        if (collect(value))
+        {
+            if (memcmp(_buffer, "GIF87a", 6) != 0 && memcmp(_buffer, "GIF89a", 6) != 0)
+            {
+                fail(GifDecoderStatus_ErrorFormat);
+                return;
+            }
+            expect(GifDecoderState_ScreenDescriptor, 7);
+        }
+        break;
+
+    case GifDecoderState_ScreenDescriptor:
+        if (collect(value))
+        {
+            _width = _buffer[0] | (_buffer[1] << 8);
+            _height = _buffer[2] | (_buffer[3] << 8);
+            if (_width == 0 || _height == 0)
+            {
+                fail(GifDecoderStatus_ErrorFormat);
+                return;
+            }
+            if ((uint32_t)_width * _height > _frameSize)
+            {
+                fail(GifDecoderStatus_ErrorTooLarge);
+                return;
+            }
+
+            if (_buffer[4] & 0x80)
+            {
+                _globalColorCount = 2 << (_buffer[4] & 0x07);
+                _colorIndex = 0;
+                expect(GifDecoderState_GlobalColorTable, 3);
+            }
+            else
+            {
+                _state = GifDecoderState_BlockIntro;
+            }
+        }
+        break;
+
+    case GifDecoderState_GlobalColorTable:
+        if (collect(value))
+        {
+            colorTableEntry(_globalColors, _globalColorCount, GifDecoderState_BlockIntro);
+        }
+        break;
+
+    case GifDecoderState_BlockIntro:
+        if (value == 0x21)
+        {
+            _state = GifDecoderState_ExtensionLabel;
+        }
+        else if (value == 0x2C)
+        {
+            expect(GifDecoderState_ImageDescriptor, 9);
+        }
+        else if (value == 0x3B)
+        {
+            _state = GifDecoderState_Trailer;
+            _status = GifDecoderStatus_Done;
+        }
+        else
+        {
+            fail(GifDecoderStatus_ErrorFormat);
+        }
+        break;
+
+    case GifDecoderState_ExtensionLabel:
+        _extensionLabel = value;
+        _extensionBlock = 0;
+        _state = GifDecoderState_ExtensionBlockSize;
+        break;
+
+    case GifDecoderState_ExtensionBlockSize:
+        if (value == 0)
+        {
+            _state = GifDecoderState_BlockIntro;
+        }
+        else
+        {
+            _blockRemaining = value;
+            expect(GifDecoderState_ExtensionBlock, GIFDECODER_BUFFER_LENGHT);
+        }
+        break;
+
+    case GifDecoderState_ExtensionBlock:
+        // Only the start of a block is of interest, the rest is skipped
+        if (_have < GIFDECODER_BUFFER_LENGHT)
+        {
+            _buffer[_have++] = value;
+        }
+        if (--_blockRemaining == 0)
+        {
+            extensionBlock();
+            _extensionBlock++;
+            _state = GifDecoderState_ExtensionBlockSize;
+        }
+        break;
+
+    case GifDecoderState_ImageDescriptor:
+        if (collect(value))
+        {
+            _imageLeft = _buffer[0] | (_buffer[1] << 8);
+            _imageTop = _buffer[2] | (_buffer[3] << 8);
+            _imageWidth = _buffer[4] | (_buffer[5] << 8);
+            _imageHeight = _buffer[6] | (_buffer[7] << 8);
+            _interlaced = _buffer[8] & 0x40;
+
+            if (_imageWidth == 0 || _imageHeight == 0 || _imageLeft + _imageWidth > _width || _imageTop + _imageHeight > _height)
+            {
+                fail(GifDecoderStatus_ErrorFormat);
+                return;
+            }
+
+            _localColorCount = 0;
+            if (_buffer[8] & 0x80)
+            {
+                _localColorCount = 2 << (_buffer[8] & 0x07);
+                _colorIndex = 0;
+                expect(GifDecoderState_LocalColorTable, 3);
+            }
+            else
+            {
+                _state = GifDecoderState_LzwMinCodeSize;
+            }
+        }
+        break;
+
+    case GifDecoderState_LocalColorTable:
+        if (collect(value))
+        {
+            colorTableEntry(_localColors, _localColorCount, GifDecoderState_LzwMinCodeSize);
+        }
+        break;
+
+    case GifDecoderState_LzwMinCodeSize:
+        if (value < 2 || value > 8)
+        {
+            fail(GifDecoderStatus_ErrorFormat);
+            return;
+        }
+        _minCodeSize = value;
+        beginImage();
+        _state = GifDecoderState_ImageBlockSize;
+        break;
+
+    case GifDecoderState_ImageBlockSize:
+        if (value == 0)
+        {
+            endImage();
+            _state = GifDecoderState_BlockIntro;
+        }
+        else
+        {
+            _blockRemaining = value;
+            _state = GifDecoderState_ImageBlock;
+        }
+        break;
+
+    case GifDecoderState_ImageBlock:
+        if (!_skipImage && !_imageDone)
+        {
+            lzwByte(value);
+        }
+        if (--_blockRemaining == 0)
+        {
+            _state = GifDecoderState_ImageBlockSize;
+        }
+        break;
+
+    case GifDecoderState_Trailer:
+        break;
+    }
+}
+
+void GifDecoder::colorTableEntry(uint16_t *colors, uint16_t count, GifDecoderState next)
+{
+    colors[_colorIndex++] = ((_buffer[0] & 0xF8) << 8) | ((_buffer[1] & 0xFC) << 3) | (_buffer[2] >> 3);
+    if (_colorIndex < count)
+    {
+        _have = 0;
+    }
+    else
+    {
+        _state = next;
+    }
+}
+
+void GifDecoder::extensionBlock()
+{
+    if (_extensionLabel == 0xF9 && _extensionBlock == 0 && _have >= 4)
+    {
+        // Graphic control extension
+        _disposal = (_buffer[0] >> 2) & 0x07;
+        _delay = _buffer[1] | (_buffer[2] << 8);
+        _transparent = (_buffer[0] & 0x01) ? _buffer[3] : -1;
+    }
+    else if (_extensionLabel == 0xFF)
+    {
+        // Application extension, only the loop count of NETSCAPE2.0 is used
+        if (_extensionBlock == 0 && (_have < 11 || memcmp(_buffer, "NETSCAPE2.0", 11) != 0))
+        {
+            _extensionLabel = 0;
+        }
+        else if (_extensionBlock == 1 && _have >= 3 && _buffer[0] == 1)
+        {
+            _loops = _buffer[1] | (_buffer[2] << 8);
+        }
+    }
+}
+
+void GifDecoder::beginImage()
+{
+    _skipImage = _frameCount >= _maxFrames;
+    _imageDone = false;
+    if (_skipImage)
+    {
+        return;
+    }
+
+    // Start with what was visible after the previous frame, according to its disposal method
+    _canvas = _frames + _frameCount * _frameSize;
+    if (_frameCount == 0 || (_previousDisposal == 3 && _frameCount < 2))
+    {
+        memset(_canvas, 0, _frameSize * sizeof(uint16_t));
+    }
+    else if (_previousDisposal == 3)
+    {
+        memcpy(_canvas, _frames + (_frameCount - 2) * _frameSize, _frameSize * sizeof(uint16_t));
+    }
+    else
+    {
+        memcpy(_canvas, _frames + (_frameCount - 1) * _frameSize, _frameSize * sizeof(uint16_t));
+        if (_previousDisposal == 2)
+        {
+            for (uint16_t y = _previousTop; y < _previousTop + _previousHeight; y++)
+            {
+                memset(_canvas + y * _width + _previousLeft, 0, _previousWidth * sizeof(uint16_t));
+            }
+        }
+    }
+
+    if (_delays != nullptr)
+    {
+        _delays[_frameCount] = _delay * 10;
+    }
+
+    _clearCode = 1 << _minCodeSize;
+    _codeSize = _minCodeSize + 1;
+    _nextCode = _clearCode + 2;
+    _previousCode = -1;
+    _bits = 0;
+    _bitCount = 0;
+
+    _pixelX = 0;
+    _pixelY = 0;
+    _pass = 0;
+    _pixelCount = 0;
+}
+
+void GifDecoder::endImage()
+{
+    if (!_skipImage)
+    {
+        _frameCount++;
+        _previousDisposal = _disposal;
+        _previousLeft = _imageLeft;
+        _previousTop = _imageTop;
+        _previousWidth = _imageWidth;
+        _previousHeight = _imageHeight;
+    }
+
+    // The graphic control extension only applies to one image
+    _delay = 0;
+    _transparent = -1;
+    _disposal = 0;
+}
+
+void GifDecoder::lzwByte(uint8_t value)
+{
+    _bits |= (uint32_t)value << _bitCount;
+    _bitCount += 8;
+
+    while (_bitCount >= _codeSize)
+    {
+        uint16_t code = _bits & ((1 << _codeSize) - 1);
+        _bits >>= _codeSize;
+        _bitCount -= _codeSize;
+
+        if (!lzwCode(code))
+        {
+            // End of image, remaining data up to the block terminator is ignored
+            _imageDone = true;
+            return;
+        }
+    }
+}
+
+bool GifDecoder::lzwCode(uint16_t code)
+{
+    uint16_t pixels = _imageWidth * _imageHeight;
+
+    if (code == _clearCode)
+    {
+        _codeSize = _minCodeSize + 1;
+        _nextCode = _clearCode + 2;
+        _previousCode = -1;
+        return true;
+    }
+    if (code == _clearCode + 1)
+    {
+        return false;
+    }
+
+    if (_previousCode == -1)
+    {
+        if (code >= _clearCode)
+        {
+            fail(GifDecoderStatus_ErrorFormat);
+            return false;
+        }
+        outputPixel(code);
+        _firstChar = code;
+        _previousCode = code;
+        return _pixelCount < pixels;
+    }
+
+    if (code > _nextCode || code >= GIFDECODER_TABLE_SIZE)
+    {
+        fail(GifDecoderStatus_ErrorFormat);
+        return false;
+    }
+
+    uint16_t incoming = code;
+    uint16_t sp = 0; // The stack is larger than 255 on matrices with 16 rows
+    if (code == _nextCode)
+    {
+        _stack[sp++] = _firstChar;
+        code = _previousCode;
+    }
+    while (code >= _clearCode)
+    {
+        if (sp >= GIFDECODER_STACK_SIZE - 1)
+        {
+            fail(GifDecoderStatus_ErrorFormat);
+            return false;
+        }
+        _stack[sp++] = _suffix[code];
+        code = _prefix[code];
+    }
+    _stack[sp++] = code;
+    _firstChar = code;
+
+    if (_nextCode < GIFDECODER_TABLE_SIZE)
+    {
+        _prefix[_nextCode] = _previousCode;
+        _suffix[_nextCode] = _firstChar;
+        _nextCode++;
+        if (_nextCode == (1 << _codeSize) && _codeSize < 12)
+        {
+            _codeSize++;
+        }
+    }
+    _previousCode = incoming;
+
+    while (sp > 0)
+    {
+        outputPixel(_stack[--sp]);
+    }
+    return _pixelCount < pixels;
+}
+
+void GifDecoder::outputPixel(uint8_t index)
+{
+    if (_pixelCount >= _imageWidth * _imageHeight)
+    {
+        return;
+    }
+
+    const uint16_t *colors = _localColorCount > 0 ? _localColors : _globalColors;
+    uint16_t colorCount = _localColorCount > 0 ? _localColorCount : _globalColorCount;
+    if (index != _transparent && index < colorCount)
+    {
+        _canvas[(_imageTop + _pixelY) * _width + _imageLeft + _pixelX] = colors[index];
+    }
+
+    _pixelCount++;
+    if (++_pixelX < _imageWidth)
+    {
+        return;
+    }
+    _pixelX = 0;
+
+    if (!_interlaced)
+    {
+        _pixelY++;
+        return;
+    }
+
+    // Interlaced rows: every 8th from 0, every 8th from 4, every 4th from 2, every 2nd from 1
+    const uint8_t start[] = {0, 4, 2, 1};
+    const uint8_t step[] = {8, 8, 4, 2};
+    _pixelY += step[_pass];
+    while (_pixelY >= _imageHeight && _pass < 3)
+    {
+        _pass++;
+        _pixelY = start[_pass];
+    }
+}
+
+void GifDecoder::fail(GifDecoderStatus status)
+{
+    _status = status;
+}
@@ -0,0 +1,116 @@
+#include "Heatshrink.h"
+#include <string.h>
+
+#define HEATSHRINK_WINDOW_MASK (HEATSHRINK_WINDOW_LENGHT - 1)
+
+HeatshrinkDecoder::HeatshrinkDecoder()
+{
+    callbackFunction = nullptr;
+    reset();
+}
+
+void HeatshrinkDecoder::reset()
+{
+    // Back references in front of the start read zeros, like in the reference decoder
+    memset(_window, 0, sizeof(_window));
+    _head = 0;
+    _flushed = 0;
+    _bits = 0;
+    _bitCount = 0;
+    _state = State_Tag;
+    _total = 0;
+}
+
+void HeatshrinkDecoder::setCallback(void (*func)(const uint8_t *data, size_t length))
+{
+    callbackFunction = func;
+}
+
+size_t HeatshrinkDecoder::total() const
+{
+    return _total;
+}
+
+void HeatshrinkDecoder::write(const uint8_t *data, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        _bits = (_bits << 8) | data[i];
+        _bitCount += 8;
+
+        // Fields are MSB first, at most 10 bits, so the 32 bit buffer never overflows
+        bool done = false;
+        while (!done)
+        {
+            switch (_state)
+            {
+            case State_Tag:
+                if (_bitCount < 1)
+                {
+                    done = true;
+                    break;
+                }
+                _bitCount--;
+                _state = (_bits >> _bitCount) & 1 ? State_Literal : State_Offset;
+                break;
+            case State_Literal:
+                if (_bitCount < 8)
+                {
+                    done = true;
+                    break;
+                }
+                _bitCount -= 8;
+                put(_bits >> _bitCount);
+                _state = State_Tag;
+                break;
+            case State_Offset:
+                if (_bitCount < HEATSHRINK_WINDOW_BITS)
+                {
+                    done = true;
+                    break;
+                }
+                _bitCount -= HEATSHRINK_WINDOW_BITS;
+                _offset = ((_bits >> _bitCount) & HEATSHRINK_WINDOW_MASK) + 1;
+                _state = State_Length;
+                break;
+            case State_Length:
+                if (_bitCount < HEATSHRINK_LOOKAHEAD_BITS)
+                {
+                    done = true;
+                    break;
+                }
+                _bitCount -= HEATSHRINK_LOOKAHEAD_BITS;
+                // Byte by byte, the source may overlap the copied bytes
+                for (uint16_t count = ((_bits >> _bitCount) & ((1 << HEATSHRINK_LOOKAHEAD_BITS) - 1)) + 1; count > 0; count--)
+                {
+                    put(_window[(_head - _offset) & HEATSHRINK_WINDOW_MASK]);
+                }
+                _state = State_Tag;
+                break;
+            }
+        }
+        _bits &= (1UL << _bitCount) - 1;
+    }
+    flush();
+}
+
+void HeatshrinkDecoder::put(uint8_t value)
+{
+    _window[_head++] = value;
+    _total++;
+    if (_head == HEATSHRINK_WINDOW_LENGHT)
+    {
+        flush();
+        _head = 0;
+        _flushed = 0;
+    }
+}
+
+void HeatshrinkDecoder::flush()
+{
+    if (_head > _flushed && callbackFunction != nullptr)
+    {
+        callbackFunction(_window + _flushed, _head - _flushed);
+    }
+    _flushed = _head;
+}
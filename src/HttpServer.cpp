@@ -0,0 +1,1124 @@
+#include "HttpServer.h"
+#include <Arduino.h>
+
+HttpServer::HttpServer(uint16_t port) : _server(port)
+{
+    _routeCount = 0;
+    _notFoundHandler = nullptr;
+    _headerCount = 0;
+    _acquireBody = nullptr;
+    _releaseBody = nullptr;
+    _current = nullptr;
+    _uploadConnection = nullptr;
+}
+
+void HttpServer::begin()
+{
+    for (uint8_t i = 0; i < HTTPSERVER_MAX_CONNECTIONS; i++)
+    {
+        _connections[i].open = false;
+        _connections[i].body = nullptr;
+        reset(_connections[i]);
+    }
+    _server.begin();
+    _server.setNoDelay(true);
+}
+
+void HttpServer::on(const String &path, HttpServerMethod method, void (*handler)())
+{
+    on(path, method, handler, nullptr);
+}
+
+void HttpServer::on(const String &path, HttpServerMethod method, void (*handler)(), void (*uploadHandler)())
+{
+    if (_routeCount >= HTTPSERVER_MAX_ROUTES)
+    {
+        return;
+    }
+    Route &route = _routes[_routeCount++];
+    route.path = path;
+    route.method = method;
+    route.handler = handler;
+    route.uploadHandler = uploadHandler;
+}
+
+void HttpServer::onNotFound(void (*handler)())
+{
+    _notFoundHandler = handler;
+}
+
+void HttpServer::collectHeaders(const char *headerKeys[], size_t count)
+{
+    _headerCount = count > HTTPSERVER_MAX_HEADERS ? HTTPSERVER_MAX_HEADERS : count;
+    for (size_t i = 0; i < _headerCount; i++)
+    {
+        _headerKeys[i] = headerKeys[i];
+    }
+}
+
+void HttpServer::setBodyAllocator(char *(*acquire)(size_t length), void (*release)(char *body))
+{
+    _acquireBody = acquire;
+    _releaseBody = release;
+}
+
+void HttpServer::loop()
+{
+    accept();
+
+    for (uint8_t i = 0; i < HTTPSERVER_MAX_CONNECTIONS; i++)
+    {
+        Connection &c = _connections[i];
+        if (!c.open)
+        {
+            continue;
+        }
+
+        process(c);
+        if (c.state == ConnectionState_Response)
+        {
+            respond(c);
+        }
+
+        if (!c.client.connected() && c.client.available() == 0)
+        {
+            close(c);
+        }
+        else if (c.state == ConnectionState_Idle && millis() - c.lastActivity >= HTTPSERVER_KEEPALIVE_TIMEOUT)
+        {
+            close(c);
+        }
+        else if (c.state == ConnectionState_Response && millis() - c.lastActivity >= HTTPSERVER_REQUEST_TIMEOUT)
+        {
+            // The client stopped reading, the response is already started
+            close(c);
+        }
+        else if (c.state != ConnectionState_Idle && millis() - c.lastActivity >= HTTPSERVER_REQUEST_TIMEOUT)
+        {
+            reject(c, 408);
+        }
+    }
+}
+
+bool HttpServer::active() const
+{
+    for (uint8_t i = 0; i < HTTPSERVER_MAX_CONNECTIONS; i++)
+    {
+        if (_connections[i].open && _connections[i].state != ConnectionState_Idle)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void HttpServer::accept()
+{
+    WiFiClient incoming = _server.available();
+    if (!incoming)
+    {
+        return;
+    }
+
+    // Free slot, otherwise the connection idle for the longest time makes room
+    Connection *slot = nullptr;
+    for (uint8_t i = 0; i < HTTPSERVER_MAX_CONNECTIONS; i++)
+    {
+        Connection &c = _connections[i];
+        if (!c.open)
+        {
+            slot = &c;
+            break;
+        }
+        if (c.state == ConnectionState_Idle && (slot == nullptr || c.lastActivity < slot->lastActivity))
+        {
+            slot = &c;
+        }
+    }
+
+    if (slot == nullptr)
+    {
+        incoming.stop();
+        return;
+    }
+
+    close(*slot);
+    slot->client = incoming;
+    slot->client.setNoDelay(true);
+    slot->open = true;
+    slot->lastActivity = millis();
+    slot->requests = 0;
+}
+
+void HttpServer::process(Connection &c)
+{
+    // Only what is already received, bounded per pass. A pipelined request waits for the response.
+    if (c.state == ConnectionState_Response)
+    {
+        return;
+    }
+    int available = c.client.available();
+    if (available <= 0)
+    {
+        return;
+    }
+
+    uint8_t buffer[HTTPSERVER_CHUNK_LENGHT];
+    size_t length = c.client.read(buffer, available > HTTPSERVER_CHUNK_LENGHT ? HTTPSERVER_CHUNK_LENGHT : available);
+    c.lastActivity = millis();
+
+    size_t i = 0;
+    while (i < length && c.open)
+    {
+        if (c.state == ConnectionState_Response)
+        {
+            // Already read requests behind a file response are dropped, the client repeats them
+            c.keepAlive = false;
+            return;
+        }
+
+        if (c.state == ConnectionState_Body || c.state == ConnectionState_Upload)
+        {
+            // Bulk copy, a pipelined next request stays in the buffer
+            size_t count = length - i;
+            if (c.lengthKnown && count > c.contentLength - c.received)
+            {
+                count = c.contentLength - c.received;
+            }
+
+            if (c.state == ConnectionState_Body)
+            {
+                memcpy(c.body + c.received, buffer + i, count);
+            }
+            else
+            {
+                uploadData(buffer + i, count);
+            }
+            c.received += count;
+            i += count;
+
+            if (c.lengthKnown && c.received >= c.contentLength)
+            {
+                dispatch(c);
+            }
+        }
+        else if (!processByte(c, buffer[i++]))
+        {
+            return;
+        }
+    }
+}
+
+bool HttpServer::processByte(Connection &c, uint8_t b)
+{
+    if (c.skipLine)
+    {
+        c.skipLine = b != '\n';
+        return true;
+    }
+
+    if (b == '\n')
+    {
+        if (c.lineLength > 0 && c.line[c.lineLength - 1] == '\r')
+        {
+            c.lineLength--;
+        }
+        c.line[c.lineLength] = '\0';
+        bool result = processLine(c);
+        c.lineLength = 0;
+        return result;
+    }
+
+    if (c.lineLength >= HTTPSERVER_LINE_LENGHT - 1)
+    {
+        // Long cookies and the like are not needed here
+        if (c.state == ConnectionState_Headers && !needsHeader(c))
+        {
+            c.skipLine = true;
+            c.lineLength = 0;
+            return true;
+        }
+        reject(c, c.state == ConnectionState_Idle ? 414 : 431);
+        return false;
+    }
+    c.line[c.lineLength++] = b;
+    return true;
+}
+
+bool HttpServer::needsHeader(const Connection &c) const
+{
+    // Name of the partial line, a line without a colon has a name longer than any of these
+    const char *colon = (const char *)memchr(c.line, ':', c.lineLength);
+    if (colon == nullptr)
+    {
+        return false;
+    }
+    size_t length = colon - c.line;
+
+    static const char *const parsed[] = {"Content-Length", "Connection", "Expect", "Transfer-Encoding", "Content-Type"};
+    for (const char *name : parsed)
+    {
+        if (strlen(name) == length && strncasecmp(c.line, name, length) == 0)
+        {
+            return true;
+        }
+    }
+    for (size_t i = 0; i < _headerCount; i++)
+    {
+        if (_headerKeys[i].length() == length && strncasecmp(c.line, _headerKeys[i].c_str(), length) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool HttpServer::processLine(Connection &c)
+{
+    if (c.state == ConnectionState_Idle)
+    {
+        // Empty lines between pipelined requests are allowed
+        if (c.lineLength == 0)
+        {
+            return true;
+        }
+
+        // Request line: METHOD URI HTTP/1.x
+        char *uri = strchr(c.line, ' ');
+        char *version = uri != nullptr ? strchr(uri + 1, ' ') : nullptr;
+        if (version == nullptr)
+        {
+            reject(c, 400);
+            return false;
+        }
+        *uri++ = '\0';
+        *version++ = '\0';
+
+        c.method = parseMethod(c.line);
+        char *query = strchr(uri, '?');
+        if (query != nullptr)
+        {
+            *query++ = '\0';
+            c.query = query;
+        }
+        c.uri = uri;
+        c.keepAlive = strcmp(version, "HTTP/1.1") == 0;
+        c.state = ConnectionState_Headers;
+        return true;
+    }
+
+    if (c.lineLength > 0)
+    {
+        char *value = strchr(c.line, ':');
+        if (value == nullptr)
+        {
+            return true;
+        }
+        *value++ = '\0';
+        while (*value == ' ')
+        {
+            value++;
+        }
+
+        if (strcasecmp(c.line, "Content-Length") == 0)
+        {
+            c.contentLength = strtoul(value, nullptr, 10);
+            c.lengthKnown = true;
+        }
+        else if (strcasecmp(c.line, "Connection") == 0)
+        {
+            if (strcasecmp(value, "close") == 0)
+            {
+                c.keepAlive = false;
+            }
+            else if (strcasecmp(value, "keep-alive") == 0)
+            {
+                c.keepAlive = true;
+            }
+        }
+        else if (strcasecmp(c.line, "Expect") == 0)
+        {
+            c.expectContinue = strcasecmp(value, "100-continue") == 0;
+        }
+        else if (strcasecmp(c.line, "Transfer-Encoding") == 0)
+        {
+            // Chunked bodies are not supported, every client sends a Content-Length for them on request
+            reject(c, 411);
+            return false;
+        }
+        else if (strcasecmp(c.line, "Content-Type") == 0)
+        {
+            char *boundary = strstr(value, "boundary=");
+            if (strncasecmp(value, "multipart/form-data", 19) == 0 && boundary != nullptr)
+            {
+                boundary += 9;
+                if (*boundary == '"')
+                {
+                    boundary++;
+                    char *end = strchr(boundary, '"');
+                    if (end != nullptr)
+                    {
+                        *end = '\0';
+                    }
+                }
+                c.boundary = boundary;
+            }
+        }
+
+        for (size_t i = 0; i < _headerCount; i++)
+        {
+            if (strcasecmp(c.line, _headerKeys[i].c_str()) == 0)
+            {
+                c.headers[i] = value;
+            }
+        }
+        return true;
+    }
+
+    return headersDone(c);
+}
+
+bool HttpServer::headersDone(Connection &c)
+{
+    c.route = -1;
+    for (uint8_t i = 0; i < _routeCount; i++)
+    {
+        if ((_routes[i].method == HttpServerMethod_Any || _routes[i].method == c.method) && c.uri == _routes[i].path)
+        {
+            c.route = i;
+            break;
+        }
+    }
+
+    bool upload = c.route >= 0 && _routes[c.route].uploadHandler != nullptr;
+    if (!c.lengthKnown || c.contentLength == 0)
+    {
+        if (upload && c.method == HttpServerMethod_Post)
+        {
+            reject(c, 411);
+            return false;
+        }
+        dispatch(c);
+        return true;
+    }
+
+    if (upload)
+    {
+        if (_uploadConnection != nullptr)
+        {
+            reject(c, 503);
+            return false;
+        }
+
+        _uploadConnection = &c;
+        _upload.totalSize = 0;
+        _upload.currentSize = 0;
+        _upload.contentLength = c.contentLength;
+        _upload.name = "";
+        _upload.filename = "";
+        _partIsFile = false;
+        if (c.boundary.length() > 0)
+        {
+            // The first boundary has no leading CRLF, start as if it was already matched
+            _delimiter = "\r\n--" + c.boundary;
+            _matched = 2;
+            _partState = PartState_Preamble;
+        }
+        else
+        {
+            _delimiter = "";
+            _partState = PartState_Data;
+            _partIsFile = true;
+            uploadEvent(HttpServerUpload_Start);
+        }
+        c.state = ConnectionState_Upload;
+    }
+    else
+    {
+        if (c.contentLength > HTTPSERVER_BODY_LENGHT)
+        {
+            reject(c, 413);
+            return false;
+        }
+
+        c.body = _acquireBody != nullptr ? _acquireBody(c.contentLength) : (char *)malloc(c.contentLength + 1);
+        if (c.body == nullptr)
+        {
+            reject(c, 503);
+            return false;
+        }
+        c.body[c.contentLength] = '\0';
+        c.state = ConnectionState_Body;
+    }
+
+    if (c.expectContinue)
+    {
+        c.client.print(F("HTTP/1.1 100 Continue\r\n\r\n"));
+    }
+    return true;
+}
+
+void HttpServer::dispatch(Connection &c)
+{
+    if (c.state == ConnectionState_Upload)
+    {
+        if (_partIsFile)
+        {
+            if (c.boundary.length() > 0)
+            {
+                // Body ended inside the file part
+                uploadEvent(HttpServerUpload_Aborted);
+            }
+            else
+            {
+                uploadFlush();
+                uploadEvent(HttpServerUpload_End);
+            }
+        }
+        _uploadConnection = nullptr;
+    }
+
+    _current = &c;
+    _responded = false;
+    _responseHeaders = "";
+
+    if (c.route >= 0)
+    {
+        _routes[c.route].handler();
+    }
+    else if (_notFoundHandler != nullptr)
+    {
+        _notFoundHandler();
+    }
+    else
+    {
+        send(404, F("text/plain"), F("Not Found"));
+    }
+
+    if (!_responded)
+    {
+        send(500, F("text/plain"), F("No response"));
+    }
+    _current = nullptr;
+
+    // A file response finishes in respond()
+    if (c.state != ConnectionState_Response)
+    {
+        finishRequest(c);
+    }
+}
+
+void HttpServer::respond(Connection &c)
+{
+    // Only as much as the send buffer takes, a slow client never blocks the loop
+#if defined(ESP8266)
+    size_t count = c.client.availableForWrite();
+#elif defined(ESP32)
+    size_t count = HTTPSERVER_CHUNK_LENGHT;
+#endif
+    count = count < HTTPSERVER_CHUNK_LENGHT ? count : HTTPSERVER_CHUNK_LENGHT;
+    count = count < c.remaining ? count : c.remaining;
+    if (count == 0)
+    {
+        return;
+    }
+
+    uint8_t buffer[HTTPSERVER_CHUNK_LENGHT];
+    int read = c.file.read(buffer, count);
+    if (read <= 0)
+    {
+        // Shorter than announced, the client only notices by the closed connection
+        c.keepAlive = false;
+        c.remaining = 0;
+    }
+    else
+    {
+        c.client.write(buffer, read);
+        c.remaining -= read;
+        c.lastActivity = millis();
+    }
+
+    if (c.remaining == 0)
+    {
+        finishRequest(c);
+    }
+}
+
+void HttpServer::finishRequest(Connection &c)
+{
+    bool keepAlive = c.keepAlive && ++c.requests < HTTPSERVER_KEEPALIVE_MAX_REQUESTS;
+    if (keepAlive)
+    {
+        reset(c);
+    }
+    else
+    {
+        close(c);
+    }
+}
+
+void HttpServer::reset(Connection &c)
+{
+    if (c.body != nullptr)
+    {
+        if (_releaseBody != nullptr)
+        {
+            _releaseBody(c.body);
+        }
+        else
+        {
+            free(c.body);
+        }
+        c.body = nullptr;
+    }
+    if (c.file)
+    {
+        c.file.close();
+    }
+    c.file = File();
+    c.remaining = 0;
+    c.state = ConnectionState_Idle;
+    c.lineLength = 0;
+    c.skipLine = false;
+    c.method = HttpServerMethod_Other;
+    c.uri = "";
+    c.query = "";
+    for (uint8_t i = 0; i < HTTPSERVER_MAX_HEADERS; i++)
+    {
+        c.headers[i] = "";
+    }
+    c.boundary = "";
+    c.keepAlive = false;
+    c.expectContinue = false;
+    c.lengthKnown = false;
+    c.contentLength = 0;
+    c.received = 0;
+    c.route = -1;
+}
+
+void HttpServer::close(Connection &c)
+{
+    if (_uploadConnection == &c)
+    {
+        uploadAbort();
+    }
+    if (c.open)
+    {
+        c.client.stop();
+        c.open = false;
+    }
+    reset(c);
+}
+
+void HttpServer::reject(Connection &c, int code)
+{
+    if (_uploadConnection == &c)
+    {
+        uploadAbort();
+    }
+
+    _current = &c;
+    _responded = false;
+    _responseHeaders = "";
+    c.keepAlive = false;
+    send(code, F("text/plain"), statusText(code));
+    _current = nullptr;
+    close(c);
+}
+
+void HttpServer::uploadData(const uint8_t *data, size_t length)
+{
+    if (_partState == PartState_Data && _delimiter.length() == 0)
+    {
+        // Raw body, no multipart framing
+        for (size_t i = 0; i < length; i++)
+        {
+            _upload.buf[_upload.currentSize++] = data[i];
+            if (_upload.currentSize == HTTPSERVER_CHUNK_LENGHT)
+            {
+                uploadFlush();
+            }
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < length; i++)
+    {
+        uploadPartByte(data[i]);
+    }
+}
+
+void HttpServer::uploadPartByte(uint8_t b)
+{
+    switch (_partState)
+    {
+    case PartState_Preamble:
+    case PartState_Data:
+        if (b == (uint8_t)_delimiter[_matched])
+        {
+            if (++_matched == _delimiter.length())
+            {
+                if (_partState == PartState_Data && _partIsFile)
+                {
+                    uploadFlush();
+                    uploadEvent(HttpServerUpload_End);
+                    _partIsFile = false;
+                }
+                _matched = 0;
+                _afterDelimiterLength = 0;
+                _partState = PartState_Delimiter;
+            }
+            return;
+        }
+
+        // No delimiter after all, the matched part was data. CR only starts the delimiter.
+        if (_partState == PartState_Data && _partIsFile)
+        {
+            for (uint8_t i = 0; i < _matched; i++)
+            {
+                _upload.buf[_upload.currentSize++] = _delimiter[i];
+                if (_upload.currentSize == HTTPSERVER_CHUNK_LENGHT)
+                {
+                    uploadFlush();
+                }
+            }
+        }
+        _matched = 0;
+        if (b == '\r')
+        {
+            _matched = 1;
+            return;
+        }
+        if (_partState == PartState_Data && _partIsFile)
+        {
+            _upload.buf[_upload.currentSize++] = b;
+            if (_upload.currentSize == HTTPSERVER_CHUNK_LENGHT)
+            {
+                uploadFlush();
+            }
+        }
+        break;
+
+    case PartState_Delimiter:
+        // "--" ends the body, CRLF starts the next part
+        _afterDelimiter[_afterDelimiterLength++] = b;
+        if (_afterDelimiterLength == 2)
+        {
+            if (_afterDelimiter[0] == '-' && _afterDelimiter[1] == '-')
+            {
+                _partState = PartState_Epilogue;
+            }
+            else
+            {
+                _partState = PartState_Headers;
+                _uploadConnection->lineLength = 0;
+                _upload.name = "";
+                _upload.filename = "";
+            }
+        }
+        break;
+
+    case PartState_Headers:
+    {
+        Connection &c = *_uploadConnection;
+        if (b != '\n')
+        {
+            if (c.lineLength < HTTPSERVER_LINE_LENGHT - 1)
+            {
+                c.line[c.lineLength++] = b;
+            }
+            break;
+        }
+
+        if (c.lineLength > 0 && c.line[c.lineLength - 1] == '\r')
+        {
+            c.lineLength--;
+        }
+        c.line[c.lineLength] = '\0';
+        if (c.lineLength > 0)
+        {
+            uploadPartHeader();
+        }
+        else
+        {
+            // Only file parts are passed on, other form fields are skipped
+            _partIsFile = _upload.filename.length() > 0;
+            _partState = PartState_Data;
+            if (_partIsFile)
+            {
+                _upload.totalSize = 0;
+                _upload.currentSize = 0;
+                uploadEvent(HttpServerUpload_Start);
+            }
+        }
+        c.lineLength = 0;
+        break;
+    }
+
+    case PartState_Epilogue:
+        break;
+    }
+}
+
+void HttpServer::uploadPartHeader()
+{
+    // Content-Disposition: form-data; name="firmware"; filename="firmware.bin"
+    char *line = _uploadConnection->line;
+    if (strncasecmp(line, "Content-Disposition:", 20) != 0)
+    {
+        return;
+    }
+
+    const char *keys[] = {" name=\"", "filename=\""};
+    String *values[] = {&_upload.name, &_upload.filename};
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        char *start = strstr(line, keys[i]);
+        if (start != nullptr)
+        {
+            start += strlen(keys[i]);
+            char *end = strchr(start, '"');
+            if (end != nullptr)
+            {
+                *end = '\0';
+                *values[i] = start;
+                *end = '"';
+            }
+        }
+    }
+}
+
+void HttpServer::uploadFlush()
+{
+    if (_upload.currentSize == 0)
+    {
+        return;
+    }
+    _upload.totalSize += _upload.currentSize;
+    uploadEvent(HttpServerUpload_Write);
+    _upload.currentSize = 0;
+}
+
+void HttpServer::uploadEvent(HttpServerUploadStatus status)
+{
+    _upload.status = status;
+    Connection *previous = _current;
+    _current = _uploadConnection;
+    _routes[_uploadConnection->route].uploadHandler();
+    _current = previous;
+}
+
+void HttpServer::uploadAbort()
+{
+    if (_partIsFile)
+    {
+        uploadEvent(HttpServerUpload_Aborted);
+        _partIsFile = false;
+    }
+    _uploadConnection = nullptr;
+}
+
+HttpServerMethod HttpServer::method() const
+{
+    return _current != nullptr ? _current->method : HttpServerMethod_Other;
+}
+
+const String &HttpServer::uri() const
+{
+    return _current->uri;
+}
+
+String HttpServer::arg(const String &name) const
+{
+    if (_current == nullptr)
+    {
+        return String();
+    }
+    if (name == "plain")
+    {
+        return _current->body != nullptr ? String(_current->body) : String();
+    }
+
+    // Query string: a=1&b=2
+    const String &query = _current->query;
+    int start = 0;
+    while (start < (int)query.length())
+    {
+        int end = query.indexOf('&', start);
+        if (end < 0)
+        {
+            end = query.length();
+        }
+        int equals = query.indexOf('=', start);
+        int nameEnd = equals >= 0 && equals < end ? equals : end;
+        if (urlDecode(query.substring(start, nameEnd)) == name)
+        {
+            return nameEnd < end ? urlDecode(query.substring(nameEnd + 1, end)) : String();
+        }
+        start = end + 1;
+    }
+    return String();
+}
+
+bool HttpServer::hasArg(const String &name) const
+{
+    if (_current == nullptr)
+    {
+        return false;
+    }
+    if (name == "plain")
+    {
+        return _current->body != nullptr;
+    }
+
+    const String &query = _current->query;
+    int start = 0;
+    while (start < (int)query.length())
+    {
+        int end = query.indexOf('&', start);
+        if (end < 0)
+        {
+            end = query.length();
+        }
+        int equals = query.indexOf('=', start);
+        int nameEnd = equals >= 0 && equals < end ? equals : end;
+        if (urlDecode(query.substring(start, nameEnd)) == name)
+        {
+            return true;
+        }
+        start = end + 1;
+    }
+    return false;
+}
+
+String HttpServer::header(const String &name) const
+{
+    if (_current != nullptr)
+    {
+        for (size_t i = 0; i < _headerCount; i++)
+        {
+            if (name.equalsIgnoreCase(_headerKeys[i]))
+            {
+                return _current->headers[i];
+            }
+        }
+    }
+    return String();
+}
+
+char *HttpServer::body()
+{
+    return _current != nullptr ? _current->body : nullptr;
+}
+
+size_t HttpServer::bodyLength() const
+{
+    return _current != nullptr && _current->body != nullptr ? _current->contentLength : 0;
+}
+
+HttpServerUpload &HttpServer::upload()
+{
+    return _upload;
+}
+
+void HttpServer::sendHeader(const String &name, const String &value)
+{
+    // The server decides about keep-alive
+    if (name.equalsIgnoreCase("Connection"))
+    {
+        if (_current != nullptr && value.equalsIgnoreCase("close"))
+        {
+            _current->keepAlive = false;
+        }
+        return;
+    }
+    _responseHeaders += name + ": " + value + "\r\n";
+}
+
+void HttpServer::send(int code)
+{
+    writeHead(code, String(), 0);
+}
+
+void HttpServer::send(int code, const String &contentType, const String &content)
+{
+    writeHead(code, contentType, content.length());
+    if (_current != nullptr && _current->method != HttpServerMethod_Head && content.length() > 0)
+    {
+        _current->client.write((const uint8_t *)content.c_str(), content.length());
+    }
+}
+
+void HttpServer::send(int code, const String &contentType, const char *content, size_t contentLength)
+{
+    writeHead(code, contentType, contentLength);
+    if (_current != nullptr && _current->method != HttpServerMethod_Head && contentLength > 0)
+    {
+        _current->client.write((const uint8_t *)content, contentLength);
+    }
+}
+
+void HttpServer::send_P(int code, PGM_P contentType, PGM_P content, size_t contentLength)
+{
+    writeHead(code, String(FPSTR(contentType)), contentLength);
+    if (_current != nullptr && _current->method != HttpServerMethod_Head)
+    {
+#if defined(ESP8266)
+        _current->client.write_P(content, contentLength);
+#elif defined(ESP32)
+        _current->client.write((const uint8_t *)content, contentLength);
+#endif
+    }
+}
+
+void HttpServer::send(int code, const String &contentType, File &content, size_t contentLength)
+{
+    if (_current == nullptr || _responded)
+    {
+        return;
+    }
+    writeHead(code, contentType, contentLength);
+    if (_current->method == HttpServerMethod_Head || contentLength == 0)
+    {
+        return;
+    }
+
+    // The caller's handle is emptied, closing it does not end the transfer
+    _current->file = content;
+    content = File();
+    _current->remaining = contentLength;
+    _current->state = ConnectionState_Response;
+}
+
+void HttpServer::writeHead(int code, const String &contentType, size_t contentLength)
+{
+    if (_current == nullptr || _responded)
+    {
+        return;
+    }
+    _responded = true;
+
+    String head;
+    head.reserve(128 + _responseHeaders.length());
+    head += F("HTTP/1.1 ");
+    head += code;
+    head += ' ';
+    head += statusText(code);
+    head += F("\r\n");
+    if (contentType.length() > 0)
+    {
+        head += F("Content-Type: ");
+        head += contentType;
+        head += F("\r\n");
+    }
+    if (code != 204 && code != 304)
+    {
+        head += F("Content-Length: ");
+        head += contentLength;
+        head += F("\r\n");
+    }
+    if (_current->keepAlive && _current->requests + 1 < HTTPSERVER_KEEPALIVE_MAX_REQUESTS)
+    {
+        head += F("Connection: keep-alive\r\nKeep-Alive: timeout=");
+        head += HTTPSERVER_KEEPALIVE_TIMEOUT / 1000;
+        head += F("\r\n");
+    }
+    else
+    {
+        head += F("Connection: close\r\n");
+    }
+    head += _responseHeaders;
+    head += F("\r\n");
+    _current->client.write((const uint8_t *)head.c_str(), head.length());
+    _responseHeaders = "";
+}
+
+HttpServerMethod HttpServer::parseMethod(const char *method)
+{
+    if (strcmp(method, "GET") == 0)
+    {
+        return HttpServerMethod_Get;
+    }
+    if (strcmp(method, "POST") == 0)
+    {
+        return HttpServerMethod_Post;
+    }
+    if (strcmp(method, "PUT") == 0)
+    {
+        return HttpServerMethod_Put;
+    }
+    if (strcmp(method, "DELETE") == 0)
+    {
+        return HttpServerMethod_Delete;
+    }
+    if (strcmp(method, "OPTIONS") == 0)
+    {
+        return HttpServerMethod_Options;
+    }
+    if (strcmp(method, "HEAD") == 0)
+    {
+        return HttpServerMethod_Head;
+    }
+    return HttpServerMethod_Other;
+}
+
+const char *HttpServer::statusText(int code)
+{
+    switch (code)
+    {
+    case 100:
+        return "Continue";
+    case 200:
+        return "OK";
+    case 204:
+        return "No Content";
+    case 302:
+        return "Found";
+    case 304:
+        return "Not Modified";
+    case 400:
+        return "Bad Request";
+    case 404:
+        return "Not Found";
+    case 406:
+        return "Not Acceptable";
+    case 408:
+        return "Request Timeout";
+    case 411:
+        return "Length Required";
+    case 413:
+        return "Payload Too Large";
+    case 414:
+        return "URI Too Long";
+    case 431:
+        return "Request Header Fields Too Large";
+    case 500:
+        return "Internal Server Error";
+    case 503:
+        return "Service Unavailable";
+    default:
+        return "";
+    }
+}
+
+String HttpServer::urlDecode(const String &text)
+{
+    String result;
+    result.reserve(text.length());
+    for (unsigned int i = 0; i < text.length(); i++)
+    {
+        char c = text[i];
+        if (c == '+')
+        {
+            c = ' ';
+        }
+        else if (c == '%' && i + 2 < text.length() && isxdigit(text[i + 1]) && isxdigit(text[i + 2]))
+        {
+            char hex[3] = {text[i + 1], text[i + 2], '\0'};
+            c = (char)strtol(hex, nullptr, 16);
+            i += 2;
+        }
+        result += c;
+    }
+    return result;
+}
@@ -0,0 +1,448 @@
+#include "HttpTask.h"
+#include <Arduino.h>
+
+#if defined(ESP8266)
+#include <lwip/dns.h>
+#include <lwip/tcp.h>
+#elif defined(ESP32)
+#include <WiFi.h>
+#endif
+
+HttpTask::HttpTask()
+{
+}
+
+void HttpTask::begin(uint32_t timeout)
+{
+    _queueHead = 0;
+    _queueCount = 0;
+    _state = HttpTaskState_Idle;
+    _timeout = timeout;
+#if defined(ESP8266)
+    _pcb = nullptr;
+#elif defined(ESP32)
+    xTaskCreate(workerTask, "HttpTask", 4096, this, 1, &_worker);
+#endif
+}
+
+void HttpTask::setTimeout(uint32_t timeout)
+{
+    _timeout = timeout;
+}
+
+bool HttpTask::get(const char *host, uint16_t port, const char *path, HttpTaskCallback callback)
+{
+    return enqueue(HttpTaskMethod_Get, host, port, path, String(), callback);
+}
+
+bool HttpTask::post(const char *host, uint16_t port, const char *path, const String &body, HttpTaskCallback callback)
+{
+    return enqueue(HttpTaskMethod_Post, host, port, path, body, callback);
+}
+
+bool HttpTask::busy() const
+{
+    return _queueCount > 0;
+}
+
+bool HttpTask::enqueue(HttpTaskMethod method, const char *host, uint16_t port, const char *path, const String &body, HttpTaskCallback callback)
+{
+    if (_queueCount >= HTTPTASK_QUEUE_SIZE || strlen(host) >= HTTPTASK_HOST_LENGHT || strlen(path) >= HTTPTASK_PATH_LENGHT)
+    {
+        return false;
+    }
+
+    HttpTaskRequest &request = _queue[(_queueHead + _queueCount) % HTTPTASK_QUEUE_SIZE];
+    request.method = method;
+    strcpy(request.host, host);
+    request.port = port;
+    strcpy(request.path, path);
+    request.body = body;
+    request.callback = callback;
+    _queueCount++;
+
+    return true;
+}
+
+void HttpTask::loop()
+{
+    if (_queueCount == 0)
+    {
+        return;
+    }
+
+    if (_state == HttpTaskState_Idle)
+    {
+        start();
+        return;
+    }
+
+#if defined(ESP8266)
+    if (_state != HttpTaskState_Done && millis() - _startedAt >= _timeout)
+    {
+        _result = HttpTaskResult_Timeout;
+        close();
+        _state = HttpTaskState_Done;
+    }
+
+    if (_state == HttpTaskState_Connecting && _pcb == nullptr)
+    {
+        connect();
+    }
+    if (_state == HttpTaskState_Sending)
+    {
+        send();
+    }
+#endif
+
+    if (_state == HttpTaskState_Done)
+    {
+        finish();
+    }
+}
+
+void HttpTask::start()
+{
+    HttpTaskRequest &request = _queue[_queueHead];
+
+    // HTTP/1.0 with connection close, the end of the body is the end of the connection (no chunked encoding)
+    _request = String(request.method == HttpTaskMethod_Post ? F("POST ") : F("GET ")) + request.path + F(" HTTP/1.0\r\nHost: ") + request.host + F("\r\nUser-Agent: PixelIt\r\nConnection: close\r\n");
+    if (request.method == HttpTaskMethod_Post)
+    {
+        _request += String(F("Content-Type: application/json\r\nContent-Length: ")) + String(request.body.length()) + F("\r\n");
+    }
+    _request += F("\r\n");
+    _request += request.body;
+    request.body = String();
+
+    _sendOffset = 0;
+    _responseLength = 0;
+    _response[0] = '\0';
+    _receivedLength = 0;
+    _truncated = false;
+    _statusLength = 0;
+    _status[0] = '\0';
+    _lineLength = 0;
+    _lineCount = 0;
+    _headerDone = false;
+    _result = HttpTaskResult_Ok;
+    _startedAt = millis();
+
+#if defined(ESP8266)
+    _state = HttpTaskState_Resolving;
+    err_t err = dns_gethostbyname(request.host, &_address, dnsFound, this);
+    if (err == ERR_OK)
+    {
+        // Cached or IP address
+        _state = HttpTaskState_Connecting;
+        connect();
+    }
+    else if (err != ERR_INPROGRESS)
+    {
+        _result = HttpTaskResult_DnsFailed;
+        _state = HttpTaskState_Done;
+    }
+#elif defined(ESP32)
+    _state = HttpTaskState_Resolving;
+    xTaskNotifyGive(_worker);
+#endif
+}
+
+void HttpTask::finish()
+{
+    HttpTaskRequest &request = _queue[_queueHead];
+    HttpTaskCallback callback = request.callback;
+
+    HttpTaskResponse response;
+    response.result = _result;
+    response.statusCode = -1;
+    response.body = "";
+    response.bodyLength = 0;
+    response.receivedLength = _receivedLength;
+    response.truncated = _truncated;
+
+    // "HTTP/1.1 200 OK", the body only counts after the complete header
+    if (_statusLength > 9 && strncmp(_status, "HTTP/", 5) == 0)
+    {
+        const char *status = strchr(_status, ' ');
+        if (status != nullptr)
+        {
+            response.statusCode = atoi(status + 1);
+        }
+
+        if (_headerDone)
+        {
+            response.body = _response;
+            response.bodyLength = _responseLength;
+        }
+    }
+
+    _request = String();
+    _queueHead = (_queueHead + 1) % HTTPTASK_QUEUE_SIZE;
+    _queueCount--;
+    _state = HttpTaskState_Idle;
+
+    if (callback != nullptr)
+    {
+        callback(response);
+    }
+}
+
+void HttpTask::appendResponse(const char *data, size_t length)
+{
+    // Skip the header, only the start of the status line is kept. Headers can be longer than
+    // the whole buffer (cookies, CSP), they must not push the body out.
+    while (!_headerDone && length > 0)
+    {
+        char c = *data++;
+        length--;
+
+        if (c == '\n')
+        {
+            // An empty line ends the header
+            _headerDone = _lineLength == 0 && _lineCount > 0;
+            _lineLength = 0;
+            _lineCount++;
+        }
+        else if (c != '\r')
+        {
+            if (_lineCount == 0 && _statusLength < HTTPTASK_STATUS_LENGHT - 1)
+            {
+                _status[_statusLength++] = c;
+                _status[_statusLength] = '\0';
+            }
+            _lineLength = _lineLength < UINT16_MAX ? _lineLength + 1 : _lineLength;
+        }
+    }
+
+    _receivedLength += length;
+    size_t space = HTTPTASK_RESPONSE_LENGHT - 1 - _responseLength;
+    if (length > space)
+    {
+        length = space;
+        _truncated = true;
+    }
+
+    memcpy(_response + _responseLength, data, length);
+    _responseLength += length;
+    _response[_responseLength] = '\0';
+}
+
+#if defined(ESP8266)
+
+void HttpTask::connect()
+{
+    _pcb = tcp_new();
+    if (_pcb == nullptr)
+    {
+        // Out of memory, try again on the next loop until the timeout hits
+        return;
+    }
+
+    tcp_arg(_pcb, this);
+    tcp_err(_pcb, tcpError);
+    tcp_recv(_pcb, tcpReceived);
+
+    if (tcp_connect(_pcb, &_address, _queue[_queueHead].port, tcpConnected) != ERR_OK)
+    {
+        _result = HttpTaskResult_ConnectFailed;
+        close();
+        _state = HttpTaskState_Done;
+    }
+}
+
+void HttpTask::send()
+{
+    // Write as much as the send buffer takes, the rest follows on the next loops
+    size_t length = _request.length() - _sendOffset;
+    size_t space = tcp_sndbuf(_pcb);
+    if (length > space)
+    {
+        length = space;
+    }
+
+    if (length > 0 && tcp_write(_pcb, _request.c_str() + _sendOffset, length, TCP_WRITE_FLAG_COPY) == ERR_OK)
+    {
+        _sendOffset += length;
+        tcp_output(_pcb);
+    }
+
+    if (_sendOffset >= _request.length())
+    {
+        _state = HttpTaskState_Receiving;
+    }
+}
+
+void HttpTask::close()
+{
+    if (_pcb == nullptr)
+    {
+        return;
+    }
+
+    tcp_arg(_pcb, nullptr);
+    tcp_err(_pcb, nullptr);
+    tcp_recv(_pcb, nullptr);
+    if (tcp_close(_pcb) != ERR_OK)
+    {
+        tcp_abort(_pcb);
+    }
+    _pcb = nullptr;
+}
+
+void HttpTask::dnsFound(const char *name, const ip_addr_t *address, void *arg)
+{
+    HttpTask *task = static_cast<HttpTask *>(arg);
+
+    // Late answer for a request that already timed out
+    if (task->_state != HttpTaskState_Resolving || strcmp(name, task->_queue[task->_queueHead].host) != 0)
+    {
+        return;
+    }
+
+    if (address == nullptr)
+    {
+        task->_result = HttpTaskResult_DnsFailed;
+        task->_state = HttpTaskState_Done;
+        return;
+    }
+
+    task->_address = *address;
+    // The connect is started from loop(), not from the lwIP context
+    task->_state = HttpTaskState_Connecting;
+}
+
+err_t HttpTask::tcpConnected(void *arg, tcp_pcb *pcb, err_t err)
+{
+    HttpTask *task = static_cast<HttpTask *>(arg);
+    if (task == nullptr)
+    {
+        return ERR_OK;
+    }
+
+    task->_state = HttpTaskState_Sending;
+    return ERR_OK;
+}
+
+err_t HttpTask::tcpReceived(void *arg, tcp_pcb *pcb, pbuf *p, err_t err)
+{
+    HttpTask *task = static_cast<HttpTask *>(arg);
+    if (task == nullptr)
+    {
+        if (p != nullptr)
+        {
+            pbuf_free(p);
+        }
+        return ERR_OK;
+    }
+
+    if (p == nullptr)
+    {
+        // Remote closed the connection, response complete
+        task->close();
+        task->_state = HttpTaskState_Done;
+        return ERR_OK;
+    }
+
+    for (pbuf *q = p; q != nullptr; q = q->next)
+    {
+        task->appendResponse(static_cast<const char *>(q->payload), q->len);
+    }
+    tcp_recved(pcb, p->tot_len);
+    pbuf_free(p);
+
+    return ERR_OK;
+}
+
+void HttpTask::tcpError(void *arg, err_t err)
+{
+    HttpTask *task = static_cast<HttpTask *>(arg);
+    if (task == nullptr)
+    {
+        return;
+    }
+
+    // The pcb is already freed by lwIP
+    task->_pcb = nullptr;
+    if (task->_state == HttpTaskState_Connecting)
+    {
+        task->_result = HttpTaskResult_ConnectFailed;
+    }
+    else if (task->_state != HttpTaskState_Receiving)
+    {
+        task->_result = HttpTaskResult_Aborted;
+    }
+    task->_state = HttpTaskState_Done;
+}
+
+#elif defined(ESP32)
+
+void HttpTask::workerTask(void *arg)
+{
+    HttpTask *task = static_cast<HttpTask *>(arg);
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        task->work();
+    }
+}
+
+void HttpTask::work()
+{
+    // Runs in the worker task, blocking is fine here. loop() only looks at the request again once _state is done.
+    const HttpTaskRequest &request = _queue[_queueHead];
+    WiFiClient client;
+
+    IPAddress address;
+    if (!WiFi.hostByName(request.host, address))
+    {
+        _result = HttpTaskResult_DnsFailed;
+        _state = HttpTaskState_Done;
+        return;
+    }
+
+    _state = HttpTaskState_Connecting;
+    if (!client.connect(address, request.port, _timeout))
+    {
+        _result = HttpTaskResult_ConnectFailed;
+        _state = HttpTaskState_Done;
+        return;
+    }
+
+    _state = HttpTaskState_Sending;
+    client.print(_request);
+
+    _state = HttpTaskState_Receiving;
+    char buffer[128];
+    while (true)
+    {
+        if (millis() - _startedAt >= _timeout)
+        {
+            _result = HttpTaskResult_Timeout;
+            break;
+        }
+
+        int available = client.available();
+        if (available > 0)
+        {
+            int length = client.read(reinterpret_cast<uint8_t *>(buffer), min(available, (int)sizeof(buffer)));
+            if (length > 0)
+            {
+                appendResponse(buffer, length);
+            }
+        }
+        else if (!client.connected())
+        {
+            break;
+        }
+        else
+        {
+            vTaskDelay(pdMS_TO_TICKS(10));
+        }
+    }
+
+    client.stop();
+    _state = HttpTaskState_Done;
+}
+
+#endif
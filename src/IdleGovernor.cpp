@@ -0,0 +1,191 @@
+#include "IdleGovernor.h"
+#if defined(ESP8266)
+#include <ESP8266WiFi.h>
+extern "C"
+{
+#include "user_interface.h"
+}
+#elif defined(ESP32)
+#include <WiFi.h>
+#endif
+
+IdleGovernor::IdleGovernor()
+{
+    _enabled = false;
+}
+
+void IdleGovernor::begin(bool enabled, bool lightSleep)
+{
+    _enabled = enabled;
+    _lightSleep = lightSleep;
+    _displayOff = false;
+    _batteryLevel = -1;
+    // Start busy, the first seconds after boot are full of requests
+    _state = IdleState_Busy;
+    _applied = IdleState_Busy;
+    _busySince = millis();
+    _animatingSince = millis();
+    _hasDeadline = false;
+
+    _windowStart = millis();
+    _windowSlept = 0;
+    _windowCharge = 0;
+    _lastLoop = millis();
+    _residency = 0;
+    _current = IDLE_CURRENT_AWAKE;
+
+    if (_enabled)
+    {
+        apply(IdleState_Busy);
+    }
+}
+
+void IdleGovernor::busy()
+{
+    _busySince = millis();
+}
+
+void IdleGovernor::animating(uint32_t deadline)
+{
+    _animatingSince = millis();
+    // Keep the earliest deadline of the loop
+    if (!_hasDeadline || (int32_t)(deadline - _deadline) < 0)
+    {
+        _deadline = deadline;
+        _hasDeadline = true;
+    }
+}
+
+void IdleGovernor::setDisplayOff(bool displayOff)
+{
+    _displayOff = displayOff;
+}
+
+void IdleGovernor::setBatteryLevel(int8_t level)
+{
+    _batteryLevel = level;
+}
+
+uint16_t IdleGovernor::frameInterval() const
+{
+    if (!_enabled || _batteryLevel < 0)
+    {
+        return 0;
+    }
+    if (_batteryLevel <= IDLE_BATTERY_LOW)
+    {
+        return IDLE_BATTERY_LOW_FRAME_INTERVAL;
+    }
+    if (_batteryLevel <= IDLE_BATTERY_MEDIUM)
+    {
+        return IDLE_BATTERY_MEDIUM_FRAME_INTERVAL;
+    }
+    return 0;
+}
+
+void IdleGovernor::loop()
+{
+    uint32_t start = millis();
+    _windowCharge += (start - _lastLoop) * IDLE_CURRENT_AWAKE;
+
+    if (_enabled)
+    {
+        if (start - _busySince < IDLE_ENTER_DELAY)
+        {
+            _state = IdleState_Busy;
+        }
+        else if (_displayOff)
+        {
+            _state = IdleState_DisplayOff;
+        }
+        else if (start - _animatingSince < IDLE_ENTER_DELAY)
+        {
+            _state = IdleState_Animating;
+        }
+        else
+        {
+            _state = IdleState_Idle;
+        }
+
+        if (_state != _applied)
+        {
+            apply(_state);
+        }
+
+        if (_state != IdleState_Busy)
+        {
+            int32_t sleep = _state == IdleState_DisplayOff ? IDLE_MAX_SLEEP_DISPLAY_OFF : IDLE_MAX_SLEEP;
+            if (_hasDeadline && (int32_t)(_deadline - start) < sleep)
+            {
+                sleep = (int32_t)(_deadline - start);
+            }
+            if (sleep > 0)
+            {
+                // delay() hands the time to the WiFi stack, which power saves in the meantime
+                delay(sleep);
+                uint32_t slept = millis() - start;
+                _windowSlept += slept;
+                _windowCharge += slept * sleepCurrent();
+            }
+        }
+    }
+    _hasDeadline = false;
+    _lastLoop = millis();
+
+    uint32_t elapsed = _lastLoop - _windowStart;
+    if (elapsed >= IDLE_STATISTICS_WINDOW)
+    {
+        _residency = _windowSlept * 100 / elapsed;
+        _current = _windowCharge / elapsed;
+        _windowStart = _lastLoop;
+        _windowSlept = 0;
+        _windowCharge = 0;
+    }
+}
+
+IdleState IdleGovernor::state() const
+{
+    return _state;
+}
+
+uint8_t IdleGovernor::sleepResidency() const
+{
+    return _residency;
+}
+
+uint16_t IdleGovernor::currentEstimate() const
+{
+    return _current;
+}
+
+void IdleGovernor::apply(IdleState state)
+{
+    _applied = state;
+    uint8_t cpuMHz = state == IdleState_Idle || state == IdleState_DisplayOff ? IDLE_CPU_MHZ : IDLE_BUSY_CPU_MHZ;
+
+#if defined(ESP8266)
+    WiFi.setSleepMode(state == IdleState_Busy ? WIFI_NONE_SLEEP : (state == IdleState_DisplayOff && _lightSleep ? WIFI_LIGHT_SLEEP : WIFI_MODEM_SLEEP));
+    if (ESP.getCpuFreqMHz() != cpuMHz)
+    {
+        system_update_cpu_freq(cpuMHz);
+    }
+#elif defined(ESP32)
+    // Light sleep needs power management in the IDF build, modem sleep only here
+    WiFi.setSleep(state != IdleState_Busy);
+    if (getCpuFrequencyMhz() != cpuMHz)
+    {
+        setCpuFrequencyMhz(cpuMHz);
+    }
+#endif
+}
+
+uint16_t IdleGovernor::sleepCurrent() const
+{
+#if defined(ESP8266)
+    if (_state == IdleState_DisplayOff && _lightSleep)
+    {
+        return IDLE_CURRENT_LIGHT_SLEEP;
+    }
+#endif
+    return IDLE_CURRENT_MODEM_SLEEP;
+}
@@ -0,0 +1,370 @@
+#include "JsonWriter.h"
+
+JsonWriter::JsonWriter(char *buffer, size_t size, size_t headroom)
+{
+    _buffer = buffer;
+    _size = size;
+    _headroom = headroom < size ? headroom : size - 1;
+    reset();
+}
+
+void JsonWriter::reset()
+{
+    _length = _headroom;
+    _documentStart = _headroom;
+    _documentEnd = 0;
+    _depth = 0;
+    _first = 1;
+    _afterKey = false;
+    _overflowed = false;
+    _buffer[_length] = '\0';
+}
+
+void JsonWriter::beginObject()
+{
+    separator();
+    push('{');
+}
+
+void JsonWriter::endObject()
+{
+    pop('}');
+}
+
+void JsonWriter::beginArray()
+{
+    separator();
+    push('[');
+}
+
+void JsonWriter::endArray()
+{
+    pop(']');
+}
+
+void JsonWriter::beginEnvelope(const char *name)
+{
+    beginObject();
+    key(name);
+    _documentStart = _length;
+}
+
+void JsonWriter::endEnvelope()
+{
+    _documentEnd = _length;
+    endObject();
+}
+
+void JsonWriter::key(const char *name)
+{
+    separator();
+    writeString(name, strlen(name));
+    write(':');
+    _afterKey = true;
+}
+
+void JsonWriter::value(const char *value)
+{
+    separator();
+    writeString(value, strlen(value));
+}
+
+void JsonWriter::value(const String &value)
+{
+    separator();
+    writeString(value.c_str(), value.length());
+}
+
+void JsonWriter::value(int value)
+{
+    separator();
+    writeSigned(value);
+}
+
+void JsonWriter::value(unsigned int value)
+{
+    separator();
+    writeUnsigned(value);
+}
+
+void JsonWriter::value(long value)
+{
+    separator();
+    writeSigned(value);
+}
+
+void JsonWriter::value(unsigned long value)
+{
+    separator();
+    writeUnsigned(value);
+}
+
+void JsonWriter::value(double value, uint8_t decimals)
+{
+    // Fixed point, the digits after the point are an integer
+    decimals = decimals < 6 ? decimals : 6;
+    if (isnan(value) || isinf(value) || value >= 4e9 || value <= -4e9)
+    {
+        null();
+        return;
+    }
+    separator();
+
+    uint32_t scale = 1;
+    for (uint8_t i = 0; i < decimals; i++)
+    {
+        scale *= 10;
+    }
+    bool negative = value < 0;
+    double rounded = (negative ? -value : value) * scale + 0.5;
+    uint32_t integer = rounded / scale;
+    uint32_t fraction = rounded - (double)integer * scale;
+    if (fraction >= scale)
+    {
+        integer++;
+        fraction -= scale;
+    }
+    while (decimals > 0 && fraction % 10 == 0)
+    {
+        fraction /= 10;
+        scale /= 10;
+        decimals--;
+    }
+
+    if (negative && (integer > 0 || fraction > 0))
+    {
+        write('-');
+    }
+    writeUnsigned(integer);
+    if (decimals > 0)
+    {
+        write('.');
+        // Leading zeros of the fraction
+        for (uint32_t limit = scale / 10; limit > 1 && fraction < limit; limit /= 10)
+        {
+            write('0');
+        }
+        writeUnsigned(fraction);
+    }
+}
+
+void JsonWriter::value(bool value)
+{
+    separator();
+    if (value)
+    {
+        write("true", 4);
+    }
+    else
+    {
+        write("false", 5);
+    }
+}
+
+void JsonWriter::null()
+{
+    separator();
+    write("null", 4);
+}
+
+void JsonWriter::raw(const char *json, size_t length)
+{
+    separator();
+    write(json, length);
+}
+
+void JsonWriter::raw(Stream &json, size_t length)
+{
+    separator();
+    if (_length + length >= _size)
+    {
+        _overflowed = true;
+        length = _size - 1 - _length;
+    }
+    _length += json.readBytes(_buffer + _length, length);
+    _buffer[_length] = '\0';
+}
+
+void JsonWriter::extend()
+{
+    while (_length > _headroom && (_buffer[_length - 1] == ' ' || _buffer[_length - 1] == '\n' || _buffer[_length - 1] == '\r'))
+    {
+        _length--;
+    }
+    if (_length == _headroom || _buffer[_length - 1] != '}' || _depth + 1 >= JSONWRITER_MAX_DEPTH)
+    {
+        return;
+    }
+    _length--;
+    _depth++;
+    // Empty object
+    if (_buffer[_length - 1] == '{')
+    {
+        _first |= 1 << _depth;
+    }
+    else
+    {
+        _first &= ~(1 << _depth);
+    }
+    _buffer[_length] = '\0';
+}
+
+const char *JsonWriter::c_str() const
+{
+    return _buffer + _headroom;
+}
+
+size_t JsonWriter::length() const
+{
+    return _length - _headroom;
+}
+
+const char *JsonWriter::document() const
+{
+    return _buffer + _documentStart;
+}
+
+size_t JsonWriter::documentLength() const
+{
+    return (_documentEnd > 0 ? _documentEnd : _length) - _documentStart;
+}
+
+char *JsonWriter::frame()
+{
+    return _buffer;
+}
+
+bool JsonWriter::overflowed() const
+{
+    return _overflowed;
+}
+
+void JsonWriter::separator()
+{
+    // A value after a key belongs to it
+    if (_afterKey)
+    {
+        _afterKey = false;
+        return;
+    }
+    if (_first & (1 << _depth))
+    {
+        _first &= ~(1 << _depth);
+    }
+    else
+    {
+        write(',');
+    }
+}
+
+void JsonWriter::write(char c)
+{
+    if (_length + 1 >= _size)
+    {
+        _overflowed = true;
+        return;
+    }
+    _buffer[_length++] = c;
+    _buffer[_length] = '\0';
+}
+
+void JsonWriter::write(const char *text, size_t length)
+{
+    if (_length + length >= _size)
+    {
+        _overflowed = true;
+        length = _size - 1 - _length;
+    }
+    memcpy(_buffer + _length, text, length);
+    _length += length;
+    _buffer[_length] = '\0';
+}
+
+void JsonWriter::writeString(const char *text, size_t length)
+{
+    static const char hex[] = "0123456789abcdef";
+    write('"');
+    size_t start = 0;
+    for (size_t i = 0; i < length; i++)
+    {
+        uint8_t c = text[i];
+        if (c >= 0x20 && c != '"' && c != '\\')
+        {
+            continue;
+        }
+        // Runs without escapes are copied at once
+        write(text + start, i - start);
+        start = i + 1;
+        write('\\');
+        switch (c)
+        {
+        case '"':
+        case '\\':
+            write(c);
+            break;
+        case '\n':
+            write('n');
+            break;
+        case '\r':
+            write('r');
+            break;
+        case '\t':
+            write('t');
+            break;
+        default:
+            write("u00", 3);
+            write(hex[c >> 4]);
+            write(hex[c & 0x0F]);
+            break;
+        }
+    }
+    write(text + start, length - start);
+    write('"');
+}
+
+void JsonWriter::writeUnsigned(unsigned long value)
+{
+    char digits[20];
+    uint8_t count = 0;
+    do
+    {
+        digits[count++] = '0' + value % 10;
+        value /= 10;
+    } while (value > 0);
+    while (count > 0)
+    {
+        write(digits[--count]);
+    }
+}
+
+void JsonWriter::writeSigned(long value)
+{
+    if (value < 0)
+    {
+        write('-');
+        writeUnsigned(-(unsigned long)value);
+    }
+    else
+    {
+        writeUnsigned(value);
+    }
+}
+
+void JsonWriter::push(char c)
+{
+    write(c);
+    if (_depth + 1 < JSONWRITER_MAX_DEPTH)
+    {
+        _depth++;
+        _first |= 1 << _depth;
+    }
+}
+
+void JsonWriter::pop(char c)
+{
+    if (_depth > 0)
+    {
+        _depth--;
+    }
+    write(c);
+}
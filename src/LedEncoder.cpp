@@ -0,0 +1,30 @@
+#include "LedEncoder.h"
+
+#define LEDENCODER_RMT_ITEM(high, low) ((uint32_t)(high) | (1UL << 15) | ((uint32_t)(low) << 16))
+
+// Character for two LED bits (first bit << 1 | second bit). The inverted start bit is the
+// high slot of the first LED bit, inverted data bits are high when 0, the stop bit is low.
+static const uint8_t ledUartChars[4] = {0b110111, 0b000111, 0b110100, 0b000100};
+
+void LEDENCODER_ATTR LedEncodeRmt(const uint8_t *data, size_t length, uint32_t *items)
+{
+    const uint32_t zero = LEDENCODER_RMT_ITEM(LEDENCODER_RMT_T0H, LEDENCODER_RMT_T0L);
+    const uint32_t one = LEDENCODER_RMT_ITEM(LEDENCODER_RMT_T1H, LEDENCODER_RMT_T1L);
+    for (size_t i = 0; i < length; i++)
+    {
+        uint8_t value = data[i];
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            *items++ = (value & 0x80) ? one : zero;
+            value <<= 1;
+        }
+    }
+}
+
+void LEDENCODER_ATTR LedEncodeUart(uint8_t value, uint8_t *chars)
+{
+    chars[0] = ledUartChars[(value >> 6) & 3];
+    chars[1] = ledUartChars[(value >> 4) & 3];
+    chars[2] = ledUartChars[(value >> 2) & 3];
+    chars[3] = ledUartChars[value & 3];
+}
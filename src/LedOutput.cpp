@@ -0,0 +1,153 @@
+#if defined(LED_OUTPUT_DMA)
+#include "LedOutput.h"
+
+#if defined(ESP8266)
+#include <esp8266_peri.h>
+
+static const uint8_t *volatile ledOutputData = nullptr;
+static volatile size_t ledOutputRemaining = 0;
+static volatile uint32_t ledOutputDoneMicros = 0;
+
+static inline uint8_t IRAM_ATTR LedOutputFifoCount()
+{
+    return (USS(UART1) >> USTXC) & 0xFF;
+}
+
+static void IRAM_ATTR LedOutputFill()
+{
+    uint8_t chars[LEDENCODER_UART_CHARS_PER_BYTE];
+    while (ledOutputRemaining > 0 && LedOutputFifoCount() <= LEDOUTPUT_UART_FIFO_LENGHT - LEDENCODER_UART_CHARS_PER_BYTE)
+    {
+        LedEncodeUart(*ledOutputData++, chars);
+        USF(UART1) = chars[0];
+        USF(UART1) = chars[1];
+        USF(UART1) = chars[2];
+        USF(UART1) = chars[3];
+        ledOutputRemaining--;
+    }
+    if (ledOutputRemaining == 0)
+    {
+        // Done when the FIFO has drained, 2.5 us per character
+        USIE(UART1) &= ~(1 << UIFE);
+        ledOutputDoneMicros = micros() + LedOutputFifoCount() * 5 / 2;
+    }
+}
+
+static void IRAM_ATTR LedOutputIsr(void *arg)
+{
+    if (USIS(UART1) & (1 << UIFE))
+    {
+        LedOutputFill();
+    }
+    USIC(UART1) = 0xFFFF;
+    USIC(UART0) = 0xFFFF;
+}
+
+#elif defined(ESP32)
+#include <driver/rmt.h>
+
+static volatile bool ledOutputSending = false;
+static volatile uint32_t ledOutputDoneMicros = 0;
+
+// Called by the RMT driver (also from its interrupt) whenever it needs items
+static void IRAM_ATTR LedOutputTranslate(const void *src, rmt_item32_t *dest, size_t srcSize, size_t wanted, size_t *translated, size_t *itemCount)
+{
+    size_t length = wanted / 8 < srcSize ? wanted / 8 : srcSize;
+    LedEncodeRmt((const uint8_t *)src, length, (uint32_t *)dest);
+    *translated = length;
+    *itemCount = length * 8;
+}
+
+static void IRAM_ATTR LedOutputDone(rmt_channel_t channel, void *arg)
+{
+    ledOutputDoneMicros = micros();
+    ledOutputSending = false;
+}
+#endif
+
+LedOutput::LedOutput()
+{
+#if defined(ESP8266)
+    static_assert(MATRIX_PIN == 2, "LED_OUTPUT_DMA on ESP8266 needs the matrix on GPIO2 (UART1 TX)");
+#endif
+    _next = 0;
+}
+
+void LedOutput::init()
+{
+#if defined(ESP8266)
+    // Inverted TX: idle low, the start bit is the high part of every LED bit
+    Serial1.begin(LEDENCODER_UART_BAUD, SERIAL_6N1, SERIAL_TX_ONLY);
+    USC0(UART1) |= (1 << UCTXI);
+    USC1(UART1) = (LEDOUTPUT_UART_FIFO_THRESHOLD << UCFET);
+    USIE(UART1) = 0;
+    USIC(UART1) = 0xFFFF;
+
+    ETS_UART_INTR_DISABLE();
+    ETS_UART_INTR_ATTACH(LedOutputIsr, nullptr);
+    USIE(UART0) = 0;
+    ETS_UART_INTR_ENABLE();
+#elif defined(ESP32)
+    rmt_config_t config = RMT_DEFAULT_CONFIG_TX((gpio_num_t)MATRIX_PIN, LEDOUTPUT_RMT_CHANNEL);
+    config.clk_div = 2; // 40 MHz, see LEDENCODER_RMT_*
+    rmt_config(&config);
+    rmt_driver_install(LEDOUTPUT_RMT_CHANNEL, 0, 0);
+    rmt_translator_init(LEDOUTPUT_RMT_CHANNEL, LedOutputTranslate);
+    rmt_register_tx_end_callback(LedOutputDone, nullptr);
+#endif
+}
+
+void LedOutput::showPixels(PixelController<GRB> &pixels)
+{
+    // Encode into the buffer that is not being sent, overlapping the previous transfer
+    uint8_t *data = _buffers[_next];
+    size_t length = 0;
+    while (pixels.has(1) && length + 3 <= LEDOUTPUT_BUFFER_LENGHT)
+    {
+        data[length++] = pixels.loadAndScale0();
+        data[length++] = pixels.loadAndScale1();
+        data[length++] = pixels.loadAndScale2();
+        pixels.advanceData();
+        pixels.stepDithering();
+    }
+
+    waitDone();
+    start(data, length);
+    _next ^= 1;
+}
+
+bool LedOutput::busy() const
+{
+#if defined(ESP8266)
+    return ledOutputRemaining > 0 || (int32_t)(micros() - ledOutputDoneMicros) < 0;
+#elif defined(ESP32)
+    return ledOutputSending;
+#endif
+}
+
+void LedOutput::waitDone()
+{
+    while (busy())
+    {
+        yield();
+    }
+    while ((int32_t)(micros() - ledOutputDoneMicros) < LEDOUTPUT_RESET_MICROS)
+    {
+    }
+}
+
+void LedOutput::start(const uint8_t *data, size_t length)
+{
+#if defined(ESP8266)
+    ledOutputData = data;
+    ledOutputRemaining = length;
+    // The FIFO is below the threshold, the interrupt fires right away
+    USIC(UART1) = 0xFFFF;
+    USIE(UART1) |= (1 << UIFE);
+#elif defined(ESP32)
+    ledOutputSending = true;
+    rmt_write_sample(LEDOUTPUT_RMT_CHANNEL, data, length, false);
+#endif
+}
+
+#endif
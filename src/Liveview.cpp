@@ -1,13 +1,15 @@
 #include "Liveview.h"
 #include <Arduino.h>
 
+static const char HEX_DIGITS[] = "0123456789ABCDEF";
+
 Liveview::Liveview()
 {
 }
 
-void Liveview::begin(FastLED_NeoMatrix *matrix, CRGB *leds, uint16_t interval)
+void Liveview::begin(const uint16_t *map, CRGB *leds, uint16_t interval)
 {
-    this->_matrix = matrix;
+    _map = map;
     _leds = leds;
     _interval = interval;
     _lastUpdate = millis();
@@ -36,13 +38,15 @@ void Liveview::fillBuffer()
     // set prefix
     memcpy(_liveviewBuffer, _LIVEVIEW_PREFIX, _LIVEVIEW_PREFIX_LENGHT);
 
-    // fill buffer with led values
-    for (int y = 0; y < MATRIX_HEIGHT; y++)
+    // fill buffer with led values, pixels in rows (the map is in the same order)
+    char *out = &_liveviewBuffer[_LIVEVIEW_PREFIX_LENGHT];
+    for (int i = 0; i < MATRIX_WIDTH * MATRIX_HEIGHT; i++)
     {
-        for (int x = 0; x < MATRIX_WIDTH; x++)
+        const CRGB &led = _leds[_map[i]];
+        for (uint8_t c = 0; c < 3; c++)
         {
-            int index = this->_matrix->XY(x, y);
-            sprintf(&_liveviewBuffer[(y * MATRIX_WIDTH + x) * 6 + _LIVEVIEW_PREFIX_LENGHT], "%02X%02X%02X", _leds[index].r, _leds[index].g, _leds[index].b);
+            *out++ = HEX_DIGITS[led.raw[c] >> 4];
+            *out++ = HEX_DIGITS[led.raw[c] & 0x0F];
         }
     }
 
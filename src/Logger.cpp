@@ -0,0 +1,170 @@
+#include "Logger.h"
+#if defined(ESP8266)
+#include <ESP8266WiFi.h>
+#elif defined(ESP32)
+#include <WiFi.h>
+#endif
+#include <TimeLib.h>
+
+static const char *const logLevelNames[] = {"debug", "info", "warning", "error"};
+// Syslog severities (RFC 5424) of the levels
+static const uint8_t logLevelSeverities[] = {7, 6, 4, 3};
+
+Logger::Logger()
+{
+    _written = 0;
+    _delivered = 0;
+    _dropped = 0;
+    _deferred = false;
+    callbackFunction = nullptr;
+    _syslogPort = 514;
+}
+
+void Logger::setCallback(void (*func)(const String &payload))
+{
+    callbackFunction = func;
+}
+
+void Logger::setSyslog(const String &server, uint16_t port, const String &hostname)
+{
+    _syslogServer = server;
+    _syslogPort = port;
+    _hostname = hostname;
+}
+
+void Logger::setDeferred(bool deferred)
+{
+    _deferred = deferred;
+}
+
+void Logger::logf(LogLevel level, const __FlashStringHelper *module, PGM_P format, ...)
+{
+    if (level < LOG_LEVEL)
+        return;
+    LogRecord &record = next(level);
+    strncpy_P(record.module, (const char *)module, LOG_MODULE_LENGHT - 1);
+    va_list args;
+    va_start(args, format);
+    vsnprintf_P(record.message, LOG_MESSAGE_LENGHT, format, args);
+    va_end(args);
+    commit();
+}
+
+void Logger::loop()
+{
+    if (_written - _delivered > LOG_RECORDS)
+    {
+        _dropped += _written - _delivered - LOG_RECORDS;
+        _delivered = _written - LOG_RECORDS;
+    }
+    if (_dropped > 0)
+    {
+        Serial.printf("[Logger] %u messages dropped\n", (unsigned int)_dropped);
+        _dropped = 0;
+    }
+
+    for (uint8_t i = 0; i < LOG_DELIVER_PER_LOOP && _delivered != _written; i++)
+    {
+        deliver(_records[_delivered % LOG_RECORDS]);
+        _delivered++;
+    }
+}
+
+String Logger::history()
+{
+    uint32_t first = _written > LOG_RECORDS ? _written - LOG_RECORDS : 0;
+    char timeStamp[20];
+    String result;
+    result.reserve((_written - first) * 80 + 16);
+    result += F("{\"log\":[");
+    for (uint32_t i = first; i < _written; i++)
+    {
+        const LogRecord &record = _records[i % LOG_RECORDS];
+        formatTimeStamp(record, timeStamp);
+        if (i != first)
+        {
+            result += ',';
+        }
+        appendJson(result, record, timeStamp);
+    }
+    result += F("]}");
+    return result;
+}
+
+void Logger::deliver(const LogRecord &record)
+{
+    char timeStamp[20];
+    formatTimeStamp(record, timeStamp);
+
+    Serial.printf("[%s] %s: %s\n", timeStamp, record.module, record.message);
+
+    if (callbackFunction)
+    {
+        String payload;
+        payload.reserve(strlen(record.module) + strlen(record.message) + 80);
+        payload += F("{\"log\":");
+        appendJson(payload, record, timeStamp);
+        payload += '}';
+        callbackFunction(payload);
+    }
+
+    if (_syslogServer.length() > 0 && WiFi.status() == WL_CONNECTED)
+    {
+        // RFC 5424, facility user
+        char header[32];
+        snprintf(header, sizeof(header), "<%u>1 %sZ ", 8 + logLevelSeverities[record.level], timeStamp);
+        if (_udp.beginPacket(_syslogServer.c_str(), _syslogPort))
+        {
+            _udp.print(header);
+            _udp.print(_hostname);
+            _udp.print(F(" PixelIt - - - "));
+            _udp.print(record.module);
+            _udp.print(F(": "));
+            _udp.print(record.message);
+            _udp.endPacket();
+        }
+    }
+}
+
+void Logger::formatTimeStamp(const LogRecord &record, char *buffer)
+{
+    // Records only keep millis(), the wall clock is taken back from now
+    time_t t = now() - (millis() - record.millis) / 1000;
+    snprintf(buffer, 20, "%04d-%02d-%02dT%02d:%02d:%02d", year(t), month(t), day(t), hour(t), minute(t), second(t));
+}
+
+void Logger::appendJson(String &target, const LogRecord &record, const char *timeStamp)
+{
+    target += F("{\"timeStamp\":\"");
+    target += timeStamp;
+    target += F("\",\"level\":\"");
+    target += logLevelNames[record.level];
+    target += F("\",\"function\":\"");
+    appendEscaped(target, record.module);
+    target += F("\",\"message\":\"");
+    appendEscaped(target, record.message);
+    target += F("\"}");
+}
+
+void Logger::appendEscaped(String &target, const char *text)
+{
+    for (; *text; text++)
+    {
+        char c = *text;
+        if (c == '"' || c == '\\')
+        {
+            target += '\\';
+            target += c;
+        }
+        else if ((uint8_t)c < 0x20)
+        {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            target += escaped;
+        }
+        else
+        {
+            target += c;
+        }
+    }
+}
@@ -0,0 +1,203 @@
+#include "MemoryBudget.h"
+
+static const char *const levelNames[] = {"normal", "tight", "low", "critical"};
+static const size_t messageLimits[] = {MEMORY_MESSAGE_LENGHT, MEMORY_MESSAGE_LENGHT, MEMORY_LOW_MESSAGE_LENGHT, MEMORY_CRITICAL_MESSAGE_LENGHT};
+
+MemoryBudget::MemoryBudget()
+{
+    _level = MemoryLevel_Normal;
+    _pool = nullptr;
+    _poolUsed = false;
+    _rejected = 0;
+    _levelChanges = 0;
+    _allocated = 0;
+    callbackFunction = nullptr;
+}
+
+void MemoryBudget::begin()
+{
+    // As early as possible, later the heap may not have a block this large
+    if (_pool == nullptr)
+    {
+        _pool = (char *)malloc(MEMORY_MESSAGE_POOL_LENGHT + 1);
+    }
+    _poolUsed = false;
+    _freeHeapMin = UINT32_MAX;
+    _maxBlockMin = UINT32_MAX;
+    sample();
+}
+
+void MemoryBudget::setCallback(void (*func)(MemoryLevel level))
+{
+    callbackFunction = func;
+}
+
+void MemoryBudget::loop()
+{
+    if (millis() - _lastSample >= MEMORY_SAMPLE_INTERVAL)
+    {
+        sample();
+    }
+}
+
+MemoryLevel MemoryBudget::level() const
+{
+    return _level;
+}
+
+bool MemoryBudget::liveviewAllowed() const
+{
+    return _level < MemoryLevel_Tight;
+}
+
+bool MemoryBudget::logStreamAllowed() const
+{
+    return _level < MemoryLevel_Critical;
+}
+
+size_t MemoryBudget::messageLimit() const
+{
+    return messageLimits[_level];
+}
+
+bool MemoryBudget::acceptMessage(size_t length)
+{
+    if (length <= messageLimit())
+    {
+        return true;
+    }
+    _rejected++;
+    return false;
+}
+
+char *MemoryBudget::acquireMessage(size_t length)
+{
+    if (!acceptMessage(length))
+    {
+        return nullptr;
+    }
+    if (_pool != nullptr && !_poolUsed && length <= MEMORY_MESSAGE_POOL_LENGHT)
+    {
+        _poolUsed = true;
+        return _pool;
+    }
+
+    char *buffer = (char *)malloc(length + 1);
+    if (buffer == nullptr)
+    {
+        _rejected++;
+        // The level is probably out of date
+        sample();
+        return nullptr;
+    }
+    _allocated++;
+    return buffer;
+}
+
+void MemoryBudget::releaseMessage(char *buffer)
+{
+    if (buffer == _pool)
+    {
+        _poolUsed = false;
+    }
+    else
+    {
+        free(buffer);
+    }
+}
+
+uint32_t MemoryBudget::freeHeap() const
+{
+    return _freeHeap;
+}
+
+uint32_t MemoryBudget::freeHeapMin() const
+{
+    return _freeHeapMin;
+}
+
+uint32_t MemoryBudget::maxBlock() const
+{
+    return _maxBlock;
+}
+
+uint32_t MemoryBudget::maxBlockMin() const
+{
+    return _maxBlockMin;
+}
+
+uint8_t MemoryBudget::fragmentation() const
+{
+    return _fragmentation;
+}
+
+uint16_t MemoryBudget::rejected() const
+{
+    return _rejected;
+}
+
+uint16_t MemoryBudget::levelChanges() const
+{
+    return _levelChanges;
+}
+
+uint16_t MemoryBudget::allocated() const
+{
+    return _allocated;
+}
+
+const char *MemoryBudget::levelName(MemoryLevel level)
+{
+    return levelNames[level];
+}
+
+void MemoryBudget::sample()
+{
+    _lastSample = millis();
+#if defined(ESP8266)
+    uint16_t block;
+    ESP.getHeapStats(&_freeHeap, &block, &_fragmentation);
+    _maxBlock = block;
+#elif defined(ESP32)
+    _freeHeap = ESP.getFreeHeap();
+    _maxBlock = ESP.getMaxAllocHeap();
+    _fragmentation = _freeHeap > 0 ? 100 - (uint64_t)_maxBlock * 100 / _freeHeap : 0;
+#endif
+    _freeHeapMin = _freeHeap < _freeHeapMin ? _freeHeap : _freeHeapMin;
+    _maxBlockMin = _maxBlock < _maxBlockMin ? _maxBlock : _maxBlockMin;
+
+    // Worse at once, better only with the hysteresis
+    MemoryLevel level = levelFor(_maxBlock);
+    if (level < _level)
+    {
+        level = levelFor(_maxBlock > MEMORY_HYSTERESIS ? _maxBlock - MEMORY_HYSTERESIS : 0);
+        level = level < _level ? level : _level;
+    }
+    if (level == _level)
+    {
+        return;
+    }
+    _level = level;
+    _levelChanges++;
+    if (callbackFunction != nullptr)
+    {
+        callbackFunction(_level);
+    }
+}
+
+MemoryLevel MemoryBudget::levelFor(uint32_t block)
+{
+    if (block < MEMORY_CRITICAL_BLOCK)
+    {
+        return MemoryLevel_Critical;
+    }
+    if (block < MEMORY_LOW_BLOCK)
+    {
+        return MemoryLevel_Low;
+    }
+    if (block < MEMORY_TIGHT_BLOCK)
+    {
+        return MemoryLevel_Tight;
+    }
+    return MemoryLevel_Normal;
+}
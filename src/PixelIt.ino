@@ -1,14 +1,10 @@
 #include <Arduino.h>
 
 #if defined(ESP8266)
-#include <ESP8266WebServer.h>
-#include <ESP8266HTTPUpdateServer.h>
 #include <ESP8266WiFi.h>
 #include <LittleFS.h>
 
 #elif defined(ESP32)
-#include <WebServer.h>
-#include <HTTPUpdateServer.h>
 #include <WiFi.h>
 #include <FS.h>
 #endif
@@ -36,22 +32,45 @@
 #include <Max44009.h>
 #include <LightDependentResistor.h>
 #include <DHTesp.h>
-#include <DFPlayerMini_Fast.h>
 #include <SoftwareSerial.h>
 #include <TimeLib.h>
 #include <ArduinoJson.h>
-#include <ArduinoHttpClient.h>
 #include <Hash.h>
 // Ulanzi Sensor
 #include "Adafruit_SHT31.h"
 // PixelIT Stuff
-#include "PixelItFont.h"
+#include "MatrixGeometry.h"
 #include "Webinterface.h"
 #include "Tools.h"
-#include "UpdateScreen.h"
+#include "Assets.h"
 #include "Liveview.h"
+#include "Blitter.h"
+#include "TextEngine.h"
+#include "GlyphFonts.h"
+#include "ClockRenderer.h"
+#include "EffectEngine.h"
+#include "Playlist.h"
+#include "Rules.h"
 #include "BtnActions.h"
-#include "BtnStates.h"
+#include "BtnEvents.h"
+#include "Buttons.h"
+#include "DFPlayer.h"
+#include "HttpTask.h"
+#include "HttpServer.h"
+#include "Logger.h"
+#include "SensorHistory.h"
+#include "Deadband.h"
+#include "IdleGovernor.h"
+#if defined(LED_OUTPUT_DMA)
+#include "LedOutput.h"
+#endif
+#include "FirmwareUpdate.h"
+#include "CommandCapture.h"
+#include "JsonWriter.h"
+#include "MemoryBudget.h"
+#include "GifDecoder.h"
+#include "Realtime.h"
+#include "Wall.h"
 #include "TempSensor.h"
 #include "TemperatureUnit.h"
 #include "LuxSensor.h"
@@ -97,6 +116,7 @@ String mqttMasterTopic = "pixelit/";
 String mqttDeviceTopic = "";
 bool mqttUseDeviceTopic = true;
 bool mqttHAdiscoverable = true;
+bool mqttSensorFieldTopics = false; // Every sensor value on its own topic (sensor/temperature, ...)
 int mqttPort = 1883;
 unsigned long mqttLastReconnectAttempt = 0; // will store last time reconnect to mqtt broker
 const int MQTT_RECONNECT_INTERVAL = 15000;
@@ -123,23 +143,24 @@ unsigned long batteryLevelPrevMillis = 0;
 #define MAX_BATTERY 100
 #endif
 
-// Telemetry API
-#define TELEMETRY_SERVER_HOST "pixelit.bastelbunker.de"
+// PixelIt API (Telemetry and Check Update)
+#define API_SERVER_HOST "pixelit.bastelbunker.de"
+#define API_SERVER_PORT 80
+#define API_SERVER_TIMEOUT 5000
 #define TELEMETRY_SERVER_PATH "/api/telemetry"
-#define TELEMETRY_SERVER_PORT 80
-
-// Check Update API
-#define CHECKUPDATE_SERVER_HOST "pixelit.bastelbunker.de"
 #define CHECKUPDATE_SERVER_PATH "/api/lastversion"
-#define CHECKUPDATE_SERVER_PORT 80
 
 int btnPressedLevel[] = {LOW, LOW, LOW};
 
 const String btnAPINames[]{"leftButton", "middleButton", "rightButton"};
 const String btnLogNames[]{"Left button", "Middle button", "Right button"};
 
-btnStates btnState[] = {btnState_Released, btnState_Released, btnState_Released};
 bool btnLastPublishState[] = {false, false, false};
+uint8_t btnPinNumber[] = {0, 0, 0};
+btnActions btnLongAction[] = {btnAction_DoNothing, btnAction_DoNothing, btnAction_DoNothing};
+btnActions btnDoubleAction[] = {btnAction_DoNothing, btnAction_DoNothing, btnAction_DoNothing};
+// Buttons with a gesture (long, double press or a rule on one) run btnAction on the short press, the others on press
+bool btnGestures[] = {false, false, false};
 
 #if defined(ULANZI)
 String btnPin[] = {"GPIO_NUM_26", "GPIO_NUM_27", "GPIO_NUM_14"}; // UlanziTC001 workaround to tweak WebUI
@@ -151,7 +172,10 @@ bool btnEnabled[] = {false, false, false};
 btnActions btnAction[] = {btnAction_ToggleSleepMode, btnAction_GotoClock, btnAction_DoNothing};
 #endif
 
-CRGB leds[MATRIX_WIDTH * MATRIX_HEIGHT];
+CRGB leds[Geometry::pixels];
+#if defined(LED_OUTPUT_DMA)
+LedOutput ledOutput;
+#endif
 
 #if defined(ESP8266)
 bool isESP8266 = true;
@@ -186,23 +210,66 @@ LuxSensor luxSensor = LuxSensor_LDR;
 
 FastLED_NeoMatrix *matrix;
 WiFiClient wifiClientMQTT;
-WiFiClient wifiClientHTTP;
 WiFiUDP udp;
 PubSubClient client(wifiClientMQTT);
 WiFiManager wifiManager;
-#if defined(ESP8266)
-ESP8266WebServer server(80);
-ESP8266HTTPUpdateServer httpUpdater;
-#elif defined(ESP32)
-WebServer server(80);
-HTTPUpdateServer httpUpdater;
-#endif
+HttpServer server(80);
+const char updatePage[] PROGMEM = "<html><body><form method='POST' action='' enctype='multipart/form-data'>Firmware:<br><input type='file' accept='.bin,.bin.gz,.bin.hs' name='firmware'><input type='submit' value='Update Firmware'></form><form method='POST' action='' enctype='multipart/form-data'>FileSystem:<br><input type='file' accept='.bin,.bin.gz,.bin.hs' name='filesystem'><input type='submit' value='Update FileSystem'></form></body></html>";
 Liveview liveview;
+Blitter blitter;
+TextEngine textEngine;
+ClockRenderer clockRenderer;
+EffectEngine effects;
+Playlist playlist;
+FirmwareUpdate firmwareUpdate;
+CommandCapture capture;
+// Shared by the status serialisers, with room for the websocket frame header in front
+#define STATUS_JSON_LENGHT 1536
+// File names are limited to 31 characters, "/gif_" and ".gif" included
+#define GIF_NAME_LENGHT 22
+char statusBuffer[WEBSOCKETS_MAX_HEADER_SIZE + STATUS_JSON_LENGHT];
+JsonWriter statusJson(statusBuffer, sizeof(statusBuffer), WEBSOCKETS_MAX_HEADER_SIZE);
+RuleEngine rules;
+Buttons buttons;
+HttpTask httpTask;
+GifDecoder gifDecoder;
+Realtime realtime;
+Wall wall;
+Logger logger;
+// Log(module, message) at info level or Log(level, module, message), Logf(level, module, PSTR(format), ...)
+// like printf. The level is checked around the call, below LOG_LEVEL the message is not even built.
+#define LOG_SELECT(_1, _2, _3, name, ...) name
+#define Log(...) LOG_SELECT(__VA_ARGS__, LogAt, LogInfo, )(__VA_ARGS__)
+#define LogInfo(module, message) LogAt(LogLevel_Info, module, message)
+#define LogAt(level, module, message)           \
+    do                                          \
+    {                                           \
+        if ((level) >= LOG_LEVEL)               \
+        {                                       \
+            LogWrite((level), module, message); \
+        }                                       \
+    } while (0)
+#define Logf(level, module, ...)                       \
+    do                                                 \
+    {                                                  \
+        if ((level) >= LOG_LEVEL)                      \
+        {                                              \
+            logger.logf((level), module, __VA_ARGS__); \
+        }                                              \
+    } while (0)
+SensorHistory sensorHistory;
+IdleGovernor idleGovernor;
+MemoryBudget memoryBudget;
+File gifFile;
+String gifFilePath;
+bool gifUploadSuccess = false;
+bool gifSaveFailed = false;
+bool gifWebSocketActive = false;
 // Store last frame (serializated)
 String currentScreenJsonBuffer;
 
 WebSocketsServer webSocket = WebSocketsServer(81);
-DFPlayerMini_Fast mp3Player;
+DFPlayer mp3Player;
 SoftwareSerial *softSerial;
 uint initialVolume = 10;
 
@@ -230,7 +297,7 @@ unsigned long lastScreenMessageMillis = 0;
 unsigned long lastGetBatteryPercent = 0;
 
 // Bmp Vars
-uint16_t bmpArray[64];
+uint16_t bmpArray[Geometry::bitmapPixels];
 bool withBMP = false;
 int bmpWidth = 8;
 int bmpHeight = 8;
@@ -267,6 +334,48 @@ bool clockBlinkAnimated = true;
 bool clockLargeFont = false;
 bool clockFatFont = false;
 bool clockDrawWeekDays = true;
+bool clockRollDigits = false;
+int clockWeekDayDrawn = -1;
+
+// Playlist Vars
+uint playlistInterruptTime = 30;
+uint playlistNightStart = 22;
+uint playlistNightEnd = 6;
+bool playlistScreenRendering = false;
+
+// Realtime Vars (DDP / E1.31)
+bool realtimeDDP = true;
+bool realtimeE131 = true;
+uint realtimeUniverse = 1;
+uint realtimeTimeout = REALTIME_DEFAULT_TIMEOUT;
+
+// Power Vars
+bool idleSleep = true;       // Sleep between frames and requests
+bool idleLightSleep = false; // Light sleep with the display off (ESP8266), buttons may react late
+
+// Syslog Vars, empty server disables syslog
+String syslogServer = "";
+uint syslogPort = 514;
+
+// Video wall Vars
+uint wallRole = WallRole_Off;
+uint wallGroup = 0;
+uint wallIndex = 0;  // Position of this panel, 0 = left
+uint wallPanels = 1; // Number of panels, the canvas is wallPanels * MATRIX_WIDTH wide
+bool wallScreenActive = false;
+bool wallFrameReady = false;
+uint32_t wallStartTime = 0;
+uint32_t wallNextTick = 0;
+uint wallTick = 30;
+String wallText;
+uint16_t wallTextColor = 0;
+int16_t wallTextPosY = 6;
+uint16_t wallTextWidth = 0;
+uint wallScrollDelay = 0;
+int16_t wallGifPosX = 0;
+int16_t wallGifPosY = 0;
+uint8_t wallGifFrames = 0;
+uint32_t wallGifDuration = 0;
 
 // Scrolltext Vars
 bool scrollTextAktivLoop = false;
@@ -279,27 +388,39 @@ int scrollposX;
 int scrollxTextWidth;
 int scrollxAvailableTextSpace;
 String scrollTextString;
+bool textClassicFont = false; // bigFont, drawn by Adafruit GFX
 
 // Animate BMP Vars
-uint16_t animationBmpList[10][64];
+uint16_t animationBmpList[10][Geometry::bitmapPixels];
+uint16_t animationBmpDelays[10]; // Per frame delay (GIF), 0 = animateBMPDelay
 bool animateBMPAktivLoop = false;
 unsigned long animateBMPPrevMillis = 0;
 int animateBMPCounter = 0;
 bool animateBMPReverse = false;
 bool animateBMPRubberbandingAktiv = false;
 uint animateBMPDelay;
+bool animateBMPFrameDelays = false; // animationBmpDelays apply, the screen has no animationDelay
 int animateBMPLimitLoops = -1;
 int animateBMPLoopCount = 0;
 int animateBMPLimitFrames = -1;
 int animateBMPFrameCount = 0;
 
+// Effect Vars
+unsigned long effectPrevMillis = 0;
+
 // Sensors Vars
 unsigned long sendLuxPrevMillis = 0;
 unsigned long getLuxPrevMillis = 0;
 unsigned long sendSensorPrevMillis = 0;
 unsigned long sendInfoPrevMillis = 0;
-String oldGetLuxSensor;
-String oldGetSensor;
+// Publish a value when it leaves the deadband around the last published value
+Deadband sensorDeadband;      // Combined sensor payload
+Deadband sensorFieldDeadband; // Sensor values on their own topics
+Deadband luxDeadband;
+float sensorDeadbands[SensorField_Count] = {0.1f, 0.5f, 0.1f, 1.0f, 1.0f, 0.5f}; // Absolute, same order as SensorField
+float sensorDeadbandRelative = 0.0f;                                            // Percent of the published value
+uint sensorPublishMinInterval = 0;                                              // Seconds
+uint sensorPublishMaxInterval = 0;                                              // Seconds, republish unchanged values, 0 = never
 float currentLux = 0.0f;
 float luxOffset = 0.0f;
 float temperatureOffset = 0.0f;
@@ -309,6 +430,8 @@ float gasOffset = 0.0f;
 
 // Other Vars
 bool sendTelemetry = true;
+String apiServerHost = API_SERVER_HOST;
+uint apiServerPort = API_SERVER_PORT;
 unsigned long sendTelemetryPrevMillis = 0;
 unsigned long forcedScreenIsActiveUntil = 0;
 bool checkUpdateScreen = true;
@@ -428,6 +551,7 @@ void getBatteryVoltage()
     {
         batteryLevel = 1;
     }
+    idleGovernor.setBatteryLevel(batteryLevel);
 }
 
 void SetCurrentMatrixBrightness(int newBrightness)
@@ -480,6 +604,22 @@ void SaveConfig()
     json["clockLargeFont"] = clockLargeFont;
     json["clockFatFont"] = clockFatFont;
     json["clockDrawWeekDays"] = clockDrawWeekDays;
+    json["clockRollDigits"] = clockRollDigits;
+    json["playlistInterruptTime"] = playlistInterruptTime;
+    json["playlistNightStart"] = playlistNightStart;
+    json["playlistNightEnd"] = playlistNightEnd;
+    json["realtimeDDP"] = realtimeDDP;
+    json["realtimeE131"] = realtimeE131;
+    json["realtimeUniverse"] = realtimeUniverse;
+    json["realtimeTimeout"] = realtimeTimeout;
+    json["idleSleep"] = idleSleep;
+    json["idleLightSleep"] = idleLightSleep;
+    json["syslogServer"] = syslogServer;
+    json["syslogPort"] = syslogPort;
+    json["wallRole"] = wallRole;
+    json["wallGroup"] = wallGroup;
+    json["wallIndex"] = wallIndex;
+    json["wallPanels"] = wallPanels;
     json["scrollTextDefaultDelay"] = scrollTextDefaultDelay;
     json["bootScreenAktiv"] = bootScreenAktiv;
     json["bootBatteryScreen"] = bootBatteryScreen;
@@ -492,11 +632,21 @@ void SaveConfig()
     json["mqttPort"] = mqttPort;
     json["mqttUseDeviceTopic"] = mqttUseDeviceTopic;
     json["mqttHAdiscoverable"] = mqttHAdiscoverable;
+    json["mqttSensorFieldTopics"] = mqttSensorFieldTopics;
     json["luxOffset"] = luxOffset;
     json["temperatureOffset"] = temperatureOffset;
     json["humidityOffset"] = humidityOffset;
     json["pressureOffset"] = pressureOffset;
     json["gasOffset"] = gasOffset;
+    json["sensorDeadbandTemperature"] = sensorDeadbands[SensorField_Temperature];
+    json["sensorDeadbandHumidity"] = sensorDeadbands[SensorField_Humidity];
+    json["sensorDeadbandPressure"] = sensorDeadbands[SensorField_Pressure];
+    json["sensorDeadbandGas"] = sensorDeadbands[SensorField_Gas];
+    json["sensorDeadbandBattery"] = sensorDeadbands[SensorField_Battery];
+    json["sensorDeadbandLux"] = sensorDeadbands[SensorField_Lux];
+    json["sensorDeadbandRelative"] = sensorDeadbandRelative;
+    json["sensorPublishMinInterval"] = sensorPublishMinInterval;
+    json["sensorPublishMaxInterval"] = sensorPublishMaxInterval;
 
     json["dfpRXpin"] = dfpRXPin;
     json["dfpTXpin"] = dfpTXPin;
@@ -509,6 +659,8 @@ void SaveConfig()
         json["btn" + String(b) + "PressedLevel"] = btnPressedLevel[b];
         json["btn" + String(b) + "Enabled"] = btnEnabled[b];
         json["btn" + String(b) + "Action"] = static_cast<int>(btnAction[b]);
+        json["btn" + String(b) + "LongAction"] = static_cast<int>(btnLongAction[b]);
+        json["btn" + String(b) + "DoubleAction"] = static_cast<int>(btnDoubleAction[b]);
     }
     json["ldrDevice"] = ldrDevice;
     json["ldrPulldown"] = ldrPulldown;
@@ -516,6 +668,8 @@ void SaveConfig()
     json["initialVolume"] = initialVolume;
     json["sendTelemetry"] = sendTelemetry;
     json["checkUpdateScreen"] = checkUpdateScreen;
+    json["apiServerHost"] = apiServerHost;
+    json["apiServerPort"] = apiServerPort;
 
 #if defined(ESP8266)
     File configFile = LittleFS.open("/config.json", "w");
@@ -680,6 +834,11 @@ void SetConfigVariables(JsonObject &json)
         clockBlinkAnimated = json["clockBlinkAnimated"].as<bool>();
     }
 
+    if (json.containsKey("clockRollDigits"))
+    {
+        clockRollDigits = json["clockRollDigits"].as<bool>();
+    }
+
     if (json.containsKey("clockAutoFallbackActive"))
     {
         clockAutoFallbackActive = json["clockAutoFallbackActive"].as<bool>();
@@ -719,6 +878,82 @@ void SetConfigVariables(JsonObject &json)
         clockDrawWeekDays = json["clockDrawWeekDays"].as<bool>();
     }
 
+    if (json.containsKey("playlistInterruptTime"))
+    {
+        playlistInterruptTime = json["playlistInterruptTime"].as<uint>();
+        playlist.setInterruptDuration(playlistInterruptTime * 1000);
+    }
+
+    if (json.containsKey("playlistNightStart"))
+    {
+        playlistNightStart = json["playlistNightStart"].as<uint>();
+    }
+
+    if (json.containsKey("playlistNightEnd"))
+    {
+        playlistNightEnd = json["playlistNightEnd"].as<uint>();
+    }
+
+    if (json.containsKey("realtimeDDP"))
+    {
+        realtimeDDP = json["realtimeDDP"].as<bool>();
+    }
+
+    if (json.containsKey("realtimeE131"))
+    {
+        realtimeE131 = json["realtimeE131"].as<bool>();
+    }
+
+    if (json.containsKey("realtimeUniverse"))
+    {
+        realtimeUniverse = json["realtimeUniverse"].as<uint>();
+    }
+
+    if (json.containsKey("realtimeTimeout"))
+    {
+        realtimeTimeout = json["realtimeTimeout"].as<uint>();
+    }
+
+    if (json.containsKey("idleSleep"))
+    {
+        idleSleep = json["idleSleep"].as<bool>();
+    }
+
+    if (json.containsKey("idleLightSleep"))
+    {
+        idleLightSleep = json["idleLightSleep"].as<bool>();
+    }
+
+    if (json.containsKey("syslogServer"))
+    {
+        syslogServer = json["syslogServer"].as<String>();
+    }
+
+    if (json.containsKey("syslogPort"))
+    {
+        syslogPort = json["syslogPort"].as<uint>();
+    }
+
+    if (json.containsKey("wallRole"))
+    {
+        wallRole = json["wallRole"].as<uint>();
+    }
+
+    if (json.containsKey("wallGroup"))
+    {
+        wallGroup = json["wallGroup"].as<uint>();
+    }
+
+    if (json.containsKey("wallIndex"))
+    {
+        wallIndex = json["wallIndex"].as<uint>();
+    }
+
+    if (json.containsKey("wallPanels"))
+    {
+        wallPanels = json["wallPanels"].as<uint>();
+    }
+
     if (json.containsKey("scrollTextDefaultDelay"))
     {
         scrollTextDefaultDelay = json["scrollTextDefaultDelay"].as<uint>();
@@ -784,6 +1019,11 @@ void SetConfigVariables(JsonObject &json)
         mqttHAdiscoverable = json["mqttHAdiscoverable"].as<bool>();
     }
 
+    if (json.containsKey("mqttSensorFieldTopics"))
+    {
+        mqttSensorFieldTopics = json["mqttSensorFieldTopics"].as<bool>();
+    }
+
     if (json.containsKey("luxOffset"))
     {
         luxOffset = json["luxOffset"].as<float>();
@@ -809,6 +1049,51 @@ void SetConfigVariables(JsonObject &json)
         gasOffset = json["gasOffset"].as<float>();
     }
 
+    if (json.containsKey("sensorDeadbandTemperature"))
+    {
+        sensorDeadbands[SensorField_Temperature] = json["sensorDeadbandTemperature"].as<float>();
+    }
+
+    if (json.containsKey("sensorDeadbandHumidity"))
+    {
+        sensorDeadbands[SensorField_Humidity] = json["sensorDeadbandHumidity"].as<float>();
+    }
+
+    if (json.containsKey("sensorDeadbandPressure"))
+    {
+        sensorDeadbands[SensorField_Pressure] = json["sensorDeadbandPressure"].as<float>();
+    }
+
+    if (json.containsKey("sensorDeadbandGas"))
+    {
+        sensorDeadbands[SensorField_Gas] = json["sensorDeadbandGas"].as<float>();
+    }
+
+    if (json.containsKey("sensorDeadbandBattery"))
+    {
+        sensorDeadbands[SensorField_Battery] = json["sensorDeadbandBattery"].as<float>();
+    }
+
+    if (json.containsKey("sensorDeadbandLux"))
+    {
+        sensorDeadbands[SensorField_Lux] = json["sensorDeadbandLux"].as<float>();
+    }
+
+    if (json.containsKey("sensorDeadbandRelative"))
+    {
+        sensorDeadbandRelative = json["sensorDeadbandRelative"].as<float>();
+    }
+
+    if (json.containsKey("sensorPublishMinInterval"))
+    {
+        sensorPublishMinInterval = json["sensorPublishMinInterval"].as<uint>();
+    }
+
+    if (json.containsKey("sensorPublishMaxInterval"))
+    {
+        sensorPublishMaxInterval = json["sensorPublishMaxInterval"].as<uint>();
+    }
+
     if (json.containsKey("dfpRXpin"))
     {
         dfpRXPin = json["dfpRXpin"].as<char *>();
@@ -852,6 +1137,14 @@ void SetConfigVariables(JsonObject &json)
         {
             btnAction[b] = static_cast<btnActions>(json["btn" + String(b) + "Action"].as<int>());
         }
+        if (json.containsKey("btn" + String(b) + "LongAction"))
+        {
+            btnLongAction[b] = static_cast<btnActions>(json["btn" + String(b) + "LongAction"].as<int>());
+        }
+        if (json.containsKey("btn" + String(b) + "DoubleAction"))
+        {
+            btnDoubleAction[b] = static_cast<btnActions>(json["btn" + String(b) + "DoubleAction"].as<int>());
+        }
     }
 
     if (json.containsKey("ldrDevice"))
@@ -883,217 +1176,1404 @@ void SetConfigVariables(JsonObject &json)
     {
         checkUpdateScreen = json["checkUpdateScreen"].as<bool>();
     }
-}
 
-void EraseWifiCredentials()
-{
-    wifiManager.resetSettings();
-    delay(300);
-    ESP.restart();
-    delay(300);
+    if (json.containsKey("apiServerHost"))
+    {
+        apiServerHost = json["apiServerHost"].as<char *>();
+    }
+
+    if (json.containsKey("apiServerPort"))
+    {
+        apiServerPort = json["apiServerPort"].as<uint>();
+    }
 }
 
-void HandleGetMainPage()
+String PlaylistItemPath(const char *name)
 {
-    server.sendHeader(F("Connection"), F("close"));
-    server.send(200, F("text/html"), mainPage);
+    return "/pl_" + String(name) + ".json";
 }
 
-void HandleNotFound()
+String PlaylistConditionToString(PlaylistCondition condition)
 {
-    if (server.method() == HTTP_OPTIONS)
+    switch (condition)
     {
-        server.sendHeader(F("Access-Control-Allow-Origin"), "*");
-        server.send(204);
+    case PlaylistCondition_Day:
+        return "day";
+    case PlaylistCondition_Night:
+        return "night";
+    default:
+        return "always";
     }
-
-    server.sendHeader("Location", "/update", true);
-    server.send(302, F("text/plain"), "");
 }
 
-void HandleScreen()
+PlaylistCondition PlaylistConditionFromString(String condition)
 {
-    DynamicJsonBuffer jsonBuffer;
-    String args = String(server.arg("plain").c_str());
-    JsonObject &json = jsonBuffer.parseObject(args.begin());
-    server.sendHeader(F("Connection"), F("close"));
-    server.sendHeader(F("Access-Control-Allow-Origin"), "*");
-
-    if (json.success())
+    if (condition == "day")
     {
-        server.send(200, F("application/json"), F("{\"response\":\"OK\"}"));
-        Log(F("HandleScreen"), "Incoming JSON length: " + String(json.measureLength()));
-        CreateFrames(json);
+        return PlaylistCondition_Day;
     }
-    else
+    if (condition == "night")
     {
-        server.send(406, F("application/json"), F("{\"response\":\"Not Acceptable\"}"));
+        return PlaylistCondition_Night;
     }
+    return PlaylistCondition_Always;
 }
 
-void HandleSetConfig()
+bool PlaylistConditionMet(PlaylistCondition condition)
 {
-    DynamicJsonBuffer jsonBuffer;
-    JsonObject &json = jsonBuffer.parseObject(server.arg("plain"));
-    server.sendHeader(F("Connection"), F("close"));
+    // Without a valid time it is always day
+    bool isNight = false;
+    if (timeStatus() != timeNotSet)
+    {
+        uint currentHour = hour();
+        if (playlistNightStart > playlistNightEnd)
+        {
+            isNight = currentHour >= playlistNightStart || currentHour < playlistNightEnd;
+        }
+        else
+        {
+            isNight = currentHour >= playlistNightStart && currentHour < playlistNightEnd;
+        }
+    }
 
-    if (json.success())
+    if (condition == PlaylistCondition_Night)
     {
-        Log(F("SetConfig"), "Incoming JSON length: " + String(json.measureLength()));
-        SetConfig(json);
-        server.send(200, F("application/json"), F("{\"response\":\"OK\"}"));
-        delay(500);
-        ESP.restart();
+        return isNight;
     }
-    else
+    if (condition == PlaylistCondition_Day)
     {
-        server.send(406, F("application/json"), F("{\"response\":\"Not Acceptable\"}"));
+        return !isNight;
     }
+    return true;
 }
 
-void HandleGetConfig()
-{
-    server.sendHeader(F("Connection"), F("close"));
-    server.send(200, F("application/json"), GetConfig());
-}
-
-void HandleGetLuxSensor()
-{
-    server.sendHeader(F("Connection"), F("close"));
-    server.send(200, F("application/json"), GetLuxSensor());
-}
-
-void HandleGetBrightness()
-{
-    server.sendHeader(F("Connection"), F("close"));
-    server.send(200, F("application/json"), GetBrightness());
-}
-
-void HandleGetDHTSensor() // Legancy
+void RemovePlaylistItemFile(const PlaylistItem &item)
 {
-    server.sendHeader(F("Connection"), F("close"));
-    server.send(200, F("application/json"), GetSensor());
+#if defined(ESP8266)
+    LittleFS.remove(PlaylistItemPath(item.name));
+#elif defined(ESP32)
+    SPIFFS.remove(PlaylistItemPath(item.name));
+#endif
+    Log(F("Playlist"), "Expired: " + String(item.name));
 }
 
-void HandleGetSensor()
+void SavePlaylist()
 {
-    server.sendHeader(F("Connection"), F("close"));
-    server.send(200, F("application/json"), GetSensor());
-}
+    playlist.removeExpired(timeStatus() != timeNotSet ? now() : 0);
 
-void HandleGetButtons()
-{
-    server.sendHeader(F("Connection"), F("close"));
-    server.send(200, F("application/json"), GetButtons());
-}
+    DynamicJsonBuffer jsonBuffer;
+    JsonObject &json = jsonBuffer.createObject();
+    JsonArray &items = json.createNestedArray("items");
 
-void HandleGetMatrixInfo()
-{
-    server.sendHeader(F("Connection"), F("close"));
-    server.send(200, F("application/json"), GetMatrixInfo());
-}
+    for (uint8_t i = 0; i < playlist.count(); i++)
+    {
+        const PlaylistItem &item = playlist.item(i);
+        JsonObject &jsonItem = items.createNestedObject();
+        jsonItem["name"] = item.name;
+        jsonItem["duration"] = item.duration;
+        jsonItem["priority"] = item.priority;
+        jsonItem["expires"] = (unsigned long)item.expires;
+        jsonItem["condition"] = PlaylistConditionToString(item.condition);
+    }
 
-void HandelWifiConfigReset()
-{
-    server.sendHeader(F("Connection"), F("close"));
-    server.send(200, F("application/json"), F("{\"response\":\"OK\"}"));
-    EraseWifiCredentials();
+#if defined(ESP8266)
+    File playlistFile = LittleFS.open("/playlist.json", "w");
+#elif defined(ESP32)
+    File playlistFile = SPIFFS.open("/playlist.json", "w");
+#endif
+    json.printTo(playlistFile);
+    playlistFile.close();
+    Log(F("SavePlaylist"), "Saved " + String(playlist.count()) + " items");
 }
 
-void HandleFactoryReset()
+void LoadPlaylist()
 {
-    server.sendHeader(F("Connection"), F("close"));
-    server.send(200, F("application/json"), F("{\"response\":\"OK\"}"));
 #if defined(ESP8266)
-    File configFile = LittleFS.open("/config.json", "w");
+    File playlistFile = LittleFS.open("/playlist.json", "r");
 #elif defined(ESP32)
-    File configFile = SPIFFS.open("/config.json", "w");
+    File playlistFile = SPIFFS.open("/playlist.json", "r");
 #endif
-    if (!configFile)
+    if (!playlistFile)
     {
-        Log(F("Handle_factoryreset"), F("Failed to open config file for reset"));
+        return;
     }
-    configFile.println("");
-    configFile.close();
-    EraseWifiCredentials();
-}
 
-void SleepScreen(bool startSleep, bool forceClockOnWake)
-{
-    if (startSleep)
-    {
-        Log(F("SleepScreen"), F("Sleeping..."));
-        matrix->clear();
-        DrawTextHelper("z", false, false, false, false, false, 0, 0, 255, (MATRIX_WIDTH / 2) - 6, 1);
-        matrix->show();
-        delay(200);
-        DrawTextHelper("Z", false, false, false, false, false, 0, 0, 255, (MATRIX_WIDTH / 2) - 1, 1);
-        matrix->show();
-        delay(200);
-        DrawTextHelper("z", false, false, false, false, false, 0, 0, 255, (MATRIX_WIDTH / 2) + 4, 1);
-        matrix->show();
-        delay(500);
-        FadeOut(30, 0);
-        matrix->setBrightness(0);
-        matrix->show();
-    }
-    else
+    DynamicJsonBuffer jsonBuffer;
+    JsonObject &json = jsonBuffer.parseObject(playlistFile);
+    playlistFile.close();
+
+    if (json.success())
     {
-        Log(F("SleepScreen"), F("Waking up..."));
-        matrix->clear();
-        // DrawTextHelper("😀", false, true, false, false, false, 255, 200, 0, 0, 1);
-        // FadeIn(30, 0);
-        // delay(150);
-        forceClock = forceClockOnWake;
+        for (JsonVariant x : json["items"].as<JsonArray>())
+        {
+            JsonObject &item = x.as<JsonObject>();
+            playlist.set(item["name"].as<char *>(), item["duration"].as<uint16_t>(), item["priority"].as<uint8_t>(), item["expires"].as<unsigned long>(), PlaylistConditionFromString(item["condition"].as<String>()));
+        }
+        Log(F("LoadPlaylist"), "Loaded " + String(playlist.count()) + " items");
     }
 }
 
-void HandleAndSendButtonPress(uint button, bool state)
+void SetPlaylist(JsonObject &json)
 {
-    btnLastPublishState[button] = state;
-    Log(F("Buttons"), btnLogNames[button] + " is now " + (state ? "true" : "false"));
-
-    // Prüfen ob über MQTT versendet werden muss
-    if (mqttAktiv == true && client.connected())
+    if (json["clear"].as<bool>())
     {
-        client.publish((mqttMasterTopic + "buttons/button" + String(button)).c_str(), (state ? "true" : "false"), true);
-        if (mqttUseDeviceTopic)
+        while (playlist.count() > 0)
         {
-            client.publish((mqttDeviceTopic + "buttons/button" + String(button)).c_str(), (state ? "true" : "false"), true);
+            String name = playlist.item(0).name;
+#if defined(ESP8266)
+            LittleFS.remove(PlaylistItemPath(name.c_str()));
+#elif defined(ESP32)
+            SPIFFS.remove(PlaylistItemPath(name.c_str()));
+#endif
+            playlist.remove(name.c_str());
         }
     }
-    // Prüfen ob über Websocket versendet werden muss
-    if (webSocket.connectedClients() > 0)
+
+    if (json.containsKey("remove"))
     {
-        for (uint i = 0; i < sizeof websocketConnection / sizeof websocketConnection[0]; i++)
+        for (JsonVariant name : json["remove"].as<JsonArray>())
         {
-            webSocket.sendTXT(i, "{\"buttons\":{\"" + btnAPINames[button] + "\":" + (state ? "true" : "false") + "}}");
+            if (playlist.remove(name.as<char *>()))
+            {
+#if defined(ESP8266)
+                LittleFS.remove(PlaylistItemPath(name.as<char *>()));
+#elif defined(ESP32)
+                SPIFFS.remove(PlaylistItemPath(name.as<char *>()));
+#endif
+            }
         }
     }
 
-    if (state == false)
+    if (json.containsKey("items"))
     {
-        return;
+        for (JsonVariant x : json["items"].as<JsonArray>())
+        {
+            JsonObject &item = x.as<JsonObject>();
+
+            // Same rules as for the hostname, the name becomes part of a filename
+            String nameRaw = item["name"].as<String>();
+            String name = "";
+            for (uint8_t n = 0; n < nameRaw.length() && name.length() < PLAYLIST_NAME_LENGHT - 1; n++)
+            {
+                if ((nameRaw.charAt(n) >= '0' && nameRaw.charAt(n) <= '9') || (nameRaw.charAt(n) >= 'A' && nameRaw.charAt(n) <= 'Z') || (nameRaw.charAt(n) >= 'a' && nameRaw.charAt(n) <= 'z') || (nameRaw.charAt(n) == '_') || (nameRaw.charAt(n) == '-'))
+                    name += nameRaw.charAt(n);
+            }
+            if (name.length() == 0)
+            {
+                Log(LogLevel_Error, F("SetPlaylist"), F("Error: item without valid name"));
+                continue;
+            }
+
+            // expires is passed in seconds from now
+            time_t expires = 0;
+            if (item["expires"].as<unsigned long>() > 0)
+            {
+                if (timeStatus() != timeNotSet)
+                {
+                    expires = now() + item["expires"].as<unsigned long>();
+                }
+                else
+                {
+                    Log(LogLevel_Warning, F("SetPlaylist"), "Time not synced, expiry of " + name + " ignored");
+                }
+            }
+
+            uint16_t duration = item.containsKey("duration") ? item["duration"].as<uint16_t>() : 10;
+            int index = playlist.set(name.c_str(), duration, item["priority"].as<uint8_t>(), expires, PlaylistConditionFromString(item["condition"].as<String>()));
+            if (index == -1)
+            {
+                Log(LogLevel_Error, F("SetPlaylist"), "Error: playlist is full, " + name + " not added");
+                continue;
+            }
+
+            if (item.containsKey("screen"))
+            {
+#if defined(ESP8266)
+                File screenFile = LittleFS.open(PlaylistItemPath(name.c_str()), "w");
+#elif defined(ESP32)
+                File screenFile = SPIFFS.open(PlaylistItemPath(name.c_str()), "w");
+#endif
+                item["screen"].as<JsonObject>().printTo(screenFile);
+                screenFile.close();
+            }
+        }
     }
 
-    if (btnAction[button] == btnAction_ToggleSleepMode)
+    SavePlaylist();
+    playlist.restart();
+}
+
+String GetPlaylist()
+{
+    DynamicJsonBuffer jsonBuffer;
+    JsonObject &root = jsonBuffer.createObject();
+    JsonArray &items = root.createNestedArray("items");
+
+    for (uint8_t i = 0; i < playlist.count(); i++)
+    {
+        const PlaylistItem &item = playlist.item(i);
+        JsonObject &jsonItem = items.createNestedObject();
+        jsonItem["name"] = item.name;
+        jsonItem["duration"] = item.duration;
+        jsonItem["priority"] = item.priority;
+        jsonItem["expires"] = (unsigned long)item.expires;
+        jsonItem["condition"] = PlaylistConditionToString(item.condition);
+    }
+    root["current"] = playlist.current() >= 0 ? playlist.item(playlist.current()).name : "";
+    root["interrupted"] = playlist.isInterrupted();
+    root["hostname"] = hostname;
+
+    String json;
+    root.printTo(json);
+
+    return json;
+}
+
+void ShowPlaylistItem(const PlaylistItem &item)
+{
+#if defined(ESP8266)
+    File screenFile = LittleFS.open(PlaylistItemPath(item.name), "r");
+#elif defined(ESP32)
+    File screenFile = SPIFFS.open(PlaylistItemPath(item.name), "r");
+#endif
+    if (!screenFile)
+    {
+        Log(LogLevel_Error, F("Playlist"), "Error: no screen stored for " + String(item.name));
+        return;
+    }
+
+    DynamicJsonBuffer jsonBuffer;
+    JsonObject &json = jsonBuffer.parseObject(screenFile);
+    screenFile.close();
+
+    if (json.success())
+    {
+        Log(F("Playlist"), "Show " + String(item.name) + " for " + String(item.duration) + "s");
+        playlistScreenRendering = true;
+        CreateFrames(json);
+        playlistScreenRendering = false;
+    }
+}
+
+void SetGpio(uint8_t gpio, bool value, ulong duration)
+{
+    // If the GPIO is already present in the array?
+    // has been found, this is to be replaced.
+    if (duration > 0)
+    {
+        int arrayIndex = -1;
+        for (int i = 0; i < SET_GPIO_SIZE; i++)
+        {
+            if (setGPIOReset[i].gpio == gpio)
+            {
+                arrayIndex = i;
+                break;
+            }
+        }
+        // Search free place in array.
+        if (arrayIndex == -1)
+        {
+            for (int i = 0; i < SET_GPIO_SIZE; i++)
+            {
+                if (setGPIOReset[i].gpio == -1)
+                {
+                    arrayIndex = i;
+                    break;
+                }
+            }
+        }
+
+        if (arrayIndex == -1)
+        {
+            Log(LogLevel_Error, F("SetGPIO"), F("Error: no free place in array found!"));
+        }
+        else
+        {
+            // Save data in array for the reset.
+            setGPIOReset[arrayIndex].gpio = gpio;
+            setGPIOReset[arrayIndex].resetMillis = (millis() + duration);
+            Log(F("SetGPIO"), "Pos: " + String(arrayIndex) + ", GPIO: " + String(gpio) + ", Duration: " + String(duration) + ", Value: " + (value ? "true" : "false"));
+        }
+    }
+    else
+    {
+        Log(F("SetGPIO"), "GPIO: " + String(gpio) + ", Value: " + (value ? "true" : "false"));
+    }
+    // Set GPIO
+    pinMode(gpio, OUTPUT);
+    digitalWrite(gpio, value);
+}
+
+int16_t ParseMinuteOfDay(String timeOfDay)
+{
+    // "HH:MM" -> minutes since midnight, -1 if not set
+    int separator = timeOfDay.indexOf(':');
+    if (separator == -1)
+    {
+        return -1;
+    }
+    return timeOfDay.substring(0, separator).toInt() * 60 + timeOfDay.substring(separator + 1).toInt();
+}
+
+void CompileRules(JsonObject &json)
+{
+    const String sourceNames[] = {"button0", "button1", "button2", "temperature", "humidity", "pressure", "gas", "lux", "battery", "time"};
+    const String actionNames[] = {"none", "screen", "brightness", "gpio", "sound", "publish"};
+    const String eventNames[] = {"released", "pressed", "short", "long", "double", "repeat"};
+
+    rules.clear();
+
+    for (JsonVariant x : json["rules"].as<JsonArray>())
+    {
+        JsonObject &jsonRule = x.as<JsonObject>();
+        Rule rule;
+        memset(&rule, 0, sizeof(rule));
+
+        String trigger = jsonRule["trigger"].as<String>();
+        if (trigger == "button")
+        {
+            trigger += jsonRule["button"].as<int>();
+        }
+
+        int source = -1;
+        for (uint8_t i = 0; i < RuleSource_Count; i++)
+        {
+            if (trigger == sourceNames[i])
+            {
+                source = i;
+                break;
+            }
+        }
+        if (source == -1)
+        {
+            Log(LogLevel_Error, F("Rules"), "Error: unknown trigger " + trigger);
+            continue;
+        }
+        rule.source = static_cast<RuleSource>(source);
+
+        rule.buttonEvent = btnEvent_Pressed;
+        if (jsonRule.containsKey("event"))
+        {
+            String event = jsonRule["event"].as<String>();
+            for (uint8_t i = 0; i < sizeof(eventNames) / sizeof(eventNames[0]); i++)
+            {
+                if (event == eventNames[i])
+                {
+                    rule.buttonEvent = i;
+                    break;
+                }
+            }
+        }
+
+        if (jsonRule.containsKey("below"))
+        {
+            rule.compare = RuleCompare_Below;
+            rule.threshold = jsonRule["below"].as<float>();
+        }
+        else
+        {
+            rule.compare = RuleCompare_Above;
+            rule.threshold = jsonRule["above"].as<float>();
+        }
+        rule.hysteresis = jsonRule["hysteresis"].as<float>();
+
+        rule.fromMinute = jsonRule.containsKey("from") ? ParseMinuteOfDay(jsonRule["from"].as<String>()) : -1;
+        rule.toMinute = jsonRule.containsKey("to") ? ParseMinuteOfDay(jsonRule["to"].as<String>()) : -1;
+
+        JsonObject &jsonAction = jsonRule["action"].as<JsonObject>();
+        String actionType = jsonAction["type"].as<String>();
+        rule.action.type = RuleActionType_None;
+        for (uint8_t i = 0; i < sizeof actionNames / sizeof actionNames[0]; i++)
+        {
+            if (actionType == actionNames[i])
+            {
+                rule.action.type = static_cast<RuleActionType>(i);
+                break;
+            }
+        }
+
+        switch (rule.action.type)
+        {
+        case RuleActionType_ShowScreen:
+            strncpy(rule.action.target, jsonAction["name"].as<String>().c_str(), RULES_TARGET_LENGHT - 1);
+            break;
+        case RuleActionType_SetBrightness:
+            rule.action.value = jsonAction["value"].as<int>();
+            break;
+        case RuleActionType_SetGpio:
+            rule.action.param = jsonAction["gpio"].as<int>();
+            rule.action.value = jsonAction["set"].as<bool>();
+            rule.action.duration = jsonAction["duration"].as<unsigned long>();
+            break;
+        case RuleActionType_PlaySound:
+            rule.action.param = jsonAction["folder"].as<int>();
+            rule.action.value = jsonAction["file"].as<int>();
+            break;
+        case RuleActionType_Publish:
+            strncpy(rule.action.target, jsonAction["topic"].as<String>().c_str(), RULES_TARGET_LENGHT - 1);
+            strncpy(rule.action.payload, jsonAction["payload"].as<String>().c_str(), RULES_PAYLOAD_LENGHT - 1);
+            break;
+        default:
+            Log(LogLevel_Error, F("Rules"), "Error: unknown action " + actionType);
+            continue;
+        }
+
+        if (rules.add(rule) == -1)
+        {
+            Log(LogLevel_Error, F("Rules"), F("Error: rule table is full"));
+            break;
+        }
+    }
+
+    Log(F("Rules"), "Compiled " + String(rules.count()) + " rules");
+    UpdateButtonGestures();
+}
+
+void LoadRules()
+{
+#if defined(ESP8266)
+    File rulesFile = LittleFS.open("/rules.json", "r");
+#elif defined(ESP32)
+    File rulesFile = SPIFFS.open("/rules.json", "r");
+#endif
+    if (!rulesFile)
+    {
+        return;
+    }
+
+    DynamicJsonBuffer jsonBuffer;
+    JsonObject &json = jsonBuffer.parseObject(rulesFile);
+    rulesFile.close();
+
+    if (json.success())
+    {
+        CompileRules(json);
+    }
+}
+
+void SetRules(JsonObject &json)
+{
+#if defined(ESP8266)
+    File rulesFile = LittleFS.open("/rules.json", "w");
+#elif defined(ESP32)
+    File rulesFile = SPIFFS.open("/rules.json", "w");
+#endif
+    json.printTo(rulesFile);
+    rulesFile.close();
+
+    CompileRules(json);
+}
+
+String GetRules()
+{
+#if defined(ESP8266)
+    File rulesFile = LittleFS.open("/rules.json", "r");
+#elif defined(ESP32)
+    File rulesFile = SPIFFS.open("/rules.json", "r");
+#endif
+    if (!rulesFile)
+    {
+        return F("{\"rules\":[]}");
+    }
+
+    String json = rulesFile.readString();
+    rulesFile.close();
+    return json;
+}
+
+bool RulesNeedSensor()
+{
+    return rules.hasRules(RuleSource_Temperature) || rules.hasRules(RuleSource_Humidity) || rules.hasRules(RuleSource_Pressure) || rules.hasRules(RuleSource_Gas) || rules.hasRules(RuleSource_Battery);
+}
+
+void ExecuteRuleAction(const RuleAction &action)
+{
+    switch (action.type)
+    {
+    case RuleActionType_ShowScreen:
+    {
+        int index = playlist.find(action.target);
+        if (index == -1)
+        {
+            Log(LogLevel_Error, F("Rules"), "Error: unknown screen " + String(action.target));
+            break;
+        }
+        ShowPlaylistItem(playlist.item(index));
+        playlist.interrupt();
+        break;
+    }
+    case RuleActionType_SetBrightness:
+        Log(F("Rules"), "Set brightness to " + String(action.value));
+        if (!sleepMode)
+        {
+            SetCurrentMatrixBrightness(action.value);
+            matrix->show();
+        }
+        break;
+    case RuleActionType_SetGpio:
+        SetGpio(action.param, action.value, action.duration);
+        break;
+    case RuleActionType_PlaySound:
+        Log(F("Rules"), "Play sound " + String(action.param) + "/" + String(action.value));
+        if (action.param > 0)
+        {
+            mp3Player.playFolder(action.param, action.value);
+        }
+        else
+        {
+            mp3Player.play(action.value);
+        }
+        break;
+    case RuleActionType_Publish:
+        Log(F("Rules"), "Publish " + String(action.target) + ": " + String(action.payload));
+        if (mqttAktiv == true && client.connected())
+        {
+            client.publish((mqttMasterTopic + action.target).c_str(), action.payload);
+            if (mqttUseDeviceTopic)
+            {
+                client.publish((mqttDeviceTopic + action.target).c_str(), action.payload);
+            }
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void EraseWifiCredentials()
+{
+    wifiManager.resetSettings();
+    delay(300);
+    ESP.restart();
+    delay(300);
+}
+
+String GifPath(const String &name)
+{
+    return "/gif_" + name + ".gif";
+}
+
+// False if the GIF should be saved but can not be
+bool BeginGif(const String &saveName)
+{
+    // The frames are decoded straight into the animation store
+    animateBMPAktivLoop = false;
+    gifDecoder.begin(&animationBmpList[0][0], Geometry::bitmapPixels, 10, animationBmpDelays);
+
+    gifFilePath = "";
+    if (saveName == "")
+    {
+        return true;
+    }
+    if (saveName.length() > GIF_NAME_LENGHT || saveName.indexOf('/') != -1)
+    {
+        Log(LogLevel_Error, F("GIF"), "Error: invalid name " + saveName + ", at most " + String(GIF_NAME_LENGHT) + " characters");
+        return false;
+    }
+
+    gifFilePath = GifPath(saveName);
+#if defined(ESP8266)
+    gifFile = LittleFS.open(gifFilePath, "w");
+#elif defined(ESP32)
+    gifFile = SPIFFS.open(gifFilePath, "w");
+#endif
+    if (!gifFile)
+    {
+        Log(LogLevel_Error, F("GIF"), "Error: can not create " + gifFilePath);
+        return false;
+    }
+    return true;
+}
+
+void WriteGif(const uint8_t *data, size_t length)
+{
+    gifDecoder.write(data, length);
+    if (gifFile)
+    {
+        gifFile.write(data, length);
+    }
+}
+
+void AbortGif()
+{
+    if (gifFile)
+    {
+        gifFile.close();
+#if defined(ESP8266)
+        LittleFS.remove(gifFilePath);
+#elif defined(ESP32)
+        SPIFFS.remove(gifFilePath);
+#endif
+    }
+    // Nothing valid left in the animation store
+    animationBmpList[0][0] = 2;
+}
+
+bool EndGif()
+{
+    GifDecoderStatus status = gifDecoder.status();
+    if (status == GifDecoderStatus_ErrorFormat || status == GifDecoderStatus_ErrorTooLarge || gifDecoder.frameCount() == 0)
+    {
+        if (status == GifDecoderStatus_ErrorTooLarge)
+        {
+            Log(LogLevel_Error, F("GIF"), "Error: GIF larger than " + String(GIFDECODER_MAX_PIXELS) + " pixels");
+        }
+        else
+        {
+            Log(LogLevel_Error, F("GIF"), F("Error: invalid GIF"));
+        }
+        AbortGif();
+        return false;
+    }
+
+    if (gifFile)
+    {
+        gifFile.close();
+    }
+
+    for (int i = 0; i < 10; i++)
+    {
+        if (i >= gifDecoder.frameCount())
+        {
+            animationBmpList[i][0] = 2;
+        }
+        // 2 in the first pixel marks the end of the animation, use the (almost) same colour 3 instead
+        else if (animationBmpList[i][0] == 2)
+        {
+            animationBmpList[i][0] = 3;
+        }
+    }
+
+    Log(F("GIF"), "Decoded " + String(gifDecoder.frameCount()) + " frames " + String(gifDecoder.width()) + "x" + String(gifDecoder.height()));
+    return true;
+}
+
+bool LoadGif(const String &name)
+{
+#if defined(ESP8266)
+    File file = LittleFS.open(GifPath(name), "r");
+#elif defined(ESP32)
+    File file = SPIFFS.open(GifPath(name), "r");
+#endif
+    if (!file)
+    {
+        Log(LogLevel_Error, F("GIF"), "Error: unknown GIF " + name);
+        return false;
+    }
+
+    BeginGif("");
+    uint8_t buffer[64];
+    while (file.available() && gifDecoder.status() == GifDecoderStatus_Decoding)
+    {
+        int length = file.read(buffer, sizeof(buffer));
+        if (length <= 0)
+        {
+            break;
+        }
+        WriteGif(buffer, length);
+    }
+    file.close();
+
+    return EndGif();
+}
+
+void ShowDecodedGif()
+{
+    DynamicJsonBuffer jsonBuffer;
+    JsonObject &root = jsonBuffer.createObject();
+    JsonObject &bitmapAnimation = root.createNestedObject("bitmapAnimation");
+    bitmapAnimation["decoded"] = true;
+    if (server.hasArg("x") && server.hasArg("y"))
+    {
+        bitmapAnimation["position"]["x"] = server.arg("x").toInt();
+        bitmapAnimation["position"]["y"] = server.arg("y").toInt();
+    }
+    CreateFrames(root);
+}
+
+void RealtimeChanged(bool active)
+{
+    Log(F("Realtime"), active ? F("Stream started") : F("Stream timed out, back to normal screens"));
+
+    if (active)
+    {
+        // The stream owns the matrix, stop everything that draws on its own
+        clockAktiv = false;
+        scrollTextAktivLoop = false;
+        animateBMPAktivLoop = false;
+        effects.stop();
+        playlist.interrupt();
+    }
+    else if (!sleepMode)
+    {
+        RestoreLastScreen();
+    }
+    SendMatrixInfo();
+}
+
+void RestoreLastScreen()
+{
+    if (playlist.count() > 0)
+    {
+        playlist.restart();
+    }
+    else if (currentScreenJsonBuffer.length() > 0)
+    {
+        DynamicJsonBuffer jsonBuffer;
+        JsonObject &tmpJson = jsonBuffer.parseObject(currentScreenJsonBuffer);
+        CreateFrames(tmpJson);
+    }
+    else
+    {
+        forceClock = true;
+    }
+}
+
+void ApplyWallScreen(const char *content, uint32_t startTime)
+{
+    DynamicJsonBuffer jsonBuffer;
+    JsonObject &json = jsonBuffer.parseObject(content);
+
+    if (!json.success() || (!json.containsKey("text") && !json.containsKey("bitmapAnimation")))
+    {
+        // Empty wall screen ends the wall
+        if (wallScreenActive)
+        {
+            Log(F("Wall"), F("Wall screen stopped"));
+            wallScreenActive = false;
+            RestoreLastScreen();
+        }
+        return;
+    }
+
+    wallText = "";
+    wallTextWidth = 0;
+    wallScrollDelay = scrollTextDefaultDelay;
+    wallTick = 100;
+    if (json.containsKey("text"))
+    {
+        wallText = json["text"]["textString"].as<String>();
+        wallTextColor = matrix->Color(json["text"]["color"]["r"].as<uint8_t>(), json["text"]["color"]["g"].as<uint8_t>(), json["text"]["color"]["b"].as<uint8_t>());
+        wallTextPosY = (json["text"]["position"]["y"].is<int16_t>() ? json["text"]["position"]["y"].as<int16_t>() : 1) + 5;
+        if (json["text"]["scrollTextDelay"].is<uint>() && json["text"]["scrollTextDelay"].as<uint>() > 0)
+        {
+            wallScrollDelay = json["text"]["scrollTextDelay"].as<uint>();
+        }
+
+        textEngine.setFont(&PixelItGlyphFont);
+        wallTextWidth = textEngine.textWidth(wallText.c_str());
+        wallTick = wallScrollDelay;
+    }
+
+    wallGifFrames = 0;
+    wallGifDuration = 0;
+    if (json["bitmapAnimation"].containsKey("gif") && LoadGif(json["bitmapAnimation"]["gif"].as<String>()))
+    {
+        wallGifFrames = gifDecoder.frameCount();
+        bmpWidth = gifDecoder.width();
+        bmpHeight = gifDecoder.height();
+        wallGifPosX = json["bitmapAnimation"]["position"]["x"].as<int16_t>();
+        wallGifPosY = json["bitmapAnimation"]["position"]["y"].as<int16_t>();
+        for (uint8_t i = 0; i < wallGifFrames; i++)
+        {
+            if (animationBmpDelays[i] == 0)
+            {
+                animationBmpDelays[i] = 100;
+            }
+            wallGifDuration += animationBmpDelays[i];
+        }
+        if (wallText == "")
+        {
+            wallTick = 20;
+        }
+    }
+
+    // Stop everything that draws on its own, the wall timeline takes over
+    clockAktiv = false;
+    scrollTextAktivLoop = false;
+    animateBMPAktivLoop = false;
+    effects.stop();
+    playlist.interrupt();
+
+    wallStartTime = startTime;
+    wallNextTick = startTime;
+    wallFrameReady = false;
+    wallScreenActive = true;
+    Log(F("Wall"), "Wall screen starts at " + String(startTime) + " (panel " + String(wallIndex + 1) + "/" + String(wallPanels) + ")");
+}
+
+void DrawWallFrame(uint32_t wallTime)
+{
+    // Every panel draws the same virtual canvas, shifted by its own position
+    int16_t offsetX = wallIndex * MATRIX_WIDTH;
+    uint32_t elapsed = wallTime - wallStartTime;
+
+    matrix->clear();
+
+    if (wallText != "")
+    {
+        uint16_t canvasWidth = wallPanels * MATRIX_WIDTH;
+        uint32_t period = canvasWidth + wallTextWidth;
+        int16_t posX = canvasWidth - (elapsed / wallScrollDelay) % period;
+
+        textEngine.setFont(&PixelItGlyphFont);
+        textEngine.setColor(wallTextColor);
+        textEngine.drawText(posX - offsetX, wallTextPosY, wallText.c_str());
+    }
+
+    if (wallGifFrames > 0)
+    {
+        uint32_t position = elapsed % wallGifDuration;
+        uint8_t frame = 0;
+        while (frame < wallGifFrames - 1 && position >= animationBmpDelays[frame])
+        {
+            position -= animationBmpDelays[frame];
+            frame++;
+        }
+        blitter.drawBitmap(wallGifPosX - offsetX, wallGifPosY, animationBmpList[frame], bmpWidth, bmpHeight);
+    }
+}
+
+void WallLoop()
+{
+    if (!wallScreenActive || sleepMode || realtime.isActive() || !wall.isSynced())
+    {
+        return;
+    }
+
+    uint32_t wallTime = wall.time();
+
+    // Fell behind (or the clock jumped), continue with the next tick from now
+    if ((int32_t)(wallTime - wallNextTick) > (int32_t)(wallTick * 4))
+    {
+        wallNextTick = wallTime - (wallTime - wallStartTime) % wallTick + wallTick;
+        wallFrameReady = false;
+    }
+
+    // Draw the next frame ahead of time, latch it with show() once the wall time is reached
+    if (!wallFrameReady)
+    {
+        DrawWallFrame(wallNextTick);
+        wallFrameReady = true;
+    }
+
+    if ((int32_t)(wallTime - wallNextTick) >= 0)
+    {
+        matrix->show();
+        wallNextTick += wallTick;
+        wallFrameReady = false;
+    }
+}
+
+void SetWallScreen(JsonObject &json)
+{
+    if (wall.role() != WallRole_Leader)
+    {
+        Log(LogLevel_Error, F("Wall"), F("Error: only the wall leader accepts wall screens"));
+        return;
+    }
+
+    String content;
+    json.printTo(content);
+    if (!wall.publish(content.c_str()))
+    {
+        Log(LogLevel_Error, F("Wall"), "Error: wall screen too large (" + String(content.length()) + " > " + String(WALL_CONTENT_LENGHT) + ")");
+    }
+}
+
+void HandleGetMainPage()
+{
+    // The page is stored gzipped in flash. Browsers revalidate on every load, so a firmware
+    // update shows at once, and unchanged pages only get a 304 via the ETag.
+    server.sendHeader(F("Cache-Control"), F("no-cache"));
+    server.sendHeader(F("ETag"), F(MAINPAGE_ETAG));
+    if (server.header(F("If-None-Match")).equals(MAINPAGE_ETAG))
+    {
+        server.send(304);
+        return;
+    }
+
+    server.sendHeader(F("Content-Encoding"), F("gzip"));
+    // Streamed from flash in chunks, no copy in RAM
+    server.send_P(200, PSTR("text/html"), (PGM_P)mainPage, MAINPAGE_LENGHT);
+}
+
+void HandleNotFound()
+{
+    if (server.method() == HttpServerMethod_Options)
+    {
+        server.sendHeader(F("Access-Control-Allow-Origin"), "*");
+        server.send(204);
+    }
+
+    server.sendHeader("Location", "/update", true);
+    server.send(302, F("text/plain"), "");
+}
+
+void HandleScreen()
+{
+    // Recorded before the in place parse changes the body
+    capture.add(CaptureTransport_Http, "/api/screen", server.body(), server.bodyLength());
+
+    // Parsed in place, the body is not copied again
+    DynamicJsonBuffer jsonBuffer;
+    JsonObject &json = jsonBuffer.parseObject(server.body());
+    server.sendHeader(F("Access-Control-Allow-Origin"), "*");
+
+    if (json.success())
+    {
+        server.send(200, F("application/json"), F("{\"response\":\"OK\"}"));
+        Log(F("HandleScreen"), "Incoming JSON length: " + String(json.measureLength()));
+        CreateFrames(json);
+    }
+    else
+    {
+        server.send(406, F("application/json"), F("{\"response\":\"Not Acceptable\"}"));
+    }
+}
+
+void HandleSetConfig()
+{
+    DynamicJsonBuffer jsonBuffer;
+    JsonObject &json = jsonBuffer.parseObject(server.body());
+
+    if (json.success())
+    {
+        Log(F("SetConfig"), "Incoming JSON length: " + String(json.measureLength()));
+        SetConfig(json);
+        server.send(200, F("application/json"), F("{\"response\":\"OK\"}"));
+        delay(500);
+        ESP.restart();
+    }
+    else
+    {
+        server.send(406, F("application/json"), F("{\"response\":\"Not Acceptable\"}"));
+    }
+}
+
+void HandleSetPlaylist()
+{
+    DynamicJsonBuffer jsonBuffer;
+    JsonObject &json = jsonBuffer.parseObject(server.body());
+    server.sendHeader(F("Access-Control-Allow-Origin"), "*");
+
+    if (json.success())
+    {
+        Log(F("SetPlaylist"), "Incoming JSON length: " + String(json.measureLength()));
+        SetPlaylist(json);
+        server.send(200, F("application/json"), F("{\"response\":\"OK\"}"));
+    }
+    else
+    {
+        server.send(406, F("application/json"), F("{\"response\":\"Not Acceptable\"}"));
+    }
+}
+
+void HandleSetWall()
+{
+    DynamicJsonBuffer jsonBuffer;
+    JsonObject &json = jsonBuffer.parseObject(server.body());
+    server.sendHeader(F("Access-Control-Allow-Origin"), "*");
+
+    if (json.success() && wall.role() == WallRole_Leader)
+    {
+        Log(F("SetWall"), "Incoming JSON length: " + String(json.measureLength()));
+        SetWallScreen(json);
+        server.send(200, F("application/json"), F("{\"response\":\"OK\"}"));
+    }
+    else
+    {
+        server.send(406, F("application/json"), F("{\"response\":\"Not Acceptable\"}"));
+    }
+}
+
+void HandleGetCapture()
+{
+    // The file is still written while recording
+    File file = capture.state() != CaptureState_Recording ? capture.open() : File();
+    if (!file)
+    {
+        server.send(406, F("application/json"), F("{\"response\":\"Not Acceptable\"}"));
+        return;
+    }
+    server.sendHeader(F("Content-Disposition"), F("attachment; filename=capture.bin"));
+    server.send(200, F("application/octet-stream"), file, file.size());
+    file.close();
+}
+
+void HandleSetCapture()
+{
+    DynamicJsonBuffer jsonBuffer;
+    JsonObject &json = jsonBuffer.parseObject(server.body());
+    server.sendHeader(F("Access-Control-Allow-Origin"), "*");
+
+    // action: record, stop, replay (speed in percent) or report
+    String action = json.success() ? json["action"].as<String>() : "";
+    bool success = action == "report";
+    if (action == "record")
+    {
+        success = capture.record();
+    }
+    else if (action == "stop")
+    {
+        capture.stop();
+        success = true;
+    }
+    else if (action == "replay")
+    {
+        success = capture.replay(json.containsKey("speed") ? json["speed"].as<uint16_t>() : 100);
+    }
+
+    if (success)
+    {
+        Log(F("Capture"), "Action: " + action);
+        server.send(200, F("application/json"), capture.report());
+    }
+    else
+    {
+        server.send(406, F("application/json"), F("{\"response\":\"Not Acceptable\"}"));
+    }
+}
+
+void HandleGetPlaylist()
+{
+    server.send(200, F("application/json"), GetPlaylist());
+}
+
+void HandleSetRules()
+{
+    DynamicJsonBuffer jsonBuffer;
+    JsonObject &json = jsonBuffer.parseObject(server.body());
+    server.sendHeader(F("Access-Control-Allow-Origin"), "*");
+
+    if (json.success())
+    {
+        Log(F("SetRules"), "Incoming JSON length: " + String(json.measureLength()));
+        SetRules(json);
+        server.send(200, F("application/json"), F("{\"response\":\"OK\"}"));
+    }
+    else
+    {
+        server.send(406, F("application/json"), F("{\"response\":\"Not Acceptable\"}"));
+    }
+}
+
+void HandleGetRules()
+{
+    server.send(200, F("application/json"), GetRules());
+}
+
+void HandleGifUpload()
+{
+    HttpServerUpload &upload = server.upload();
+    if (upload.status == HttpServerUpload_Start)
+    {
+        gifUploadSuccess = false;
+        // The GIF is still decoded and shown, the upload fails at the end
+        gifSaveFailed = !BeginGif(server.arg("save"));
+    }
+    else if (upload.status == HttpServerUpload_Write)
+    {
+        WriteGif(upload.buf, upload.currentSize);
+    }
+    else if (upload.status == HttpServerUpload_End)
+    {
+        gifUploadSuccess = EndGif() && !gifSaveFailed;
+    }
+    else if (upload.status == HttpServerUpload_Aborted)
+    {
+        AbortGif();
+    }
+}
+
+void HandleGif()
+{
+
+    if (gifUploadSuccess)
+    {
+        server.send(200, F("application/json"), F("{\"response\":\"OK\"}"));
+        if (server.arg("show") != "false")
+        {
+            ShowDecodedGif();
+        }
+    }
+    else
+    {
+        server.send(406, F("application/json"), F("{\"response\":\"Not Acceptable\"}"));
+    }
+    gifUploadSuccess = false;
+}
+
+void HandleGetUpdatePage()
+{
+    server.send_P(200, PSTR("text/html"), updatePage, strlen_P(updatePage));
+}
+
+void HandleUpdateUpload()
+{
+    // Firmware (or file system image) is written to flash while it is received
+    HttpServerUpload &upload = server.upload();
+    if (upload.status == HttpServerUpload_Start)
+    {
+        bool filesystem = upload.name == "filesystem";
+        bool heatshrink = upload.filename.endsWith(".hs") || server.arg("format") == "heatshrink";
+        String md5 = server.arg("md5");
+        Log(F("Update"), "Update started: " + upload.filename + (filesystem ? " (filesystem)" : "") + (heatshrink ? " (heatshrink)" : "") + (md5.length() > 0 ? ", MD5 " + md5 : ""));
+        if (firmwareUpdate.begin(filesystem, heatshrink, md5, upload.contentLength))
+        {
+            ShowUpdateProgress(0);
+        }
+    }
+    else if (upload.status == HttpServerUpload_Write)
+    {
+        firmwareUpdate.write(upload.buf, upload.currentSize);
+    }
+    else if (upload.status == HttpServerUpload_End)
+    {
+        if (firmwareUpdate.end())
+        {
+            Log(F("Update"), "Update finished: " + String(upload.totalSize) + " bytes");
+        }
+    }
+    else if (upload.status == HttpServerUpload_Aborted)
+    {
+        firmwareUpdate.abort();
+        Log(F("Update"), F("Update aborted"));
+    }
+}
+
+void HandleUpdate()
+{
+    if (firmwareUpdate.success())
+    {
+        server.send(200, F("text/html"), F("Update Success! Rebooting..."));
+        delay(500);
+        ESP.restart();
+    }
+    else
+    {
+        String error = firmwareUpdate.error();
+        Log(LogLevel_Error, F("Update"), "Update failed: " + error);
+        server.send(500, F("text/plain"), "Update failed: " + error);
+        forceClock = true;
+    }
+}
+
+void ShowUpdateProgress(uint8_t progress)
+{
+    if (sleepMode || realtime.isActive())
+    {
+        return;
+    }
+
+    // Only the bar is redrawn, one show() per percent keeps the upload going
+    if (progress == 0)
+    {
+        lastScreenMessageMillis = millis();
+        clockAktiv = false;
+        scrollTextAktivLoop = false;
+        animateBMPAktivLoop = false;
+        effects.stop();
+        wallScreenActive = false;
+        playlist.interrupt();
+
+        matrix->setBrightness(currentMatrixBrightness);
+        matrix->clear();
+        DrawTextCenter(F("Update"), 0, 255, 255, 255, 0, 1);
+    }
+    // Keeps the clock fallback and the playlist away
+    lastScreenMessageMillis = millis();
+    forcedScreenIsActiveUntil = millis() + 5000;
+
+    uint16_t done = Geometry::width * progress / 100;
+    if (done > 0)
+    {
+        matrix->drawLine(0, Geometry::height - 1, done - 1, Geometry::height - 1, matrix->Color(0, 255, 0));
+    }
+    matrix->show();
+}
+
+void SendStatusJson(void (*write)(JsonWriter &json))
+{
+    statusJson.reset();
+    write(statusJson);
+    server.send(200, F("application/json"), statusJson.c_str(), statusJson.length());
+}
+
+void HandleGetConfig()
+{
+    size_t configLength = ConfigJsonLength();
+    std::unique_ptr<char[]> buffer(new char[configLength]);
+    JsonWriter json(buffer.get(), configLength);
+    WriteConfig(json);
+    server.send(200, F("application/json"), json.c_str(), json.length());
+}
+
+void HandleGetLuxSensor()
+{
+    SendStatusJson(WriteLuxSensor);
+}
+
+void HandleGetBrightness()
+{
+    SendStatusJson(WriteBrightness);
+}
+
+void HandleGetDHTSensor() // Legancy
+{
+    SendStatusJson(WriteSensor);
+}
+
+void HandleGetSensor()
+{
+    SendStatusJson(WriteSensor);
+}
+
+void HandleGetSensorHistory()
+{
+    int8_t resolution = SensorHistory::resolutionFromName(server.hasArg("resolution") ? server.arg("resolution").c_str() : "1m");
+    if (resolution < 0)
+    {
+        server.send(406, F("application/json"), F("{\"response\":\"Not Acceptable\"}"));
+        return;
+    }
+    server.send(200, F("application/json"), GetSensorHistory(static_cast<SensorResolution>(resolution)));
+}
+
+void HandleGetButtons()
+{
+    SendStatusJson(WriteButtons);
+}
+
+void HandleGetMatrixInfo()
+{
+    SendStatusJson(WriteMatrixInfo);
+}
+
+void HandleGetLog()
+{
+    server.send(200, F("application/json"), logger.history());
+}
+
+void HandelWifiConfigReset()
+{
+    server.send(200, F("application/json"), F("{\"response\":\"OK\"}"));
+    EraseWifiCredentials();
+}
+
+void HandleFactoryReset()
+{
+    server.send(200, F("application/json"), F("{\"response\":\"OK\"}"));
+#if defined(ESP8266)
+    File configFile = LittleFS.open("/config.json", "w");
+#elif defined(ESP32)
+    File configFile = SPIFFS.open("/config.json", "w");
+#endif
+    if (!configFile)
+    {
+        Log(LogLevel_Error, F("Handle_factoryreset"), F("Failed to open config file for reset"));
+    }
+    configFile.println("");
+    configFile.close();
+    EraseWifiCredentials();
+}
+
+void SleepScreen(bool startSleep, bool forceClockOnWake)
+{
+    if (startSleep)
+    {
+        Log(F("SleepScreen"), F("Sleeping..."));
+        matrix->clear();
+        DrawTextHelper("z", false, false, false, false, false, 0, 0, 255, (MATRIX_WIDTH / 2) - 6, Geometry::clockY + 1);
+        matrix->show();
+        delay(200);
+        DrawTextHelper("Z", false, false, false, false, false, 0, 0, 255, (MATRIX_WIDTH / 2) - 1, Geometry::clockY + 1);
+        matrix->show();
+        delay(200);
+        DrawTextHelper("z", false, false, false, false, false, 0, 0, 255, (MATRIX_WIDTH / 2) + 4, Geometry::clockY + 1);
+        matrix->show();
+        delay(500);
+        FadeOut(30, 0);
+        matrix->setBrightness(0);
+        matrix->show();
+    }
+    else
+    {
+        Log(F("SleepScreen"), F("Waking up..."));
+        matrix->clear();
+        // DrawTextHelper("😀", false, true, false, false, false, 255, 200, 0, 0, 1);
+        // FadeIn(30, 0);
+        // delay(150);
+        forceClock = forceClockOnWake;
+    }
+}
+
+void HandleAndSendButtonPress(uint button, bool state)
+{
+    btnLastPublishState[button] = state;
+    Log(F("Buttons"), btnLogNames[button] + " is now " + (state ? "true" : "false"));
+
+    // Prüfen ob über MQTT versendet werden muss
+    if (mqttAktiv == true && client.connected())
+    {
+        client.publish((mqttMasterTopic + "buttons/button" + String(button)).c_str(), (state ? "true" : "false"), true);
+        if (mqttUseDeviceTopic)
+        {
+            client.publish((mqttDeviceTopic + "buttons/button" + String(button)).c_str(), (state ? "true" : "false"), true);
+        }
+    }
+    // Prüfen ob über Websocket versendet werden muss
+    if (webSocket.connectedClients() > 0)
+    {
+        for (uint i = 0; i < sizeof websocketConnection / sizeof websocketConnection[0]; i++)
+        {
+            webSocket.sendTXT(i, "{\"buttons\":{\"" + btnAPINames[button] + "\":" + (state ? "true" : "false") + "}}");
+        }
+    }
+}
+
+void SendButtonGesture(uint button, const String &gesture)
+{
+    Log(F("Buttons"), btnLogNames[button] + " " + gesture);
+
+    if (mqttAktiv == true && client.connected())
+    {
+        client.publish((mqttMasterTopic + "buttons/button" + String(button) + "/event").c_str(), gesture.c_str(), false);
+        if (mqttUseDeviceTopic)
+        {
+            client.publish((mqttDeviceTopic + "buttons/button" + String(button) + "/event").c_str(), gesture.c_str(), false);
+        }
+    }
+    if (webSocket.connectedClients() > 0)
+    {
+        for (uint i = 0; i < sizeof websocketConnection / sizeof websocketConnection[0]; i++)
+        {
+            webSocket.sendTXT(i, "{\"buttonEvents\":{\"" + btnAPINames[button] + "\":\"" + gesture + "\"}}");
+        }
+    }
+}
+
+void ExecuteButtonAction(btnActions action)
+{
+    if (action == btnAction_ToggleSleepMode)
     {
         sleepMode = !sleepMode;
         SleepScreen(sleepMode, true);
     }
-    if (btnAction[button] == btnAction_GotoClock)
+    if (action == btnAction_GotoClock)
     {
         forceClock = true;
+        playlist.interrupt();
     }
-    if (btnAction[button] == btnAction_MP3PlayPrevious)
+    if (action == btnAction_MP3PlayPrevious)
     {
         mp3Player.playPrevious();
     }
-    if (btnAction[button] == btnAction_MP3PlayNext)
+    if (action == btnAction_MP3PlayNext)
     {
         mp3Player.playNext();
     }
-    if (btnAction[button] == btnAction_MP3PlayPause)
+    if (action == btnAction_MP3PlayPause)
     {
         if (mp3Player.isPlaying())
         {
@@ -1101,16 +2581,71 @@ void HandleAndSendButtonPress(uint button, bool state)
         }
         else
         {
-            delay(200);
             mp3Player.resume();
         }
     }
 }
 
+void HandleButtonEvent(uint8_t button, btnEvents event)
+{
+    rules.buttonEvent(button, event);
+
+    switch (event)
+    {
+    case btnEvent_Pressed:
+        HandleAndSendButtonPress(button, true);
+        if (!btnGestures[button])
+        {
+            ExecuteButtonAction(btnAction[button]);
+        }
+        break;
+    case btnEvent_Released:
+        HandleAndSendButtonPress(button, false);
+        break;
+    case btnEvent_Short:
+        SendButtonGesture(button, F("short"));
+        if (btnGestures[button])
+        {
+            ExecuteButtonAction(btnAction[button]);
+        }
+        break;
+    case btnEvent_Long:
+        SendButtonGesture(button, F("long"));
+        ExecuteButtonAction(btnLongAction[button]);
+        break;
+    case btnEvent_Double:
+        SendButtonGesture(button, F("double"));
+        ExecuteButtonAction(btnDoubleAction[button]);
+        break;
+    case btnEvent_Repeat:
+        SendButtonGesture(button, F("repeat"));
+        break;
+    }
+}
+
+void UpdateButtonGestures()
+{
+    // Waiting for a second click delays the short press, only do it if a double press is used
+    for (uint8_t b = 0; b < 3; b++)
+    {
+        bool doublePress = btnDoubleAction[b] != btnAction_DoNothing || rules.hasButtonRules(b, btnEvent_Double);
+        buttons.setDoublePressEnabled(b, doublePress);
+
+        // Without any gesture the action runs on press, as fast as before the gestures existed
+        btnGestures[b] = doublePress || btnLongAction[b] != btnAction_DoNothing || rules.hasButtonRules(b, btnEvent_Short) || rules.hasButtonRules(b, btnEvent_Long) || rules.hasButtonRules(b, btnEvent_Repeat);
+    }
+}
+
 void callback(char *topic, byte *payload, unsigned int length)
 {
     if (payload[0] == '{')
     {
+        // Rejected before the parser needs about as much memory again
+        if (!memoryBudget.acceptMessage(length))
+        {
+            Logf(LogLevel_Warning, F("MQTT_callback"), PSTR("Message rejected, low memory (Bytes: %u)"), length);
+            return;
+        }
         payload[length] = '\0';
         String channel = String(topic);
         int lastSlashIndex = channel.lastIndexOf('/');
@@ -1118,15 +2653,17 @@ void callback(char *topic, byte *payload, unsigned int length)
         {
             channel = channel.substring(lastSlashIndex + 1);
         }
+        capture.add(CaptureTransport_Mqtt, channel.c_str(), (const char *)payload, length);
 
         DynamicJsonBuffer jsonBuffer;
         JsonObject &json = jsonBuffer.parseObject(payload);
 
-        Log("MQTT_callback", "Incoming JSON (Topic: " + String(topic) + ", Cmd: " + channel + ", Bytes: " + String(length) + "/" + String(json.measureLength()) + ") ");
+        Logf(LogLevel_Info, F("MQTT_callback"), PSTR("Incoming JSON (Topic: %s, Cmd: %s, Bytes: %u/%u)"), topic, channel.c_str(), length, json.measureLength());
+        Logf(LogLevel_Debug, F("MQTT_callback"), PSTR("%s"), (const char *)payload);
 
         if (json.measureLength() == 2)
         {
-            Log("MQTT_callback", "JSON message empty or too long");
+            Log(F("MQTT_callback"), F("JSON message empty or too long"));
             return;
         }
         if (channel.equals("setScreen"))
@@ -1135,32 +2672,56 @@ void callback(char *topic, byte *payload, unsigned int length)
         }
         else if (channel.equals("getLuxsensor"))
         {
-            client.publish((mqttMasterTopic + "luxsensor").c_str(), GetLuxSensor().c_str());
+            statusJson.reset();
+            WriteLuxSensor(statusJson);
+            client.publish((mqttMasterTopic + "luxsensor").c_str(), statusJson.c_str());
             if (mqttUseDeviceTopic)
             {
-                client.publish((mqttDeviceTopic + "luxsensor").c_str(), GetLuxSensor().c_str());
+                client.publish((mqttDeviceTopic + "luxsensor").c_str(), statusJson.c_str());
             }
         }
         else if (channel.equals("getMatrixinfo"))
         {
-            client.publish((mqttMasterTopic + "matrixinfo").c_str(), GetMatrixInfo().c_str());
+            statusJson.reset();
+            WriteMatrixInfo(statusJson);
+            client.publish((mqttMasterTopic + "matrixinfo").c_str(), statusJson.c_str());
             if (mqttUseDeviceTopic)
             {
-                client.publish((mqttDeviceTopic + "matrixinfo").c_str(), GetMatrixInfo().c_str());
+                client.publish((mqttDeviceTopic + "matrixinfo").c_str(), statusJson.c_str());
             }
         }
         else if (channel.equals("getConfig"))
         {
-            client.publish((mqttMasterTopic + "config").c_str(), GetConfig().c_str());
+            size_t configLength = ConfigJsonLength();
+            std::unique_ptr<char[]> buffer(new char[configLength]);
+            JsonWriter config(buffer.get(), configLength);
+            WriteConfig(config);
+            client.publish((mqttMasterTopic + "config").c_str(), config.c_str());
             if (mqttUseDeviceTopic)
             {
-                client.publish((mqttDeviceTopic + "config").c_str(), GetConfig().c_str());
+                client.publish((mqttDeviceTopic + "config").c_str(), config.c_str());
             }
         }
         else if (channel.equals("setConfig"))
         {
             SetConfig(json);
         }
+        else if (channel.equals("setPlaylist"))
+        {
+            SetPlaylist(json);
+        }
+        else if (channel.equals("setRules"))
+        {
+            SetRules(json);
+        }
+        else if (channel.equals("setWall"))
+        {
+            SetWallScreen(json);
+        }
+        else if (channel.equals("setSpectrum"))
+        {
+            SetSpectrum(json);
+        }
     }
 }
 
@@ -1170,7 +2731,7 @@ void webSocketEvent(uint8_t num, WStype_t type, uint8_t *payload, size_t length)
     {
     case WStype_DISCONNECTED:
     {
-        Log("WebSocketEvent", "[" + String(num) + "] Disconnected!");
+        Logf(LogLevel_Info, F("WebSocketEvent"), PSTR("[%u] Disconnected!"), num);
         websocketConnection[num] = "";
         break;
     }
@@ -1183,30 +2744,46 @@ void webSocketEvent(uint8_t num, WStype_t type, uint8_t *payload, size_t length)
         IPAddress ip = webSocket.remoteIP(num);
 
         // Logging
-        Log(F("WebSocketEvent"), "[" + String(num) + "] Connected from " + ip.toString() + " url: " + websocketConnection[num]);
+        Logf(LogLevel_Info, F("WebSocketEvent"), PSTR("[%u] Connected from %s url: %s"), num, ip.toString().c_str(), websocketConnection[num].c_str());
 
         // send message to client
         SendMatrixInfo();
         SendLDR(true);
         SendSensor(true);
         SendConfig();
-        webSocket.sendTXT(num, "{\"buttons\":" + GetButtons() + "}");
-        webSocket.sendTXT(num, "{\"telemetry\":" + GetTelemetry() + "}");
+        statusJson.reset();
+        statusJson.beginEnvelope("buttons");
+        WriteButtons(statusJson);
+        statusJson.endEnvelope();
+        webSocket.sendTXT(num, statusJson.frame(), statusJson.length(), true);
+        statusJson.reset();
+        statusJson.beginEnvelope("telemetry");
+        WriteTelemetry(statusJson);
+        statusJson.endEnvelope();
+        webSocket.sendTXT(num, statusJson.frame(), statusJson.length(), true);
         break;
     }
     case WStype_TEXT:
     {
         if (((char *)payload)[0] == '{')
         {
+            if (!memoryBudget.acceptMessage(length))
+            {
+                Logf(LogLevel_Warning, F("WebSocketEvent"), PSTR("Message rejected, low memory (Length: %u)"), (unsigned int)length);
+                return;
+            }
+            capture.add(CaptureTransport_WebSocket, "", (const char *)payload, length);
+
             DynamicJsonBuffer jsonBuffer;
             JsonObject &json = jsonBuffer.parseObject(payload);
             int forcedDuration = 0;
 
             // Logging
-            Log(F("WebSocketEvent"), "Incoming JSON (Length: " + String(length) + "/" + String(json.measureLength()) + ")");
+            Logf(LogLevel_Info, F("WebSocketEvent"), PSTR("Incoming JSON (Length: %u/%u)"), (unsigned int)length, json.measureLength());
+            Logf(LogLevel_Debug, F("WebSocketEvent"), PSTR("%.*s"), (int)length, (const char *)payload);
             if (length != json.measureLength())
             {
-                Log("MQTT_callback", "JSON length mismatch! JSON Message to long :(");
+                Log(F("WebSocketEvent"), F("JSON length mismatch! JSON Message to long :("));
                 return;
             }
 
@@ -1225,6 +2802,22 @@ void webSocketEvent(uint8_t num, WStype_t type, uint8_t *payload, size_t length)
                 delay(500);
                 ESP.restart();
             }
+            else if (json.containsKey("setPlaylist"))
+            {
+                SetPlaylist(json["setPlaylist"]);
+            }
+            else if (json.containsKey("setRules"))
+            {
+                SetRules(json["setRules"]);
+            }
+            else if (json.containsKey("setWall"))
+            {
+                SetWallScreen(json["setWall"]);
+            }
+            else if (json.containsKey("setSpectrum"))
+            {
+                SetSpectrum(json["setSpectrum"]);
+            }
             else if (json.containsKey("wifiReset"))
             {
                 if (json["wifiReset"].as<bool>() == true)
@@ -1247,14 +2840,37 @@ void webSocketEvent(uint8_t num, WStype_t type, uint8_t *payload, size_t length)
         break;
     }
     case WStype_BIN:
+        // Binary messages are GIF animations
+        BeginGif("");
+        WriteGif(payload, length);
+        if (EndGif())
+        {
+            ShowDecodedGif();
+        }
         break;
     case WStype_FRAGMENT_BIN_START:
+        gifWebSocketActive = true;
+        BeginGif("");
+        WriteGif(payload, length);
         break;
     case WStype_FRAGMENT_TEXT_START:
         break;
     case WStype_FRAGMENT:
+        if (gifWebSocketActive)
+        {
+            WriteGif(payload, length);
+        }
         break;
     case WStype_FRAGMENT_FIN:
+        if (gifWebSocketActive)
+        {
+            gifWebSocketActive = false;
+            WriteGif(payload, length);
+            if (EndGif())
+            {
+                ShowDecodedGif();
+            }
+        }
         break;
     case WStype_PING:
         break;
@@ -1274,12 +2890,13 @@ void CreateFrames(JsonObject &json, int forceDuration)
 {
     bool sendMatrixInfo = false;
 
-    String logMessage = F("JSON contains ");
+    // What the JSON contained, logged at the end
+    char logMessage[LOG_MESSAGE_LENGHT] = "";
 
     if (json.containsKey("sleepMode"))
     {
 
-        logMessage += F("Sleep Control, ");
+        LogAppend(logMessage, PSTR("Sleep Control, "));
         Serial.printf("SleepMode: %s\n", json["sleepMode"].as<bool>() ? "true" : "false");
 
         // Update internal sleep state
@@ -1308,7 +2925,7 @@ void CreateFrames(JsonObject &json, int forceDuration)
     // Ist eine Display Helligkeit übergeben worden?
     if (json.containsKey("brightness") && !sleepMode)
     {
-        logMessage += F("Brightness Control, ");
+        LogAppend(logMessage, PSTR("Brightness Control, "));
 
         if (json["brightness"].as<int>() != currentMatrixBrightness)
         {
@@ -1322,7 +2939,7 @@ void CreateFrames(JsonObject &json, int forceDuration)
     // Enable/Disable automatic brightness control
     if (json.containsKey("autobrightness"))
     {
-        logMessage += F("Brightness Automatic Control, ");
+        LogAppend(logMessage, PSTR("Brightness Automatic Control, "));
         if (json["autobrightness"].as<bool>() != matrixBrightnessAutomatic)
         {
             sendMatrixInfo = true;
@@ -1333,75 +2950,22 @@ void CreateFrames(JsonObject &json, int forceDuration)
     // Set GPIO
     if (json.containsKey("setGpio"))
     {
-        logMessage += F("Set Gpio, ");
+        LogAppend(logMessage, PSTR("Set Gpio, "));
         if (json["setGpio"]["set"].is<bool>() && json["setGpio"]["gpio"].is<uint8_t>())
         {
-            uint8_t gpio = json["setGpio"]["gpio"].as<uint8_t>();
-
-            // If the GPIO is already present in the array?
-            // has been found, this is to be replaced.
-            if (json["setGpio"]["duration"].is<ulong>())
-            {
-                int arrayIndex = -1;
-                for (int i = 0; i < SET_GPIO_SIZE; i++)
-                {
-                    if (setGPIOReset[i].gpio == gpio)
-                    {
-                        arrayIndex = i;
-                        break;
-                    }
-                }
-                // Search free place in array.
-                if (arrayIndex == -1)
-                {
-                    for (int i = 0; i < SET_GPIO_SIZE; i++)
-                    {
-                        if (setGPIOReset[i].gpio == -1)
-                        {
-                            arrayIndex = i;
-                            break;
-                        }
-                    }
-                }
-
-                if (arrayIndex == -1)
-                {
-                    Log(F("SetGPIO"), F("Error: no free place in array found!"));
-                }
-                else
-                {
-                    // Save data in array for the reset.
-                    setGPIOReset[arrayIndex].gpio = gpio;
-                    setGPIOReset[arrayIndex].resetMillis = (millis() + json["setGpio"]["duration"].as<ulong>());
-                    Log(F("SetGPIO"), "Pos: " + String(arrayIndex) + ", GPIO: " + String(gpio) + ", Duration: " + String(json["setGpio"]["duration"].as<char *>()) + ", Value: " + json["setGpio"]["set"].as<char *>());
-                }
-            }
-            else
-            {
-                Log(F("SetGPIO"), "GPIO: " + String(gpio) + ", Value: " + json["setGpio"]["set"].as<char *>());
-            }
-            // Set GPIO
-            pinMode(gpio, OUTPUT);
-            digitalWrite(gpio, json["setGpio"]["set"].as<bool>());
+            SetGpio(json["setGpio"]["gpio"].as<uint8_t>(), json["setGpio"]["set"].as<bool>(), json["setGpio"]["duration"].is<ulong>() ? json["setGpio"]["duration"].as<ulong>() : 0);
         }
     }
 
     // Sound
     if (json.containsKey("sound"))
     {
-        logMessage += F("Sound, ");
+        LogAppend(logMessage, PSTR("Sound, "));
         // Volume
         if (json["sound"]["volume"] != NULL && json["sound"]["volume"].is<int>())
         {
+            // Queued, the player keeps the spacing the module needs after a volume change
             mp3Player.volume(json["sound"]["volume"].as<int>());
-
-            // Sometimes, mp3Player gets hickups. A brief delay might help - but also might hinder scrolling.
-            // So, do it only if there are more commands to come.
-            if (json["sound"]["control"].as<String>() == "")
-            {
-                Log(F("Sound"), F("Changing volume can prevent DFPlayer from executing a control command at the same time. Better make two separate API calls."));
-                delay(200);
-            }
         }
         // Play
         if (json["sound"]["control"] == "play")
@@ -1436,17 +3000,25 @@ void CreateFrames(JsonObject &json, int forceDuration)
     // - no sleepmode control is in message
     // - not sleeping
     // - no forced screen is active OR forceDuration is set
-    if (!json.containsKey("sleepMode") && !sleepMode && (millis() >= forcedScreenIsActiveUntil || forceDuration > 0))
+    if (!json.containsKey("sleepMode") && !sleepMode && !realtime.isActive() && (millis() >= forcedScreenIsActiveUntil || forceDuration > 0))
     {
         matrix->setBrightness(currentMatrixBrightness);
 
         // Prüfung für die Unterbrechnung der lokalen Schleifen
-        if (json.containsKey("bitmap") || json.containsKey("bitmaps") || json.containsKey("text") || json.containsKey("bar") || json.containsKey("bars") || json.containsKey("bitmapAnimation"))
+        if (json.containsKey("bitmap") || json.containsKey("bitmaps") || json.containsKey("text") || json.containsKey("bar") || json.containsKey("bars") || json.containsKey("sparkline") || json.containsKey("effect") || json.containsKey("bitmapAnimation"))
         {
             lastScreenMessageMillis = millis();
             clockAktiv = false;
             scrollTextAktivLoop = false;
             animateBMPAktivLoop = false;
+            wallScreenActive = false;
+            effects.stop();
+        }
+
+        // Screens from outside interrupt the local playlist for a while
+        if (!playlistScreenRendering && (json.containsKey("bitmap") || json.containsKey("bitmaps") || json.containsKey("text") || json.containsKey("bar") || json.containsKey("bars") || json.containsKey("sparkline") || json.containsKey("effect") || json.containsKey("bitmapAnimation") || json.containsKey("clock")))
+        {
+            playlist.interrupt();
         }
 
         // Ist eine Switch Animation übergeben worden?
@@ -1456,7 +3028,7 @@ void CreateFrames(JsonObject &json, int forceDuration)
         bool bitmapWipeAnimationAktiv = false;
         if (json.containsKey("switchAnimation"))
         {
-            logMessage += F("SwitchAnimation, ");
+            LogAppend(logMessage, PSTR("SwitchAnimation, "));
             // Switch Animation aktiv?
             if (json["switchAnimation"]["aktiv"])
             {
@@ -1529,9 +3101,10 @@ void CreateFrames(JsonObject &json, int forceDuration)
         // Clock
         if (json.containsKey("clock"))
         {
-            logMessage += F("InternalClock Control, Params: (");
+            LogAppend(logMessage, PSTR("InternalClock Control, Params: ("));
             scrollTextAktivLoop = false;
             animateBMPAktivLoop = false;
+            effects.stop();
             clockAktiv = true;
 
             clockCounterClock = 0;
@@ -1540,71 +3113,75 @@ void CreateFrames(JsonObject &json, int forceDuration)
             bool isSwitchAktivSet = json["clock"]["switchAktiv"].is<bool>();
             if (isSwitchAktivSet)
             {
-                logMessage += F("clockSwitchAktiv, ");
+                LogAppend(logMessage, PSTR("clockSwitchAktiv, "));
                 clockSwitchAktiv = json["clock"]["switchAktiv"];
             }
 
             bool isClockSwitchSecSet = json["clock"]["switchSec"] != NULL;
             if (clockSwitchAktiv && isClockSwitchSecSet)
             {
-                logMessage += F("clockSwitchSec, ");
+                LogAppend(logMessage, PSTR("clockSwitchSec, "));
                 clockSwitchSec = json["clock"]["switchSec"];
             }
 
             bool isClockWithSecondsSet = json["clock"]["withSeconds"].is<bool>();
             if (isClockWithSecondsSet)
             {
-                logMessage += F("withSeconds, ");
+                LogAppend(logMessage, PSTR("withSeconds, "));
                 clockWithSeconds = json["clock"]["withSeconds"];
             }
 
             bool isClockBlinkAnimatedSet = json["clock"]["blinkAnimated"].is<bool>();
             if (isClockBlinkAnimatedSet)
             {
-                logMessage += F("blinkAnimated, ");
+                LogAppend(logMessage, PSTR("blinkAnimated, "));
                 clockBlinkAnimated = json["clock"]["blinkAnimated"];
             }
 
+            bool isRollDigitsSet = json["clock"]["rollDigits"].is<bool>();
+            if (isRollDigitsSet)
+            {
+                LogAppend(logMessage, PSTR("rollDigits, "));
+                clockRollDigits = json["clock"]["rollDigits"];
+            }
+
             bool isFatFontSet = json["clock"]["fatFont"].is<bool>();
             if (isFatFontSet)
             {
-                logMessage += F("fatFont, ");
+                LogAppend(logMessage, PSTR("fatFont, "));
                 clockFatFont = json["clock"]["fatFont"];
             }
             bool isLargeFontSet = json["clock"]["largeFont"].is<bool>();
             if (isLargeFontSet)
             {
-                logMessage += F("largeFont, ");
+                LogAppend(logMessage, PSTR("largeFont, "));
                 clockLargeFont = json["clock"]["largeFont"];
             }
             bool isDrawWeekDaysSet = json["clock"]["drawWeekDays"].is<bool>();
             if (isDrawWeekDaysSet)
             {
-                logMessage += F("drawWeekDays, ");
+                LogAppend(logMessage, PSTR("drawWeekDays, "));
                 clockDrawWeekDays = json["clock"]["drawWeekDays"];
             }
 
             if (json["clock"]["color"]["r"].as<char *>() != NULL)
             {
-                logMessage += F("color, ");
+                LogAppend(logMessage, PSTR("color, "));
                 clockColorR = json["clock"]["color"]["r"].as<uint8_t>();
                 clockColorG = json["clock"]["color"]["g"].as<uint8_t>();
                 clockColorB = json["clock"]["color"]["b"].as<uint8_t>();
             }
             else if (json["clock"]["hexColor"].as<char *>() != NULL)
             {
-                logMessage += F("hexColor, ");
+                LogAppend(logMessage, PSTR("hexColor, "));
                 HEXtoRGB(json["clock"]["hexColor"].as<char *>(), clockColorR, clockColorG, clockColorB);
             }
-            if (logMessage.endsWith(", "))
-            {
-                logMessage.remove(logMessage.length() - 2);
-            }
-            logMessage += F("), ");
+            LogTrimList(logMessage);
+            LogAppend(logMessage, PSTR("), "));
             DrawClock(true);
         }
 
-        if (json.containsKey("bitmap") || json.containsKey("bitmaps") || json.containsKey("bitmapAnimation") || json.containsKey("text") || json.containsKey("bar") || json.containsKey("bars"))
+        if (json.containsKey("bitmap") || json.containsKey("bitmaps") || json.containsKey("bitmapAnimation") || json.containsKey("text") || json.containsKey("bar") || json.containsKey("bars") || json.containsKey("sparkline") || json.containsKey("effect"))
         {
             // Alle Pixel löschen
             matrix->clear();
@@ -1613,7 +3190,7 @@ void CreateFrames(JsonObject &json, int forceDuration)
         // Bar
         if (json.containsKey("bar"))
         {
-            logMessage += F("Bar, ");
+            LogAppend(logMessage, PSTR("Bar, "));
             uint8_t r, g, b;
             if (json["bar"]["hexColor"].as<char *>() != NULL)
             {
@@ -1631,7 +3208,7 @@ void CreateFrames(JsonObject &json, int forceDuration)
         // Bars
         if (json.containsKey("bars"))
         {
-            logMessage += F("Bars, ");
+            LogAppend(logMessage, PSTR("Bars, "));
             for (JsonVariant x : json["bars"].as<JsonArray>())
             {
                 uint8_t r, g, b;
@@ -1649,6 +3226,20 @@ void CreateFrames(JsonObject &json, int forceDuration)
             }
         }
 
+        // Sparkline
+        if (json.containsKey("sparkline"))
+        {
+            LogAppend(logMessage, PSTR("Sparkline, "));
+            DrawSparkline(json["sparkline"].as<JsonObject>());
+        }
+
+        // Effect, drawn when the rest of the screen is complete
+        if (json.containsKey("effect"))
+        {
+            LogAppend(logMessage, PSTR("Effect, "));
+            StartEffect(json["effect"].as<JsonObject>());
+        }
+
         // clear withBMP only if no sleepMode is in the same message
         if (!json.containsKey("sleepMode"))
         {
@@ -1661,7 +3252,7 @@ void CreateFrames(JsonObject &json, int forceDuration)
             withBMP = json["withBMPRestore"];
             if (withBMP == true)
             {
-                matrix->drawRGBBitmap(bmpPosX, bmpPosY, bmpArray, bmpWidth, bmpHeight);
+                blitter.drawBitmap(bmpPosX, bmpPosY, bmpArray, bmpWidth, bmpHeight);
             }
         }
 
@@ -1674,20 +3265,18 @@ void CreateFrames(JsonObject &json, int forceDuration)
         // Ist ein Bitmap übergeben worden?
         if (json.containsKey("bitmap"))
         {
-            logMessage += F("Bitmap, ");
+            LogAppend(logMessage, PSTR("Bitmap, "));
             DrawSingleBitmap(json["bitmap"]);
         }
 
         // Sind mehrere Bitmaps übergeben worden?
         if (json.containsKey("bitmaps"))
         {
-            logMessage += F("Bitmaps (");
             for (JsonVariant singleBitmap : json["bitmaps"].as<JsonArray>())
             {
                 DrawSingleBitmap(singleBitmap);
             }
-            logMessage += json["bitmaps"].as<JsonArray>().size();
-            logMessage += F("), ");
+            LogAppend(logMessage, PSTR("Bitmaps (%u), "), (unsigned int)json["bitmaps"].as<JsonArray>().size());
         }
 
         // Ist eine BitmapAnimation übergeben worden?
@@ -1709,29 +3298,50 @@ void CreateFrames(JsonObject &json, int forceDuration)
             }
             withBMP = true;
 
-            logMessage += F("BitmapAnimation, ");
-            // animationBmpList zurücksetzten um das ende nacher zu finden -1 (habe aktuell keine bessere Lösung)
-            for (int i = 0; i < 10; i++)
+            bool isGif = json["bitmapAnimation"].containsKey("gif") || json["bitmapAnimation"]["decoded"].as<bool>();
+            if (isGif)
             {
-                animationBmpList[i][0] = 2;
+                LogAppend(logMessage, PSTR("BitmapAnimation (GIF), "));
+                // "gif" is decoded from flash, "decoded" was already decoded by an upload
+                if (json["bitmapAnimation"].containsKey("gif") && !LoadGif(json["bitmapAnimation"]["gif"].as<String>()))
+                {
+                    animationBmpList[0][0] = 2;
+                }
+                if (!json["bitmapAnimation"]["size"]["width"].is<int16_t>() || !json["bitmapAnimation"]["size"]["height"].is<int16_t>())
+                {
+                    bmpWidth = gifDecoder.width();
+                    bmpHeight = gifDecoder.height();
+                }
             }
-
-            int counter = 0;
-            for (JsonVariant x : json["bitmapAnimation"]["data"].as<JsonArray>())
+            else
             {
-                // JsonArray in IntArray konvertieren
-                x.as<JsonArray>().copyTo(bmpArray);
-                // Speichern für die Ausgabe
-                for (int i = 0; i < 64; i++)
+                LogAppend(logMessage, PSTR("BitmapAnimation, "));
+                // animationBmpList zurücksetzten um das ende nacher zu finden -1 (habe aktuell keine bessere Lösung)
+                for (int i = 0; i < 10; i++)
                 {
-                    animationBmpList[counter][i] = bmpArray[i];
+                    animationBmpList[i][0] = 2;
+                    animationBmpDelays[i] = 0;
+                }
+
+                int counter = 0;
+                for (JsonVariant x : json["bitmapAnimation"]["data"].as<JsonArray>())
+                {
+                    // JsonArray in IntArray konvertieren
+                    x.as<JsonArray>().copyTo(bmpArray);
+                    // Speichern für die Ausgabe
+                    for (int i = 0; i < Geometry::bitmapPixels; i++)
+                    {
+                        animationBmpList[counter][i] = bmpArray[i];
+                    }
+                    counter++;
                 }
-                counter++;
-            }
 
-            // Serial.printf("Counter: %d\n", counter);
+                // Serial.printf("Counter: %d\n", counter);
+            }
 
             animateBMPDelay = json["bitmapAnimation"]["animationDelay"];
+            // An explicit animationDelay wins over the delays in the GIF
+            animateBMPFrameDelays = isGif && animateBMPDelay == 0;
             animateBMPRubberbandingAktiv = json["bitmapAnimation"]["rubberbanding"];
 
             animateBMPLimitLoops = 0;
@@ -1739,6 +3349,15 @@ void CreateFrames(JsonObject &json, int forceDuration)
             {
                 animateBMPLimitLoops = json["bitmapAnimation"]["limitLoops"].as<int>();
             }
+            else if (isGif)
+            {
+                animateBMPLimitLoops = gifDecoder.loops();
+            }
+            // GIF frames without own delay
+            if (isGif && animateBMPDelay == 0)
+            {
+                animateBMPDelay = 100;
+            }
 
             // Hier einmal den Counter zurücksetzten
             animateBMPCounter = 0;
@@ -1753,7 +3372,7 @@ void CreateFrames(JsonObject &json, int forceDuration)
         bool scrollTextAktiv = false;
         if (json.containsKey("text"))
         {
-            logMessage += F("Text, ");
+            LogAppend(logMessage, PSTR("Text, "));
             // Always assume the default delay first.
             scrollTextDelay = scrollTextDefaultDelay;
 
@@ -1778,7 +3397,7 @@ void CreateFrames(JsonObject &json, int forceDuration)
 
                 bool centerText = json["text"]["centerText"];
 
-                bool fadeInRequired = ((json.containsKey("bars") || json.containsKey("bar") || json.containsKey("bitmap") || json.containsKey("bitmapAnimation")) && fadeAnimationAktiv);
+                bool fadeInRequired = ((json.containsKey("bars") || json.containsKey("bar") || json.containsKey("sparkline") || json.containsKey("effect") || json.containsKey("bitmap") || json.containsKey("bitmapAnimation")) && fadeAnimationAktiv);
 
                 // Wurde ein Benutzerdefeniertes Delay übergeben?
                 if (json["text"]["scrollTextDelay"])
@@ -1806,6 +3425,13 @@ void CreateFrames(JsonObject &json, int forceDuration)
             }
         }
 
+        // Scrolling text composes the effect itself
+        if (effects.active() && !scrollTextAktiv)
+        {
+            effects.capture();
+            effects.draw();
+        }
+
         // Fade aktiv?
         if (!scrollTextAktiv && (fadeAnimationAktiv || coloredBarWipeAnimationAktiv || zigzagWipeAnimationAktiv || bitmapWipeAnimationAktiv))
         {
@@ -1821,17 +3447,13 @@ void CreateFrames(JsonObject &json, int forceDuration)
 
     if (sleepMode && !json.containsKey("sleepMode"))
     {
-        logMessage += F("[not all data processed because sleepMode is active]");
+        LogAppend(logMessage, PSTR("[not all data processed because sleepMode is active]"));
     }
 
-    if (logMessage.endsWith(", "))
-    {
-        logMessage.remove(logMessage.length() - 2);
-        logMessage += F(" ");
-    }
-    Log(F("CreateFrames"), logMessage + "(Length: " + json.measureLength() + ")");
+    LogTrimList(logMessage);
+    Logf(LogLevel_Info, F("CreateFrames"), PSTR("JSON contains %s (Length: %u)"), logMessage, json.measureLength());
 
-    if (forceDuration > 0 && (json.containsKey("bitmap") || json.containsKey("bitmaps") || json.containsKey("text") || json.containsKey("bar") || json.containsKey("bars") || json.containsKey("bitmapAnimation")))
+    if (forceDuration > 0 && (json.containsKey("bitmap") || json.containsKey("bitmaps") || json.containsKey("text") || json.containsKey("bar") || json.containsKey("bars") || json.containsKey("sparkline") || json.containsKey("effect") || json.containsKey("bitmapAnimation")))
     {
         forcedScreenIsActiveUntil = millis() + forceDuration;
     }
@@ -1855,7 +3477,19 @@ void CreateFrames(JsonObject &json, int forceDuration)
     }
 }
 
-String GetConfig()
+// Buffer for WriteConfig(), the file plus what is added
+size_t ConfigJsonLength()
+{
+#if defined(ESP8266)
+    File configFile = LittleFS.open("/config.json", "r");
+#elif defined(ESP32)
+    File configFile = SPIFFS.open("/config.json", "r");
+#endif
+    return WEBSOCKETS_MAX_HEADER_SIZE + (configFile ? configFile.size() : 0) + 64;
+}
+
+// The file is copied as it is, parsing it into a JsonBuffer needs several times its size
+void WriteConfig(JsonWriter &json)
 {
 #if defined(ESP8266)
     File configFile = LittleFS.open("/config.json", "r");
@@ -1865,54 +3499,45 @@ String GetConfig()
 
     if (configFile)
     {
-        // Log(F("GetConfig"), F("Opened config file"));
-        size_t size = configFile.size();
-        // Allocate a buffer to store contents of the file.
-        std::unique_ptr<char[]> buf(new char[size]);
-
-        configFile.readBytes(buf.get(), size);
-        DynamicJsonBuffer jsonBuffer;
-        JsonObject &root = jsonBuffer.parseObject(buf.get());
-
+        json.raw(configFile, configFile.size());
+        json.extend();
         // add current vbat pin to show button on webinterface or not
-        root["showBatteryBtn"] = VBAT_PIN > 0 ? true : false;
-
-        String json;
-        root.printTo(json);
-
-        return json;
+        json.add("showBatteryBtn", VBAT_PIN > 0);
+        json.endObject();
     }
-    return "";
 }
 
-String GetSensor()
+// Reads all installed sensors into values (NAN if not available) and feeds rules and history.
+// Returns false if a sensor failed to read.
+bool ReadSensors(float *values)
 {
-    DynamicJsonBuffer jsonBuffer;
-    JsonObject &root = jsonBuffer.createObject();
+    bool success = true;
+    for (uint8_t i = 0; i < SensorField_Count; i++)
+    {
+        values[i] = NAN;
+    }
+
     if (tempSensor == TempSensor_BME280)
     {
         const float currentTemp = bme280->readTemperature();
-        root["temperature"] = currentTemp + temperatureOffset;
-        root["humidity"] = bme280->readHumidity() + humidityOffset;
-        root["pressure"] = (bme280->readPressure() / 100.0F) + pressureOffset;
-        root["gas"] = "Not installed";
+        values[SensorField_Temperature] = currentTemp + temperatureOffset;
+        values[SensorField_Humidity] = bme280->readHumidity() + humidityOffset;
+        values[SensorField_Pressure] = (bme280->readPressure() / 100.0F) + pressureOffset;
 
         if (temperatureUnit == TemperatureUnit_Fahrenheit)
         {
-            root["temperature"] = CelsiusToFahrenheit(currentTemp) + temperatureOffset;
+            values[SensorField_Temperature] = CelsiusToFahrenheit(currentTemp) + temperatureOffset;
         }
     }
     else if (tempSensor == TempSensor_DHT)
     {
         const float currentTemp = dht.getTemperature();
-        root["temperature"] = currentTemp + temperatureOffset;
-        root["humidity"] = roundf(dht.getHumidity() + humidityOffset);
-        root["pressure"] = "Not installed";
-        root["gas"] = "Not installed";
+        values[SensorField_Temperature] = currentTemp + temperatureOffset;
+        values[SensorField_Humidity] = roundf(dht.getHumidity() + humidityOffset);
 
         if (temperatureUnit == TemperatureUnit_Fahrenheit)
         {
-            root["temperature"] = CelsiusToFahrenheit(currentTemp) + temperatureOffset;
+            values[SensorField_Temperature] = CelsiusToFahrenheit(currentTemp) + temperatureOffset;
         }
     }
     else if (tempSensor == TempSensor_BME680)
@@ -1946,15 +3571,7 @@ String GetSensor()
         {
             bme680->beginReading(); // start measurement process
             // return previous values
-            const float currentTemp = bme680->temperature;
-            root["temperature"] = currentTemp + temperatureOffset;
-            root["humidity"] = bme680->humidity + humidityOffset;
-            root["pressure"] = (bme680->pressure / 100.0F) + pressureOffset;
-            root["gas"] = (bme680->gas_resistance / 1000.0F) + gasOffset;
-            if (temperatureUnit == TemperatureUnit_Fahrenheit)
-            {
-                root["temperature"] = CelsiusToFahrenheit(currentTemp) + temperatureOffset;
-            }
+            ReadBME680Values(values);
         }
 
         if (remain >= 0 || elapsedSinceLastRead > 20000)
@@ -1965,200 +3582,293 @@ String GetSensor()
             if (bme680->endReading()) // will become blocking if measurement not complete yet
             {
                 lastBME680read = millis();
-                const float currentTemp = bme680->temperature;
-                root["temperature"] = currentTemp + temperatureOffset;
-                root["humidity"] = bme680->humidity + humidityOffset;
-                root["pressure"] = (bme680->pressure / 100.0F) + pressureOffset;
-                root["gas"] = (bme680->gas_resistance / 1000.0F) + gasOffset;
-                if (temperatureUnit == TemperatureUnit_Fahrenheit)
-                {
-                    root["temperature"] = CelsiusToFahrenheit(currentTemp) + temperatureOffset;
-                }
+                ReadBME680Values(values);
             }
             else
             {
-                root["humidity"] = "Error while reading";
-                root["temperature"] = "Error while reading";
-                root["pressure"] = "Error while reading";
-                root["gas"] = "Error while reading";
+                values[SensorField_Temperature] = NAN;
+                values[SensorField_Humidity] = NAN;
+                values[SensorField_Pressure] = NAN;
+                values[SensorField_Gas] = NAN;
+                success = false;
             }
         }
     }
     else if (tempSensor == TempSensor_BMP280)
     {
         const float currentTemp = bmp280->readTemperature();
-        root["temperature"] = currentTemp + temperatureOffset;
-        // root["humidity"] = bmp280->readHumidity() + humidityOffset;
-        root["humidity"] = "Not installed";
-        root["pressure"] = (bmp280->readPressure() / 100.0F) + pressureOffset;
-        root["gas"] = "Not installed";
+        values[SensorField_Temperature] = currentTemp + temperatureOffset;
+        values[SensorField_Pressure] = (bmp280->readPressure() / 100.0F) + pressureOffset;
 
         if (temperatureUnit == TemperatureUnit_Fahrenheit)
         {
-            root["temperature"] = CelsiusToFahrenheit(currentTemp) + temperatureOffset;
+            values[SensorField_Temperature] = CelsiusToFahrenheit(currentTemp) + temperatureOffset;
         }
     }
     else if (tempSensor == TempSensor_SHT31)
     {
         const float currentTemp = sht31.readTemperature();
         const float currentHumi = sht31.readHumidity();
-        root["temperature"] = currentTemp + temperatureOffset;
-        root["humidity"] = roundf(currentHumi + humidityOffset);
-        root["pressure"] = "Not installed";
-        root["gas"] = "Not installed";
-    }
-    else
-    {
-        root["humidity"] = "Not installed";
-        root["temperature"] = "Not installed";
-        root["pressure"] = "Not installed";
-        root["gas"] = "Not installed";
+        values[SensorField_Temperature] = currentTemp + temperatureOffset;
+        values[SensorField_Humidity] = roundf(currentHumi + humidityOffset);
     }
 
     if (VBAT_PIN > 0)
     {
-        root["battery"] = batteryLevel;
+        values[SensorField_Battery] = batteryLevel;
     }
-    else
-    {
-        root["battery"] = "Not installed";
-    }
-    root["hostname"] = hostname;
 
-    String json;
-    root.printTo(json);
-
-    // Log(F("Sensor readings"), F("Hum/Temp/Press/Gas:"));
-    // Log(F("Sensor readings"), json);
-    return json;
+    return success;
 }
 
-String GetLuxSensor()
+void FeedSensorValues(const float *values)
 {
-    DynamicJsonBuffer jsonBuffer;
-    JsonObject &root = jsonBuffer.createObject();
-
-    root["lux"] = currentLux;
-    root["hostname"] = hostname;
+    // Local rules and the history, both skip values that are not available
+    rules.sensorValue(RuleSource_Temperature, values[SensorField_Temperature]);
+    rules.sensorValue(RuleSource_Humidity, values[SensorField_Humidity]);
+    rules.sensorValue(RuleSource_Pressure, values[SensorField_Pressure]);
+    rules.sensorValue(RuleSource_Gas, values[SensorField_Gas]);
+    rules.sensorValue(RuleSource_Battery, values[SensorField_Battery]);
+    for (uint8_t i = 0; i < SensorField_Lux; i++)
+    {
+        sensorHistory.add(static_cast<SensorField>(i), values[i]);
+    }
+}
 
-    String json;
-    root.printTo(json);
+void ReadBME680Values(float *values)
+{
+    const float currentTemp = bme680->temperature;
+    values[SensorField_Temperature] = currentTemp + temperatureOffset;
+    values[SensorField_Humidity] = bme680->humidity + humidityOffset;
+    values[SensorField_Pressure] = (bme680->pressure / 100.0F) + pressureOffset;
+    values[SensorField_Gas] = (bme680->gas_resistance / 1000.0F) + gasOffset;
+    if (temperatureUnit == TemperatureUnit_Fahrenheit)
+    {
+        values[SensorField_Temperature] = CelsiusToFahrenheit(currentTemp) + temperatureOffset;
+    }
+}
 
-    return json;
+void WriteSensorValues(JsonWriter &json, const float *values, bool success)
+{
+    json.beginObject();
+    for (uint8_t i = 0; i < SensorField_Lux; i++)
+    {
+        const char *name = SensorHistory::fieldName(static_cast<SensorField>(i));
+        if (!isnan(values[i]))
+        {
+            json.add(name, values[i]);
+        }
+        else if (!success && i != SensorField_Battery)
+        {
+            json.add(name, "Error while reading");
+        }
+        else
+        {
+            json.add(name, "Not installed");
+        }
+    }
+    json.add("hostname", hostname);
+    json.endObject();
 }
 
-String GetBrightness()
+void WriteSensor(JsonWriter &json)
 {
-    DynamicJsonBuffer jsonBuffer;
-    JsonObject &root = jsonBuffer.createObject();
+    float values[SensorField_Count];
+    bool success = ReadSensors(values);
+    WriteSensorValues(json, values, success);
+}
 
-    root["brightness_255"] = currentMatrixBrightness;
-    root["brightness"] = map(currentMatrixBrightness, 0, 255, 0, 100);
-    root["hostname"] = hostname;
+void WriteLuxSensor(JsonWriter &json)
+{
+    json.beginObject();
+    json.add("lux", currentLux);
+    json.add("hostname", hostname);
+    json.endObject();
+}
 
+String GetSensorHistory(SensorResolution resolution)
+{
+    // Written directly, a JsonBuffer with a few hundred values would be much larger than the history
+    int32_t values[SENSORHISTORY_MAX_SAMPLES];
+    char number[16];
     String json;
-    root.printTo(json);
+    json.reserve(96 + sensorHistory.samples(resolution) * SensorField_Count * 8);
+
+    json += F("{\"resolution\":\"");
+    json += SensorHistory::resolutionName(resolution);
+    json += F("\",\"interval\":");
+    json += String(sensorHistory.interval(resolution));
+    // Time of the newest value, the others are interval seconds apart
+    json += F(",\"end\":");
+    json += String((unsigned long)(now() - sensorHistory.age(resolution) / 1000));
+    json += F(",\"hostname\":\"");
+    json += hostname;
+    json += '"';
+
+    for (uint8_t field = 0; field < SensorField_Count; field++)
+    {
+        if (!sensorHistory.hasField(resolution, static_cast<SensorField>(field)))
+        {
+            continue;
+        }
+        uint16_t count = sensorHistory.values(resolution, static_cast<SensorField>(field), values, SENSORHISTORY_MAX_SAMPLES);
+        json += F(",\"");
+        json += SensorHistory::fieldName(static_cast<SensorField>(field));
+        json += F("\":[");
+        for (uint16_t i = 0; i < count; i++)
+        {
+            if (i > 0)
+            {
+                json += ',';
+            }
+            if (values[i] == SENSORHISTORY_MISSING)
+            {
+                json += F("null");
+                continue;
+            }
+            long value = values[i] < 0 ? -(long)values[i] : values[i];
+            snprintf(number, sizeof(number), "%s%ld.%02ld", values[i] < 0 ? "-" : "", value / SENSORHISTORY_SCALE, value % SENSORHISTORY_SCALE);
+            json += number;
+        }
+        json += ']';
+    }
+    json += '}';
 
     return json;
 }
 
-String GetMatrixInfo()
+void WriteBrightness(JsonWriter &json)
 {
-    DynamicJsonBuffer jsonBuffer;
-    JsonObject &root = jsonBuffer.createObject();
+    json.beginObject();
+    json.add("brightness_255", currentMatrixBrightness);
+    json.add("brightness", map(currentMatrixBrightness, 0, 255, 0, 100));
+    json.add("hostname", hostname);
+    json.endObject();
+}
 
-    root["pixelitVersion"] = VERSION;
+void WriteMatrixInfo(JsonWriter &json)
+{
+    char text[18];
+    json.beginObject();
+    json.add("pixelitVersion", VERSION);
     //// Matrix Config
-    root["note"] = note;
-    root["hostname"] = hostname;
-    root["deviceID"] = deviceID;
-    root["buildSection"] = STR(BUILD_SECTION);
-    root["freeSketchSpace"] = ESP.getFreeSketchSpace();
-    root["wifiRSSI"] = WiFi.RSSI();
-    root["wifiQuality"] = GetRSSIasQuality(WiFi.RSSI());
-    root["wifiSSID"] = WiFi.SSID();
-    root["ipAddress"] = WiFi.localIP().toString();
-    root["freeHeap"] = ESP.getFreeHeap();
-    root["currentMatrixBrightness"] = currentMatrixBrightness;
-    root["wifiBSSID"] = WiFi.BSSIDstr();
+    json.add("note", note);
+    json.add("hostname", hostname);
+    json.add("deviceID", deviceID);
+    json.add("buildSection", STR(BUILD_SECTION));
+    json.add("freeSketchSpace", ESP.getFreeSketchSpace());
+    json.add("wifiRSSI", WiFi.RSSI());
+    json.add("wifiQuality", GetRSSIasQuality(WiFi.RSSI()));
+    json.add("wifiSSID", WiFi.SSID());
+    IPAddress ip = WiFi.localIP();
+    snprintf(text, sizeof(text), "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+    json.add("ipAddress", text);
+    json.add("freeHeap", ESP.getFreeHeap());
+    json.add("freeHeapMin", memoryBudget.freeHeapMin());
+    json.add("maxFreeBlock", memoryBudget.maxBlock());
+    json.add("maxFreeBlockMin", memoryBudget.maxBlockMin());
+    json.add("heapFragmentation", memoryBudget.fragmentation());
+    json.add("memoryLevel", MemoryBudget::levelName(memoryBudget.level()));
+    json.add("memoryLevelChanges", memoryBudget.levelChanges());
+    json.add("rejectedMessages", memoryBudget.rejected());
+    json.add("currentMatrixBrightness", currentMatrixBrightness);
+    const uint8_t *bssid = WiFi.BSSID();
+    snprintf(text, sizeof(text), "%02X:%02X:%02X:%02X:%02X:%02X", bssid[0], bssid[1], bssid[2], bssid[3], bssid[4], bssid[5]);
+    json.add("wifiBSSID", text);
 
 #if defined(ESP8266)
-    root["sketchSize"] = ESP.getSketchSize();
-    root["chipID"] = ESP.getChipId();
+    json.add("sketchSize", ESP.getSketchSize());
+    json.add("chipID", ESP.getChipId());
 #elif defined(ESP32)
-    root["chipID"] = uint64ToString(ESP.getEfuseMac());
+    json.add("chipID", uint64ToString(ESP.getEfuseMac()));
 #endif
 
-    root["cpuFreqMHz"] = ESP.getCpuFreqMHz();
-    root["sleepMode"] = sleepMode;
-    root["uptime"] = millis() / 1000;
-    root["resetReason"] = ResetReason();
-    JsonObject &matrix = root.createNestedObject("matrixsize");
-    matrix["cols"] = MATRIX_WIDTH;
-    matrix["rows"] = MATRIX_HEIGHT;
-
-    String json;
-    root.printTo(json);
-
-    return json;
+    json.add("cpuFreqMHz", ESP.getCpuFreqMHz());
+    json.add("idleState", idleGovernor.state());
+    json.add("sleepResidency", idleGovernor.sleepResidency());
+    // Controller plus LEDs at the current brightness (5 V)
+    json.add("currentEstimate", idleGovernor.currentEstimate() + (sleepMode ? 0 : calculate_unscaled_power_mW(leds, Geometry::pixels) * currentMatrixBrightness / 255 / 5));
+    json.add("sleepMode", sleepMode);
+    json.add("realtimeActive", realtime.isActive());
+    json.add("realtimeFrames", realtime.frames());
+    json.add("realtimeDropped", realtime.dropped());
+    json.add("wallSynced", wall.isSynced());
+    json.add("wallOffset", wall.offset());
+    json.add("soundState", DFPlayer::stateName(mp3Player.state()));
+    json.add("soundErrors", mp3Player.errors());
+    json.add("uptime", millis() / 1000);
+    json.add("resetReason", ResetReason());
+    json.key("matrixsize");
+    json.beginObject();
+    json.add("cols", MATRIX_WIDTH);
+    json.add("rows", MATRIX_HEIGHT);
+    json.endObject();
+    json.endObject();
 }
 
-String GetButtons()
+void WriteButtons(JsonWriter &json)
 {
-    DynamicJsonBuffer jsonBuffer;
-    JsonObject &root = jsonBuffer.createObject();
-
+    json.beginObject();
     for (uint button = 0; button < 3; button++)
     {
-        root[btnAPINames[button]] = btnLastPublishState[button] ? "true" : "false";
+        json.add(btnAPINames[button].c_str(), btnLastPublishState[button] ? "true" : "false");
     }
-    root["hostname"] = hostname;
-
-    String json;
-    root.printTo(json);
-
-    return json;
+    json.add("hostname", hostname);
+    json.endObject();
 }
 
 void SendTelemetry()
 {
     Log(F("SendTelemetry"), F("Sending..."));
-    HttpClient httpClient = HttpClient(wifiClientHTTP, TELEMETRY_SERVER_HOST, TELEMETRY_SERVER_PORT);
-    httpClient.setTimeout(1500);
-    httpClient.sendHeader("User-Agent", "PixelIt");
-    httpClient.post(TELEMETRY_SERVER_PATH, "application/json", GetTelemetry());
+    statusJson.reset();
+    WriteTelemetry(statusJson);
+    if (!httpTask.post(apiServerHost.c_str(), apiServerPort, TELEMETRY_SERVER_PATH, statusJson.c_str(), SendTelemetryResponse))
+    {
+        Log(LogLevel_Error, F("SendTelemetry"), F("Error: request queue full"));
+    }
 }
 
-String GetTelemetry()
+void SendTelemetryResponse(const HttpTaskResponse &response)
 {
-    const String MatrixTypeNames[] = {"Colum major", "Row major", "Tiled 4x 8x8 CJMCU (Column major)", "MicroMatrix", "Tiled 4x 8x8 CJMCU (Row major)"};
-    const String TempSensorNames[] = {"none", "BME280", "DHT", "BME680", "BMP280", "SHT31"};
-    const String LuxSensorNames[] = {"LDR", "BH1750", "Max44009"};
-
-    DynamicJsonBuffer jsonBuffer;
-    JsonObject &root = jsonBuffer.createObject();
-
-    root["uuid"] = sha1(GetChipID());
-    root["version"] = VERSION;
-    root["type"] = isESP8266 ? "esp8266" : "esp32";
-    root["buildSection"] = STR(BUILD_SECTION);
-
-    JsonObject &matrix = root.createNestedObject("matrix");
-    matrix["type"] = matrixType;
-    matrix["name"] = MatrixTypeNames[matrixType - 1];
-    matrix["width"] = MATRIX_WIDTH;
-    matrix["height"] = MATRIX_HEIGHT;
+    if (response.result != HttpTaskResult_Ok)
+    {
+        Log(LogLevel_Error, F("SendTelemetry"), "Error. Request failed: " + String(response.result));
+    }
+    else if (response.statusCode != 200)
+    {
+        Log(LogLevel_Error, F("SendTelemetry"), "Error. HTTP Code: " + String(response.statusCode));
+    }
+}
 
-    JsonArray &sensors = root.createNestedArray("sensors");
-    sensors.add(LuxSensorNames[luxSensor]);
+void WriteTelemetry(JsonWriter &json)
+{
+    static const char *const MatrixTypeNames[] = {"Colum major", "Row major", "Tiled 4x 8x8 CJMCU (Column major)", "MicroMatrix", "Tiled 4x 8x8 CJMCU (Row major)"};
+    static const char *const TempSensorNames[] = {"none", "BME280", "DHT", "BME680", "BMP280", "SHT31"};
+    static const char *const LuxSensorNames[] = {"LDR", "BH1750", "Max44009"};
+
+    json.beginObject();
+    json.add("uuid", sha1(GetChipID()));
+    json.add("version", VERSION);
+    json.add("type", isESP8266 ? "esp8266" : "esp32");
+    json.add("buildSection", STR(BUILD_SECTION));
+
+    json.key("matrix");
+    json.beginObject();
+    json.add("type", matrixType);
+    json.add("name", MatrixTypeNames[matrixType - 1]);
+    json.add("width", MATRIX_WIDTH);
+    json.add("height", MATRIX_HEIGHT);
+    json.endObject();
+
+    json.key("sensors");
+    json.beginArray();
+    json.value(LuxSensorNames[luxSensor]);
     if (tempSensor > 0)
     {
-        sensors.add(TempSensorNames[tempSensor]);
+        json.value(TempSensorNames[tempSensor]);
     }
-
-    String json;
-    root.printTo(json);
-    return json;
+    json.endArray();
+    json.endObject();
 }
 
 void DrawText(String text, int bigFont, int colorRed, int colorGreen, int colorBlue, int posX, int posY)
@@ -2187,17 +3897,17 @@ void DrawTextHelper(String text, int bigFont, bool centerText, bool scrollText,
     int16_t boundsx1, boundsy1;
     uint16_t boundsw, boundsh;
 
-    text = Utf8ToAscii(text);
-
     // Debug function values
     // Serial.printf("DrawTextHelper: %s (bigFont: %s, centerText: %s, scrollText: %s, autoScrollText: %s: %s, fadeInRequired: %s)\n", text.c_str(), bigFont == 1 ? "true" : "false", centerText ? "true" : "false", scrollText ? "true" : "false", autoScrollText ? "true" : "false" ? "true" : "false", fadeInRequired ? "true" : "false");
 
     // Available text space depends on matrix size
     xAvailableTextSpace = MATRIX_WIDTH - posX;
 
+    textClassicFont = bigFont == 1;
     if (bigFont == 1)
     {
-        // Set large font
+        // Set large font, it only has Latin-1 and a few symbols
+        text = Utf8ToAscii(text);
         matrix->setFont();
         matrix->getTextBounds(text, 0, 0, &boundsx1, &boundsy1, &boundsw, &boundsh);
         xTextWidth = boundsw;
@@ -2208,10 +3918,8 @@ void DrawTextHelper(String text, int bigFont, bool centerText, bool scrollText,
     else if (bigFont == 2) // fat font, only to be used for time display
     {
         // Set fat font
-        matrix->setFont(&FatPixels);
-
-        matrix->getTextBounds(text, 0, 0, &boundsx1, &boundsy1, &boundsw, &boundsh);
-        xTextWidth = boundsw;
+        textEngine.setFont(&FatPixelsGlyphFont);
+        xTextWidth = textEngine.textWidth(text.c_str()) - 1;
 
         // Position correction
         posY = posY + 6;
@@ -2219,10 +3927,8 @@ void DrawTextHelper(String text, int bigFont, bool centerText, bool scrollText,
     else if (bigFont == 3) // very large font, only to be used for time display
     {
         // Set very large font
-        matrix->setFont(&LargePixels);
-
-        matrix->getTextBounds(text, 0, 0, &boundsx1, &boundsy1, &boundsw, &boundsh);
-        xTextWidth = boundsw;
+        textEngine.setFont(&LargePixelsGlyphFont);
+        xTextWidth = textEngine.textWidth(text.c_str()) - 1;
 
         // Position correction
         posY = posY + 6;
@@ -2230,9 +3936,8 @@ void DrawTextHelper(String text, int bigFont, bool centerText, bool scrollText,
     else
     {
         // Set small font
-        matrix->setFont(&PixelItFont);
-        matrix->getTextBounds(text, 0, 0, &boundsx1, &boundsy1, &boundsw, &boundsh);
-        xTextWidth = boundsw - 4;
+        textEngine.setFont(&PixelItGlyphFont);
+        xTextWidth = textEngine.textWidth(text.c_str());
 
         // Position correction
         posY = posY + 5;
@@ -2244,9 +3949,8 @@ void DrawTextHelper(String text, int bigFont, bool centerText, bool scrollText,
         posX = posX + ((xAvailableTextSpace - xTextWidth) / 2);
     }
 
-    matrix->setCursor(posX, posY);
-
     matrix->setTextColor(matrix->Color(colorRed, colorGreen, colorBlue));
+    textEngine.setColor(matrix->Color(colorRed, colorGreen, colorBlue));
 
     if (scrollText || (autoScrollText && xTextWidth > xAvailableTextSpace)) // scroll text if text is larger than available pixels
     {
@@ -2267,7 +3971,7 @@ void DrawTextHelper(String text, int bigFont, bool centerText, bool scrollText,
     // In case the text on the display fits!
     else if (autoScrollText)
     {
-        matrix->print(text);
+        PrintText(posX, posY, text);
         // Here you have to check if the fade out was done,
         // then the brightness is too low (0),
         // but only if animateBMPAktivLoop is not active,
@@ -2283,8 +3987,21 @@ void DrawTextHelper(String text, int bigFont, bool centerText, bool scrollText,
     }
     else
     {
+        PrintText(posX, posY, text);
+    }
+}
+
+void PrintText(int16_t x, int16_t y, const String &text)
+{
+    if (textClassicFont)
+    {
+        matrix->setCursor(x, y);
         matrix->print(text);
     }
+    else
+    {
+        textEngine.drawText(x, y, text.c_str());
+    }
 }
 
 void ScrollText(bool isFadeInRequired)
@@ -2294,8 +4011,7 @@ void ScrollText(bool isFadeInRequired)
     if (scrollCurPos > ((scrollxTextWidth - xOffset) * -1))
     {
         matrix->clear();
-        matrix->setCursor(--scrollCurPos, scrollposY);
-        matrix->print(scrollTextString);
+        PrintText(--scrollCurPos, scrollposY, scrollTextString);
 
         // draw black pixel under icon / blank space if (xOffset > 0)
         for (int i = 0; i < xOffset; i++)
@@ -2305,7 +4021,13 @@ void ScrollText(bool isFadeInRequired)
 
         if (withBMP)
         {
-            matrix->drawRGBBitmap(bmpPosX, bmpPosY, bmpArray, bmpWidth, bmpHeight);
+            blitter.drawBitmap(bmpPosX, bmpPosY, bmpArray, bmpWidth, bmpHeight);
+        }
+
+        if (effects.active())
+        {
+            effects.capture();
+            effects.draw();
         }
 
         if (isFadeInRequired)
@@ -2377,11 +4099,29 @@ void AnimateBMP(bool isShowRequired)
         }
     }
 
+    // The frame goes into the screen without the effect, from the loop the effect is already drawn
+    bool composeEffect = isShowRequired && effects.active();
+    if (composeEffect)
+    {
+        effects.restore();
+    }
+
     ClearBMPArea();
 
-    matrix->drawRGBBitmap(bmpPosX, bmpPosY, animationBmpList[animateBMPCounter], bmpWidth, bmpHeight);
+    blitter.drawBitmap(bmpPosX, bmpPosY, animationBmpList[animateBMPCounter], bmpWidth, bmpHeight);
+
+    if (composeEffect)
+    {
+        effects.capture();
+        effects.draw();
+    }
+
+    if (animateBMPFrameDelays && animationBmpDelays[animateBMPCounter] > 0)
+    {
+        animateBMPDelay = animationBmpDelays[animateBMPCounter];
+    }
 
-    for (int y = 0; y < 64; y++)
+    for (int y = 0; y < Geometry::bitmapPixels; y++)
     {
         bmpArray[y] = animationBmpList[animateBMPCounter][y];
     }
@@ -2415,12 +4155,26 @@ void DrawSingleBitmap(JsonObject &json)
     bmpPosY = y;
     withBMP = true;
 
-    // Hier kann leider nicht die Funktion matrix->drawRGBBitmap() genutzt werde da diese Fehler in der Anzeige macht wenn es mehr wie 8x8 Pixel werden.
-    for (int16_t j = 0; j < h; j++, y++)
+    // One pass over the JsonArray (an index lookup walks the list), the visible part of each row is blitted
+    uint16_t row[Geometry::width];
+    int16_t start = x < 0 ? -x : 0;
+    int16_t visible = w - start > Geometry::width ? Geometry::width : w - start;
+    int16_t i = 0;
+    int16_t j = 0;
+    for (JsonVariant pixel : json["data"].as<JsonArray>())
     {
-        for (int16_t i = 0; i < w; i++)
+        if (i >= start && i - start < visible)
+        {
+            row[i - start] = pixel.as<uint16_t>();
+        }
+        if (++i == w)
         {
-            matrix->drawPixel(x + i, y, json["data"][j * w + i].as<uint16_t>());
+            blitter.drawRow(x + start, y + j, row, visible);
+            i = 0;
+            if (++j == h)
+            {
+                break;
+            }
         }
     }
 
@@ -2432,8 +4186,6 @@ void DrawSingleBitmap(JsonObject &json)
 
 void DrawClock(bool fromJSON)
 {
-    matrix->clear();
-
     char date[14];
     char time[14];
 
@@ -2516,6 +4268,9 @@ void DrawClock(bool fromJSON)
         }
     }
 
+    // Time or date, switching between them slides the other one in
+    bool showDate = false;
+    bool slide = false;
     if (!clockSwitchAktiv || (clockSwitchAktiv && clockCounterClock <= clockSwitchSec))
     {
         if (clockSwitchAktiv)
@@ -2525,43 +4280,8 @@ void DrawClock(bool fromJSON)
         if (clockCounterClock > clockSwitchSec)
         {
             clockCounterDate = 0;
-
-            if (clockFontIsLarge) // fade rather than vertical animate purely because DrawTextCenter doesnt have a Y argument...
-            {
-                DrawTextCenter(String(time), clockFontChoice, clockColorR, clockColorG, clockColorB, 0, 1);
-                FadeOut(30);
-                matrix->clear();
-                DrawTextCenter(String(date), clockFontChoice, clockColorR, clockColorG, clockColorB, 0, 1);
-                FadeIn(30);
-            }
-            else
-            {
-                int counter = 0;
-                while (counter <= 6) // vertical animate
-                {
-                    counter++;
-                    matrix->clear();
-                    DrawText(String(time), false, clockColorR, clockColorG, clockColorB, xPosTime, (1 + counter));
-                    DrawText(String(date), false, clockColorR, clockColorG, clockColorB, 7, (-6 + counter));
-                    matrix->drawLine(0, 7, 33, 7, 0);
-                    if (clockDrawWeekDays)
-                    {
-                        DrawWeekDay();
-                    }
-                    matrix->show();
-                    delay(35);
-                }
-            }
-        }
-        else if (clockFontIsLarge)
-        {
-
-            DrawTextCenter(String(time), clockFontChoice, clockColorR, clockColorG, clockColorB, 0, 1);
-        }
-        else
-        {
-            DrawText(String(time), false, clockColorR, clockColorG, clockColorB, xPosTime, 1);
-            xPosTime = 3;
+            showDate = true;
+            slide = true;
         }
     }
     else
@@ -2571,80 +4291,88 @@ void DrawClock(bool fromJSON)
         if (clockCounterDate == clockSwitchSec)
         {
             clockCounterClock = 0;
-
-            if (clockFontIsLarge) // fade rather than vertical animate purely because DrawTextCenter doesnt have a Y argument...
-            {
-                DrawTextCenter(String(date), 2, clockColorR, clockColorG, clockColorB, 0, 1);
-                FadeOut(30);
-                matrix->clear();
-                DrawTextCenter(String(time), 2, clockColorR, clockColorG, clockColorB, 0, 1);
-                FadeIn(30);
-            }
-            else
-            {
-                int counter = 0;
-                while (counter <= 6) // vertical animate
-                {
-                    counter++;
-                    matrix->clear();
-                    DrawText(String(date), false, clockColorR, clockColorG, clockColorB, 7, (1 + counter));
-                    DrawText(String(time), false, clockColorR, clockColorG, clockColorB, xPosTime, (-6 + counter));
-                    matrix->drawLine(0, 7, 33, 7, 0);
-                    if (clockDrawWeekDays)
-                    {
-                        DrawWeekDay();
-                    }
-                    matrix->show();
-                    delay(35);
-                }
-            }
-        }
-        else if (clockFontIsLarge)
-        {
-            DrawTextCenter(String(date), clockFontChoice, clockColorR, clockColorG, clockColorB, 0, 1);
+            slide = true;
         }
         else
         {
-            DrawText(String(date), false, clockColorR, clockColorG, clockColorB, 7, 1);
+            showDate = true;
         }
     }
 
-    if (!clockFontIsLarge && clockDrawWeekDays)
+    const char *text = showDate ? date : time;
+    int16_t x;
+    int16_t y;
+    if (clockFontIsLarge)
+    {
+        clockRenderer.setFont(clockFontChoice == 2 ? &FatPixelsGlyphFont : &LargePixelsGlyphFont);
+        // Centered, same as DrawTextCenter()
+        int16_t width = clockRenderer.textWidth(text) - 1;
+        x = width < MATRIX_WIDTH ? (MATRIX_WIDTH - width) / 2 : 0;
+        y = Geometry::clockY + 7;
+    }
+    else
+    {
+        clockRenderer.setFont(&PixelItGlyphFont);
+        x = Geometry::clockX + (showDate ? 7 : xPosTime);
+        y = Geometry::clockY + 6;
+    }
+    clockRenderer.setColor(matrix->Color(clockColorR, clockColorG, clockColorB));
+    clockRenderer.setRollDigits(clockRollDigits);
+
+    // Everything is drawn after other screens, otherwise only what changed
+    if (fromJSON || !clockRenderer.intact())
+    {
+        matrix->clear();
+        clockRenderer.invalidate();
+        clockWeekDayDrawn = -1;
+    }
+
+    bool changed = false;
+    if (!clockFontIsLarge && clockDrawWeekDays && WeekDayNumber() != clockWeekDayDrawn)
     {
+        clockWeekDayDrawn = WeekDayNumber();
         DrawWeekDay();
+        changed = true;
+    }
+
+    if (clockRenderer.update(text, x, y, slide))
+    {
+        changed = true;
     }
 
     // Wenn der Aufruf nicht über JSON sondern über den Loop kommt
     // muss ich mich selbst ums Show kümmern.
-    if (!fromJSON)
+    if (!fromJSON && changed)
     {
         matrix->show();
     }
 }
 
-void DrawWeekDay()
+int WeekDayNumber()
 {
     // The Libary works with dayOfWeek with Sunday = 1...
     // So Sunday = 1 <-> Saturday = 7
-    int weekDayNumber = 0;
     if (clockDayOfWeekFirstMonday)
     {
-        weekDayNumber = DayOfWeekFirstMonday(dayOfWeek(now()) - 1);
-    }
-    else
-    {
-        weekDayNumber = dayOfWeek(now()) - 1;
+        return DayOfWeekFirstMonday(dayOfWeek(now()) - 1);
     }
+    return dayOfWeek(now()) - 1;
+}
+
+void DrawWeekDay()
+{
+    int weekDayNumber = WeekDayNumber();
 
     for (int i = 0; i <= 6; i++)
     {
+        int16_t x = Geometry::weekDayX + i * Geometry::weekDaySpacing;
         if (i == weekDayNumber)
         {
-            matrix->drawLine(2 + i * 4, 7, i * 4 + 4, 7, matrix->Color(clockColorR, clockColorG, clockColorB));
+            matrix->drawFastHLine(x, Geometry::weekDayY, Geometry::weekDaySpacing - 1, matrix->Color(clockColorR, clockColorG, clockColorB));
         }
         else
         {
-            matrix->drawLine(2 + i * 4, 7, i * 4 + 4, 7, 21162);
+            matrix->drawFastHLine(x, Geometry::weekDayY, Geometry::weekDaySpacing - 1, 21162);
         }
     }
 }
@@ -2673,6 +4401,9 @@ boolean MQTTreconnect()
         client.subscribe((mqttMasterTopic + "getMatrixinfo").c_str());
         client.subscribe((mqttMasterTopic + "getConfig").c_str());
         client.subscribe((mqttMasterTopic + "setConfig").c_str());
+        client.subscribe((mqttMasterTopic + "setPlaylist").c_str());
+        client.subscribe((mqttMasterTopic + "setRules").c_str());
+        client.subscribe((mqttMasterTopic + "setWall").c_str());
         if (mqttUseDeviceTopic)
         {
             client.subscribe((mqttDeviceTopic + "setScreen").c_str());
@@ -2680,6 +4411,9 @@ boolean MQTTreconnect()
             client.subscribe((mqttDeviceTopic + "getMatrixinfo").c_str());
             client.subscribe((mqttDeviceTopic + "getConfig").c_str());
             client.subscribe((mqttDeviceTopic + "setConfig").c_str());
+            client.subscribe((mqttDeviceTopic + "setPlaylist").c_str());
+            client.subscribe((mqttDeviceTopic + "setRules").c_str());
+            client.subscribe((mqttDeviceTopic + "setWall").c_str());
         }
         // ... and publish state ....
         client.publish((mqttMasterTopic + "state").c_str(), "connected", true);
@@ -3101,7 +4835,7 @@ boolean MQTTreconnect()
     }
     else
     {
-        Log(F("MQTTreconnect"), F("MQTT connect failed! Retry in a few seconds..."));
+        Log(LogLevel_Warning, F("MQTTreconnect"), F("MQTT connect failed! Retry in a few seconds..."));
     }
 
     return connected;
@@ -3142,14 +4876,14 @@ void FadeIn(int dealy, int minBrightness)
 
 void ColoredBarWipe()
 {
-    for (uint16_t i = 0; i < 32 + 1; i++)
+    for (uint16_t i = 0; i < Geometry::width + 1; i++)
     {
-        matrix->fillRect(0, 0, i - 1, 8, matrix->Color(0, 0, 0));
+        matrix->fillRect(0, 0, i - 1, Geometry::height, matrix->Color(0, 0, 0));
 
-        matrix->drawFastVLine(i, 0, 8, ColorWheel((i * 8) & 255, 0));
-        matrix->drawFastVLine(i + 1, 0, 8, ColorWheel((i * 9) & 255, 0));
-        matrix->drawFastVLine(i - 1, 0, 8, 0);
-        matrix->drawFastVLine(i - 2, 0, 8, 0);
+        matrix->drawFastVLine(i, 0, Geometry::height, ColorWheel((i * 8) & 255, 0));
+        matrix->drawFastVLine(i + 1, 0, Geometry::height, ColorWheel((i * 9) & 255, 0));
+        matrix->drawFastVLine(i - 1, 0, Geometry::height, 0);
+        matrix->drawFastVLine(i - 2, 0, Geometry::height, 0);
         matrix->show();
         delay(15);
     }
@@ -3157,11 +4891,11 @@ void ColoredBarWipe()
 
 void ZigZagWipe(uint8_t r, uint8_t g, uint8_t b)
 {
-    for (uint16_t row = 0; row <= 7; row += 2)
+    for (uint16_t row = 0; row < Geometry::height; row += 2)
     {
-        for (uint16_t col = 0; col <= 31; col++)
+        for (uint16_t col = 0; col < Geometry::width; col++)
         {
-            if (row == 0 || row == 4)
+            if (row % 4 == 0)
             {
                 matrix->fillRect(0, row, col - 1, 2, matrix->Color(0, 0, 0));
                 matrix->drawFastVLine(col - 1, row, 2, matrix->Color(r, g, b));
@@ -3169,18 +4903,18 @@ void ZigZagWipe(uint8_t r, uint8_t g, uint8_t b)
             }
             else
             {
-                matrix->fillRect(32 - col, row, col, 2, matrix->Color(0, 0, 0));
-                matrix->drawFastVLine(32 - col, row, 2, matrix->Color(r, g, b));
-                matrix->drawFastVLine(32 - col - 1, row, 2, matrix->Color(r, g, b));
+                matrix->fillRect(Geometry::width - col, row, col, 2, matrix->Color(0, 0, 0));
+                matrix->drawFastVLine(Geometry::width - col, row, 2, matrix->Color(r, g, b));
+                matrix->drawFastVLine(Geometry::width - col - 1, row, 2, matrix->Color(r, g, b));
             }
             matrix->show();
             delay(5);
         }
-        matrix->fillRect(0, row, 32, 2, matrix->Color(0, 0, 0));
-        if (row == 0 || row == 4)
+        matrix->fillRect(0, row, Geometry::width, 2, matrix->Color(0, 0, 0));
+        if (row % 4 == 0)
         {
-            matrix->drawFastVLine(30, row + 1, 2, matrix->Color(r, g, b));
-            matrix->drawFastVLine(31, row + 1, 2, matrix->Color(r, g, b));
+            matrix->drawFastVLine(Geometry::width - 2, row + 1, 2, matrix->Color(r, g, b));
+            matrix->drawFastVLine(Geometry::width - 1, row + 1, 2, matrix->Color(r, g, b));
         }
         else
         {
@@ -3189,40 +4923,38 @@ void ZigZagWipe(uint8_t r, uint8_t g, uint8_t b)
         }
         matrix->show();
         delay(5);
-        matrix->fillRect(0, row, 32, 2, matrix->Color(0, 0, 0));
+        matrix->fillRect(0, row, Geometry::width, 2, matrix->Color(0, 0, 0));
     }
-    matrix->fillRect(0, 0, 32, 8, matrix->Color(0, 0, 0));
+    matrix->fillRect(0, 0, Geometry::width, Geometry::height, matrix->Color(0, 0, 0));
     matrix->show();
 }
 
 void BitmapWipe(JsonArray &data, int16_t w)
 {
-    for (int16_t x = -w + 1; x <= 31; x++)
+    if (w <= 0)
     {
-        int16_t y = 0;
-        for (int16_t j = 0; j < 8; j++, y++)
-        {
-            for (int16_t i = 0; i < w; i++)
-            {
-                matrix->drawPixel(x + i, y, data[j * w + i].as<uint16_t>());
-            }
-        }
+        return;
+    }
+
+    // Decode once, every step of the wipe only blits
+    int16_t h = data.size() / w > Geometry::height ? Geometry::height : data.size() / w;
+    uint16_t *bitmap = new uint16_t[w * h];
+    data.copyTo(bitmap, w * h);
+
+    for (int16_t x = -w + 1; x < Geometry::width; x++)
+    {
+        blitter.drawBitmap(x, 0, bitmap, w, h);
         matrix->show();
         delay(18);
-        matrix->fillRect(0, 0, x, 8, matrix->Color(0, 0, 0));
+        matrix->fillRect(0, 0, x, Geometry::height, matrix->Color(0, 0, 0));
         matrix->show();
     }
+    delete[] bitmap;
 }
 
 void ColorFlash(int red, int green, int blue)
 {
-    for (uint16_t row = 0; row < 8; row++)
-    {
-        for (uint16_t column = 0; column < 32; column++)
-        {
-            matrix->drawPixel(column, row, matrix->Color(red, green, blue));
-        }
-    }
+    matrix->fillScreen(matrix->Color(red, green, blue));
     matrix->show();
 }
 
@@ -3246,49 +4978,22 @@ uint ColorWheel(byte wheelPos, int pos)
 
 void ShowBootAnimation()
 {
-    DrawTextHelper("P", false, false, false, false, false, 255, 51, 255, (MATRIX_WIDTH / 2) - 12, 1);
-    matrix->show();
-
-    delay(200);
-    DrawTextHelper("I", false, false, false, false, false, 0, 255, 42, (MATRIX_WIDTH / 2) - 8, 1);
-    matrix->show();
-
-    delay(200);
-    DrawTextHelper("X", false, false, false, false, false, 255, 25, 25, (MATRIX_WIDTH / 2) - 6, 1);
-    matrix->show();
-
-    delay(200);
-    DrawTextHelper("E", false, false, false, false, false, 25, 255, 255, (MATRIX_WIDTH / 2) - 2, 1);
-    matrix->show();
-
-    delay(200);
-    DrawTextHelper("L", false, false, false, false, false, 255, 221, 51, (MATRIX_WIDTH / 2) + 2, 1);
-    matrix->show();
-
-    delay(500);
-    DrawTextHelper("I", false, false, false, false, false, 255, 255, 255, (MATRIX_WIDTH / 2) + 6, 1);
-    DrawTextHelper("T", false, false, false, false, false, 255, 255, 255, (MATRIX_WIDTH / 2) + 8, 1);
-    matrix->show();
-    delay(1000);
+    // 32x8 animation, centered
+    int16_t x = (MATRIX_WIDTH / 2) - 16;
+    for (uint8_t i = 0; i < bootAnimation.frameCount; i++)
+    {
+        blitter.drawAsset(x, Geometry::clockY, bootAnimation, i);
+        matrix->show();
+        delay(AssetFrameDelay(bootAnimation, i));
+        mp3Player.loop();
+    }
 }
 
 void ShowBatteryScreen()
 {
-    const size_t capacity = JSON_ARRAY_SIZE(64) + JSON_OBJECT_SIZE(1) + 2 * JSON_OBJECT_SIZE(2) + JSON_OBJECT_SIZE(3) + 350;
-    DynamicJsonBuffer jsonBuffer(capacity);
-    const char *json = "{\"bitmap\":{\"data\":[0,0,65535,65535,65535,0,0,0,0,0,65535,2016,65535,0,0,0,0,65535,2016,2016,2016,65535,0,0,0,65535,2016,2016,2016,65535,0,0,0,65535,2016,2016,2016,65535,0,0,0,65535,2016,2016,2016,65535,0,0,0,65535,2016,2016,2016,65535,0,0,0,65535,65535,65535,65535,65535,0,0],\"position\":{\"x\":0,\"y\":0},\"size\":{\"width\":8,\"height\":8}}}";
-    JsonObject &root = jsonBuffer.parseObject(json);
-    if (root.success())
-    {
-        Serial.println("parsed json");
-    }
-    else
-    {
-        Serial.println("failed to parse json");
-    }
     getBatteryVoltage();
     matrix->clear();
-    DrawSingleBitmap(root["bitmap"]);
+    blitter.drawAsset(0, 0, batteryScreen, 0);
     DrawTextHelper(String(batteryLevel, 0) + "%", false, true, false, false, false, 255, 255, 255, 9, 1);
     matrix->show();
     delay(1000);
@@ -3545,17 +5250,41 @@ int DayOfWeekFirstMonday(int OrigDayofWeek)
 
 void initDFPlayer()
 {
-    if (!mp3Player.begin(*softSerial))
+    // Detected in the background, the commands wait until the module has started
+    mp3Player.setCallback(DFPlayerChanged);
+    mp3Player.begin(*softSerial);
+    mp3Player.volume(initialVolume);
+}
+
+void DFPlayerChanged(DFPlayerState state)
+{
+    if (state == DFPlayerState_Offline)
     {
-        Log(F("DFPlayer"), F("DFPlayer not found"));
+        Log(LogLevel_Warning, F("DFPlayer"), F("DFPlayer not found"));
     }
     else
     {
-        Log(F("DFPlayer"), F("DFPlayer started"));
-        mp3Player.volume(initialVolume);
+        Log(F("DFPlayer"), "State: " + String(DFPlayer::stateName(state)));
     }
 }
 
+char *AcquireRequestBody(size_t length)
+{
+    return memoryBudget.acquireMessage(length);
+}
+
+void ReleaseRequestBody(char *body)
+{
+    memoryBudget.releaseMessage(body);
+}
+
+void MemoryLevelChanged(MemoryLevel level)
+{
+    // Log streaming to the web UI is the last optional load
+    logger.setCallback(memoryBudget.logStreamAllowed() ? SendLog : nullptr);
+    Log(level == MemoryLevel_Normal ? LogLevel_Info : LogLevel_Warning, F("Memory"), "Level: " + String(MemoryBudget::levelName(level)) + " (Free: " + String(memoryBudget.freeHeap()) + ", Block: " + String(memoryBudget.maxBlock()) + ")");
+}
+
 /////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////
 void setup()
@@ -3569,6 +5298,14 @@ void setup()
 
     Serial.begin(115200);
 
+    // Reserve the inbound message buffer while the heap is still in one piece
+    memoryBudget.begin();
+    memoryBudget.setCallback(MemoryLevelChanged);
+
+    // Local rules, must be ready before any event is fed
+    rules.begin();
+    rules.setCallback(ExecuteRuleAction);
+
     // Mounting FileSystem
     Serial.println(F("Mounting file system..."));
 #if defined(ESP8266)
@@ -3586,6 +5323,14 @@ void setup()
             SaveConfig();
             LoadConfig();
         }
+
+        // Playlist
+        playlist.begin(playlistInterruptTime * 1000);
+        playlist.setCallback(ShowPlaylistItem);
+        playlist.setConditionCallback(PlaylistConditionMet);
+        playlist.setExpiredCallback(RemovePlaylistItemFile);
+        LoadPlaylist();
+        LoadRules();
     }
     else
     {
@@ -3599,6 +5344,15 @@ void setup()
         setGPIOReset[i].resetMillis = -1;
     }
 
+    // Buttons
+    for (uint b = 0; b < 3; b++)
+    {
+        btnPinNumber[b] = TranslatePin(btnPin[b]);
+    }
+    buttons.begin(btnPinNumber, btnPressedLevel, btnEnabled);
+    buttons.setCallback(HandleButtonEvent);
+    UpdateButtonGestures();
+
     // I2C Sensors
     twowire.begin(TranslatePin(SDAPin), TranslatePin(SCLPin));
 
@@ -3698,28 +5452,41 @@ void setup()
         }
     }
 
+    // The matrix type describes the wiring of one panel, panels are chained in MATRIX_TILE_LAYOUT order
+    uint8_t panelWidth = Geometry::panelWidth;
+    uint8_t panelHeight = Geometry::panelHeight;
+    uint8_t panelLayout;
     switch (matrixType)
     {
     default: // Matix Type 1 (Colum major)
-        matrix = new FastLED_NeoMatrix(leds, 32, 8, NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_COLUMNS + NEO_MATRIX_ZIGZAG);
+        panelLayout = NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_COLUMNS + NEO_MATRIX_ZIGZAG;
         break;
 
     case 2: // Matix Type 2 (Row major)
-        matrix = new FastLED_NeoMatrix(leds, 32, 8, NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS + NEO_MATRIX_ZIGZAG);
+        panelLayout = NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS + NEO_MATRIX_ZIGZAG;
         break;
 
     case 3: // Matix Type 3 (Tiled 4x 8x8 CJMCU, Column major)
-        matrix = new FastLED_NeoMatrix(leds, 32, 8, NEO_MATRIX_BOTTOM + NEO_MATRIX_LEFT + NEO_MATRIX_COLUMNS + NEO_MATRIX_PROGRESSIVE);
+        panelLayout = NEO_MATRIX_BOTTOM + NEO_MATRIX_LEFT + NEO_MATRIX_COLUMNS + NEO_MATRIX_PROGRESSIVE;
         break;
 
     case 4: // Matix Type 4 (MicroMatrix by foorschtbar) See: https://github.com/foorschtbar/Sk6805EC15-Matrix
-        matrix = new FastLED_NeoMatrix(leds, 8, 8, 4, 1, NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS + NEO_MATRIX_ZIGZAG);
+        panelWidth = 8;
+        panelHeight = 8;
+        panelLayout = NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS + NEO_MATRIX_ZIGZAG;
         break;
 
     case 5: // Matix Type 5 (Tiled 4x 8x8 CJMCU, Row major)
-        matrix = new FastLED_NeoMatrix(leds, 8, 8, 4, 1, NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS + NEO_MATRIX_PROGRESSIVE);
+        panelWidth = 8;
+        panelHeight = 8;
+        panelLayout = NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS + NEO_MATRIX_PROGRESSIVE;
         break;
     }
+    matrix = new FastLED_NeoMatrix(leds, panelWidth, panelHeight, Geometry::width / panelWidth, Geometry::height / panelHeight, panelLayout + MATRIX_TILE_LAYOUT);
+    blitter.begin(matrix, leds);
+    textEngine.begin(&blitter);
+    clockRenderer.begin(&blitter, &textEngine);
+    effects.begin(&blitter);
 
     ColorTemperature userColorTemp = GetUserColorTemp();
     LEDColorCorrection userLEDCorrection = GetUserColorCorrection();
@@ -3727,16 +5494,16 @@ void setup()
     // Matrix Color Correction
     if (userLEDCorrection != UncorrectedColor)
     {
-        FastLED.addLeds<NEOPIXEL, MATRIX_PIN>(leds, MATRIX_WIDTH * MATRIX_HEIGHT).setCorrection(userLEDCorrection);
+        AddMatrixLeds().setCorrection(userLEDCorrection);
     }
     else if (userColorTemp != UncorrectedTemperature)
     {
-        FastLED.addLeds<NEOPIXEL, MATRIX_PIN>(leds, MATRIX_WIDTH * MATRIX_HEIGHT).setTemperature(userColorTemp);
+        AddMatrixLeds().setTemperature(userColorTemp);
     }
     else
     {
         int *rgbArray = GetUserCutomCorrection();
-        FastLED.addLeds<NEOPIXEL, MATRIX_PIN>(leds, MATRIX_WIDTH * MATRIX_HEIGHT).setCorrection(matrix->Color(rgbArray[0], rgbArray[1], rgbArray[2]));
+        AddMatrixLeds().setCorrection(matrix->Color(rgbArray[0], rgbArray[1], rgbArray[2]));
     }
 
     matrix->begin();
@@ -3749,12 +5516,10 @@ void setup()
     softSerial->begin(9600);
     Log(F("Setup"), F("Software Serial started"));
 
+    initDFPlayer();
     // Play sound on boot
     if (bootSound)
     {
-        delay(1000); // is needed for the dfplayer to startup
-        initDFPlayer();
-        delay(10);
         mp3Player.play(1);
     }
 
@@ -3767,7 +5532,15 @@ void setup()
     // Battery
     if (bootBatteryScreen)
     {
-        ShowBatteryScreen();
+        ShowBatteryScreen();
+    }
+
+    // Connecting the WiFi blocks, so the boot sound is sent before
+    unsigned long soundMillis = millis();
+    while (bootSound && mp3Player.busy() && millis() - soundMillis < DFPLAYER_STARTUP_DELAY + 1000)
+    {
+        mp3Player.loop();
+        delay(1);
     }
 
     // Set unique device ID
@@ -3795,7 +5568,7 @@ void setup()
 
     if (!wifiManager.autoConnect("PIXELIT"))
     {
-        Log(F("Setup"), F("Wifi failed to connect and hit timeout"));
+        Log(LogLevel_Warning, F("Setup"), F("Wifi failed to connect and hit timeout"));
         delay(3000);
         // Reset and try again, or maybe put it to deep sleep
         ESP.restart();
@@ -3813,34 +5586,80 @@ void setup()
     udp.begin(2390);
     // Log(F("Setup"), "Local port: " + String(udp.localPort()));
 
-    httpUpdater.setup(&server);
-
-    server.on(F("/api/screen"), HTTP_POST, HandleScreen);
-    server.on(F("/api/luxsensor"), HTTP_GET, HandleGetLuxSensor);
-    server.on(F("/api/brightness"), HTTP_GET, HandleGetBrightness);
-    server.on(F("/api/dhtsensor"), HTTP_GET, HandleGetDHTSensor); // Legacy
-    server.on(F("/api/sensor"), HTTP_GET, HandleGetSensor);
-    server.on(F("/api/buttons"), HTTP_GET, HandleGetButtons);
-    server.on(F("/api/matrixinfo"), HTTP_GET, HandleGetMatrixInfo);
-    // server.on(F("/api/soundinfo"), HTTP_GET, HandleGetSoundInfo);
-    server.on(F("/api/config"), HTTP_POST, HandleSetConfig);
-    server.on(F("/api/config"), HTTP_GET, HandleGetConfig);
-    server.on(F("/api/wifireset"), HTTP_POST, HandelWifiConfigReset);
-    server.on(F("/api/factoryreset"), HTTP_POST, HandleFactoryReset);
-    server.on(F("/"), HTTP_GET, HandleGetMainPage);
+    server.on(F("/update"), HttpServerMethod_Get, HandleGetUpdatePage);
+    server.on(F("/update"), HttpServerMethod_Post, HandleUpdate, HandleUpdateUpload);
+    firmwareUpdate.setCallback(ShowUpdateProgress);
+
+    server.on(F("/api/screen"), HttpServerMethod_Post, HandleScreen);
+    server.on(F("/api/luxsensor"), HttpServerMethod_Get, HandleGetLuxSensor);
+    server.on(F("/api/brightness"), HttpServerMethod_Get, HandleGetBrightness);
+    server.on(F("/api/dhtsensor"), HttpServerMethod_Get, HandleGetDHTSensor); // Legacy
+    server.on(F("/api/sensor"), HttpServerMethod_Get, HandleGetSensor);
+    server.on(F("/api/sensor/history"), HttpServerMethod_Get, HandleGetSensorHistory);
+    server.on(F("/api/buttons"), HttpServerMethod_Get, HandleGetButtons);
+    server.on(F("/api/matrixinfo"), HttpServerMethod_Get, HandleGetMatrixInfo);
+    server.on(F("/api/log"), HttpServerMethod_Get, HandleGetLog);
+    // server.on(F("/api/soundinfo"), HttpServerMethod_Get, HandleGetSoundInfo);
+    server.on(F("/api/config"), HttpServerMethod_Post, HandleSetConfig);
+    server.on(F("/api/config"), HttpServerMethod_Get, HandleGetConfig);
+    server.on(F("/api/playlist"), HttpServerMethod_Post, HandleSetPlaylist);
+    server.on(F("/api/playlist"), HttpServerMethod_Get, HandleGetPlaylist);
+    server.on(F("/api/rules"), HttpServerMethod_Post, HandleSetRules);
+    server.on(F("/api/rules"), HttpServerMethod_Get, HandleGetRules);
+    server.on(F("/api/gif"), HttpServerMethod_Post, HandleGif, HandleGifUpload);
+    server.on(F("/api/wall"), HttpServerMethod_Post, HandleSetWall);
+    server.on(F("/api/capture"), HttpServerMethod_Get, HandleGetCapture);
+    server.on(F("/api/capture"), HttpServerMethod_Post, HandleSetCapture);
+    server.on(F("/api/wifireset"), HttpServerMethod_Post, HandelWifiConfigReset);
+    server.on(F("/api/factoryreset"), HttpServerMethod_Post, HandleFactoryReset);
+    server.on(F("/"), HttpServerMethod_Get, HandleGetMainPage);
     server.onNotFound(HandleNotFound);
 
+    // If-None-Match is needed for the ETag of the web UI
+    const char *headerKeys[] = {"If-None-Match"};
+    server.collectHeaders(headerKeys, 1);
+    server.setBodyAllocator(AcquireRequestBody, ReleaseRequestBody);
+
     server.begin();
 
     webSocket.begin();
     webSocket.onEvent(webSocketEvent);
 
+    // Log delivery to the web UI and syslog
+    logger.setCallback(SendLog);
+    logger.setSyslog(syslogServer, syslogPort, hostname);
+
     // Liveview
-    liveview.begin(matrix, leds, SEND_LIVEVIEW_INTERVAL); // pass pointer to matrix, ledbuffer and interval
-    liveview.setCallback(sendLiveview);                   // set callback function which is called after the interval
+    liveview.begin(blitter.map(), leds, SEND_LIVEVIEW_INTERVAL); // pass pointer to XY map, ledbuffer and interval
+    liveview.setCallback(sendLiveview);                           // set callback function which is called after the interval
 
     Log(F("Setup"), F("Webserver started"));
 
+    // Realtime pixel streams
+    realtime.begin(matrix, leds, blitter.map(), realtimeDDP, realtimeE131, realtimeUniverse, realtimeTimeout);
+    realtime.setCallback(RealtimeChanged);
+
+    // Video wall
+    wall.begin(static_cast<WallRole>(wallRole), wallGroup);
+    wall.setCallback(ApplyWallScreen);
+
+    // Outbound requests (Telemetry, Check Update)
+    httpTask.begin(API_SERVER_TIMEOUT);
+
+    // Sensor history
+    sensorHistory.begin();
+
+    // Sensor publishing
+    sensorDeadband.begin(SensorField_Lux, sensorPublishMinInterval * 1000, sensorPublishMaxInterval * 1000);
+    sensorFieldDeadband.begin(SensorField_Lux, sensorPublishMinInterval * 1000, sensorPublishMaxInterval * 1000);
+    for (uint8_t i = 0; i < SensorField_Lux; i++)
+    {
+        sensorDeadband.setBand(i, sensorDeadbands[i], sensorDeadbandRelative / 100);
+        sensorFieldDeadband.setBand(i, sensorDeadbands[i], sensorDeadbandRelative / 100);
+    }
+    luxDeadband.begin(1, sensorPublishMinInterval * 1000, sensorPublishMaxInterval * 1000);
+    luxDeadband.setBand(0, sensorDeadbands[SensorField_Lux], sensorDeadbandRelative / 100);
+
     if (mqttAktiv == true)
     {
         client.setServer(mqttServer.c_str(), mqttPort);
@@ -3849,50 +5668,352 @@ void setup()
         Log(F("Setup"), F("MQTT started"));
     }
 
-    if (!bootSound)
+    // Power saving from now on
+    idleGovernor.begin(idleSleep, idleLightSleep);
+    if (VBAT_PIN > 0)
     {
-        initDFPlayer();
+        idleGovernor.setBatteryLevel(batteryLevel);
     }
+
+    // From now on log messages are delivered from the loop
+    logger.setDeferred(true);
 }
 
-void displayUpdateScreen()
+void DrawSparkline(JsonObject &sparkline)
 {
-    Log(F("UpdateScreen"), F("Display UpdateScreen..."));
+    int8_t field = SensorHistory::fieldFromName(sparkline.containsKey("field") ? sparkline["field"].as<char *>() : "temperature");
+    int8_t resolution = SensorHistory::resolutionFromName(sparkline.containsKey("resolution") ? sparkline["resolution"].as<char *>() : "1m");
+    if (field < 0 || resolution < 0)
+    {
+        Log(LogLevel_Error, F("Sparkline"), F("Error: unknown field or resolution"));
+        return;
+    }
 
-    DynamicJsonBuffer jsonBuffer;
-    JsonObject &root = jsonBuffer.createObject();
+    int16_t x = sparkline["position"]["x"];
+    int16_t y = sparkline["position"]["y"];
+    int16_t width = sparkline["size"].is<JsonObject>() ? sparkline["size"]["width"].as<int16_t>() : Geometry::width;
+    int16_t height = sparkline["size"].is<JsonObject>() ? sparkline["size"]["height"].as<int16_t>() : Geometry::height;
+    if (width <= 0 || height <= 0)
+    {
+        return;
+    }
+
+    uint8_t r, g, b;
+    if (sparkline["hexColor"].as<char *>() != NULL)
+    {
+        HEXtoRGB(sparkline["hexColor"].as<char *>(), r, g, b);
+    }
+    else if (sparkline.containsKey("color"))
+    {
+        r = sparkline["color"]["r"].as<uint8_t>();
+        g = sparkline["color"]["g"].as<uint8_t>();
+        b = sparkline["color"]["b"].as<uint8_t>();
+    }
+    else
+    {
+        r = g = b = 255;
+    }
+    uint16_t color = matrix->Color(r, g, b);
+
+    // One column per value, the newest on the right
+    int32_t values[SENSORHISTORY_MAX_SAMPLES];
+    uint16_t count = sensorHistory.values(static_cast<SensorResolution>(resolution), static_cast<SensorField>(field), values, width < SENSORHISTORY_MAX_SAMPLES ? width : SENSORHISTORY_MAX_SAMPLES);
+
+    // Scale to the given range or to the values shown
+    int32_t low = INT32_MAX;
+    int32_t high = INT32_MIN + 1;
+    for (uint16_t i = 0; i < count; i++)
+    {
+        if (values[i] != SENSORHISTORY_MISSING)
+        {
+            low = values[i] < low ? values[i] : low;
+            high = values[i] > high ? values[i] : high;
+        }
+    }
+    if (sparkline.containsKey("min"))
+    {
+        low = roundf(sparkline["min"].as<float>() * SENSORHISTORY_SCALE);
+    }
+    if (sparkline.containsKey("max"))
+    {
+        high = roundf(sparkline["max"].as<float>() * SENSORHISTORY_SCALE);
+    }
+    int32_t range = high > low ? high - low : 1;
+    bool bars = sparkline["bars"];
+
+    int16_t bottom = y + height - 1;
+    int16_t previousY = -1;
+    for (uint16_t i = 0; i < count; i++)
+    {
+        if (values[i] == SENSORHISTORY_MISSING)
+        {
+            previousY = -1;
+            continue;
+        }
+        int32_t value = values[i] < low ? low : (values[i] > high ? high : values[i]);
+        int16_t column = x + width - count + i;
+        int16_t row = bottom - (int64_t)(value - low) * (height - 1) / range;
+        if (bars)
+        {
+            matrix->drawLine(column, bottom, column, row, color);
+        }
+        else if (previousY >= 0 && (row > previousY + 1 || row < previousY - 1))
+        {
+            // Connect steep changes to the previous column
+            matrix->drawLine(column, row, column, row > previousY ? previousY + 1 : previousY - 1, color);
+        }
+        else
+        {
+            matrix->drawPixel(column, row, color);
+        }
+        previousY = row;
+    }
+}
+
+void StartEffect(JsonObject &effect)
+{
+    const char *name = effect["name"].as<char *>();
+    int8_t type = EffectEngine::typeFromName(name != NULL ? name : "");
+    if (type < 0)
+    {
+        Log(LogLevel_Error, F("Effect"), F("Error: unknown effect"));
+        return;
+    }
+    if (type == EffectType_None)
+    {
+        return;
+    }
+
+    int16_t x = effect["position"]["x"];
+    int16_t y = effect["position"]["y"];
+    int16_t width = effect["size"].is<JsonObject>() ? effect["size"]["width"].as<int16_t>() : Geometry::width;
+    int16_t height = effect["size"].is<JsonObject>() ? effect["size"]["height"].as<int16_t>() : Geometry::height;
+    effects.start(static_cast<EffectType>(type), x, y, width, height);
+
+    if (effect.containsKey("palette"))
+    {
+        if (!effects.setPalette(effect["palette"].as<char *>()))
+        {
+            Log(LogLevel_Warning, F("Effect"), F("Unknown palette, using the default"));
+        }
+    }
+    else if (effect["hexColor"].as<char *>() != NULL)
+    {
+        uint8_t r, g, b;
+        HEXtoRGB(effect["hexColor"].as<char *>(), r, g, b);
+        effects.setColor(CRGB(r, g, b));
+    }
+    else if (effect.containsKey("color"))
+    {
+        effects.setColor(CRGB(effect["color"]["r"].as<uint8_t>(), effect["color"]["g"].as<uint8_t>(), effect["color"]["b"].as<uint8_t>()));
+    }
+    if (effect.containsKey("density"))
+    {
+        effects.setDensity(effect["density"].as<uint8_t>());
+    }
+    if (effect.containsKey("delay"))
+    {
+        effects.setInterval(effect["delay"].as<uint16_t>());
+    }
+    effects.setBackground(effect["background"].as<bool>());
+    if (effect.containsKey("values"))
+    {
+        SetSpectrum(effect);
+    }
+
+    // First frame right away
+    effects.step();
+    effectPrevMillis = millis();
+}
 
-    BuildUpdateScreenJSON(root);
+void SetSpectrum(JsonObject &json)
+{
+    // Values 0 to max (default 255), one per band
+    float max = json.containsKey("max") ? json["max"].as<float>() : 255;
+    if (max <= 0)
+    {
+        return;
+    }
+
+    uint8_t values[EFFECT_MAX_BANDS];
+    uint8_t count = 0;
+    for (JsonVariant value : json["values"].as<JsonArray>())
+    {
+        if (count == EFFECT_MAX_BANDS)
+        {
+            break;
+        }
+        float level = value.as<float>() * 255 / max;
+        values[count++] = level <= 0 ? 0 : (level >= 255 ? 255 : level);
+    }
+    effects.setSpectrum(values, count);
+}
+
+void ReplayCommand(CaptureRecord &record)
+{
+    // Only drawing commands, config, playlist, rules and resets would persist or restart
+    unsigned long start = micros();
+    DynamicJsonBuffer jsonBuffer;
+    // Parsed in place, the payload is only needed once
+    JsonObject &json = jsonBuffer.parseObject((char *)record.payload.c_str());
+    bool replayed = true;
+    if (!json.success())
+    {
+        replayed = false;
+    }
+    else if (record.transport == CaptureTransport_Http && strcmp(record.command, "/api/screen") == 0)
+    {
+        CreateFrames(json);
+    }
+    else if (record.transport == CaptureTransport_Mqtt && strcmp(record.command, "setScreen") == 0)
+    {
+        CreateFrames(json);
+    }
+    else if (record.transport == CaptureTransport_Mqtt && strcmp(record.command, "setSpectrum") == 0)
+    {
+        SetSpectrum(json);
+    }
+    else if (record.transport == CaptureTransport_WebSocket && json.containsKey("setScreen"))
+    {
+        CreateFrames(json["setScreen"], json.containsKey("forcedDuration") ? json["forcedDuration"].as<int>() : 0);
+    }
+    else if (record.transport == CaptureTransport_WebSocket && json.containsKey("setSpectrum"))
+    {
+        SetSpectrum(json["setSpectrum"]);
+    }
+    else
+    {
+        replayed = false;
+    }
 
-    if (root.success())
+    if (replayed)
     {
-        CreateFrames(root, CHECKUPDATESCREEN_DURATION);
+        capture.renderTime(micros() - start);
     }
     else
     {
-        Log(F("UpdateScreen"), F("Failed to Build UpdateScreen JSON"));
+        capture.skipped();
+        Log(LogLevel_Warning, F("Capture"), "Skipped " + String(CommandCapture::transportName(record.transport)) + " command " + String(record.command));
+    }
+}
+
+CLEDController &AddMatrixLeds()
+{
+#if defined(LED_OUTPUT_DMA)
+    // show() only encodes the frame, the transfer runs in the background
+    return FastLED.addLeds(&ledOutput, leds, Geometry::pixels);
+#else
+    return FastLED.addLeds<NEOPIXEL, MATRIX_PIN>(leds, Geometry::pixels);
+#endif
+}
+
+void LoadAssetAnimation(const Asset &asset, int16_t x, int16_t y)
+{
+    if (asset.width * asset.height > Geometry::bitmapPixels)
+    {
+        Log(LogLevel_Error, F("Asset"), F("Error: animation larger than the bitmap store"));
+        return;
+    }
+
+    // Expand the frames into the animation store, same as a bitmapAnimation
+    uint8_t frames = min((int)asset.frameCount, 9);
+    memset(animationBmpList[0], 0, sizeof(animationBmpList[0]));
+    for (uint8_t i = 0; i < 10; i++)
+    {
+        if (i >= frames)
+        {
+            animationBmpList[i][0] = 2;
+            animationBmpDelays[i] = 0;
+            continue;
+        }
+        if (i > 0)
+        {
+            memcpy(animationBmpList[i], animationBmpList[i - 1], sizeof(animationBmpList[i]));
+        }
+        AssetApplyFrame(asset, i, animationBmpList[i]);
+        animationBmpDelays[i] = AssetFrameDelay(asset, i);
+    }
+    // 2 in the first pixel marks the end of the animation, use the (almost) same colour 3 instead
+    for (uint8_t i = 0; i < frames; i++)
+    {
+        if (animationBmpList[i][0] == 2)
+        {
+            animationBmpList[i][0] = 3;
+        }
+    }
+
+    bmpPosX = x;
+    bmpPosY = y;
+    bmpWidth = asset.width;
+    bmpHeight = asset.height;
+    withBMP = true;
+    animateBMPDelay = animationBmpDelays[0];
+    animateBMPFrameDelays = true;
+    animateBMPRubberbandingAktiv = false;
+    animateBMPLimitLoops = 0;
+    animateBMPCounter = 0;
+    animateBMPLoopCount = 0;
+    animateBMPAktivLoop = true;
+    animateBMPReverse = false;
+    animateBMPPrevMillis = millis();
+    AnimateBMP(false);
+}
+
+void displayUpdateScreen()
+{
+    Log(F("UpdateScreen"), F("Display UpdateScreen..."));
+
+    if (sleepMode || realtime.isActive())
+    {
+        return;
     }
+
+    // Built-in screen, rendered straight from the asset tables without JSON
+    lastScreenMessageMillis = millis();
+    clockAktiv = false;
+    scrollTextAktivLoop = false;
+    animateBMPAktivLoop = false;
+    effects.stop();
+    wallScreenActive = false;
+    playlist.interrupt();
+
+    matrix->setBrightness(currentMatrixBrightness);
+    matrix->clear();
+    LoadAssetAnimation(updateScreen, 0, 0);
+    scrollTextDelay = scrollTextDefaultDelay;
+    DrawTextScrolled(F("New FW available"), false, false, false, 255, 255, 255, 7, 1);
+    matrix->show();
+
+    forcedScreenIsActiveUntil = millis() + CHECKUPDATESCREEN_DURATION;
 }
 
 void checkUpdate()
 {
     Log(F("CheckUpdate"), F("Checking..."));
-    HttpClient httpClient = HttpClient(wifiClientHTTP, CHECKUPDATE_SERVER_HOST, CHECKUPDATE_SERVER_PORT);
-    httpClient.sendHeader("User-Agent", "PixelIt");
-    httpClient.setTimeout(1500);
-    httpClient.get(CHECKUPDATE_SERVER_PATH);
-    int statusCode = httpClient.responseStatusCode();
-    String response = httpClient.responseBody();
+    if (!httpTask.get(apiServerHost.c_str(), apiServerPort, CHECKUPDATE_SERVER_PATH, checkUpdateResponse))
+    {
+        Log(LogLevel_Error, F("CheckUpdate"), F("Error: request queue full"));
+    }
+}
+
+void checkUpdateResponse(const HttpTaskResponse &response)
+{
+    if (response.result != HttpTaskResult_Ok)
+    {
+        Log(LogLevel_Error, F("CheckUpdate"), "Error. Request failed: " + String(response.result));
+        return;
+    }
 
-    // Serial.print("Status code: ");
-    // Serial.println(statusCode);
-    // Serial.print("Response: ");
-    // Serial.println(response);
+    if (response.truncated)
+    {
+        Log(LogLevel_Error, F("CheckUpdate"), "Error. Response too large: " + String(response.receivedLength) + " bytes");
+        return;
+    }
 
-    if (statusCode == 200)
+    if (response.statusCode == 200)
     {
         DynamicJsonBuffer jsonBuffer;
-        JsonObject &root = jsonBuffer.parseObject(response);
+        JsonObject &root = jsonBuffer.parseObject(response.body);
         if (root.containsKey("version"))
         {
             lastReleaseVersion = root["version"].as<String>();
@@ -3911,14 +6032,32 @@ void checkUpdate()
     }
     else
     {
-        Log(F("CheckUpdate"), "Error. HTTP Code: " + statusCode);
+        Log(LogLevel_Error, F("CheckUpdate"), "Error. HTTP Code: " + String(response.statusCode));
     }
 }
 
 void loop()
 {
-    server.handleClient();
+    server.loop();
     webSocket.loop();
+    httpTask.loop();
+    mp3Player.loop();
+    memoryBudget.loop();
+
+    // Replay a recorded capture with its original timing
+    if (capture.state() == CaptureState_Replaying)
+    {
+        capture.loop();
+        CaptureRecord record;
+        while (capture.next(record))
+        {
+            ReplayCommand(record);
+        }
+        if (capture.state() == CaptureState_Idle)
+        {
+            Log(F("Capture"), "Replay finished: " + capture.report());
+        }
+    }
 
     // Update Battery level
     if (millis() - batteryLevelPrevMillis >= UPDATE_BATTERY_LEVEL_INTERVAL)
@@ -4000,34 +6139,35 @@ void loop()
         }
     }
 
-    // Check buttons
-    for (uint button = 0; button < 3; button++)
+    // Check buttons, edges are collected by interrupt
+    buttons.loop();
+
+    // Local rules with time windows
+    if (rules.count() > 0)
     {
-        if (btnEnabled[button])
-        {
-            if ((btnState[button] == btnState_Released) && (digitalRead(TranslatePin(btnPin[button])) == btnPressedLevel[button]))
-            {
-                btnState[button] = btnState_PressedNew;
-            }
-            if ((btnState[button] == btnState_PressedBefore) && (digitalRead(TranslatePin(btnPin[button])) != btnPressedLevel[button]))
-            {
-                btnState[button] = btnState_Released;
-                HandleAndSendButtonPress(button, false);
-            }
-            if (btnState[button] == btnState_PressedNew)
-            {
-                btnState[button] = btnState_PressedBefore;
-                HandleAndSendButtonPress(button, true);
-            }
-        }
+        rules.timeTick(timeStatus() != timeNotSet ? hour() * 60 + minute() : -1);
+    }
+
+    // Realtime pixel stream, drained while sleeping but not drawn
+    realtime.loop(!sleepMode);
+
+    // Video wall, frames follow the shared wall clock
+    wall.loop();
+    WallLoop();
+
+    // Local playlist rotation, paused while sleeping, streaming, on the wall or a forced screen is shown
+    if (!sleepMode && !realtime.isActive() && !wallScreenActive && millis() >= forcedScreenIsActiveUntil)
+    {
+        playlist.loop(timeStatus() != timeNotSet ? now() : 0);
     }
 
     // Clock Auto Fallback
-    if (!sleepMode && ((clockAutoFallbackActive && !clockAktiv && millis() - lastScreenMessageMillis >= (clockAutoFallbackTime * 1000)) || forceClock))
+    if (!sleepMode && !realtime.isActive() && !wallScreenActive && ((clockAutoFallbackActive && !clockAktiv && millis() - lastScreenMessageMillis >= (clockAutoFallbackTime * 1000)) || forceClock))
     {
         forceClock = false;
         scrollTextAktivLoop = false;
         animateBMPAktivLoop = false;
+        effects.stop();
 
         int performWipe = 0;
 
@@ -4087,6 +6227,12 @@ void loop()
         DrawClock(false);
     }
 
+    // Running clock transitions
+    if (clockAktiv && clockRenderer.loop())
+    {
+        matrix->show();
+    }
+
     // Get Lunx and control brightness
     if (millis() - getLuxPrevMillis >= SEND_LUX_INTERVAL)
     {
@@ -4105,6 +6251,9 @@ void loop()
             currentLux = (roundf(photocell->getSmoothedLux() * 1000) / 1000) + luxOffset;
         }
 
+        rules.sensorValue(RuleSource_Lux, currentLux);
+        sensorHistory.add(SensorField_Lux, currentLux);
+
         if (!sleepMode && matrixBrightnessAutomatic)
         {
             float newBrightness = map(currentLux, mbaLuxMin, mbaLuxMax, mbaDimMin, mbaDimMax);
@@ -4142,8 +6291,14 @@ void loop()
         SendSensor(false);
     }
 
-    // liveview
-    liveview.loop();
+    // liveview, paused while the memory is tight
+    if (memoryBudget.liveviewAllowed())
+    {
+        liveview.loop();
+    }
+
+    // Downsample sensor readings
+    sensorHistory.loop();
 
     // send matrix info
     if (millis() - sendInfoPrevMillis >= SEND_MATRIXINFO_INTERVAL)
@@ -4153,17 +6308,59 @@ void loop()
         // SendMp3PlayerInfo(false);
     }
 
-    if (!sleepMode && (animateBMPAktivLoop && millis() - animateBMPPrevMillis >= animateBMPDelay))
+    // On battery the frame rate may be capped
+    uint16_t frameInterval = idleGovernor.frameInterval();
+    uint animateInterval = animateBMPDelay > frameInterval ? animateBMPDelay : frameInterval;
+    uint scrollInterval = scrollTextDelay > frameInterval ? scrollTextDelay : frameInterval;
+    uint effectInterval = effects.interval() > frameInterval ? effects.interval() : frameInterval;
+
+    if (!sleepMode && (animateBMPAktivLoop && millis() - animateBMPPrevMillis >= animateInterval))
     {
         animateBMPPrevMillis = millis();
         AnimateBMP(true);
     }
 
-    if (!sleepMode && (scrollTextAktivLoop && millis() - scrollTextPrevMillis >= scrollTextDelay))
+    if (!sleepMode && (scrollTextAktivLoop && millis() - scrollTextPrevMillis >= scrollInterval))
     {
         scrollTextPrevMillis = millis();
         ScrollText(false);
     }
+
+    bool effectVisible = !sleepMode && effects.active() && !realtime.isActive() && !wallScreenActive;
+    if (effectVisible && millis() - effectPrevMillis >= effectInterval)
+    {
+        effectPrevMillis = millis();
+        effects.step();
+        effects.draw();
+        matrix->show();
+    }
+
+    // Deliver log messages
+    logger.loop();
+
+    // Tell the governor what is running and sleep until the next deadline
+    if (realtime.isActive() || server.active() || gifWebSocketActive || wallRole != WallRole_Off || capture.state() == CaptureState_Replaying || mp3Player.busy())
+    {
+        idleGovernor.busy();
+    }
+    if (!sleepMode && animateBMPAktivLoop)
+    {
+        idleGovernor.animating(animateBMPPrevMillis + animateInterval);
+    }
+    if (!sleepMode && scrollTextAktivLoop)
+    {
+        idleGovernor.animating(scrollTextPrevMillis + scrollInterval);
+    }
+    if (effectVisible)
+    {
+        idleGovernor.animating(effectPrevMillis + effectInterval);
+    }
+    if (clockAktiv && clockRenderer.inTransition())
+    {
+        idleGovernor.animating(clockRenderer.nextStep());
+    }
+    idleGovernor.setDisplayOff(sleepMode);
+    idleGovernor.loop();
 }
 
 void SendMatrixInfo()
@@ -4171,15 +6368,19 @@ void SendMatrixInfo()
     // Check if mqtt or websocket connected
     if ((mqttAktiv == true && client.connected()) || (webSocket.connectedClients() > 0))
     {
-        String matrixInfo = GetMatrixInfo();
+        // Written once with the websocket envelope, MQTT gets the document inside
+        statusJson.reset();
+        statusJson.beginEnvelope("sysinfo");
+        WriteMatrixInfo(statusJson);
+        statusJson.endEnvelope();
 
         // Check if sending via MQTT is required
         if (mqttAktiv == true && client.connected())
         {
-            client.publish((mqttMasterTopic + "matrixinfo").c_str(), matrixInfo.c_str(), true);
+            client.publish((mqttMasterTopic + "matrixinfo").c_str(), (const uint8_t *)statusJson.document(), statusJson.documentLength(), true);
             if (mqttUseDeviceTopic)
             {
-                client.publish((mqttDeviceTopic + "matrixinfo").c_str(), matrixInfo.c_str(), true);
+                client.publish((mqttDeviceTopic + "matrixinfo").c_str(), (const uint8_t *)statusJson.document(), statusJson.documentLength(), true);
             }
         }
         // Check if sending via websocket is required
@@ -4187,7 +6388,7 @@ void SendMatrixInfo()
         {
             for (uint i = 0; i < sizeof websocketConnection / sizeof websocketConnection[0]; i++)
             {
-                webSocket.sendTXT(i, "{\"sysinfo\":" + matrixInfo + "}");
+                webSocket.sendTXT(i, statusJson.frame(), statusJson.length(), true);
             }
         }
     }
@@ -4197,35 +6398,44 @@ void SendLDR(bool force)
 {
     if (force)
     {
-        oldGetLuxSensor = "";
+        luxDeadband.reset();
     }
 
-    String luxSensor;
+    bool mqttConnected = mqttAktiv == true && client.connected();
+    bool webSocketConnected = webSocket.connectedClients() > 0;
 
-    // Prüfen ob die Abfrage des LuxSensor überhaupt erforderlich ist
-    if ((mqttAktiv == true && client.connected()) || (webSocket.connectedClients() > 0))
+    // Only serialise when someone gets the change
+    if ((!mqttConnected && !webSocketConnected) || !luxDeadband.due(0, currentLux))
     {
-        luxSensor = GetLuxSensor();
+        return;
     }
+    luxDeadband.published(0, currentLux);
+
+    statusJson.reset();
+    statusJson.beginEnvelope("sensor");
+    WriteLuxSensor(statusJson);
+    statusJson.endEnvelope();
     // Prüfen ob über MQTT versendet werden muss
-    if (mqttAktiv == true && client.connected() && oldGetLuxSensor != luxSensor)
+    if (mqttConnected)
     {
-        client.publish((mqttMasterTopic + "luxsensor").c_str(), luxSensor.c_str(), true);
+        client.publish((mqttMasterTopic + "luxsensor").c_str(), (const uint8_t *)statusJson.document(), statusJson.documentLength(), true);
         if (mqttUseDeviceTopic)
         {
-            client.publish((mqttDeviceTopic + "luxsensor").c_str(), luxSensor.c_str(), true);
+            client.publish((mqttDeviceTopic + "luxsensor").c_str(), (const uint8_t *)statusJson.document(), statusJson.documentLength(), true);
+        }
+        if (mqttSensorFieldTopics)
+        {
+            client.publish(((mqttUseDeviceTopic ? mqttDeviceTopic : mqttMasterTopic) + "sensor/lux").c_str(), String(currentLux).c_str(), true);
         }
     }
     // Prüfen ob über Websocket versendet werden muss
-    if (webSocket.connectedClients() > 0 && oldGetLuxSensor != luxSensor)
+    if (webSocketConnected)
     {
         for (unsigned int i = 0; i < sizeof websocketConnection / sizeof websocketConnection[0]; i++)
         {
-            webSocket.sendTXT(i, "{\"sensor\":" + luxSensor + "}");
+            webSocket.sendTXT(i, statusJson.frame(), statusJson.length(), true);
         }
     }
-
-    oldGetLuxSensor = luxSensor;
 }
 void sendLiveview(const char *data, size_t length)
 {
@@ -4242,47 +6452,88 @@ void SendSensor(bool force)
 {
     if (force)
     {
-        oldGetSensor = "";
+        sensorDeadband.reset();
+        sensorFieldDeadband.reset();
     }
 
-    String Sensor;
+    bool mqttConnected = mqttAktiv == true && client.connected();
+    bool webSocketConnected = webSocket.connectedClients() > 0;
 
-    // Prüfen ob die Abfrage des LuxSensor überhaupt erforderlich ist
-    if ((mqttAktiv == true && client.connected()) || (webSocket.connectedClients() > 0))
+    // Prüfen ob die Abfrage der Sensoren überhaupt erforderlich ist, the history samples all the time
+    if (!mqttConnected && !webSocketConnected && !RulesNeedSensor() && tempSensor == TempSensor_None && VBAT_PIN <= 0)
     {
-        Sensor = GetSensor();
+        return;
     }
-    // Prüfen ob über MQTT versendet werden muss
-    if (mqttAktiv == true && client.connected() && oldGetSensor != Sensor)
+
+    float values[SensorField_Count];
+    bool success = ReadSensors(values);
+    // Only the periodic reading, forced ones (e.g. a new websocket client) would add samples and fire rules
+    if (!force)
     {
-        client.publish((mqttMasterTopic + "dhtsensor").c_str(), Sensor.c_str(), true); // Legancy
-        client.publish((mqttMasterTopic + "sensor").c_str(), Sensor.c_str(), true);
-        if (mqttUseDeviceTopic)
+        FeedSensorValues(values);
+    }
+
+    // Combined payload, only serialised when it is published
+    if ((mqttConnected || webSocketConnected) && sensorDeadband.due(values))
+    {
+        sensorDeadband.published(values);
+        statusJson.reset();
+        statusJson.beginEnvelope("sensor");
+        WriteSensorValues(statusJson, values, success);
+        statusJson.endEnvelope();
+        const uint8_t *document = (const uint8_t *)statusJson.document();
+        size_t documentLength = statusJson.documentLength();
+
+        // Prüfen ob über MQTT versendet werden muss
+        if (mqttConnected)
+        {
+            client.publish((mqttMasterTopic + "dhtsensor").c_str(), document, documentLength, true); // Legancy
+            client.publish((mqttMasterTopic + "sensor").c_str(), document, documentLength, true);
+            if (mqttUseDeviceTopic)
+            {
+                client.publish((mqttDeviceTopic + "dhtsensor").c_str(), document, documentLength, true); // Legancy
+                client.publish((mqttDeviceTopic + "sensor").c_str(), document, documentLength, true);
+            }
+        }
+        // Prüfen ob über Websocket versendet werden muss
+        if (webSocketConnected)
         {
-            client.publish((mqttDeviceTopic + "dhtsensor").c_str(), Sensor.c_str(), true); // Legancy
-            client.publish((mqttDeviceTopic + "sensor").c_str(), Sensor.c_str(), true);
+            for (uint i = 0; i < sizeof websocketConnection / sizeof websocketConnection[0]; i++)
+            {
+                webSocket.sendTXT(i, statusJson.frame(), statusJson.length(), true);
+            }
         }
     }
-    // Prüfen ob über Websocket versendet werden muss
-    if (webSocket.connectedClients() > 0 && oldGetSensor != Sensor)
+
+    // Single values, each with its own deadband
+    if (mqttConnected && mqttSensorFieldTopics)
     {
-        for (uint i = 0; i < sizeof websocketConnection / sizeof websocketConnection[0]; i++)
+        String topic = (mqttUseDeviceTopic ? mqttDeviceTopic : mqttMasterTopic) + "sensor/";
+        for (uint8_t i = 0; i < SensorField_Lux; i++)
         {
-            webSocket.sendTXT(i, "{\"sensor\":" + Sensor + "}");
+            if (isnan(values[i]) || !sensorFieldDeadband.due(i, values[i]))
+            {
+                continue;
+            }
+            sensorFieldDeadband.published(i, values[i]);
+            client.publish((topic + SensorHistory::fieldName(static_cast<SensorField>(i))).c_str(), String(values[i]).c_str(), true);
         }
     }
-
-    oldGetSensor = Sensor;
 }
 
 void SendConfig()
 {
     if (webSocket.connectedClients() > 0)
     {
+        size_t configLength = ConfigJsonLength();
+        std::unique_ptr<char[]> buffer(new char[configLength]);
+        JsonWriter json(buffer.get(), configLength, WEBSOCKETS_MAX_HEADER_SIZE);
+        json.beginEnvelope("config");
+        WriteConfig(json);
+        json.endEnvelope();
         for (uint i = 0; i < sizeof websocketConnection / sizeof websocketConnection[0]; i++)
         {
-            String config = GetConfig();
-            webSocket.sendTXT(i, "{\"config\":" + config + "}");
+            webSocket.sendTXT(i, json.frame(), json.length(), true);
         }
     }
 }
@@ -4343,20 +6594,47 @@ void sendNTPpacket(String &address)
     udp.endPacket();
 }
 
-void Log(String function, String message)
+// Behind the Log() macro, only reached at an enabled level
+void LogWrite(LogLevel level, const __FlashStringHelper *function, const String &message)
+{
+    logger.log(level, function, message.c_str());
+}
+
+void LogWrite(LogLevel level, const __FlashStringHelper *function, const __FlashStringHelper *message)
+{
+    logger.log(level, function, message);
+}
+
+void LogWrite(LogLevel level, const String &function, const String &message)
 {
+    logger.log(level, function.c_str(), message.c_str());
+}
 
-    String timeStamp = IntFormat(year()) + "-" + IntFormat(month()) + "-" + IntFormat(day()) + "T" + IntFormat(hour()) + ":" + IntFormat(minute()) + ":" + IntFormat(second());
+// Removes the ", " behind the last item of a list
+void LogTrimList(char *message)
+{
+    size_t length = strlen(message);
+    if (length >= 2 && strcmp(message + length - 2, ", ") == 0)
+    {
+        message[length - 2] = '\0';
+    }
+}
 
-    Serial.println("[" + timeStamp + "] " + function + ": " + message);
+// Appends to a fixed log message, format in flash
+void LogAppend(char *message, PGM_P format, ...)
+{
+    size_t length = strlen(message);
+    va_list args;
+    va_start(args, format);
+    vsnprintf_P(message + length, LOG_MESSAGE_LENGHT - length, format, args);
+    va_end(args);
+}
 
+void SendLog(const String &payload)
+{
     // Prüfen ob über Websocket versendet werden muss
     if (webSocket.connectedClients() > 0)
     {
-        for (unsigned int i = 0; i < sizeof websocketConnection / sizeof websocketConnection[0]; i++)
-        {
-            String payload = "{\"log\":{\"timeStamp\":\"" + timeStamp + "\",\"function\":\"" + function + "\",\"message\":\"" + message + "\"}}";
-            webSocket.sendTXT(i, payload);
-        }
+        webSocket.broadcastTXT(payload.c_str(), payload.length());
     }
 }
\ No newline at end of file
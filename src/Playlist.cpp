@@ -0,0 +1,251 @@
+#include "Playlist.h"
+#include <Arduino.h>
+
+Playlist::Playlist()
+{
+}
+
+void Playlist::begin(uint32_t interruptDuration)
+{
+    _count = 0;
+    _current = -1;
+    _currentSince = millis();
+    _interruptedSince = 0;
+    _interruptDuration = interruptDuration;
+    _interrupted = false;
+    callbackFunction = nullptr;
+    conditionFunction = nullptr;
+    expiredFunction = nullptr;
+}
+
+void Playlist::setCallback(void (*func)(const PlaylistItem &))
+{
+    callbackFunction = func;
+}
+
+void Playlist::setConditionCallback(bool (*func)(PlaylistCondition))
+{
+    conditionFunction = func;
+}
+
+void Playlist::setExpiredCallback(void (*func)(const PlaylistItem &))
+{
+    expiredFunction = func;
+}
+
+void Playlist::setInterruptDuration(uint32_t interruptDuration)
+{
+    _interruptDuration = interruptDuration;
+}
+
+void Playlist::loop(time_t currentTime)
+{
+    if (_count == 0 || callbackFunction == nullptr)
+    {
+        return;
+    }
+
+    bool forceShow = false;
+    if (_interrupted)
+    {
+        if ((millis() - _interruptedSince) < _interruptDuration)
+        {
+            return;
+        }
+        // The interrupting screen is over, continue with the next item
+        _interrupted = false;
+        forceShow = true;
+    }
+
+    bool currentValid = _current >= 0 && _current < _count && isEligible(_current, currentTime);
+    if (!forceShow && currentValid && (millis() - _currentSince) < (uint32_t)_items[_current].duration * 1000)
+    {
+        return;
+    }
+
+    int nextItem = next(currentTime);
+    if (nextItem == -1)
+    {
+        _current = -1;
+        return;
+    }
+
+    _currentSince = millis();
+    // A single eligible item only has to be redrawn if something else was shown in between
+    if (nextItem != _current || forceShow || !currentValid)
+    {
+        _current = nextItem;
+        callbackFunction(_items[_current]);
+    }
+}
+
+int Playlist::set(const char *name, uint16_t duration, uint8_t priority, time_t expires, PlaylistCondition condition)
+{
+    int index = find(name);
+    if (index == -1)
+    {
+        if (_count >= PLAYLIST_MAX_ITEMS)
+        {
+            return -1;
+        }
+        index = _count++;
+    }
+
+    strncpy(_items[index].name, name, PLAYLIST_NAME_LENGHT - 1);
+    _items[index].name[PLAYLIST_NAME_LENGHT - 1] = '\0';
+    _items[index].duration = duration > 0 ? duration : 1;
+    _items[index].priority = priority;
+    _items[index].expires = expires;
+    _items[index].condition = condition;
+
+    return index;
+}
+
+bool Playlist::remove(const char *name)
+{
+    int index = find(name);
+    if (index == -1)
+    {
+        return false;
+    }
+
+    for (uint8_t i = index; i + 1 < _count; i++)
+    {
+        _items[i] = _items[i + 1];
+    }
+    _count--;
+
+    if (_current == index)
+    {
+        _current = -1;
+    }
+    else if (_current > index)
+    {
+        _current--;
+    }
+    return true;
+}
+
+void Playlist::clear()
+{
+    _count = 0;
+    _current = -1;
+}
+
+int Playlist::find(const char *name) const
+{
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        if (strncmp(_items[i].name, name, PLAYLIST_NAME_LENGHT) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool Playlist::removeExpired(time_t currentTime)
+{
+    bool removed = false;
+    for (int i = _count - 1; i >= 0; i--)
+    {
+        if (_items[i].expires > 0 && currentTime > 0 && _items[i].expires <= currentTime)
+        {
+            if (expiredFunction != nullptr)
+            {
+                expiredFunction(_items[i]);
+            }
+            remove(_items[i].name);
+            removed = true;
+        }
+    }
+    return removed;
+}
+
+void Playlist::interrupt()
+{
+    _interrupted = true;
+    _interruptedSince = millis();
+}
+
+void Playlist::restart()
+{
+    _interrupted = false;
+    _current = -1;
+}
+
+uint8_t Playlist::count() const
+{
+    return _count;
+}
+
+const PlaylistItem &Playlist::item(uint8_t index) const
+{
+    return _items[index];
+}
+
+int Playlist::current() const
+{
+    return _current;
+}
+
+bool Playlist::isInterrupted() const
+{
+    return _interrupted;
+}
+
+bool Playlist::isEligible(uint8_t index, time_t currentTime) const
+{
+    const PlaylistItem &item = _items[index];
+
+    // Without a valid time (currentTime == 0) expiry can not be checked, keep the item
+    if (item.expires > 0 && currentTime > 0 && item.expires <= currentTime)
+    {
+        return false;
+    }
+
+    if (item.condition != PlaylistCondition_Always && conditionFunction != nullptr)
+    {
+        return conditionFunction(item.condition);
+    }
+
+    return true;
+}
+
+int Playlist::next(time_t currentTime) const
+{
+    // Items are cycled ordered by priority (descending) and then by registration order.
+    // The sort key is computed on the fly, the list is small enough for a linear scan.
+    int32_t currentKey = -1;
+    if (_current >= 0 && _current < _count)
+    {
+        currentKey = ((255 - _items[_current].priority) << 8) | _current;
+    }
+
+    int following = -1;
+    int32_t followingKey = INT32_MAX;
+    int first = -1;
+    int32_t firstKey = INT32_MAX;
+
+    for (uint8_t i = 0; i < _count; i++)
+    {
+        if (!isEligible(i, currentTime))
+        {
+            continue;
+        }
+
+        int32_t key = ((255 - _items[i].priority) << 8) | i;
+        if (key < firstKey)
+        {
+            firstKey = key;
+            first = i;
+        }
+        if (key > currentKey && key < followingKey)
+        {
+            followingKey = key;
+            following = i;
+        }
+    }
+
+    return following != -1 ? following : first;
+}
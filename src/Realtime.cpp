@@ -0,0 +1,294 @@
+#include "Realtime.h"
+#include <Arduino.h>
+
+static const uint8_t E131_ACN_ID[] = {'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0, 0, 0};
+
+static uint32_t readUInt32(const uint8_t *data)
+{
+    return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | data[3];
+}
+
+static uint16_t readUInt16(const uint8_t *data)
+{
+    return (data[0] << 8) | data[1];
+}
+
+Realtime::Realtime()
+{
+}
+
+void Realtime::begin(FastLED_NeoMatrix *matrix, CRGB *leds, const uint16_t *map, bool ddp, bool e131, uint16_t universe, uint32_t timeout)
+{
+    _matrix = matrix;
+    _leds = leds;
+    _map = map;
+    _pixels = (uint32_t)_matrix->width() * _matrix->height();
+    _ddpEnabled = ddp;
+    _e131Enabled = e131;
+    _universe = universe;
+    _universes = (_pixels * 3 + REALTIME_E131_CHANNELS_PER_UNIVERSE - 1) / REALTIME_E131_CHANNELS_PER_UNIVERSE;
+    if (_universes > REALTIME_E131_MAX_UNIVERSES)
+    {
+        _universes = REALTIME_E131_MAX_UNIVERSES;
+    }
+    _timeout = timeout;
+
+    _active = false;
+    _dirty = false;
+    _frames = 0;
+    _dropped = 0;
+    _ddpSequence = 0;
+    _e131Seen = 0;
+    _e131SyncUniverse = 0;
+    callbackFunction = nullptr;
+
+    if (_ddpEnabled)
+    {
+        _ddp.begin(REALTIME_DDP_PORT);
+    }
+    if (_e131Enabled)
+    {
+        _e131.begin(REALTIME_E131_PORT);
+    }
+}
+
+void Realtime::setCallback(void (*func)(bool))
+{
+    callbackFunction = func;
+}
+
+void Realtime::loop(bool render)
+{
+    if (_ddpEnabled)
+    {
+        receive(_ddp, true, render);
+    }
+    if (_e131Enabled)
+    {
+        receive(_e131, false, render);
+    }
+
+    if (_active && millis() - _lastPacket >= _timeout)
+    {
+        _active = false;
+        if (callbackFunction != nullptr)
+        {
+            callbackFunction(false);
+        }
+    }
+}
+
+bool Realtime::isActive() const
+{
+    return _active;
+}
+
+uint32_t Realtime::frames() const
+{
+    return _frames;
+}
+
+uint32_t Realtime::dropped() const
+{
+    return _dropped;
+}
+
+void Realtime::receive(WiFiUDP &udp, bool ddp, bool render)
+{
+    // Bounded, so a flood of packets can not starve the rest of the loop
+    for (uint8_t i = 0; i < REALTIME_MAX_PACKETS_PER_LOOP; i++)
+    {
+        int size = udp.parsePacket();
+        if (size <= 0)
+        {
+            return;
+        }
+
+        size_t length = udp.read(_packet, REALTIME_PACKET_LENGHT);
+        bool valid = ddp ? handleDDP(length, render) : handleE131(length, render);
+        if (!valid)
+        {
+            _dropped++;
+        }
+    }
+}
+
+bool Realtime::handleDDP(size_t length, bool render)
+{
+    if (length < 10)
+    {
+        return false;
+    }
+
+    uint8_t flags = _packet[0];
+    // Version 1 only, queries and replies are not supported
+    if ((flags & 0xC0) != 0x40 || (flags & 0x06) != 0)
+    {
+        return false;
+    }
+
+    // Sequence 1..15, 0 = not used. Duplicates and late packets are dropped.
+    uint8_t sequence = _packet[1] & 0x0F;
+    if (_active && sequence != 0 && _ddpSequence != 0)
+    {
+        uint8_t distance = (sequence - _ddpSequence + 15) % 15;
+        if (distance == 0 || distance > 7)
+        {
+            return false;
+        }
+    }
+    _ddpSequence = sequence;
+
+    // Data type: undefined or RGB, 8 bit
+    uint8_t type = (_packet[2] >> 3) & 0x07;
+    if (type > 1)
+    {
+        return false;
+    }
+
+    size_t header = (flags & 0x10) ? 14 : 10;
+    uint32_t offset = readUInt32(_packet + 4);
+    uint16_t dataLength = readUInt16(_packet + 8);
+    if (header + dataLength > length)
+    {
+        return false;
+    }
+
+    activate();
+    if (render)
+    {
+        writeChannels(offset, _packet + header, dataLength);
+        // Push flag marks the last packet of a frame
+        if (flags & 0x01)
+        {
+            show();
+        }
+    }
+    return true;
+}
+
+bool Realtime::handleE131(size_t length, bool render)
+{
+    // Synchronization packets are only 49 bytes, data packets at least 126
+    if (length < 49 || memcmp(_packet + 4, E131_ACN_ID, sizeof(E131_ACN_ID)) != 0)
+    {
+        return false;
+    }
+
+    uint32_t rootVector = readUInt32(_packet + 18);
+    uint32_t framingVector = readUInt32(_packet + 40);
+
+    // Synchronization packet
+    if (rootVector == 0x00000008 && framingVector == 0x00000001)
+    {
+        if (_e131SyncUniverse != 0 && readUInt16(_packet + 45) == _e131SyncUniverse && render && _dirty)
+        {
+            show();
+        }
+        return true;
+    }
+
+    if (length < 126 || rootVector != 0x00000004 || framingVector != 0x00000002 || _packet[117] != 0x02 || _packet[125] != 0x00)
+    {
+        return false;
+    }
+
+    uint8_t options = _packet[112];
+    // Preview data is not meant for a live output
+    if (options & 0x80)
+    {
+        return true;
+    }
+    // Stream terminated by the source
+    if (options & 0x40)
+    {
+        _lastPacket = millis() - _timeout;
+        return true;
+    }
+
+    uint16_t universe = readUInt16(_packet + 113);
+    if (universe < _universe || universe >= _universe + _universes)
+    {
+        return true;
+    }
+
+    // Per universe sequence, duplicates and late packets are dropped. A jump back of 20 or more is a restarted source.
+    uint8_t index = universe - _universe;
+    int8_t distance = _packet[111] - _e131Sequence[index];
+    if (_active && (_e131Seen & (1 << index)) && distance <= 0 && distance > -20)
+    {
+        return false;
+    }
+    _e131Sequence[index] = _packet[111];
+    _e131Seen |= 1 << index;
+
+    uint16_t channels = readUInt16(_packet + 123) - 1;
+    if ((size_t)126 + channels > length)
+    {
+        return false;
+    }
+    if (channels > REALTIME_E131_CHANNELS_PER_UNIVERSE)
+    {
+        channels = REALTIME_E131_CHANNELS_PER_UNIVERSE;
+    }
+
+    activate();
+    if (render)
+    {
+        writeChannels((uint32_t)index * REALTIME_E131_CHANNELS_PER_UNIVERSE, _packet + 126, channels);
+
+        // With a sync universe the frame is shown on the sync packet, otherwise with the last universe
+        _e131SyncUniverse = readUInt16(_packet + 109);
+        if (_e131SyncUniverse == 0 && index == _universes - 1)
+        {
+            show();
+        }
+    }
+    return true;
+}
+
+void Realtime::writeChannels(uint32_t channel, const uint8_t *data, uint32_t length)
+{
+    // Channels are RGB triplets of the pixels in rows (left to right, top to bottom), same order as the map
+    uint32_t pixel = channel / 3;
+    uint8_t component = channel % 3;
+
+    for (uint32_t i = 0; i < length; i++)
+    {
+        if (pixel >= _pixels)
+        {
+            break;
+        }
+
+        _leds[_map[pixel]].raw[component] = data[i];
+
+        if (++component == 3)
+        {
+            component = 0;
+            pixel++;
+        }
+    }
+    _dirty = true;
+}
+
+void Realtime::show()
+{
+    _matrix->show();
+    _dirty = false;
+    _frames++;
+}
+
+void Realtime::activate()
+{
+    _lastPacket = millis();
+    if (!_active)
+    {
+        _active = true;
+        _ddpSequence = 0;
+        _e131Seen = 0;
+        if (callbackFunction != nullptr)
+        {
+            callbackFunction(true);
+        }
+    }
+}
@@ -0,0 +1,203 @@
+#include "Rules.h"
+#include <Arduino.h>
+
+RuleEngine::RuleEngine()
+{
+}
+
+void RuleEngine::begin()
+{
+    callbackFunction = nullptr;
+    _minuteOfDay = -1;
+    clear();
+}
+
+void RuleEngine::setCallback(void (*func)(const RuleAction &))
+{
+    callbackFunction = func;
+}
+
+void RuleEngine::clear()
+{
+    _count = 0;
+    for (uint8_t i = 0; i < RuleSource_Count; i++)
+    {
+        _first[i] = -1;
+    }
+}
+
+int RuleEngine::add(const Rule &rule)
+{
+    if (_count >= RULES_MAX || rule.source >= RuleSource_Count)
+    {
+        return -1;
+    }
+
+    uint8_t index = _count++;
+    _rules[index] = rule;
+    _armed[index] = true;
+
+    // Append to the chain of the source, keeps the configured order
+    _next[index] = -1;
+    if (_first[rule.source] == -1)
+    {
+        _first[rule.source] = index;
+    }
+    else
+    {
+        int8_t last = _first[rule.source];
+        while (_next[last] != -1)
+        {
+            last = _next[last];
+        }
+        _next[last] = index;
+    }
+
+    return index;
+}
+
+uint8_t RuleEngine::count() const
+{
+    return _count;
+}
+
+const Rule &RuleEngine::rule(uint8_t index) const
+{
+    return _rules[index];
+}
+
+bool RuleEngine::hasRules(RuleSource source) const
+{
+    return _first[source] != -1;
+}
+
+bool RuleEngine::hasButtonRules(uint8_t button, btnEvents event) const
+{
+    if (button >= RULES_BUTTONS)
+    {
+        return false;
+    }
+
+    for (int8_t i = _first[RuleSource_Button0 + button]; i != -1; i = _next[i])
+    {
+        if (_rules[i].buttonEvent == event)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void RuleEngine::buttonEvent(uint8_t button, btnEvents event)
+{
+    if (button >= RULES_BUTTONS)
+    {
+        return;
+    }
+
+    for (int8_t i = _first[RuleSource_Button0 + button]; i != -1; i = _next[i])
+    {
+        if (_rules[i].buttonEvent == event && inTimeWindow(_rules[i]))
+        {
+            fire(i);
+        }
+    }
+}
+
+void RuleEngine::sensorValue(RuleSource source, float value)
+{
+    if (isnan(value))
+    {
+        return;
+    }
+
+    for (int8_t i = _first[source]; i != -1; i = _next[i])
+    {
+        const Rule &rule = _rules[i];
+        bool beyond = rule.compare == RuleCompare_Above ? value > rule.threshold : value < rule.threshold;
+
+        if (beyond)
+        {
+            // Only fire on crossing the threshold, not on every reading
+            if (_armed[i] && inTimeWindow(rule))
+            {
+                _armed[i] = false;
+                fire(i);
+            }
+        }
+        else
+        {
+            bool rearm = rule.compare == RuleCompare_Above ? value <= rule.threshold - rule.hysteresis : value >= rule.threshold + rule.hysteresis;
+            if (rearm)
+            {
+                _armed[i] = true;
+            }
+        }
+    }
+}
+
+void RuleEngine::timeTick(int16_t minuteOfDay)
+{
+    if (minuteOfDay == _minuteOfDay)
+    {
+        return;
+    }
+    _minuteOfDay = minuteOfDay;
+
+    for (int8_t i = _first[RuleSource_Time]; i != -1; i = _next[i])
+    {
+        const Rule &rule = _rules[i];
+        if (rule.fromMinute < 0)
+        {
+            // Without a time the rule fires every minute
+            if (_minuteOfDay >= 0)
+            {
+                fire(i);
+            }
+            continue;
+        }
+
+        // Time rules fire once when entering their window, without an end once a day at the start
+        bool inside = rule.toMinute < 0 || rule.toMinute == rule.fromMinute ? _minuteOfDay == rule.fromMinute : inTimeWindow(rule);
+        if (inside)
+        {
+            if (_armed[i])
+            {
+                _armed[i] = false;
+                fire(i);
+            }
+        }
+        else
+        {
+            _armed[i] = true;
+        }
+    }
+}
+
+bool RuleEngine::inTimeWindow(const Rule &rule) const
+{
+    if (rule.fromMinute < 0 || rule.toMinute < 0 || rule.fromMinute == rule.toMinute)
+    {
+        return true;
+    }
+    // No valid time, windowed rules stay silent
+    if (_minuteOfDay < 0)
+    {
+        return false;
+    }
+
+    if (rule.fromMinute < rule.toMinute)
+    {
+        return _minuteOfDay >= rule.fromMinute && _minuteOfDay < rule.toMinute;
+    }
+    // Window wraps around midnight
+    return _minuteOfDay >= rule.fromMinute || _minuteOfDay < rule.toMinute;
+}
+
+void RuleEngine::fire(uint8_t index)
+{
+    if (callbackFunction != nullptr && _rules[index].action.type != RuleActionType_None)
+    {
+        callbackFunction(_rules[index].action);
+    }
+}
@@ -0,0 +1,229 @@
+#include "SensorHistory.h"
+
+#define SENSORHISTORY_RECORD_LENGHT (1 + SensorField_Count * 5)
+
+static const char *const sensorFieldNames[] = {"temperature", "humidity", "pressure", "gas", "battery", "lux"};
+static const char *const sensorResolutionNames[] = {"1m", "15m", "1h"};
+// Samples of the finer resolution per sample
+static const uint8_t sensorResolutionRatios[] = {1, 15, 4};
+
+SensorHistory::SensorHistory()
+{
+}
+
+void SensorHistory::begin()
+{
+    initSeries(_series[SensorResolution_Minute], _minuteData, SENSORHISTORY_MINUTE_LENGHT, SENSORHISTORY_MINUTE_SAMPLES);
+    initSeries(_series[SensorResolution_Quarter], _quarterData, SENSORHISTORY_QUARTER_LENGHT, SENSORHISTORY_QUARTER_SAMPLES);
+    initSeries(_series[SensorResolution_Hour], _hourData, SENSORHISTORY_HOUR_LENGHT, SENSORHISTORY_HOUR_SAMPLES);
+    memset(_fields, 0, sizeof(_fields));
+}
+
+void SensorHistory::initSeries(SensorSeries &series, uint8_t *data, uint16_t size, uint16_t maxSamples)
+{
+    memset(&series, 0, sizeof(series));
+    series.data = data;
+    series.size = size;
+    series.maxSamples = maxSamples;
+    series.closedMillis = millis();
+}
+
+void SensorHistory::add(SensorField field, float value)
+{
+    if (isnan(value))
+    {
+        return;
+    }
+    SensorSeries &series = _series[SensorResolution_Minute];
+    series.sum[field] += (int32_t)roundf(value * SENSORHISTORY_SCALE);
+    series.sumCount[field]++;
+}
+
+void SensorHistory::loop()
+{
+    if (millis() - _series[SensorResolution_Minute].closedMillis >= SENSORHISTORY_MINUTE_INTERVAL)
+    {
+        close(SensorResolution_Minute);
+    }
+}
+
+void SensorHistory::close(uint8_t resolution)
+{
+    SensorSeries &series = _series[resolution];
+    int32_t values[SensorField_Count];
+    uint8_t mask = 0;
+
+    for (uint8_t i = 0; i < SensorField_Count; i++)
+    {
+        if (series.sumCount[i] > 0)
+        {
+            values[i] = series.sum[i] / series.sumCount[i];
+            mask |= 1 << i;
+        }
+        series.sum[i] = 0;
+        series.sumCount[i] = 0;
+    }
+
+    append(series, mask, values);
+    _fields[resolution] |= mask;
+    series.periods = 0;
+    series.closedMillis = millis();
+
+    if (resolution + 1 < SensorResolution_Count)
+    {
+        SensorSeries &next = _series[resolution + 1];
+        for (uint8_t i = 0; i < SensorField_Count; i++)
+        {
+            if (mask & (1 << i))
+            {
+                next.sum[i] += values[i];
+                next.sumCount[i]++;
+            }
+        }
+        if (++next.periods >= sensorResolutionRatios[resolution + 1])
+        {
+            close(resolution + 1);
+        }
+    }
+}
+
+void SensorHistory::append(SensorSeries &series, uint8_t mask, const int32_t *values)
+{
+    while (series.samples > 0 && (series.samples >= series.maxSamples || series.length + SENSORHISTORY_RECORD_LENGHT > series.size))
+    {
+        dropOldest(series);
+    }
+
+    uint8_t *p = series.data + series.length;
+    *p++ = mask;
+    for (uint8_t i = 0; i < SensorField_Count; i++)
+    {
+        if (!(mask & (1 << i)))
+        {
+            continue;
+        }
+        int32_t delta = values[i] - series.last[i];
+        series.last[i] = values[i];
+        // Zigzag, small positive and negative deltas both become small numbers
+        uint32_t zigzag = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+        while (zigzag >= 0x80)
+        {
+            *p++ = (zigzag & 0x7F) | 0x80;
+            zigzag >>= 7;
+        }
+        *p++ = zigzag;
+    }
+    series.length = p - series.data;
+    series.samples++;
+}
+
+void SensorHistory::dropOldest(SensorSeries &series)
+{
+    uint8_t mask;
+    uint16_t length = decode(series.data, series.base, mask);
+    memmove(series.data, series.data + length, series.length - length);
+    series.length -= length;
+    series.samples--;
+}
+
+uint16_t SensorHistory::decode(const uint8_t *data, int32_t *values, uint8_t &mask)
+{
+    const uint8_t *p = data;
+    mask = *p++;
+    for (uint8_t i = 0; i < SensorField_Count; i++)
+    {
+        if (!(mask & (1 << i)))
+        {
+            continue;
+        }
+        uint32_t zigzag = 0;
+        uint8_t shift = 0;
+        do
+        {
+            zigzag |= (uint32_t)(*p & 0x7F) << shift;
+            shift += 7;
+        } while (*p++ & 0x80);
+        values[i] += (int32_t)((zigzag >> 1) ^ (0 - (zigzag & 1)));
+    }
+    return p - data;
+}
+
+uint16_t SensorHistory::samples(SensorResolution resolution) const
+{
+    return _series[resolution].samples;
+}
+
+uint32_t SensorHistory::interval(SensorResolution resolution) const
+{
+    uint32_t result = SENSORHISTORY_MINUTE_INTERVAL / 1000;
+    for (uint8_t i = 1; i <= resolution; i++)
+    {
+        result *= sensorResolutionRatios[i];
+    }
+    return result;
+}
+
+uint32_t SensorHistory::age(SensorResolution resolution) const
+{
+    return millis() - _series[resolution].closedMillis;
+}
+
+bool SensorHistory::hasField(SensorResolution resolution, SensorField field) const
+{
+    return _fields[resolution] & (1 << field);
+}
+
+uint16_t SensorHistory::values(SensorResolution resolution, SensorField field, int32_t *target, uint16_t maxCount) const
+{
+    const SensorSeries &series = _series[resolution];
+    uint16_t skip = series.samples > maxCount ? series.samples - maxCount : 0;
+    int32_t values[SensorField_Count];
+    memcpy(values, series.base, sizeof(values));
+
+    const uint8_t *p = series.data;
+    uint16_t count = 0;
+    for (uint16_t i = 0; i < series.samples; i++)
+    {
+        uint8_t mask;
+        p += decode(p, values, mask);
+        if (i >= skip)
+        {
+            target[count++] = (mask & (1 << field)) ? values[field] : SENSORHISTORY_MISSING;
+        }
+    }
+    return count;
+}
+
+const char *SensorHistory::fieldName(SensorField field)
+{
+    return sensorFieldNames[field];
+}
+
+int8_t SensorHistory::fieldFromName(const char *name)
+{
+    for (uint8_t i = 0; i < SensorField_Count; i++)
+    {
+        if (strcmp(name, sensorFieldNames[i]) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+const char *SensorHistory::resolutionName(SensorResolution resolution)
+{
+    return sensorResolutionNames[resolution];
+}
+
+int8_t SensorHistory::resolutionFromName(const char *name)
+{
+    for (uint8_t i = 0; i < SensorResolution_Count; i++)
+    {
+        if (strcmp(name, sensorResolutionNames[i]) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
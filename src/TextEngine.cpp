@@ -0,0 +1,286 @@
+#include "TextEngine.h"
+
+uint32_t Utf8Decode(const char *&text)
+{
+    const uint8_t *s = (const uint8_t *)text;
+    uint8_t lead = s[0];
+    if (lead == 0)
+    {
+        return 0;
+    }
+    if (lead < 0x80)
+    {
+        text++;
+        return lead;
+    }
+
+    uint8_t length;
+    uint32_t codePoint;
+    uint32_t minimum;
+    if (lead >= 0xC2 && lead <= 0xDF)
+    {
+        length = 2;
+        codePoint = lead & 0x1F;
+        minimum = 0x80;
+    }
+    else if (lead >= 0xE0 && lead <= 0xEF)
+    {
+        length = 3;
+        codePoint = lead & 0x0F;
+        minimum = 0x800;
+    }
+    else if (lead >= 0xF0 && lead <= 0xF4)
+    {
+        length = 4;
+        codePoint = lead & 0x07;
+        minimum = 0x10000;
+    }
+    else
+    {
+        text++;
+        return 0xFFFD;
+    }
+
+    for (uint8_t i = 1; i < length; i++)
+    {
+        // Also stops at the terminating 0
+        if ((s[i] & 0xC0) != 0x80)
+        {
+            text++;
+            return 0xFFFD;
+        }
+        codePoint = (codePoint << 6) | (s[i] & 0x3F);
+    }
+
+    // Overlong forms, surrogates and beyond U+10FFFF
+    if (codePoint < minimum || (codePoint >= 0xD800 && codePoint <= 0xDFFF) || codePoint > 0x10FFFF)
+    {
+        text++;
+        return 0xFFFD;
+    }
+
+    text += length;
+    return codePoint;
+}
+
+// Symbols of the classic font behind Latin-1, slot 0xDE onwards
+static const uint32_t classicSymbols[] PROGMEM = {
+    0x20AC,  // Euro €
+    0x2190,  // Arrow left ←
+    0x2191,  // Arrow up ↑
+    0x2192,  // Arrow right →
+    0x2193,  // Arrow down ↓
+    0x2605,  // Star ★
+    0x1F4C4, // File 📄
+    0x2665,  // Heart ♥
+    0x21A7,  // Download ↧
+    0x1F697, // Car 🚗
+    0x1F600, // Smiley 😀
+    0x1F4C1, // Folder 📁
+};
+
+String Utf8ToAscii(const String &text)
+{
+    String result;
+    result.reserve(text.length());
+    const char *s = text.c_str();
+    uint32_t codePoint;
+    while ((codePoint = Utf8Decode(s)) != 0)
+    {
+        if (codePoint < 0x80)
+        {
+            result += (char)codePoint;
+            continue;
+        }
+        if (codePoint == 0xA0)
+        {
+            result += ' ';
+            continue;
+        }
+        // Latin-1 Supplement U+00A1..U+00FF is stored from slot 0x7F on
+        if (codePoint >= 0xA1 && codePoint <= 0xFF)
+        {
+            result += (char)(codePoint - 34);
+            continue;
+        }
+
+        char c = '?';
+        for (uint8_t i = 0; i < sizeof(classicSymbols) / sizeof(classicSymbols[0]); i++)
+        {
+            if (pgm_read_dword(&classicSymbols[i]) == codePoint)
+            {
+                c = (char)(0xDE + i);
+                break;
+            }
+        }
+        result += c;
+    }
+    return result;
+}
+
+// Variation selectors and joiners of emoji sequences have no width
+static inline bool IsZeroWidth(uint32_t codePoint)
+{
+    return (codePoint >= 0xFE00 && codePoint <= 0xFE0F) || codePoint == 0x200D;
+}
+
+TextEngine::TextEngine()
+{
+}
+
+void TextEngine::begin(Blitter *blitter)
+{
+    _blitter = blitter;
+}
+
+void TextEngine::setFont(const GlyphFont *font)
+{
+    _font = font;
+    _range = 0;
+}
+
+void TextEngine::setColor(uint16_t color)
+{
+    _color = _blitter->color(color);
+}
+
+bool TextEngine::lookup(uint32_t codePoint, Glyph &glyph)
+{
+    // Text mostly stays in one range (ASCII), try the last one first
+    GlyphRange range;
+    memcpy_P(&range, &_font->ranges[_range], sizeof(GlyphRange));
+    if (codePoint >= range.first && codePoint < range.first + range.count)
+    {
+        memcpy_P(&glyph, &_font->glyphs[range.glyph + (codePoint - range.first)], sizeof(Glyph));
+        return true;
+    }
+
+    uint16_t low = 0;
+    uint16_t high = _font->rangeCount;
+    while (low < high)
+    {
+        uint16_t middle = (low + high) / 2;
+        memcpy_P(&range, &_font->ranges[middle], sizeof(GlyphRange));
+        if (codePoint < range.first)
+        {
+            high = middle;
+        }
+        else if (codePoint >= range.first + range.count)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            _range = middle;
+            memcpy_P(&glyph, &_font->glyphs[range.glyph + (codePoint - range.first)], sizeof(Glyph));
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TextEngine::findGlyph(uint32_t codePoint, Glyph &glyph)
+{
+    if (IsZeroWidth(codePoint))
+    {
+        return false;
+    }
+    // No-break space, as Utf8ToAscii() maps it
+    if (codePoint == 0xA0)
+    {
+        codePoint = ' ';
+    }
+    return lookup(codePoint, glyph) || lookup(0xFFFD, glyph);
+}
+
+uint16_t TextEngine::textWidth(const char *text)
+{
+    uint16_t width = 0;
+    uint32_t codePoint;
+    Glyph glyph;
+    while ((codePoint = Utf8Decode(text)) != 0)
+    {
+        if (findGlyph(codePoint, glyph))
+        {
+            width += glyph.xAdvance;
+        }
+    }
+    return width;
+}
+
+uint8_t TextEngine::rasterize(uint32_t codePoint, uint8_t *rows, uint8_t rowCount)
+{
+    memset(rows, 0, rowCount);
+    Glyph glyph;
+    if (!lookup(codePoint, glyph))
+    {
+        return 0;
+    }
+
+    const uint8_t *bitmap = _font->bitmaps + glyph.offset;
+    uint8_t bits = 0;
+    uint8_t bit = 0;
+    for (uint8_t j = 0; j < glyph.height; j++)
+    {
+        int8_t row = rowCount - 1 + glyph.yOffset + j;
+        for (uint8_t i = 0; i < glyph.width; i++)
+        {
+            if ((bit & 7) == 0)
+            {
+                bits = pgm_read_byte(bitmap++);
+            }
+            int8_t column = glyph.xOffset + i;
+            if ((bits & 0x80) && row >= 0 && row < rowCount && column >= 0 && column < 8)
+            {
+                rows[row] |= 0x80 >> column;
+            }
+            bits <<= 1;
+            bit++;
+        }
+    }
+    return glyph.xAdvance;
+}
+
+int16_t TextEngine::drawText(int16_t x, int16_t y, const char *text)
+{
+    uint32_t codePoint;
+    Glyph glyph;
+    while ((codePoint = Utf8Decode(text)) != 0)
+    {
+        if (!findGlyph(codePoint, glyph))
+        {
+            continue;
+        }
+        // Scrolling text is mostly outside the matrix, only visible glyphs are drawn
+        int16_t left = x + glyph.xOffset;
+        if (glyph.width > 0 && left < Geometry::width && left + glyph.width > 0)
+        {
+            drawGlyph(x, y, glyph);
+        }
+        x += glyph.xAdvance;
+    }
+    return x;
+}
+
+void TextEngine::drawGlyph(int16_t x, int16_t y, const Glyph &glyph)
+{
+    const uint8_t *bitmap = _font->bitmaps + glyph.offset;
+    uint8_t bits = 0;
+    uint8_t bit = 0;
+    for (uint8_t j = 0; j < glyph.height; j++)
+    {
+        for (uint8_t i = 0; i < glyph.width; i++)
+        {
+            if ((bit & 7) == 0)
+            {
+                bits = pgm_read_byte(bitmap++);
+            }
+            if (bits & 0x80)
+            {
+                _blitter->drawPixel(x + glyph.xOffset + i, y + glyph.yOffset + j, _color);
+            }
+            bits <<= 1;
+            bit++;
+        }
+    }
+}
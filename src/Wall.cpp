@@ -0,0 +1,266 @@
+#include "Wall.h"
+#include <Arduino.h>
+#if defined(ESP8266)
+#include <ESP8266WiFi.h>
+#elif defined(ESP32)
+#include <WiFi.h>
+#endif
+
+static void writeUInt32(uint8_t *data, uint32_t value)
+{
+    data[0] = value >> 24;
+    data[1] = value >> 16;
+    data[2] = value >> 8;
+    data[3] = value;
+}
+
+static uint32_t readUInt32(const uint8_t *data)
+{
+    return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | data[3];
+}
+
+Wall::Wall()
+{
+}
+
+void Wall::begin(WallRole role, uint8_t group)
+{
+    _role = role;
+    _group = group;
+    _synced = role == WallRole_Leader;
+    _offset = 0;
+    _targetOffset = 0;
+    _lastSlew = millis();
+    _windowMax = INT32_MIN;
+    _windowSamples = 0;
+    _lastSync = 0;
+    _lastContent = 0;
+    _contentId = 0;
+    _contentLength = 0;
+    callbackFunction = nullptr;
+
+    if (_role == WallRole_Off)
+    {
+        return;
+    }
+
+    bind();
+}
+
+void Wall::bind()
+{
+    // The group membership belongs to the interface address, it is lost on a reconnect or a new address
+    _address = WiFi.localIP();
+    IPAddress multicast(WALL_MULTICAST_ADDRESS);
+#if defined(ESP8266)
+    _udp.beginMulticast(_address, multicast, WALL_PORT);
+#elif defined(ESP32)
+    _udp.beginMulticast(multicast, WALL_PORT);
+#endif
+}
+
+void Wall::setCallback(void (*func)(const char *, uint32_t))
+{
+    callbackFunction = func;
+}
+
+void Wall::loop()
+{
+    if (_role == WallRole_Off)
+    {
+        return;
+    }
+
+    if (WiFi.localIP() != _address)
+    {
+        bind();
+    }
+
+    if (_role == WallRole_Member)
+    {
+        receive();
+        slew();
+        return;
+    }
+
+    // Leader, own packets may come back through the multicast loopback
+    while (_udp.parsePacket() > 0)
+    {
+        _udp.flush();
+    }
+
+    if (millis() - _lastSync >= WALL_SYNC_INTERVAL)
+    {
+        _lastSync = millis();
+        send(false);
+    }
+    // Repeat the screen for members that (re)joined late
+    if (_contentId != 0 && millis() - _lastContent >= WALL_CONTENT_INTERVAL)
+    {
+        _lastContent = millis();
+        send(true);
+    }
+}
+
+bool Wall::publish(const char *content)
+{
+    size_t length = strlen(content);
+    if (_role != WallRole_Leader || length > WALL_CONTENT_LENGHT)
+    {
+        return false;
+    }
+
+    // Start a bit in the future, so every member has the screen before its first frame
+    _contentId = _contentId == 0xFFFF ? 1 : _contentId + 1;
+    _contentStart = time() + WALL_START_DELAY;
+    _contentLength = length;
+    memcpy(_packet + WALL_HEADER_LENGHT, content, length);
+
+    _lastContent = millis();
+    send(true);
+
+    if (callbackFunction != nullptr)
+    {
+        callbackFunction(content, _contentStart);
+    }
+    return true;
+}
+
+uint32_t Wall::time() const
+{
+    return millis() + _offset;
+}
+
+bool Wall::isSynced() const
+{
+    return _synced;
+}
+
+int32_t Wall::offset() const
+{
+    return _offset;
+}
+
+WallRole Wall::role() const
+{
+    return _role;
+}
+
+void Wall::send(bool content)
+{
+    _packet[0] = 'P';
+    _packet[1] = 'X';
+    _packet[2] = 'W';
+    _packet[3] = 1;
+    _packet[4] = content ? 'C' : 'S';
+    _packet[5] = _group;
+    writeUInt32(_packet + 6, time());
+
+    size_t length = 10;
+    if (content)
+    {
+        _packet[10] = _contentId >> 8;
+        _packet[11] = _contentId;
+        writeUInt32(_packet + 12, _contentStart);
+        _packet[16] = _contentLength >> 8;
+        _packet[17] = _contentLength;
+        length = WALL_HEADER_LENGHT + _contentLength;
+    }
+
+    IPAddress multicast(WALL_MULTICAST_ADDRESS);
+#if defined(ESP8266)
+    _udp.beginPacketMulticast(multicast, WALL_PORT, WiFi.localIP());
+#elif defined(ESP32)
+    _udp.beginMulticastPacket();
+#endif
+    _udp.write(_packet, length);
+    _udp.endPacket();
+}
+
+void Wall::receive()
+{
+    while (true)
+    {
+        int size = _udp.parsePacket();
+        if (size <= 0)
+        {
+            return;
+        }
+
+        // One byte is kept free for the null terminator of the screen
+        size_t length = _udp.read(_packet, sizeof(_packet) - 1);
+        if (length < 10 || memcmp(_packet, "PXW\x01", 4) != 0 || _packet[5] != _group)
+        {
+            continue;
+        }
+
+        sample(readUInt32(_packet + 6));
+
+        if (_packet[4] != 'C' || length < WALL_HEADER_LENGHT)
+        {
+            continue;
+        }
+
+        uint16_t id = (_packet[10] << 8) | _packet[11];
+        uint16_t contentLength = (_packet[16] << 8) | _packet[17];
+        if (id == _contentId || (size_t)WALL_HEADER_LENGHT + contentLength > length)
+        {
+            continue;
+        }
+
+        _contentId = id;
+        _contentStart = readUInt32(_packet + 12);
+        _packet[WALL_HEADER_LENGHT + contentLength] = '\0';
+        if (callbackFunction != nullptr)
+        {
+            callbackFunction(reinterpret_cast<const char *>(_packet + WALL_HEADER_LENGHT), _contentStart);
+        }
+    }
+}
+
+void Wall::sample(uint32_t leaderTime)
+{
+    // leaderTime - local time = real offset - network delay. The largest value of a
+    // window has the shortest delay and is the best estimate.
+    int32_t offset = (int32_t)(leaderTime - millis());
+    if (offset > _windowMax)
+    {
+        _windowMax = offset;
+    }
+
+    if (!_synced)
+    {
+        _offset = offset;
+        _targetOffset = offset;
+        _synced = true;
+    }
+
+    if (++_windowSamples >= WALL_SYNC_WINDOW)
+    {
+        _targetOffset = _windowMax;
+        _windowMax = INT32_MIN;
+        _windowSamples = 0;
+
+        if (abs(_targetOffset - _offset) > WALL_STEP_LIMIT)
+        {
+            _offset = _targetOffset;
+        }
+    }
+}
+
+void Wall::slew()
+{
+    // 1 ms per WALL_SLEW_INTERVAL, slower than the clock, so the wall time still moves forward
+    while (millis() - _lastSlew >= WALL_SLEW_INTERVAL)
+    {
+        _lastSlew += WALL_SLEW_INTERVAL;
+        if (_offset < _targetOffset)
+        {
+            _offset++;
+        }
+        else if (_offset > _targetOffset)
+        {
+            _offset--;
+        }
+    }
+}
@@ -0,0 +1,210 @@
+#ifndef HOST_ADAFRUIT_GFX_H_
+#define HOST_ADAFRUIT_GFX_H_
+
+#include <Arduino.h>
+
+// GFX fonts (gfxfont.h of the library)
+struct GFXglyph
+{
+    uint16_t bitmapOffset;
+    uint8_t width;
+    uint8_t height;
+    uint8_t xAdvance;
+    int8_t xOffset;
+    int8_t yOffset;
+};
+
+struct GFXfont
+{
+    uint8_t *bitmap;
+    GFXglyph *glyph;
+    uint16_t first;
+    uint16_t last;
+    uint8_t yAdvance;
+};
+
+// Drawing base class, only the primitives the firmware modules reach. Text with GFX fonts
+// takes the per glyph, per pixel path of the library (text size 1), the classic font is not drawn.
+class Adafruit_GFX : public Print
+{
+public:
+    Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h), _width(w), _height(h), rotation(0) {}
+    virtual ~Adafruit_GFX() {}
+
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+    virtual void startWrite() {}
+    virtual void writePixel(int16_t x, int16_t y, uint16_t color)
+    {
+        drawPixel(x, y, color);
+    }
+    virtual void endWrite() {}
+    virtual void fillScreen(uint16_t color)
+    {
+        fillRect(0, 0, _width, _height, color);
+    }
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+    {
+        for (int16_t j = y; j < y + h; j++)
+        {
+            for (int16_t i = x; i < x + w; i++)
+            {
+                drawPixel(i, j, color);
+            }
+        }
+    }
+    void drawRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h)
+    {
+        startWrite();
+        for (int16_t j = 0; j < h; j++, y++)
+        {
+            for (int16_t i = 0; i < w; i++)
+            {
+                writePixel(x + i, y, bitmap[j * w + i]);
+            }
+        }
+        endWrite();
+    }
+    void setRotation(uint8_t r) { rotation = r & 3; }
+
+    void setFont(const GFXfont *f) { gfxFont = f; }
+    void setCursor(int16_t x, int16_t y)
+    {
+        cursor_x = x;
+        cursor_y = y;
+    }
+    void setTextColor(uint16_t c) { textcolor = c; }
+    void setTextWrap(bool w) { wrap = w; }
+    int16_t getCursorX() const { return cursor_x; }
+
+    void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color)
+    {
+        c -= (uint8_t)pgm_read_byte(&gfxFont->first);
+        const GFXglyph *glyph = gfxFont->glyph + c;
+        const uint8_t *bitmap = gfxFont->bitmap;
+        uint16_t bo = pgm_read_word(&glyph->bitmapOffset);
+        uint8_t w = pgm_read_byte(&glyph->width), h = pgm_read_byte(&glyph->height);
+        int8_t xo = pgm_read_byte(&glyph->xOffset), yo = pgm_read_byte(&glyph->yOffset);
+        uint8_t bits = 0, bit = 0;
+
+        startWrite();
+        for (uint8_t yy = 0; yy < h; yy++)
+        {
+            for (uint8_t xx = 0; xx < w; xx++)
+            {
+                if (!(bit++ & 7))
+                {
+                    bits = pgm_read_byte(&bitmap[bo++]);
+                }
+                if (bits & 0x80)
+                {
+                    writePixel(x + xo + xx, y + yo + yy, color);
+                }
+                bits <<= 1;
+            }
+        }
+        endWrite();
+    }
+
+    size_t write(uint8_t c) override
+    {
+        if (gfxFont == nullptr || c == '\r')
+        {
+            return 1;
+        }
+        if (c == '\n')
+        {
+            cursor_x = 0;
+            cursor_y += (uint8_t)pgm_read_byte(&gfxFont->yAdvance);
+            return 1;
+        }
+        uint8_t first = pgm_read_byte(&gfxFont->first);
+        if (c >= first && c <= (uint8_t)pgm_read_byte(&gfxFont->last))
+        {
+            const GFXglyph *glyph = gfxFont->glyph + (c - first);
+            uint8_t w = pgm_read_byte(&glyph->width), h = pgm_read_byte(&glyph->height);
+            if (w > 0 && h > 0)
+            {
+                int16_t xo = (int8_t)pgm_read_byte(&glyph->xOffset);
+                if (wrap && cursor_x + xo + w > _width)
+                {
+                    cursor_x = 0;
+                    cursor_y += (uint8_t)pgm_read_byte(&gfxFont->yAdvance);
+                }
+                drawChar(cursor_x, cursor_y, c, textcolor);
+            }
+            cursor_x += (uint8_t)pgm_read_byte(&glyph->xAdvance);
+        }
+        return 1;
+    }
+
+    void getTextBounds(const String &str, int16_t x, int16_t y, int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h)
+    {
+        *x1 = x;
+        *y1 = y;
+        *w = *h = 0;
+        int16_t minx = _width, miny = _height, maxx = -1, maxy = -1;
+        for (size_t i = 0; i < str.length(); i++)
+        {
+            charBounds(str[i], &x, &y, &minx, &miny, &maxx, &maxy);
+        }
+        if (maxx >= minx)
+        {
+            *x1 = minx;
+            *w = maxx - minx + 1;
+        }
+        if (maxy >= miny)
+        {
+            *y1 = miny;
+            *h = maxy - miny + 1;
+        }
+    }
+
+    int16_t width() const { return _width; }
+    int16_t height() const { return _height; }
+
+protected:
+    void charBounds(unsigned char c, int16_t *x, int16_t *y, int16_t *minx, int16_t *miny, int16_t *maxx, int16_t *maxy)
+    {
+        if (gfxFont == nullptr || c == '\r')
+        {
+            return;
+        }
+        if (c == '\n')
+        {
+            *x = 0;
+            *y += (uint8_t)pgm_read_byte(&gfxFont->yAdvance);
+            return;
+        }
+        uint8_t first = pgm_read_byte(&gfxFont->first);
+        if (c >= first && c <= (uint8_t)pgm_read_byte(&gfxFont->last))
+        {
+            const GFXglyph *glyph = gfxFont->glyph + (c - first);
+            uint8_t gw = pgm_read_byte(&glyph->width), gh = pgm_read_byte(&glyph->height), xa = pgm_read_byte(&glyph->xAdvance);
+            int8_t xo = pgm_read_byte(&glyph->xOffset), yo = pgm_read_byte(&glyph->yOffset);
+            if (wrap && *x + xo + gw > _width)
+            {
+                *x = 0;
+                *y += (uint8_t)pgm_read_byte(&gfxFont->yAdvance);
+            }
+            int16_t x1 = *x + xo, y1 = *y + yo, x2 = x1 + gw - 1, y2 = y1 + gh - 1;
+            *minx = x1 < *minx ? x1 : *minx;
+            *miny = y1 < *miny ? y1 : *miny;
+            *maxx = x2 > *maxx ? x2 : *maxx;
+            *maxy = y2 > *maxy ? y2 : *maxy;
+            *x += xa;
+        }
+    }
+
+    const int16_t WIDTH;
+    const int16_t HEIGHT;
+    int16_t _width;
+    int16_t _height;
+    uint8_t rotation;
+    const GFXfont *gfxFont = nullptr;
+    int16_t cursor_x = 0;
+    int16_t cursor_y = 0;
+    uint16_t textcolor = 0xFFFF;
+    bool wrap = true;
+};
+
+#endif
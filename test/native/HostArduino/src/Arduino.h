@@ -0,0 +1,129 @@
+#ifndef HOST_ARDUINO_H_
+#define HOST_ARDUINO_H_
+
+// Arduino core for the host tests (pio test -e native). Time, pins and the heap are simulated,
+// see Host.h for the test side.
+
+#include <math.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <algorithm>
+#include <string>
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+using std::max;
+using std::min;
+
+// Flash is ordinary memory on the host
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(text) (text)
+#define F(text) (reinterpret_cast<const __FlashStringHelper *>(PSTR(text)))
+#define FPSTR(pointer) (reinterpret_cast<const __FlashStringHelper *>(pointer))
+#define pgm_read_byte(address) (*(const uint8_t *)(address))
+#define pgm_read_word(address) (*(const uint16_t *)(address))
+#define pgm_read_dword(address) (*(const uint32_t *)(address))
+#define pgm_read_ptr(address) (*(const void *const *)(address))
+#define pgm_read_float(address) (*(const float *)(address))
+#define memcpy_P memcpy
+#define memcmp_P memcmp
+#define strlen_P strlen
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define strcmp_P strcmp
+#define strncmp_P strncmp
+#define strcasecmp_P strcasecmp
+#define sprintf_P sprintf
+#define snprintf_P snprintf
+
+#define IRAM_ATTR
+#define ICACHE_RAM_ATTR
+#define ICACHE_FLASH_ATTR
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+#define NOT_AN_INTERRUPT -1
+
+#ifndef F_CPU
+#define F_CPU 80000000L
+#endif
+
+// Virtual clock, only moves when a test advances it (or delay() is called)
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t value);
+int analogRead(uint8_t pin);
+int digitalPinToInterrupt(uint8_t pin);
+void attachInterrupt(int interrupt, void (*isr)(), int mode);
+void detachInterrupt(int interrupt);
+inline void interrupts() {}
+inline void noInterrupts() {}
+
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+
+inline long map(long x, long inMin, long inMax, long outMin, long outMax)
+{
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+template <typename T, typename L, typename H>
+inline T constrain(T x, L low, H high)
+{
+    return x < low ? low : (x > high ? high : x);
+}
+
+class HardwareSerial : public Stream
+{
+public:
+    void begin(unsigned long baud) {}
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+    int available() override { return 0; }
+    int read() override { return -1; }
+};
+extern HardwareSerial Serial;
+
+class EspClass
+{
+public:
+    uint32_t getFreeHeap();
+    uint32_t getMaxFreeBlockSize();
+    uint8_t getHeapFragmentation();
+    void getHeapStats(uint32_t *free = nullptr, uint16_t *max = nullptr, uint8_t *fragmentation = nullptr);
+    uint8_t getCpuFreqMHz();
+    uint32_t getFreeSketchSpace() { return 1024 * 1024; }
+    uint32_t getSketchSize() { return 512 * 1024; }
+    uint32_t getChipId() { return 0x123456; }
+    void restart();
+};
+extern EspClass ESP;
+
+#include "Host.h"
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef HOST_ESP8266WIFI_H_
+#define HOST_ESP8266WIFI_H_
+
+#include <Arduino.h>
+#include "IPAddress.h"
+#include "WiFiClient.h"
+#include "WiFiUdp.h"
+
+typedef enum
+{
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6,
+} wl_status_t;
+
+typedef enum
+{
+    WIFI_NONE_SLEEP = 0,
+    WIFI_LIGHT_SLEEP = 1,
+    WIFI_MODEM_SLEEP = 2,
+} WiFiSleepType_t;
+
+// Station state, set by the test
+class ESP8266WiFiClass
+{
+public:
+    IPAddress localIP() const { return address; }
+    wl_status_t status() const { return connected ? WL_CONNECTED : WL_DISCONNECTED; }
+    bool isConnected() const { return connected; }
+    bool setSleepMode(WiFiSleepType_t type)
+    {
+        sleepMode = type;
+        return true;
+    }
+    WiFiSleepType_t getSleepMode() const { return sleepMode; }
+    int32_t RSSI() const { return -60; }
+
+    IPAddress address = IPAddress(192, 168, 1, 10);
+    bool connected = true;
+    WiFiSleepType_t sleepMode = WIFI_NONE_SLEEP;
+};
+extern ESP8266WiFiClass WiFi;
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef HOST_FS_H_
+#define HOST_FS_H_
+
+#include <Arduino.h>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace Host
+{
+    struct FileData
+    {
+        // Shared with the file system and the other handles of the same file
+        std::shared_ptr<std::string> content;
+        size_t position = 0;
+        bool open = true;
+    };
+}
+
+// File in memory. Copies share the open file like in the core, close() ends it for all of them.
+class File : public Stream
+{
+public:
+    File() {}
+    explicit File(std::shared_ptr<Host::FileData> data) : _data(data) {}
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+    int available() override;
+    int read() override;
+    size_t read(uint8_t *buffer, size_t length);
+    int peek() override;
+    size_t size() const { return isOpen() ? _data->content->size() : 0; }
+    size_t position() const { return isOpen() ? _data->position : 0; }
+    bool seek(uint32_t position);
+    void close();
+    operator bool() const { return isOpen(); }
+
+protected:
+    std::shared_ptr<Host::FileData> _data;
+
+    bool isOpen() const { return _data && _data->open; }
+};
+
+// File system in memory, behind LittleFS. Files are kept until remove(), also when closed.
+class FS
+{
+public:
+    bool begin() { return true; }
+    // "r", "w" (truncates) or "a", an empty File if "r" does not find it
+    File open(const char *path, const char *mode = "r");
+    File open(const String &path, const char *mode = "r") { return open(path.c_str(), mode); }
+    bool exists(const char *path) const;
+    bool remove(const char *path);
+
+protected:
+    std::map<std::string, std::shared_ptr<std::string>> _files;
+};
+
+namespace Host
+{
+    // Open file that is not on a file system
+    File openFile(const std::string &content);
+    // Files opened and not closed yet
+    extern int filesOpen;
+}
+
+#endif
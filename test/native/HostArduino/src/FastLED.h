@@ -0,0 +1,147 @@
+#ifndef HOST_FASTLED_H_
+#define HOST_FASTLED_H_
+
+#include <Arduino.h>
+
+// The part of FastLED the firmware modules use, same 8 bit math as the library
+
+struct CRGB
+{
+    union
+    {
+        struct
+        {
+            uint8_t r;
+            uint8_t g;
+            uint8_t b;
+        };
+        uint8_t raw[3];
+    };
+
+    CRGB() {}
+    CRGB(uint8_t red, uint8_t green, uint8_t blue) : r(red), g(green), b(blue) {}
+    CRGB(uint32_t color) : r(color >> 16), g(color >> 8), b(color) {}
+
+    enum HTMLColorCode
+    {
+        Black = 0x000000,
+        Blue = 0x0000FF,
+        Green = 0x008000,
+        Red = 0xFF0000,
+        White = 0xFFFFFF,
+        Yellow = 0xFFFF00,
+    };
+
+    CRGB &operator+=(const CRGB &other)
+    {
+        r = qadd(r, other.r);
+        g = qadd(g, other.g);
+        b = qadd(b, other.b);
+        return *this;
+    }
+    bool operator==(const CRGB &other) const { return r == other.r && g == other.g && b == other.b; }
+    bool operator!=(const CRGB &other) const { return !(*this == other); }
+    explicit operator bool() const { return r || g || b; }
+
+private:
+    static uint8_t qadd(uint8_t i, uint8_t j) { return i + j > 255 ? 255 : i + j; }
+};
+
+inline uint8_t scale8(uint8_t i, uint8_t scale)
+{
+    return ((uint16_t)i * (1 + (uint16_t)scale)) >> 8;
+}
+
+inline uint8_t qadd8(uint8_t i, uint8_t j)
+{
+    unsigned int t = i + j;
+    return t > 255 ? 255 : t;
+}
+
+inline uint8_t qsub8(uint8_t i, uint8_t j)
+{
+    return i > j ? i - j : 0;
+}
+
+extern uint16_t rand16seed;
+
+inline uint16_t random16()
+{
+    rand16seed = rand16seed * 2053 + 13849;
+    return rand16seed;
+}
+
+inline uint16_t random16(uint16_t lim)
+{
+    return ((uint32_t)random16() * lim) >> 16;
+}
+
+inline uint8_t random8()
+{
+    random16();
+    return (uint8_t)((uint8_t)rand16seed + (uint8_t)(rand16seed >> 8));
+}
+
+inline uint8_t random8(uint8_t lim)
+{
+    return (random8() * lim) >> 8;
+}
+
+inline uint8_t random8(uint8_t min, uint8_t lim)
+{
+    return random8(lim - min) + min;
+}
+
+inline void random16_set_seed(uint16_t seed)
+{
+    rand16seed = seed;
+}
+
+uint8_t sin8(uint8_t theta);
+
+typedef uint32_t TProgmemRGBPalette16[16];
+extern const TProgmemRGBPalette16 CloudColors_p, LavaColors_p, OceanColors_p, ForestColors_p, RainbowColors_p, PartyColors_p, HeatColors_p;
+
+struct CRGBPalette16
+{
+    CRGB entries[16];
+
+    CRGBPalette16() {}
+    CRGBPalette16(const TProgmemRGBPalette16 &palette)
+    {
+        for (uint8_t i = 0; i < 16; i++)
+        {
+            entries[i] = CRGB(palette[i]);
+        }
+    }
+    CRGBPalette16(const CRGB &c1, const CRGB &c2)
+    {
+        CRGB colors[] = {c1, c2};
+        gradient(colors, 2);
+    }
+    CRGBPalette16(const CRGB &c1, const CRGB &c2, const CRGB &c3)
+    {
+        CRGB colors[] = {c1, c2, c3};
+        gradient(colors, 3);
+    }
+
+private:
+    void gradient(const CRGB *colors, uint8_t count);
+};
+
+CRGB ColorFromPalette(const CRGBPalette16 &palette, uint8_t index, uint8_t brightness = 255);
+
+class CFastLED
+{
+public:
+    void show() { shows++; }
+    void setBrightness(uint8_t scale) { brightness = scale; }
+    uint8_t getBrightness() const { return brightness; }
+
+    // Test side, FastLED.show() calls so far
+    uint32_t shows = 0;
+    uint8_t brightness = 255;
+};
+extern CFastLED FastLED;
+
+#endif
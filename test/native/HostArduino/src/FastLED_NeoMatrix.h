@@ -0,0 +1,65 @@
+#ifndef HOST_FASTLED_NEOMATRIX_H_
+#define HOST_FASTLED_NEOMATRIX_H_
+
+#include <Adafruit_GFX.h>
+#include <FastLED.h>
+
+// Layout flags and the XY remap of FastLED_NeoMatrix (Framebuffer_GFX), tiles, rotation,
+// remap function and pass through color included, drawPixel() costs what the library does
+
+#define NEO_MATRIX_TOP 0x00
+#define NEO_MATRIX_BOTTOM 0x01
+#define NEO_MATRIX_LEFT 0x00
+#define NEO_MATRIX_RIGHT 0x02
+#define NEO_MATRIX_CORNER 0x03
+#define NEO_MATRIX_ROWS 0x00
+#define NEO_MATRIX_COLUMNS 0x04
+#define NEO_MATRIX_AXIS 0x04
+#define NEO_MATRIX_PROGRESSIVE 0x00
+#define NEO_MATRIX_ZIGZAG 0x08
+#define NEO_MATRIX_SEQUENCE 0x08
+
+#define NEO_TILE_TOP 0x00
+#define NEO_TILE_BOTTOM 0x10
+#define NEO_TILE_LEFT 0x00
+#define NEO_TILE_RIGHT 0x20
+#define NEO_TILE_CORNER 0x30
+#define NEO_TILE_ROWS 0x00
+#define NEO_TILE_COLUMNS 0x40
+#define NEO_TILE_AXIS 0x40
+#define NEO_TILE_PROGRESSIVE 0x00
+#define NEO_TILE_ZIGZAG 0x80
+#define NEO_TILE_SEQUENCE 0x80
+
+class FastLED_NeoMatrix : public Adafruit_GFX
+{
+public:
+    FastLED_NeoMatrix(CRGB *leds, uint8_t matrixWidth, uint8_t matrixHeight, uint8_t tilesX, uint8_t tilesY, uint8_t type);
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+    void fillScreen(uint16_t color) override;
+    void clear() { fillScreen(0); }
+    uint16_t XY(int16_t x, int16_t y);
+    void show();
+    void setBrightness(uint8_t brightness);
+    void setRemapFunction(uint16_t (*fn)(uint16_t, uint16_t));
+    void setPassThruColor(uint32_t color);
+    void setPassThruColor();
+
+    // RGB565 to the LED color with the gamma of the library
+    static CRGB expandColor(uint16_t color);
+    static uint16_t Color(uint8_t r, uint8_t g, uint8_t b) { return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3); }
+
+protected:
+    CRGB *_leds;
+    uint8_t _matrixWidth;
+    uint8_t _matrixHeight;
+    uint8_t _tilesX;
+    uint8_t _tilesY;
+    uint8_t _type;
+    uint16_t (*_remapFn)(uint16_t, uint16_t);
+    bool _passThruFlag;
+    CRGB _passThruColor;
+};
+
+#endif
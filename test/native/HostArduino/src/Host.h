@@ -0,0 +1,53 @@
+#ifndef HOST_H_
+#define HOST_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Test side of the host Arduino core
+namespace Host
+{
+    // Virtual clock behind millis() and micros()
+    void setMicros(uint64_t us);
+    void advance(uint32_t ms);
+    void advanceMicros(uint32_t us);
+
+    // Input level of a pin, an attached interrupt is called when it changes
+    void setPin(uint8_t pin, int level);
+    // Last digitalWrite() to a pin
+    int pin(uint8_t pin);
+
+    // Every malloc() and new of the firmware code is counted
+    struct HeapStats
+    {
+        size_t live;
+        size_t peak;
+        uint32_t allocations;
+        uint32_t frees;
+    };
+    extern HeapStats heap;
+    // ESP.getFreeHeap() is this minus the live bytes
+    void setHeapSize(size_t size);
+    // Largest free block, 0 = the heap is not fragmented
+    void setLargestBlock(size_t size);
+    void resetHeapPeak();
+    size_t freeHeap();
+
+    void *allocate(size_t size);
+    void *allocateZeroed(size_t count, size_t size);
+    void *reallocate(void *pointer, size_t size);
+    void release(void *pointer);
+
+    // ESP.restart() was called
+    extern bool restarted;
+    // CPU clock, ESP.getCpuFreqMHz() and system_update_cpu_freq()
+    extern uint8_t cpuMHz;
+}
+
+// Counted allocations, the includes above already have the real declarations
+#define malloc(size) Host::allocate(size)
+#define calloc(count, size) Host::allocateZeroed(count, size)
+#define realloc(pointer, size) Host::reallocate(pointer, size)
+#define free(pointer) Host::release(pointer)
+
+#endif
@@ -0,0 +1,346 @@
+#include "Arduino.h"
+#include <new>
+
+// The real allocator, the macros of Host.h must not apply here
+#undef malloc
+#undef calloc
+#undef realloc
+#undef free
+
+HardwareSerial Serial;
+EspClass ESP;
+
+namespace Host
+{
+    HeapStats heap;
+    bool restarted = false;
+    uint8_t cpuMHz = F_CPU / 1000000L;
+
+    static uint64_t clockMicros = 0;
+    static int pinLevels[64];
+    static int pinOutputs[64];
+    static void (*pinInterrupts[64])();
+    static int pinInterruptModes[64];
+    static size_t heapSize = 64 * 1024 * 1024; // Tests that care set their own
+    static size_t largestBlock = 0;
+
+    // Every block starts with its size, so the live bytes are known on release
+    struct Block
+    {
+        size_t size;
+        uint32_t magic;
+    };
+    static const uint32_t blockMagic = 0x50584954;
+    static const size_t blockHeader = (sizeof(Block) + 15) & ~(size_t)15;
+
+    void setMicros(uint64_t us)
+    {
+        clockMicros = us;
+    }
+
+    void advance(uint32_t ms)
+    {
+        clockMicros += (uint64_t)ms * 1000;
+    }
+
+    void advanceMicros(uint32_t us)
+    {
+        clockMicros += us;
+    }
+
+    void setPin(uint8_t pin, int level)
+    {
+        if (pin >= 64)
+        {
+            return;
+        }
+        int previous = pinLevels[pin];
+        pinLevels[pin] = level;
+        if (pinInterrupts[pin] == nullptr || previous == level)
+        {
+            return;
+        }
+        int mode = pinInterruptModes[pin];
+        if (mode == CHANGE || (mode == RISING && level == HIGH) || (mode == FALLING && level == LOW))
+        {
+            pinInterrupts[pin]();
+        }
+    }
+
+    int pin(uint8_t pin)
+    {
+        return pin < 64 ? pinOutputs[pin] : LOW;
+    }
+
+    void setHeapSize(size_t size)
+    {
+        heapSize = size;
+    }
+
+    void setLargestBlock(size_t size)
+    {
+        largestBlock = size;
+    }
+
+    void resetHeapPeak()
+    {
+        heap.peak = heap.live;
+    }
+
+    size_t freeHeap()
+    {
+        return heap.live < heapSize ? heapSize - heap.live : 0;
+    }
+
+    void *allocate(size_t size)
+    {
+        // Like on the device an allocation can fail
+        if (size > freeHeap() || (largestBlock > 0 && size > largestBlock))
+        {
+            return nullptr;
+        }
+        Block *block = static_cast<Block *>(malloc(blockHeader + size));
+        if (block == nullptr)
+        {
+            return nullptr;
+        }
+        block->size = size;
+        block->magic = blockMagic;
+        heap.live += size;
+        heap.peak = heap.live > heap.peak ? heap.live : heap.peak;
+        heap.allocations++;
+        return reinterpret_cast<uint8_t *>(block) + blockHeader;
+    }
+
+    void *allocateZeroed(size_t count, size_t size)
+    {
+        void *pointer = allocate(count * size);
+        if (pointer != nullptr)
+        {
+            memset(pointer, 0, count * size);
+        }
+        return pointer;
+    }
+
+    void release(void *pointer)
+    {
+        if (pointer == nullptr)
+        {
+            return;
+        }
+        Block *block = reinterpret_cast<Block *>(static_cast<uint8_t *>(pointer) - blockHeader);
+        if (block->magic != blockMagic)
+        {
+            abort();
+        }
+        block->magic = 0;
+        heap.live -= block->size;
+        heap.frees++;
+        free(block);
+    }
+
+    void *reallocate(void *pointer, size_t size)
+    {
+        if (pointer == nullptr)
+        {
+            return allocate(size);
+        }
+        size_t previous = reinterpret_cast<Block *>(static_cast<uint8_t *>(pointer) - blockHeader)->size;
+        void *moved = allocate(size);
+        if (moved == nullptr)
+        {
+            return nullptr;
+        }
+        memcpy(moved, pointer, previous < size ? previous : size);
+        release(pointer);
+        return moved;
+    }
+}
+
+// new and delete are counted like malloc
+void *operator new(size_t size)
+{
+    void *pointer = Host::allocate(size);
+    if (pointer == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    return Host::allocate(size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    return Host::allocate(size);
+}
+
+void operator delete(void *pointer) noexcept
+{
+    Host::release(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    Host::release(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept
+{
+    Host::release(pointer);
+}
+
+void operator delete[](void *pointer, size_t) noexcept
+{
+    Host::release(pointer);
+}
+
+unsigned long millis()
+{
+    return (unsigned long)(uint32_t)(Host::clockMicros / 1000);
+}
+
+unsigned long micros()
+{
+    return (unsigned long)(uint32_t)Host::clockMicros;
+}
+
+void delay(unsigned long ms)
+{
+    Host::advance(ms);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    Host::advanceMicros(us);
+}
+
+void yield()
+{
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    if (pin < 64 && mode == INPUT_PULLUP)
+    {
+        Host::pinLevels[pin] = HIGH;
+    }
+}
+
+int digitalRead(uint8_t pin)
+{
+    return pin < 64 ? Host::pinLevels[pin] : LOW;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+    if (pin < 64)
+    {
+        Host::pinOutputs[pin] = value;
+    }
+}
+
+int analogRead(uint8_t pin)
+{
+    return 0;
+}
+
+int digitalPinToInterrupt(uint8_t pin)
+{
+    // Like GPIO16 on the ESP8266, the pins above can not raise interrupts
+    return pin < 16 ? pin : NOT_AN_INTERRUPT;
+}
+
+void attachInterrupt(int interrupt, void (*isr)(), int mode)
+{
+    if (interrupt >= 0 && interrupt < 64)
+    {
+        Host::pinInterrupts[interrupt] = isr;
+        Host::pinInterruptModes[interrupt] = mode;
+    }
+}
+
+void detachInterrupt(int interrupt)
+{
+    if (interrupt >= 0 && interrupt < 64)
+    {
+        Host::pinInterrupts[interrupt] = nullptr;
+    }
+}
+
+long random(long max)
+{
+    return max > 0 ? rand() % max : 0;
+}
+
+long random(long min, long max)
+{
+    return max > min ? min + random(max - min) : min;
+}
+
+void randomSeed(unsigned long seed)
+{
+    srand(seed);
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+    return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+    return size;
+}
+
+uint32_t EspClass::getFreeHeap()
+{
+    return Host::freeHeap();
+}
+
+uint32_t EspClass::getMaxFreeBlockSize()
+{
+    size_t free = Host::freeHeap();
+    return Host::largestBlock > 0 && Host::largestBlock < free ? Host::largestBlock : free;
+}
+
+uint8_t EspClass::getHeapFragmentation()
+{
+    size_t free = Host::freeHeap();
+    return free > 0 ? 100 - (uint64_t)getMaxFreeBlockSize() * 100 / free : 0;
+}
+
+void EspClass::getHeapStats(uint32_t *free, uint16_t *max, uint8_t *fragmentation)
+{
+    if (free != nullptr)
+    {
+        *free = getFreeHeap();
+    }
+    if (max != nullptr)
+    {
+        uint32_t block = getMaxFreeBlockSize();
+        *max = block < 0xFFFF ? block : 0xFFFF;
+    }
+    if (fragmentation != nullptr)
+    {
+        *fragmentation = getHeapFragmentation();
+    }
+}
+
+uint8_t EspClass::getCpuFreqMHz()
+{
+    return Host::cpuMHz;
+}
+
+void EspClass::restart()
+{
+    Host::restarted = true;
+}
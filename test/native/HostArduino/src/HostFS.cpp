@@ -0,0 +1,104 @@
+#include <FS.h>
+
+namespace Host
+{
+    int filesOpen = 0;
+
+    File openFile(const std::string &content)
+    {
+        std::shared_ptr<FileData> data = std::make_shared<FileData>();
+        data->content = std::make_shared<std::string>(content);
+        filesOpen++;
+        return File(data);
+    }
+}
+
+size_t File::write(const uint8_t *buffer, size_t size)
+{
+    if (!isOpen())
+    {
+        return 0;
+    }
+    _data->content->replace(_data->position, size, reinterpret_cast<const char *>(buffer), size);
+    _data->position += size;
+    return size;
+}
+
+int File::available()
+{
+    return isOpen() ? _data->content->size() - _data->position : 0;
+}
+
+int File::read()
+{
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+size_t File::read(uint8_t *buffer, size_t length)
+{
+    if (!isOpen())
+    {
+        return 0;
+    }
+    size_t count = std::min(length, (size_t)available());
+    memcpy(buffer, _data->content->data() + _data->position, count);
+    _data->position += count;
+    return count;
+}
+
+int File::peek()
+{
+    return available() > 0 ? (uint8_t)(*_data->content)[_data->position] : -1;
+}
+
+bool File::seek(uint32_t position)
+{
+    if (!isOpen() || position > _data->content->size())
+    {
+        return false;
+    }
+    _data->position = position;
+    return true;
+}
+
+void File::close()
+{
+    if (isOpen())
+    {
+        _data->open = false;
+        Host::filesOpen--;
+    }
+    _data.reset();
+}
+
+File FS::open(const char *path, const char *mode)
+{
+    std::shared_ptr<std::string> &content = _files[path];
+    if (content == nullptr || mode[0] == 'w')
+    {
+        if (mode[0] == 'r')
+        {
+            _files.erase(path);
+            return File();
+        }
+        content = std::make_shared<std::string>();
+    }
+    std::shared_ptr<Host::FileData> data = std::make_shared<Host::FileData>();
+    data->content = content;
+    data->position = mode[0] == 'a' ? content->size() : 0;
+    Host::filesOpen++;
+    return File(data);
+}
+
+bool FS::exists(const char *path) const
+{
+    return _files.count(path) > 0;
+}
+
+bool FS::remove(const char *path)
+{
+    return _files.erase(path) > 0;
+}
+
+FS LittleFS;
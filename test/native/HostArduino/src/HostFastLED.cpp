@@ -0,0 +1,273 @@
+#include <FastLED.h>
+#include <FastLED_NeoMatrix.h>
+#include <math.h>
+
+uint16_t rand16seed = 1337;
+CFastLED FastLED;
+
+const TProgmemRGBPalette16 CloudColors_p = {0x0000FF, 0x00008B, 0x00008B, 0x00008B, 0x00008B, 0x00008B, 0x00008B, 0x00008B, 0x0000FF, 0x00008B, 0x87CEEB, 0x87CEEB, 0xADD8E6, 0xFFFFFF, 0xADD8E6, 0x87CEEB};
+const TProgmemRGBPalette16 LavaColors_p = {0x000000, 0x800000, 0x000000, 0x800000, 0x8B0000, 0x8B0000, 0x800000, 0x8B0000, 0x8B0000, 0x8B0000, 0xFF0000, 0xFFA500, 0xFFFFFF, 0xFFA500, 0xFF0000, 0x8B0000};
+const TProgmemRGBPalette16 OceanColors_p = {0x191970, 0x00008B, 0x191970, 0x000080, 0x00008B, 0x0000CD, 0x2E8B57, 0x008080, 0x5F9EA0, 0x0000FF, 0x008B8B, 0x6495ED, 0x7FFFD4, 0x2E8B57, 0x00FFFF, 0x87CEFA};
+const TProgmemRGBPalette16 ForestColors_p = {0x006400, 0x006400, 0x556B2F, 0x006400, 0x008000, 0x228B22, 0x6B8E23, 0x008000, 0x2E8B57, 0x66CDAA, 0x32CD32, 0x9ACD32, 0x90EE90, 0x7CFC00, 0x66CDAA, 0x228B22};
+const TProgmemRGBPalette16 RainbowColors_p = {0xFF0000, 0xD52A00, 0xAB5500, 0xAB7F00, 0xABAB00, 0x56D500, 0x00FF00, 0x00D52A, 0x00AB55, 0x0056AA, 0x0000FF, 0x2A00D5, 0x5500AB, 0x7F0081, 0xAB0055, 0xD5002B};
+const TProgmemRGBPalette16 PartyColors_p = {0x5500AB, 0x84007C, 0xB5004B, 0xE5001B, 0xE81700, 0xB84700, 0xAB7700, 0xABAB00, 0xAB5500, 0xDD2200, 0xF2000E, 0xC2003E, 0x8F0071, 0x5F00A1, 0x2F00D0, 0x0007F9};
+const TProgmemRGBPalette16 HeatColors_p = {0x000000, 0x330000, 0x660000, 0x990000, 0xCC0000, 0xFF0000, 0xFF3300, 0xFF6600, 0xFF9900, 0xFFCC00, 0xFFFF00, 0xFFFF33, 0xFFFF66, 0xFFFF99, 0xFFFFCC, 0xFFFFFF};
+
+uint8_t sin8(uint8_t theta)
+{
+    static const uint8_t interleave[] = {0, 49, 49, 41, 90, 27, 117, 10};
+
+    uint8_t offset = theta;
+    if (theta & 0x40)
+    {
+        offset = (uint8_t)255 - offset;
+    }
+    offset &= 0x3F;
+
+    uint8_t secoffset = offset & 0x0F;
+    if (theta & 0x40)
+    {
+        secoffset++;
+    }
+
+    uint8_t section = offset >> 4;
+    uint8_t b = interleave[section * 2];
+    uint8_t m16 = interleave[section * 2 + 1];
+    uint8_t mx = (m16 * secoffset) >> 4;
+    int8_t y = mx + b;
+    if (theta & 0x80)
+    {
+        y = -y;
+    }
+    return y + 128;
+}
+
+void CRGBPalette16::gradient(const CRGB *colors, uint8_t count)
+{
+    for (uint8_t i = 0; i < 16; i++)
+    {
+        int position = i * (count - 1) * 256 / 15;
+        int k = position >> 8;
+        int f = position & 255;
+        if (k >= count - 1)
+        {
+            k = count - 2;
+            f = 255;
+        }
+        entries[i] = CRGB(colors[k].r + (colors[k + 1].r - colors[k].r) * f / 255, colors[k].g + (colors[k + 1].g - colors[k].g) * f / 255, colors[k].b + (colors[k + 1].b - colors[k].b) * f / 255);
+    }
+}
+
+CRGB ColorFromPalette(const CRGBPalette16 &palette, uint8_t index, uint8_t brightness)
+{
+    uint8_t hi4 = index >> 4;
+    uint8_t lo4 = index & 0x0F;
+    const CRGB &entry = palette.entries[hi4];
+    const CRGB &next = palette.entries[(hi4 + 1) & 0x0F];
+
+    uint8_t f2 = lo4 << 4;
+    uint8_t f1 = 255 - f2;
+    CRGB color(scale8(entry.r, f1) + scale8(next.r, f2), scale8(entry.g, f1) + scale8(next.g, f2), scale8(entry.b, f1) + scale8(next.b, f2));
+    if (brightness != 255)
+    {
+        color.r = scale8(color.r, brightness);
+        color.g = scale8(color.g, brightness);
+        color.b = scale8(color.b, brightness);
+    }
+    return color;
+}
+
+FastLED_NeoMatrix::FastLED_NeoMatrix(CRGB *leds, uint8_t matrixWidth, uint8_t matrixHeight, uint8_t tilesX, uint8_t tilesY, uint8_t type)
+    : Adafruit_GFX(matrixWidth * tilesX, matrixHeight * tilesY), _leds(leds), _matrixWidth(matrixWidth), _matrixHeight(matrixHeight), _tilesX(tilesX), _tilesY(tilesY), _type(type),
+      _remapFn(nullptr), _passThruFlag(false)
+{
+}
+
+// 5 and 6 bit channels through a 2.5 gamma curve, tables like gamma5 and gamma6 of the library
+struct GammaTables
+{
+    uint8_t five[32];
+    uint8_t six[64];
+
+    GammaTables()
+    {
+        for (uint8_t i = 0; i < 64; i++)
+        {
+            if (i < 32)
+            {
+                five[i] = lround(pow(i / 31.0, 2.5) * 255);
+            }
+            six[i] = lround(pow(i / 63.0, 2.5) * 255);
+        }
+    }
+};
+
+static const GammaTables gammaTables;
+
+CRGB FastLED_NeoMatrix::expandColor(uint16_t color)
+{
+    return CRGB(gammaTables.five[color >> 11], gammaTables.six[(color >> 5) & 0x3F], gammaTables.five[color & 0x1F]);
+}
+
+void FastLED_NeoMatrix::drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+    if (x < 0 || y < 0 || x >= _width || y >= _height)
+    {
+        return;
+    }
+    _leds[XY(x, y)] = _passThruFlag ? _passThruColor : expandColor(color);
+}
+
+void FastLED_NeoMatrix::fillScreen(uint16_t color)
+{
+    CRGB expanded = expandColor(color);
+    for (uint32_t i = 0; i < (uint32_t)_width * _height; i++)
+    {
+        _leds[i] = expanded;
+    }
+}
+
+uint16_t FastLED_NeoMatrix::XY(int16_t x, int16_t y)
+{
+    if (x < 0 || y < 0 || x >= _width || y >= _height)
+    {
+        return 0;
+    }
+
+    int16_t t;
+    switch (rotation)
+    {
+    case 1:
+        t = x;
+        x = WIDTH - 1 - y;
+        y = t;
+        break;
+    case 2:
+        x = WIDTH - 1 - x;
+        y = HEIGHT - 1 - y;
+        break;
+    case 3:
+        t = x;
+        x = y;
+        y = HEIGHT - 1 - t;
+        break;
+    }
+
+    if (_remapFn)
+    {
+        return _remapFn(x, y);
+    }
+
+    uint32_t tileOffset = 0;
+    uint8_t corner = _type & NEO_MATRIX_CORNER;
+    uint16_t minor;
+    uint16_t major;
+    uint16_t majorScale;
+
+    if (_tilesX > 1 || _tilesY > 1)
+    {
+        // Tile number first, presume row major
+        minor = x / _matrixWidth;
+        major = y / _matrixHeight;
+        x -= minor * _matrixWidth;
+        y -= major * _matrixHeight;
+
+        if (_type & NEO_TILE_RIGHT)
+        {
+            minor = _tilesX - 1 - minor;
+        }
+        if (_type & NEO_TILE_BOTTOM)
+        {
+            major = _tilesY - 1 - major;
+        }
+
+        if ((_type & NEO_TILE_AXIS) == NEO_TILE_ROWS)
+        {
+            majorScale = _tilesX;
+        }
+        else
+        {
+            uint16_t swap = major;
+            major = minor;
+            minor = swap;
+            majorScale = _tilesY;
+        }
+
+        uint16_t tile;
+        if ((_type & NEO_TILE_SEQUENCE) == NEO_TILE_PROGRESSIVE)
+        {
+            tile = major * majorScale + minor;
+        }
+        else if (major & 1)
+        {
+            // Zigzag tiles also flip the corner of the matrix on odd rows
+            corner ^= NEO_MATRIX_CORNER;
+            tile = (major + 1) * majorScale - 1 - minor;
+        }
+        else
+        {
+            tile = major * majorScale + minor;
+        }
+        tileOffset = (uint32_t)tile * _matrixWidth * _matrixHeight;
+    }
+
+    minor = x;
+    major = y;
+    if (corner & NEO_MATRIX_RIGHT)
+    {
+        minor = _matrixWidth - 1 - minor;
+    }
+    if (corner & NEO_MATRIX_BOTTOM)
+    {
+        major = _matrixHeight - 1 - major;
+    }
+
+    if ((_type & NEO_MATRIX_AXIS) == NEO_MATRIX_ROWS)
+    {
+        majorScale = _matrixWidth;
+    }
+    else
+    {
+        uint16_t swap = major;
+        major = minor;
+        minor = swap;
+        majorScale = _matrixHeight;
+    }
+
+    uint32_t pixelOffset;
+    if ((_type & NEO_MATRIX_SEQUENCE) == NEO_MATRIX_PROGRESSIVE || !(major & 1))
+    {
+        pixelOffset = major * majorScale + minor;
+    }
+    else
+    {
+        pixelOffset = (major + 1) * majorScale - 1 - minor;
+    }
+    return tileOffset + pixelOffset;
+}
+
+void FastLED_NeoMatrix::show()
+{
+    FastLED.show();
+}
+
+void FastLED_NeoMatrix::setBrightness(uint8_t brightness)
+{
+    FastLED.setBrightness(brightness);
+}
+
+void FastLED_NeoMatrix::setRemapFunction(uint16_t (*fn)(uint16_t, uint16_t))
+{
+    _remapFn = fn;
+}
+
+void FastLED_NeoMatrix::setPassThruColor(uint32_t color)
+{
+    _passThruColor = CRGB(color);
+    _passThruFlag = true;
+}
+
+void FastLED_NeoMatrix::setPassThruColor()
+{
+    _passThruFlag = false;
+}
@@ -0,0 +1,192 @@
+#include "lwip/dns.h"
+#include "lwip/tcp.h"
+#include <string.h>
+#include <vector>
+
+namespace Host
+{
+    DnsMode dnsMode = DnsMode_Cached;
+    tcp_pcb *tcpLast = nullptr;
+    bool tcpNewFails = false;
+    uint16_t tcpSendBuffer = 2920;
+
+    static dns_found_callback dnsFound = nullptr;
+    static void *dnsArg = nullptr;
+    static std::string dnsName;
+    static std::vector<tcp_pcb *> pcbs;
+
+    void dnsAnswer(const ip_addr_t *address)
+    {
+        dns_found_callback found = dnsFound;
+        dnsFound = nullptr;
+        if (found != nullptr)
+        {
+            found(dnsName.c_str(), address, dnsArg);
+        }
+    }
+
+    void tcpReset()
+    {
+        for (tcp_pcb *pcb : pcbs)
+        {
+            delete pcb;
+        }
+        pcbs.clear();
+        tcpLast = nullptr;
+        tcpNewFails = false;
+        tcpSendBuffer = 2920;
+        dnsMode = DnsMode_Cached;
+        dnsFound = nullptr;
+    }
+
+    void tcpAccept(tcp_pcb *pcb)
+    {
+        if (pcb->connected != nullptr)
+        {
+            pcb->connected(pcb->arg, pcb, ERR_OK);
+        }
+    }
+
+    void tcpDeliver(tcp_pcb *pcb, const char *data, size_t length, size_t segment)
+    {
+        // One chain, like a TCP segment split over several buffers
+        std::vector<pbuf *> chain;
+        for (size_t offset = 0; offset < length; offset += segment)
+        {
+            pbuf *p = new pbuf();
+            p->len = length - offset < segment ? length - offset : segment;
+            p->payload = new char[p->len];
+            memcpy(p->payload, data + offset, p->len);
+            chain.push_back(p);
+        }
+        for (size_t i = 0; i < chain.size(); i++)
+        {
+            chain[i]->next = i + 1 < chain.size() ? chain[i + 1] : nullptr;
+            chain[i]->tot_len = length - i * segment;
+        }
+        if (!chain.empty() && pcb->recv != nullptr)
+        {
+            pcb->recv(pcb->arg, pcb, chain[0], ERR_OK);
+        }
+    }
+
+    void tcpRemoteClose(tcp_pcb *pcb)
+    {
+        if (pcb->recv != nullptr)
+        {
+            pcb->recv(pcb->arg, pcb, nullptr, ERR_OK);
+        }
+    }
+
+    void tcpFail(tcp_pcb *pcb, err_t err)
+    {
+        pcb->closed = true;
+        if (pcb->errf != nullptr)
+        {
+            pcb->errf(pcb->arg, err);
+        }
+    }
+}
+
+err_t dns_gethostbyname(const char *name, ip_addr_t *address, dns_found_callback found, void *arg)
+{
+    switch (Host::dnsMode)
+    {
+    case Host::DnsMode_Cached:
+        address->addr = 0x0100007F;
+        return ERR_OK;
+    case Host::DnsMode_Pending:
+        Host::dnsFound = found;
+        Host::dnsArg = arg;
+        Host::dnsName = name;
+        return ERR_INPROGRESS;
+    default:
+        return ERR_ARG;
+    }
+}
+
+tcp_pcb *tcp_new()
+{
+    if (Host::tcpNewFails)
+    {
+        return nullptr;
+    }
+    tcp_pcb *pcb = new tcp_pcb();
+    pcb->sndbuf = Host::tcpSendBuffer;
+    Host::pcbs.push_back(pcb);
+    Host::tcpLast = pcb;
+    return pcb;
+}
+
+void tcp_arg(tcp_pcb *pcb, void *arg)
+{
+    pcb->arg = arg;
+}
+
+void tcp_err(tcp_pcb *pcb, tcp_err_fn errf)
+{
+    pcb->errf = errf;
+}
+
+void tcp_recv(tcp_pcb *pcb, tcp_recv_fn recv)
+{
+    pcb->recv = recv;
+}
+
+err_t tcp_connect(tcp_pcb *pcb, const ip_addr_t *address, uint16_t port, tcp_connected_fn connected)
+{
+    pcb->remote = *address;
+    pcb->port = port;
+    pcb->connected = connected;
+    return ERR_OK;
+}
+
+uint16_t tcp_sndbuf(tcp_pcb *pcb)
+{
+    return pcb->sndbuf;
+}
+
+err_t tcp_write(tcp_pcb *pcb, const void *data, uint16_t length, uint8_t flags)
+{
+    if (pcb->closed || length > pcb->sndbuf)
+    {
+        return ERR_MEM;
+    }
+    pcb->written.append(static_cast<const char *>(data), length);
+    return ERR_OK;
+}
+
+err_t tcp_output(tcp_pcb *pcb)
+{
+    return ERR_OK;
+}
+
+void tcp_recved(tcp_pcb *pcb, uint16_t length)
+{
+    pcb->recved += length;
+}
+
+err_t tcp_close(tcp_pcb *pcb)
+{
+    pcb->closed = true;
+    return ERR_OK;
+}
+
+void tcp_abort(tcp_pcb *pcb)
+{
+    pcb->closed = true;
+}
+
+uint8_t pbuf_free(pbuf *p)
+{
+    uint8_t count = 0;
+    while (p != nullptr)
+    {
+        pbuf *next = p->next;
+        delete[] static_cast<char *>(p->payload);
+        delete p;
+        p = next;
+        count++;
+    }
+    return count;
+}
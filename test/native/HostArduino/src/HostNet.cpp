@@ -0,0 +1,331 @@
+#include <ESP8266WiFi.h>
+#include <WiFiUdp.h>
+#include <deque>
+#include <vector>
+
+ESP8266WiFiClass WiFi;
+
+namespace Host
+{
+    uint32_t udpDelayMicros = 0;
+    uint32_t udpLossEvery = 0;
+    bool udpMulticastLoop = true;
+    uint32_t udpSent = 0;
+    uint32_t udpLost = 0;
+
+    struct Datagram
+    {
+        uint64_t visibleAt;
+        IPAddress from;
+        uint16_t fromPort;
+        std::string data;
+    };
+    typedef std::deque<Datagram> DatagramQueue;
+
+    // Sockets can be globals of the test, constructed before anything of this file
+    static std::vector<WiFiUDP *> &sockets()
+    {
+        static std::vector<WiFiUDP *> list;
+        return list;
+    }
+
+    void udpReset()
+    {
+        udpDelayMicros = 0;
+        udpLossEvery = 0;
+        udpMulticastLoop = true;
+        udpSent = 0;
+        udpLost = 0;
+    }
+
+    static uint64_t now()
+    {
+        // micros() wraps, the queue needs the full time
+        static uint32_t last = 0;
+        static uint64_t high = 0;
+        uint32_t current = micros();
+        if (current < last)
+        {
+            high += 1ULL << 32;
+        }
+        last = current;
+        return high + current;
+    }
+}
+
+static bool isMulticast(IPAddress address)
+{
+    return (address[0] & 0xF0) == 0xE0;
+}
+
+WiFiUDP::WiFiUDP() : _port(0), _sendPort(0), _sending(false), _inOffset(0), _remotePort(0), _queue(new Host::DatagramQueue())
+{
+    Host::sockets().push_back(this);
+}
+
+WiFiUDP::~WiFiUDP()
+{
+    for (size_t i = 0; i < Host::sockets().size(); i++)
+    {
+        if (Host::sockets()[i] == this)
+        {
+            Host::sockets().erase(Host::sockets().begin() + i);
+            break;
+        }
+    }
+    delete static_cast<Host::DatagramQueue *>(_queue);
+}
+
+uint8_t WiFiUDP::begin(uint16_t port)
+{
+    stop();
+    localAddress = WiFi.localIP();
+    _port = port;
+    return 1;
+}
+
+uint8_t WiFiUDP::beginMulticast(IPAddress interfaceAddress, IPAddress group, uint16_t port)
+{
+    stop();
+    localAddress = interfaceAddress;
+    _port = port;
+    // No interface address, no membership
+    if (!interfaceAddress.isSet())
+    {
+        return 0;
+    }
+    _group = group;
+    return 1;
+}
+
+uint8_t WiFiUDP::beginMulticast(IPAddress group, uint16_t port)
+{
+    return beginMulticast(WiFi.localIP(), group, port);
+}
+
+void WiFiUDP::stop()
+{
+    _port = 0;
+    _group = IPAddress();
+    static_cast<Host::DatagramQueue *>(_queue)->clear();
+    _in.clear();
+    _inOffset = 0;
+}
+
+int WiFiUDP::beginPacket(IPAddress address, uint16_t port)
+{
+    _sendAddress = address;
+    _sendPort = port;
+    _sending = true;
+    _out.clear();
+    return 1;
+}
+
+int WiFiUDP::beginPacket(const char *host, uint16_t port)
+{
+    IPAddress address;
+    address.fromString(host);
+    return beginPacket(address, port);
+}
+
+int WiFiUDP::beginPacketMulticast(IPAddress group, uint16_t port, IPAddress interfaceAddress, int ttl)
+{
+    localAddress = interfaceAddress;
+    return beginPacket(group, port);
+}
+
+int WiFiUDP::beginMulticastPacket()
+{
+    return beginPacket(_group, _port);
+}
+
+size_t WiFiUDP::write(uint8_t c)
+{
+    return write(&c, 1);
+}
+
+size_t WiFiUDP::write(const uint8_t *buffer, size_t size)
+{
+    if (!_sending)
+    {
+        return 0;
+    }
+    _out.append(reinterpret_cast<const char *>(buffer), size);
+    return size;
+}
+
+int WiFiUDP::endPacket()
+{
+    if (!_sending)
+    {
+        return 0;
+    }
+    _sending = false;
+    Host::udpSent++;
+    if (Host::udpLossEvery > 0 && Host::udpSent % Host::udpLossEvery == 0)
+    {
+        Host::udpLost++;
+        return 1;
+    }
+
+    bool multicast = isMulticast(_sendAddress);
+    Host::Datagram datagram = {Host::now() + Host::udpDelayMicros, localAddress, _port, _out};
+    for (WiFiUDP *socket : Host::sockets())
+    {
+        if (socket->_port != _sendPort || (socket == this && !(multicast && Host::udpMulticastLoop)))
+        {
+            continue;
+        }
+        // Like on the ESP8266 the membership is bound to the interface address it was made with
+        if (multicast ? socket->_group != _sendAddress || socket->localAddress != WiFi.localIP() : socket->localAddress != _sendAddress && _sendAddress != IPAddress(255, 255, 255, 255))
+        {
+            continue;
+        }
+        static_cast<Host::DatagramQueue *>(socket->_queue)->push_back(datagram);
+    }
+    return 1;
+}
+
+int WiFiUDP::parsePacket()
+{
+    // The rest of the previous packet is discarded
+    _in.clear();
+    _inOffset = 0;
+
+    Host::DatagramQueue &queue = *static_cast<Host::DatagramQueue *>(_queue);
+    if (queue.empty() || queue.front().visibleAt > Host::now())
+    {
+        return 0;
+    }
+    _in = queue.front().data;
+    _remoteAddress = queue.front().from;
+    _remotePort = queue.front().fromPort;
+    queue.pop_front();
+    return _in.length();
+}
+
+int WiFiUDP::available()
+{
+    return _in.length() - _inOffset;
+}
+
+int WiFiUDP::read()
+{
+    return _inOffset < _in.length() ? (uint8_t)_in[_inOffset++] : -1;
+}
+
+int WiFiUDP::read(uint8_t *buffer, size_t length)
+{
+    size_t count = _in.length() - _inOffset;
+    count = count < length ? count : length;
+    memcpy(buffer, _in.data() + _inOffset, count);
+    _inOffset += count;
+    return count;
+}
+
+int WiFiUDP::peek()
+{
+    return _inOffset < _in.length() ? (uint8_t)_in[_inOffset] : -1;
+}
+
+void WiFiUDP::flush()
+{
+    _inOffset = _in.length();
+}
+
+namespace Host
+{
+    struct Pending
+    {
+        uint16_t port;
+        std::shared_ptr<Peer> peer;
+    };
+
+    static std::deque<Pending> &pending()
+    {
+        static std::deque<Pending> list;
+        return list;
+    }
+
+    std::shared_ptr<Peer> connect(uint16_t port)
+    {
+        std::shared_ptr<Peer> peer = std::make_shared<Peer>();
+        pending().push_back({port, peer});
+        return peer;
+    }
+
+    std::string Peer::receive()
+    {
+        std::string data;
+        data.swap(toClient);
+        return data;
+    }
+}
+
+WiFiClient WiFiServer::available()
+{
+    std::deque<Host::Pending> &pending = Host::pending();
+    for (auto it = pending.begin(); it != pending.end(); ++it)
+    {
+        if (it->port == _port)
+        {
+            WiFiClient client(it->peer);
+            pending.erase(it);
+            return client;
+        }
+    }
+    return WiFiClient();
+}
+
+int WiFiClient::available()
+{
+    return _peer && _peer->serverOpen ? _peer->toServer.size() - _peer->toServerRead : 0;
+}
+
+int WiFiClient::read()
+{
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int WiFiClient::read(uint8_t *buffer, size_t length)
+{
+    size_t count = std::min(length, (size_t)available());
+    memcpy(buffer, _peer->toServer.data() + _peer->toServerRead, count);
+    _peer->toServerRead += count;
+    return count;
+}
+
+int WiFiClient::peek()
+{
+    return available() > 0 ? (uint8_t)_peer->toServer[_peer->toServerRead] : -1;
+}
+
+size_t WiFiClient::write(const uint8_t *buffer, size_t size)
+{
+    // Blocks on the device until there is room, the test sees all of it at once
+    if (!connected())
+    {
+        return 0;
+    }
+    _peer->toClient.append(reinterpret_cast<const char *>(buffer), size);
+    return size;
+}
+
+int WiFiClient::availableForWrite()
+{
+    return connected() && _peer->toClient.size() < _peer->sendBuffer ? _peer->sendBuffer - _peer->toClient.size() : 0;
+}
+
+uint8_t WiFiClient::connected()
+{
+    return _peer && _peer->serverOpen && _peer->clientOpen;
+}
+
+void WiFiClient::stop()
+{
+    if (_peer)
+    {
+        _peer->serverOpen = false;
+    }
+}
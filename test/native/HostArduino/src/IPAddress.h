@@ -0,0 +1,40 @@
+#ifndef HOST_IPADDRESS_H_
+#define HOST_IPADDRESS_H_
+
+#include <Arduino.h>
+
+class IPAddress
+{
+public:
+    constexpr IPAddress() : _address(0) {}
+    constexpr IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _address(a | (b << 8) | (c << 16) | ((uint32_t)d << 24)) {}
+    constexpr IPAddress(uint32_t address) : _address(address) {}
+
+    operator uint32_t() const { return _address; }
+    bool operator==(const IPAddress &other) const { return _address == other._address; }
+    bool operator!=(const IPAddress &other) const { return _address != other._address; }
+    uint8_t operator[](int index) const { return _address >> (index * 8); }
+    bool isSet() const { return _address != 0; }
+
+    String toString() const
+    {
+        char text[16];
+        snprintf(text, sizeof(text), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+        return String(text);
+    }
+    bool fromString(const char *text)
+    {
+        unsigned int a, b, c, d;
+        if (sscanf(text, "%u.%u.%u.%u", &a, &b, &c, &d) != 4 || a > 255 || b > 255 || c > 255 || d > 255)
+        {
+            return false;
+        }
+        *this = IPAddress(a, b, c, d);
+        return true;
+    }
+
+private:
+    uint32_t _address;
+};
+
+#endif
@@ -0,0 +1,8 @@
+#ifndef HOST_LITTLEFS_H_
+#define HOST_LITTLEFS_H_
+
+#include <FS.h>
+
+extern FS LittleFS;
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef HOST_PRINT_H_
+#define HOST_PRINT_H_
+
+#include <stdarg.h>
+#include <stdio.h>
+#include "WString.h"
+
+#define DEC 10
+#define HEX 16
+
+class Print
+{
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size)
+    {
+        size_t written = 0;
+        while (written < size && write(buffer[written]) == 1)
+        {
+            written++;
+        }
+        return written;
+    }
+    size_t write(const char *text) { return text != nullptr ? write(reinterpret_cast<const uint8_t *>(text), strlen(text)) : 0; }
+    size_t write(const char *buffer, size_t size) { return write(reinterpret_cast<const uint8_t *>(buffer), size); }
+
+    size_t print(const char *text) { return write(text); }
+    size_t print(const String &text) { return write(reinterpret_cast<const uint8_t *>(text.c_str()), text.length()); }
+    size_t print(const __FlashStringHelper *text) { return write(reinterpret_cast<const char *>(text)); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int value, int base = DEC) { return print(String(value, base)); }
+    size_t print(unsigned int value, int base = DEC) { return print(String(value, base)); }
+    size_t print(long value, int base = DEC) { return print(String(value, base)); }
+    size_t print(unsigned long value, int base = DEC) { return print(String(value, base)); }
+    size_t print(double value, int decimals = 2) { return print(String(value, decimals)); }
+
+    template <typename T>
+    size_t println(const T &value)
+    {
+        size_t written = print(value);
+        return written + println();
+    }
+    size_t println() { return write("\r\n"); }
+
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)))
+    {
+        char text[256];
+        va_list args;
+        va_start(args, format);
+        int length = vsnprintf(text, sizeof(text), format, args);
+        va_end(args);
+        if (length < 0)
+        {
+            return 0;
+        }
+        return write(reinterpret_cast<const uint8_t *>(text), (size_t)length < sizeof(text) ? length : sizeof(text) - 1);
+    }
+};
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef HOST_STREAM_H_
+#define HOST_STREAM_H_
+
+#include "Print.h"
+
+class Stream : public Print
+{
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() { return -1; }
+    virtual void flush() {}
+    void setTimeout(unsigned long timeout) { _timeout = timeout; }
+
+    // No waiting on the host, only what is available is read
+    virtual size_t readBytes(uint8_t *buffer, size_t length)
+    {
+        size_t count = 0;
+        while (count < length && available() > 0)
+        {
+            int c = read();
+            if (c < 0)
+            {
+                break;
+            }
+            buffer[count++] = c;
+        }
+        return count;
+    }
+    size_t readBytes(char *buffer, size_t length) { return readBytes(reinterpret_cast<uint8_t *>(buffer), length); }
+
+protected:
+    unsigned long _timeout = 1000;
+};
+
+#endif
@@ -0,0 +1,239 @@
+#ifndef HOST_WSTRING_H_
+#define HOST_WSTRING_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+class __FlashStringHelper;
+
+// Arduino String on top of std::string, only the part the firmware uses
+class String
+{
+public:
+    String() {}
+    String(const char *text) : _text(text != nullptr ? text : "") {}
+    String(const char *text, size_t length) : _text(text, length) {}
+    String(const __FlashStringHelper *text) : _text(reinterpret_cast<const char *>(text)) {}
+    String(const std::string &text) : _text(text) {}
+    explicit String(char c) : _text(1, c) {}
+    explicit String(unsigned char value, unsigned char base = 10) { fromUnsigned(value, base); }
+    explicit String(int value, unsigned char base = 10) { fromSigned(value, base); }
+    explicit String(unsigned int value, unsigned char base = 10) { fromUnsigned(value, base); }
+    explicit String(long value, unsigned char base = 10) { fromSigned(value, base); }
+    explicit String(unsigned long value, unsigned char base = 10) { fromUnsigned(value, base); }
+    explicit String(long long value) : _text(std::to_string(value)) {}
+    explicit String(unsigned long long value) : _text(std::to_string(value)) {}
+    explicit String(float value, unsigned char decimals = 2) { fromDouble(value, decimals); }
+    explicit String(double value, unsigned char decimals = 2) { fromDouble(value, decimals); }
+
+    unsigned int length() const { return _text.length(); }
+    const char *c_str() const { return _text.c_str(); }
+    bool reserve(unsigned int size)
+    {
+        _text.reserve(size);
+        return true;
+    }
+    bool isEmpty() const { return _text.empty(); }
+
+    String &operator=(const char *text)
+    {
+        _text = text != nullptr ? text : "";
+        return *this;
+    }
+    String &operator=(const __FlashStringHelper *text) { return *this = reinterpret_cast<const char *>(text); }
+
+    bool concat(const String &text)
+    {
+        _text += text._text;
+        return true;
+    }
+    bool concat(const char *text)
+    {
+        _text += text != nullptr ? text : "";
+        return true;
+    }
+    bool concat(const char *text, unsigned int length)
+    {
+        _text.append(text, length);
+        return true;
+    }
+    bool concat(char c)
+    {
+        _text += c;
+        return true;
+    }
+    bool concat(const __FlashStringHelper *text) { return concat(reinterpret_cast<const char *>(text)); }
+    template <typename T>
+    bool concat(T value) { return concat(String(value)); }
+
+    template <typename T>
+    String &operator+=(const T &value)
+    {
+        concat(value);
+        return *this;
+    }
+
+    char charAt(unsigned int index) const { return index < _text.length() ? _text[index] : '\0'; }
+    void setCharAt(unsigned int index, char c)
+    {
+        if (index < _text.length())
+        {
+            _text[index] = c;
+        }
+    }
+    char operator[](unsigned int index) const { return charAt(index); }
+    char &operator[](unsigned int index) { return _text[index]; }
+
+    int compareTo(const String &other) const { return _text.compare(other._text); }
+    bool equals(const String &other) const { return _text == other._text; }
+    bool equals(const char *other) const { return _text == (other != nullptr ? other : ""); }
+    bool equalsIgnoreCase(const String &other) const { return _text.length() == other._text.length() && strcasecmp(c_str(), other.c_str()) == 0; }
+    bool operator==(const String &other) const { return equals(other); }
+    bool operator==(const char *other) const { return equals(other); }
+    bool operator!=(const String &other) const { return !equals(other); }
+    bool operator!=(const char *other) const { return !equals(other); }
+    bool operator<(const String &other) const { return _text < other._text; }
+    bool startsWith(const String &prefix) const { return _text.compare(0, prefix._text.length(), prefix._text) == 0; }
+    bool endsWith(const String &suffix) const { return _text.length() >= suffix._text.length() && _text.compare(_text.length() - suffix._text.length(), suffix._text.length(), suffix._text) == 0; }
+
+    int indexOf(char c, unsigned int from = 0) const { return position(_text.find(c, from)); }
+    int indexOf(const String &text, unsigned int from = 0) const { return position(_text.find(text._text, from)); }
+    int lastIndexOf(char c) const { return position(_text.rfind(c)); }
+    int lastIndexOf(const String &text) const { return position(_text.rfind(text._text)); }
+    String substring(unsigned int from) const { return from < _text.length() ? String(_text.substr(from)) : String(); }
+    String substring(unsigned int from, unsigned int to) const
+    {
+        if (from > to)
+        {
+            unsigned int swap = from;
+            from = to;
+            to = swap;
+        }
+        return from < _text.length() ? String(_text.substr(from, to - from)) : String();
+    }
+
+    void replace(const String &find, const String &replacement)
+    {
+        if (find._text.empty())
+        {
+            return;
+        }
+        for (size_t at = _text.find(find._text); at != std::string::npos; at = _text.find(find._text, at + replacement._text.length()))
+        {
+            _text.replace(at, find._text.length(), replacement._text);
+        }
+    }
+    void remove(unsigned int index) { _text.erase(index < _text.length() ? index : _text.length()); }
+    void remove(unsigned int index, unsigned int count) { _text.erase(index < _text.length() ? index : _text.length(), count); }
+    void toLowerCase()
+    {
+        for (char &c : _text)
+        {
+            c = tolower(c);
+        }
+    }
+    void toUpperCase()
+    {
+        for (char &c : _text)
+        {
+            c = toupper(c);
+        }
+    }
+    void trim()
+    {
+        size_t first = _text.find_first_not_of(" \t\r\n");
+        size_t last = _text.find_last_not_of(" \t\r\n");
+        _text = first == std::string::npos ? std::string() : _text.substr(first, last - first + 1);
+    }
+
+    long toInt() const { return atol(c_str()); }
+    float toFloat() const { return atof(c_str()); }
+    double toDouble() const { return atof(c_str()); }
+    void toCharArray(char *buffer, unsigned int size, unsigned int index = 0) const { getBytes(reinterpret_cast<unsigned char *>(buffer), size, index); }
+    void getBytes(unsigned char *buffer, unsigned int size, unsigned int index = 0) const
+    {
+        if (size == 0)
+        {
+            return;
+        }
+        size_t length = index < _text.length() ? _text.copy(reinterpret_cast<char *>(buffer), size - 1, index) : 0;
+        buffer[length] = '\0';
+    }
+
+protected:
+    std::string _text;
+
+    static int position(size_t at) { return at == std::string::npos ? -1 : (int)at; }
+    void fromSigned(long value, unsigned char base)
+    {
+        if (value < 0 && base == 10)
+        {
+            fromUnsigned(-(unsigned long)value, base);
+            _text.insert(_text.begin(), '-');
+        }
+        else
+        {
+            fromUnsigned((unsigned long)value, base);
+        }
+    }
+    void fromUnsigned(unsigned long value, unsigned char base)
+    {
+        char digits[66];
+        int count = 0;
+        do
+        {
+            digits[count++] = "0123456789abcdefghijklmnopqrstuvwxyz"[value % base];
+            value /= base;
+        } while (value > 0);
+        _text.assign(digits, count);
+        std::string reversed(_text.rbegin(), _text.rend());
+        _text = reversed;
+    }
+    void fromDouble(double value, unsigned char decimals)
+    {
+        char text[48];
+        snprintf(text, sizeof(text), "%.*f", decimals, value);
+        _text = text;
+    }
+};
+
+inline String operator+(const String &left, const String &right)
+{
+    String result(left);
+    result.concat(right);
+    return result;
+}
+inline String operator+(const String &left, const char *right)
+{
+    String result(left);
+    result.concat(right);
+    return result;
+}
+inline String operator+(const char *left, const String &right)
+{
+    String result(left);
+    result.concat(right);
+    return result;
+}
+inline String operator+(const String &left, const __FlashStringHelper *right)
+{
+    String result(left);
+    result.concat(right);
+    return result;
+}
+inline String operator+(const String &left, char right)
+{
+    String result(left);
+    result.concat(right);
+    return result;
+}
+inline String operator+(const String &left, int right) { return left + String(right); }
+inline String operator+(const String &left, unsigned int right) { return left + String(right); }
+inline String operator+(const String &left, long right) { return left + String(right); }
+inline String operator+(const String &left, unsigned long right) { return left + String(right); }
+inline String operator+(const String &left, float right) { return left + String(right); }
+inline String operator+(const String &left, double right) { return left + String(right); }
+
+#endif
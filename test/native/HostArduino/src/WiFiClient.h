@@ -0,0 +1,68 @@
+#ifndef HOST_WIFICLIENT_H_
+#define HOST_WIFICLIENT_H_
+
+#include <Arduino.h>
+#include <deque>
+#include <memory>
+#include <string>
+
+namespace Host
+{
+    // Client end of a TCP connection to a WiFiServer of the firmware
+    struct Peer
+    {
+        std::string toServer;
+        size_t toServerRead = 0;
+        std::string toClient;
+        // Send buffer of the server side, filled by what the client has not read yet
+        size_t sendBuffer = 2920;
+        bool clientOpen = true;
+        bool serverOpen = true;
+
+        void send(const std::string &data) { toServer += data; }
+        std::string receive();
+    };
+
+    // Queued for WiFiServer::available() of that port
+    std::shared_ptr<Peer> connect(uint16_t port);
+}
+
+// Server end of a connection, copies share it like in the core
+class WiFiClient : public Stream
+{
+public:
+    WiFiClient() {}
+    explicit WiFiClient(std::shared_ptr<Host::Peer> peer) : _peer(peer) {}
+
+    int available() override;
+    int read() override;
+    int read(uint8_t *buffer, size_t length);
+    int peek() override;
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+    size_t write_P(PGM_P buffer, size_t size) { return write(reinterpret_cast<const uint8_t *>(buffer), size); }
+    int availableForWrite();
+    uint8_t connected();
+    void stop();
+    void setNoDelay(bool noDelay) {}
+    operator bool() const { return _peer != nullptr; }
+
+protected:
+    std::shared_ptr<Host::Peer> _peer;
+};
+
+class WiFiServer
+{
+public:
+    WiFiServer(uint16_t port) : _port(port) {}
+    void begin() {}
+    void setNoDelay(bool noDelay) {}
+    // Next queued connection, an empty client if there is none
+    WiFiClient available();
+
+protected:
+    uint16_t _port;
+};
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef HOST_WIFIUDP_H_
+#define HOST_WIFIUDP_H_
+
+#include <Arduino.h>
+#include <string>
+#include "IPAddress.h"
+
+// UDP over an in-process network: every socket of the test sees the packets sent to its
+// port, multicast only when it joined the group with the current WiFi.localIP().
+// Packets can be delayed and lost.
+class WiFiUDP : public Stream
+{
+public:
+    WiFiUDP();
+    ~WiFiUDP();
+
+    uint8_t begin(uint16_t port);
+    // ESP8266: interface address, group, port. ESP32: group, port.
+    uint8_t beginMulticast(IPAddress interfaceAddress, IPAddress group, uint16_t port);
+    uint8_t beginMulticast(IPAddress group, uint16_t port);
+    void stop();
+
+    int beginPacket(IPAddress address, uint16_t port);
+    int beginPacket(const char *host, uint16_t port);
+    int beginPacketMulticast(IPAddress group, uint16_t port, IPAddress interfaceAddress, int ttl = 1);
+    int beginMulticastPacket();
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+    int endPacket();
+
+    int parsePacket();
+    int available() override;
+    int read() override;
+    int read(uint8_t *buffer, size_t length);
+    int read(char *buffer, size_t length) { return read(reinterpret_cast<uint8_t *>(buffer), length); }
+    int peek() override;
+    void flush() override;
+    IPAddress remoteIP() const { return _remoteAddress; }
+    uint16_t remotePort() const { return _remotePort; }
+
+    // Test side, the address this socket sends from
+    IPAddress localAddress;
+
+protected:
+    uint16_t _port;
+    IPAddress _group;
+    IPAddress _sendAddress;
+    uint16_t _sendPort;
+    bool _sending;
+    std::string _out;
+    std::string _in;
+    size_t _inOffset;
+    IPAddress _remoteAddress;
+    uint16_t _remotePort;
+    void *_queue;
+};
+
+namespace Host
+{
+    // Delivery after this many µs on the virtual clock
+    extern uint32_t udpDelayMicros;
+    // Every nth packet is lost, 0 = none
+    extern uint32_t udpLossEvery;
+    // A multicast sender receives its own packets
+    extern bool udpMulticastLoop;
+    extern uint32_t udpSent;
+    extern uint32_t udpLost;
+    // Drops all queued packets and restores the defaults
+    void udpReset();
+}
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef HOST_LWIP_DNS_H_
+#define HOST_LWIP_DNS_H_
+
+#include "lwip/ip_addr.h"
+
+typedef void (*dns_found_callback)(const char *name, const ip_addr_t *address, void *arg);
+
+err_t dns_gethostbyname(const char *name, ip_addr_t *address, dns_found_callback found, void *arg);
+
+namespace Host
+{
+    enum DnsMode
+    {
+        DnsMode_Cached,  // Answered at once
+        DnsMode_Pending, // Answered by dnsAnswer()
+        DnsMode_Error,   // Rejected at once
+    };
+    extern DnsMode dnsMode;
+    // Answers the pending query, nullptr = host not found
+    void dnsAnswer(const ip_addr_t *address);
+}
+
+#endif
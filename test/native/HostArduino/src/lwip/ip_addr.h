@@ -0,0 +1,21 @@
+#ifndef HOST_LWIP_IP_ADDR_H_
+#define HOST_LWIP_IP_ADDR_H_
+
+#include <stdint.h>
+
+typedef struct
+{
+    uint32_t addr;
+} ip_addr_t;
+
+typedef signed char err_t;
+
+#define ERR_OK 0
+#define ERR_MEM -1
+#define ERR_INPROGRESS -5
+#define ERR_ARG -16
+#define ERR_ABRT -13
+#define ERR_RST -14
+#define ERR_CLSD -15
+
+#endif
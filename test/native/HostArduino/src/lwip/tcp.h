@@ -0,0 +1,69 @@
+#ifndef HOST_LWIP_TCP_H_
+#define HOST_LWIP_TCP_H_
+
+#include <stddef.h>
+#include <string>
+#include "lwip/ip_addr.h"
+
+// Raw lwIP API for the host tests. The test is the remote side: it accepts the
+// connection, reads what was written and delivers data, a close or an error.
+
+struct pbuf
+{
+    pbuf *next;
+    void *payload;
+    uint16_t tot_len;
+    uint16_t len;
+};
+
+struct tcp_pcb;
+typedef err_t (*tcp_connected_fn)(void *arg, tcp_pcb *pcb, err_t err);
+typedef err_t (*tcp_recv_fn)(void *arg, tcp_pcb *pcb, pbuf *p, err_t err);
+typedef void (*tcp_err_fn)(void *arg, err_t err);
+
+struct tcp_pcb
+{
+    void *arg;
+    tcp_connected_fn connected;
+    tcp_recv_fn recv;
+    tcp_err_fn errf;
+    ip_addr_t remote;
+    uint16_t port;
+    uint16_t sndbuf;
+    std::string written; // Everything tcp_write() took
+    size_t recved;       // Acknowledged with tcp_recved()
+    bool closed;
+};
+
+#define TCP_WRITE_FLAG_COPY 0x01
+
+tcp_pcb *tcp_new();
+void tcp_arg(tcp_pcb *pcb, void *arg);
+void tcp_err(tcp_pcb *pcb, tcp_err_fn errf);
+void tcp_recv(tcp_pcb *pcb, tcp_recv_fn recv);
+err_t tcp_connect(tcp_pcb *pcb, const ip_addr_t *address, uint16_t port, tcp_connected_fn connected);
+uint16_t tcp_sndbuf(tcp_pcb *pcb);
+err_t tcp_write(tcp_pcb *pcb, const void *data, uint16_t length, uint8_t flags);
+err_t tcp_output(tcp_pcb *pcb);
+void tcp_recved(tcp_pcb *pcb, uint16_t length);
+err_t tcp_close(tcp_pcb *pcb);
+void tcp_abort(tcp_pcb *pcb);
+uint8_t pbuf_free(pbuf *p);
+
+namespace Host
+{
+    // Last pcb of tcp_new(), pcbs stay valid until tcpReset()
+    extern tcp_pcb *tcpLast;
+    extern bool tcpNewFails;
+    extern uint16_t tcpSendBuffer;
+    void tcpReset();
+    void tcpAccept(tcp_pcb *pcb);
+    // Delivers the data in segments of at most segment bytes, one pbuf chain per call
+    void tcpDeliver(tcp_pcb *pcb, const char *data, size_t length, size_t segment = 536);
+    // Remote close, the receive callback gets a null pbuf
+    void tcpRemoteClose(tcp_pcb *pcb);
+    // Reset or abort, lwIP frees the pcb and calls the error callback
+    void tcpFail(tcp_pcb *pcb, err_t err);
+}
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef HOST_USER_INTERFACE_H_
+#define HOST_USER_INTERFACE_H_
+
+#include "Host.h"
+
+// ESP8266 SDK, the CPU clock only
+inline bool system_update_cpu_freq(uint8_t freq)
+{
+    Host::cpuMHz = freq;
+    return true;
+}
+
+#endif
@@ -0,0 +1,336 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <chrono>
+#include "Blitter.h"
+
+// The blitter against FastLED_NeoMatrix drawPixel() for every matrix type. Each side draws
+// into its own LED buffer, the buffers have to be identical. The remap is also checked
+// against LED indices worked out by hand from the wiring, and both ways are timed.
+
+#define BENCHMARK_FRAMES 10000
+#define BENCHMARK_ROUND 100 // Frames per clock reading, a reading costs about as much as a blitted frame
+// The host predicts the branches of XY() and keeps the gamma tables in its cache, it measures
+// 6-10x. On the ESP8266 (no branch prediction, software division for tiles) the gap is wider.
+#define BENCHMARK_SPEEDUP 5
+
+static CRGB reference[Geometry::pixels];
+static CRGB blitted[Geometry::pixels];
+static Blitter blitter;
+
+// Panel wiring per matrix type, as in setup()
+static FastLED_NeoMatrix *createMatrix(CRGB *leds, int matrixType)
+{
+    uint8_t panelWidth = Geometry::panelWidth;
+    uint8_t panelHeight = Geometry::panelHeight;
+    uint8_t panelLayout;
+    switch (matrixType)
+    {
+    default:
+        panelLayout = NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_COLUMNS + NEO_MATRIX_ZIGZAG;
+        break;
+    case 2:
+        panelLayout = NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS + NEO_MATRIX_ZIGZAG;
+        break;
+    case 3:
+        panelLayout = NEO_MATRIX_BOTTOM + NEO_MATRIX_LEFT + NEO_MATRIX_COLUMNS + NEO_MATRIX_PROGRESSIVE;
+        break;
+    case 4:
+        panelWidth = 8;
+        panelHeight = 8;
+        panelLayout = NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS + NEO_MATRIX_ZIGZAG;
+        break;
+    case 5:
+        panelWidth = 8;
+        panelHeight = 8;
+        panelLayout = NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS + NEO_MATRIX_PROGRESSIVE;
+        break;
+    }
+    return new FastLED_NeoMatrix(leds, panelWidth, panelHeight, Geometry::width / panelWidth, Geometry::height / panelHeight, panelLayout + MATRIX_TILE_LAYOUT);
+}
+
+static void assertSame(int matrixType)
+{
+    char message[32];
+    for (uint16_t i = 0; i < Geometry::pixels; i++)
+    {
+        snprintf(message, sizeof(message), "type %d led %u", matrixType, i);
+        TEST_ASSERT_EQUAL_HEX32_MESSAGE(reference[i].r << 16 | reference[i].g << 8 | reference[i].b, blitted[i].r << 16 | blitted[i].g << 8 | blitted[i].b, message);
+    }
+}
+
+static void clear()
+{
+    std::fill(reference, reference + Geometry::pixels, CRGB(CRGB::Black));
+    std::fill(blitted, blitted + Geometry::pixels, CRGB(CRGB::Black));
+}
+
+static void eachType(void (*check)(FastLED_NeoMatrix &matrix, int matrixType))
+{
+    for (int matrixType = 1; matrixType <= 5; matrixType++)
+    {
+        FastLED_NeoMatrix *matrix = createMatrix(reference, matrixType);
+        FastLED_NeoMatrix *blitterMatrix = createMatrix(blitted, matrixType);
+        blitter.begin(blitterMatrix, blitted);
+        clear();
+        check(*matrix, matrixType);
+        delete matrix;
+        delete blitterMatrix;
+    }
+}
+
+void setUp()
+{
+    randomSeed(1);
+}
+
+void tearDown() {}
+
+static void checkPermutation(FastLED_NeoMatrix &matrix, int matrixType)
+{
+    static bool used[Geometry::pixels];
+    std::fill(used, used + Geometry::pixels, false);
+    for (uint16_t i = 0; i < Geometry::pixels; i++)
+    {
+        TEST_ASSERT_LESS_THAN(Geometry::pixels, blitter.map()[i]);
+        TEST_ASSERT_FALSE(used[blitter.map()[i]]);
+        used[blitter.map()[i]] = true;
+    }
+}
+
+void test_map_is_a_permutation()
+{
+    eachType(checkPermutation);
+}
+
+// LED index of a few pixels per matrix type, counted on the wiring of the panels
+struct KnownIndex
+{
+    int matrixType;
+    int16_t x;
+    int16_t y;
+    uint16_t index;
+};
+
+static const KnownIndex knownIndices[] = {
+#if MATRIX_WIDTH == 32 && MATRIX_HEIGHT == 8
+    // One 32x8 panel, columns top down, every second one bottom up
+    {1, 0, 0, 0},
+    {1, 0, 7, 7},
+    {1, 1, 0, 15},
+    {1, 1, 7, 8},
+    {1, 31, 0, 255},
+    {1, 31, 7, 248},
+    // Rows left to right, every second one right to left
+    {2, 31, 0, 31},
+    {2, 0, 1, 63},
+    {2, 31, 1, 32},
+    {2, 5, 7, 250},
+    // Columns bottom up
+    {3, 0, 7, 0},
+    {3, 0, 0, 7},
+    {3, 1, 7, 8},
+    {3, 31, 0, 255},
+    // Four 8x8 panels in a row, rows zigzag inside each
+    {4, 9, 0, 65},
+    {4, 9, 1, 78},
+    {4, 31, 7, 248},
+    // Four 8x8 panels, rows left to right
+    {5, 9, 1, 73},
+    {5, 23, 4, 167},
+    {5, 31, 7, 255},
+#elif MATRIX_WIDTH == 64 && MATRIX_HEIGHT == 16
+    // 2x2 panels of 32x8, panel order left to right, top to bottom
+    {1, 0, 0, 0},
+    {1, 33, 0, 271},
+    {1, 0, 8, 512},
+    {1, 63, 15, 1016},
+    {2, 31, 1, 32},
+    {2, 32, 1, 319},
+    {2, 40, 12, 1024 - 256 + 4 * 32 + 8},
+    {3, 0, 7, 0},
+    {3, 32, 15, 768},
+    {3, 63, 8, 1023},
+    // 8x2 panels of 8x8
+    {4, 10, 9, 589},
+    {4, 63, 15, 1016},
+    {5, 10, 9, 586},
+    {5, 63, 15, 1023},
+#endif
+};
+
+static void checkKnownIndices(FastLED_NeoMatrix &matrix, int matrixType)
+{
+    char message[48];
+    for (const KnownIndex &known : knownIndices)
+    {
+        if (known.matrixType == matrixType)
+        {
+            snprintf(message, sizeof(message), "type %d x %d y %d", matrixType, known.x, known.y);
+            TEST_ASSERT_EQUAL_MESSAGE(known.index, blitter.index(known.x, known.y), message);
+        }
+    }
+}
+
+void test_map_matches_the_wiring()
+{
+    TEST_ASSERT_GREATER_THAN(0, sizeof(knownIndices) / sizeof(knownIndices[0]));
+    eachType(checkKnownIndices);
+}
+
+static void checkPixels(FastLED_NeoMatrix &matrix, int matrixType)
+{
+    // Every pixel, and over the loop every RGB565 value once
+    for (uint32_t color = 0; color < 0x10000; color++)
+    {
+        int16_t x = color % Geometry::width;
+        int16_t y = (color / Geometry::width) % Geometry::height;
+        matrix.drawPixel(x, y, color);
+        blitter.drawPixel(x, y, (uint16_t)color);
+        if (x == Geometry::width - 1 && y == Geometry::height - 1)
+        {
+            assertSame(matrixType);
+        }
+    }
+    assertSame(matrixType);
+}
+
+void test_every_pixel_and_color()
+{
+    eachType(checkPixels);
+}
+
+static void checkClipping(FastLED_NeoMatrix &matrix, int matrixType)
+{
+    const int16_t outside[][2] = {{-1, 0}, {0, -1}, {Geometry::width, 0}, {0, Geometry::height}, {-32768, 5}, {Geometry::width, Geometry::height}};
+    for (const int16_t *p : outside)
+    {
+        matrix.drawPixel(p[0], p[1], 0xFFFF);
+        blitter.drawPixel(p[0], p[1], (uint16_t)0xFFFF);
+        blitter.drawPixel(p[0], p[1], CRGB(CRGB::White));
+    }
+    assertSame(matrixType);
+}
+
+void test_clipped_pixels()
+{
+    eachType(checkClipping);
+}
+
+static void checkBitmaps(FastLED_NeoMatrix &matrix, int matrixType)
+{
+    static uint16_t bitmap[Geometry::bitmapPixels];
+    for (uint16_t &pixel : bitmap)
+    {
+        pixel = random(0x10000);
+    }
+    // Partly outside on every side
+    for (int16_t y = -Geometry::height; y <= Geometry::height; y += 3)
+    {
+        for (int16_t x = -Geometry::height; x <= Geometry::width; x++)
+        {
+            for (int16_t j = 0; j < Geometry::height; j++)
+            {
+                for (int16_t i = 0; i < Geometry::height; i++)
+                {
+                    matrix.drawPixel(x + i, y + j, bitmap[j * Geometry::height + i]);
+                }
+            }
+            blitter.drawBitmap(x, y, bitmap, Geometry::height, Geometry::height);
+        }
+        assertSame(matrixType);
+    }
+}
+
+void test_bitmaps_at_every_position()
+{
+    eachType(checkBitmaps);
+}
+
+static std::chrono::steady_clock::duration::rep nanos(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void report(const char *what, int matrixType, std::chrono::steady_clock::duration::rep pixel, std::chrono::steady_clock::duration::rep blitted)
+{
+    char message[64];
+    printf("type %d %ux%u %-7s: drawRGBBitmap %7.2f us/frame, Blitter %7.2f us/frame, %5.1fx\n", matrixType, Geometry::width, Geometry::height, what,
+           pixel / 1000.0 / BENCHMARK_FRAMES, blitted / 1000.0 / BENCHMARK_FRAMES, (double)pixel / blitted);
+    snprintf(message, sizeof(message), "type %d %s: Blitter less than %dx faster", matrixType, what, BENCHMARK_SPEEDUP);
+    TEST_ASSERT_GREATER_OR_EQUAL_MESSAGE(BENCHMARK_SPEEDUP * blitted, pixel, message);
+}
+
+// Full frames (the frame buffer of a screen) and the full width in icons, through the
+// drawRGBBitmap() -> writePixel() -> drawPixel() calls the renderer made before the blitter. Both ways alternate in rounds, so changes of the host load hit both.
+static void benchmark(FastLED_NeoMatrix &matrix, int matrixType)
+{
+    static uint16_t frame[Geometry::pixels];
+    static uint16_t bitmap[Geometry::bitmapPixels];
+    for (uint16_t &pixel : frame)
+    {
+        pixel = random(0x10000);
+    }
+    for (uint16_t &pixel : bitmap)
+    {
+        pixel = random(0x10000);
+    }
+
+    std::chrono::steady_clock::duration::rep framePixel = 0, frameBlitted = 0, bitmapPixel = 0, bitmapBlitted = 0;
+    for (uint16_t round = 0; round < BENCHMARK_FRAMES / BENCHMARK_ROUND; round++)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (uint16_t n = 0; n < BENCHMARK_ROUND; n++)
+        {
+            matrix.drawRGBBitmap(0, 0, frame, Geometry::width, Geometry::height);
+        }
+        framePixel += nanos(start);
+
+        start = std::chrono::steady_clock::now();
+        for (uint16_t n = 0; n < BENCHMARK_ROUND; n++)
+        {
+            blitter.drawBitmap(0, 0, frame, Geometry::width, Geometry::height);
+        }
+        frameBlitted += nanos(start);
+
+        start = std::chrono::steady_clock::now();
+        for (uint16_t n = 0; n < BENCHMARK_ROUND; n++)
+        {
+            for (int16_t x = 0; x < Geometry::width; x += Geometry::height)
+            {
+                matrix.drawRGBBitmap(x, 0, bitmap, Geometry::height, Geometry::height);
+            }
+        }
+        bitmapPixel += nanos(start);
+
+        start = std::chrono::steady_clock::now();
+        for (uint16_t n = 0; n < BENCHMARK_ROUND; n++)
+        {
+            for (int16_t x = 0; x < Geometry::width; x += Geometry::height)
+            {
+                blitter.drawBitmap(x, 0, bitmap, Geometry::height, Geometry::height);
+            }
+        }
+        bitmapBlitted += nanos(start);
+    }
+    assertSame(matrixType);
+
+    report("frame", matrixType, framePixel, frameBlitted);
+    report("bitmaps", matrixType, bitmapPixel, bitmapBlitted);
+}
+
+void test_blitter_speedup()
+{
+    eachType(benchmark);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_map_is_a_permutation);
+    RUN_TEST(test_map_matches_the_wiring);
+    RUN_TEST(test_every_pixel_and_color);
+    RUN_TEST(test_clipped_pixels);
+    RUN_TEST(test_bitmaps_at_every_position);
+    RUN_TEST(test_blitter_speedup);
+    return UNITY_END();
+}
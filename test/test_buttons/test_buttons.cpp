@@ -0,0 +1,182 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "Buttons.h"
+
+// Recorded bounce traces through the interrupt, queue, debounce and gesture path
+
+static Buttons buttons;
+static const uint8_t pins[BUTTONS_COUNT] = {4, 5, 16}; // GPIO16 has no interrupt and is polled
+static const int pressedLevels[BUTTONS_COUNT] = {LOW, LOW, LOW};
+static const bool enabled[BUTTONS_COUNT] = {true, true, true};
+
+static char events[64];
+static uint8_t eventCount;
+
+static void record(uint8_t button, btnEvents event)
+{
+    // One letter per event, upper case for the first button
+    static const char names[] = "RPSLDT";
+    if (eventCount < sizeof(events) - 1)
+    {
+        events[eventCount++] = button == 0 ? names[event] : tolower(names[event]);
+        events[eventCount] = '\0';
+    }
+}
+
+// Runs loop() every millisecond like the main loop does
+static void run(uint32_t ms)
+{
+    for (uint32_t i = 0; i < ms; i++)
+    {
+        Host::advance(1);
+        buttons.loop();
+    }
+}
+
+// Contact bounce: the level toggles every few hundred µs before it settles
+static void bounce(uint8_t pin, int level, uint8_t bounces)
+{
+    for (uint8_t i = 0; i < bounces; i++)
+    {
+        Host::setPin(pin, level);
+        Host::advanceMicros(300);
+        Host::setPin(pin, !level);
+        Host::advanceMicros(500);
+    }
+    Host::setPin(pin, level);
+}
+
+static void click(uint8_t pin, uint32_t pressMs, uint8_t bounces)
+{
+    bounce(pin, LOW, bounces);
+    run(pressMs);
+    bounce(pin, HIGH, bounces);
+}
+
+void setUp()
+{
+    Host::setMicros(1000000);
+    for (uint8_t b = 0; b < BUTTONS_COUNT; b++)
+    {
+        Host::setPin(pins[b], HIGH);
+    }
+    buttons.begin(pins, pressedLevels, enabled);
+    buttons.setCallback(record);
+    eventCount = 0;
+    events[0] = '\0';
+}
+
+void tearDown()
+{
+}
+
+void test_bouncing_click_is_one_short_press()
+{
+    click(4, 120, 6);
+    run(100);
+    TEST_ASSERT_EQUAL_STRING("PRS", events);
+}
+
+void test_short_press_is_not_delayed_without_double_press()
+{
+    click(4, 80, 3);
+    // Debounce of the release only
+    run(BUTTONS_DEBOUNCE_MS);
+    TEST_ASSERT_EQUAL_STRING("PRS", events);
+}
+
+void test_glitch_shorter_than_debounce_is_ignored()
+{
+    bounce(4, LOW, 4);
+    run(BUTTONS_DEBOUNCE_MS / 2);
+    bounce(4, HIGH, 2);
+    run(200);
+    TEST_ASSERT_EQUAL_STRING("", events);
+}
+
+void test_double_press()
+{
+    buttons.setDoublePressEnabled(0, true);
+    click(4, 80, 5);
+    run(120);
+    click(4, 80, 5);
+    run(500);
+    TEST_ASSERT_EQUAL_STRING("PRPRD", events);
+}
+
+void test_single_click_waits_for_double_press_timeout()
+{
+    buttons.setDoublePressEnabled(0, true);
+    click(4, 80, 5);
+    run(BUTTONS_DOUBLEPRESS_MS);
+    TEST_ASSERT_EQUAL_STRING("PR", events);
+    run(BUTTONS_DEBOUNCE_MS + 5);
+    TEST_ASSERT_EQUAL_STRING("PRS", events);
+}
+
+void test_long_press_repeats_and_has_no_short_press()
+{
+    click(4, BUTTONS_LONGPRESS_MS + 3 * BUTTONS_REPEAT_MS + 50, 4);
+    run(400);
+    TEST_ASSERT_EQUAL_STRING("PLTTTR", events);
+}
+
+void test_polled_pin_without_interrupt()
+{
+    click(16, 100, 6);
+    run(100);
+    TEST_ASSERT_EQUAL_STRING("prs", events);
+}
+
+void test_buttons_are_independent()
+{
+    bounce(4, LOW, 3);
+    run(20);
+    bounce(5, LOW, 3);
+    run(100);
+    bounce(4, HIGH, 3);
+    run(100);
+    bounce(5, HIGH, 3);
+    run(100);
+    TEST_ASSERT_EQUAL_STRING("PpRSrs", events);
+}
+
+void test_queue_overflow_resyncs_from_the_pin()
+{
+    // A long burst without loop() in between, more edges than the queue holds
+    bounce(4, LOW, BUTTONS_QUEUE_SIZE * 2);
+    run(100);
+    bounce(4, HIGH, BUTTONS_QUEUE_SIZE * 2);
+    run(100);
+    TEST_ASSERT_EQUAL_STRING("PRS", events);
+}
+
+void test_recorded_trace_fed_through_edge()
+{
+    // Timestamps in ms of a real switch, pressed for about 150 ms
+    static const uint32_t trace[][2] = {{1000, LOW}, {1001, HIGH}, {1001, LOW}, {1003, HIGH}, {1004, LOW}, {1152, HIGH}, {1153, LOW}, {1153, HIGH}, {1155, LOW}, {1156, HIGH}};
+    Host::setMicros(999000);
+    for (size_t i = 0; i < sizeof(trace) / sizeof(trace[0]); i++)
+    {
+        run(trace[i][0] - millis());
+        buttons.edge(0, trace[i][1], trace[i][0]);
+    }
+    run(100);
+    TEST_ASSERT_EQUAL_STRING("PRS", events);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_bouncing_click_is_one_short_press);
+    RUN_TEST(test_short_press_is_not_delayed_without_double_press);
+    RUN_TEST(test_glitch_shorter_than_debounce_is_ignored);
+    RUN_TEST(test_double_press);
+    RUN_TEST(test_single_click_waits_for_double_press_timeout);
+    RUN_TEST(test_long_press_repeats_and_has_no_short_press);
+    RUN_TEST(test_polled_pin_without_interrupt);
+    RUN_TEST(test_buttons_are_independent);
+    RUN_TEST(test_queue_overflow_resyncs_from_the_pin);
+    RUN_TEST(test_recorded_trace_fed_through_edge);
+    return UNITY_END();
+}
@@ -0,0 +1,434 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <deque>
+#include <vector>
+#include "DFPlayer.h"
+
+// The driver against a simulated DFPlayer Mini on the serial port. The module behaves like
+// the real one as far as the driver cares: it reads the SD card for a while after power on
+// and ignores commands until then (1.5 s by default), frames take 10 ms on the wire at 9600 baud, answers come
+// ~20 ms later, commands faster than 100 ms after the last one are dropped, and busy errors,
+// lost acknowledgements and line noise can be switched on.
+
+#define MODULE_READY 1500 // ms after power on
+#define MODULE_FRAME_TIME 11 // ms for 10 bytes at 9600 baud
+#define MODULE_ANSWER_DELAY 20 // ms
+#define MODULE_MIN_SPACING 100 // ms, a command that follows faster is lost
+#define MODULE_TRACK_LENGHT 5000 // ms
+
+struct ModuleCommand
+{
+    unsigned long time;
+    uint8_t command;
+    uint16_t param;
+};
+
+class SimulatedModule : public Stream
+{
+public:
+    bool present = true;
+    unsigned long readyAfter = MODULE_READY;
+    uint8_t busyErrors = 0;   // The next n play commands answer busy
+    uint8_t lostAcks = 0;     // The next n acknowledgements are not sent
+    bool noise = false;       // Garbage and a broken frame in front of every answer
+    std::vector<ModuleCommand> executed;
+    uint16_t ignored = 0; // Commands before the SD card was read
+    uint16_t lost = 0;    // Commands dropped because they came too fast
+    uint8_t volume = 0;
+    uint16_t track = 0;
+    uint8_t status = 0; // 0 stopped, 1 playing, 2 paused
+
+    void powerOn()
+    {
+        _powerOn = millis();
+        _ready = false;
+        _lastCommand = 0;
+        _input.clear();
+        _output.clear();
+    }
+
+    // Module side, called every millisecond
+    void loop()
+    {
+        if (!present)
+        {
+            return;
+        }
+        if (!_ready && millis() - _powerOn >= readyAfter)
+        {
+            _ready = true;
+            answer(0x3F, 0x0002);
+        }
+        if (status == 1 && millis() - _trackStart >= MODULE_TRACK_LENGHT)
+        {
+            status = 0;
+            answer(0x3D, track);
+        }
+    }
+
+    int available() override
+    {
+        int count = 0;
+        for (const std::pair<unsigned long, uint8_t> &b : _output)
+        {
+            if ((long)(millis() - b.first) < 0)
+            {
+                break;
+            }
+            count++;
+        }
+        return count;
+    }
+
+    int read() override
+    {
+        if (available() == 0)
+        {
+            return -1;
+        }
+        uint8_t b = _output.front().second;
+        _output.pop_front();
+        return b;
+    }
+
+    size_t write(uint8_t b) override
+    {
+        _input.push_back(b);
+        if (_input.size() == DFPLAYER_FRAME_LENGHT)
+        {
+            receive();
+            _input.clear();
+        }
+        return 1;
+    }
+    using Print::write;
+
+protected:
+    unsigned long _powerOn;
+    bool _ready;
+    unsigned long _lastCommand;
+    unsigned long _trackStart;
+    std::vector<uint8_t> _input;
+    std::deque<std::pair<unsigned long, uint8_t>> _output;
+
+    void receive()
+    {
+        uint16_t checksum = (_input[7] << 8) | _input[8];
+        for (uint8_t i = 1; i < 7; i++)
+        {
+            checksum += _input[i];
+        }
+        TEST_ASSERT_EQUAL_HEX8(0x7E, _input[0]);
+        TEST_ASSERT_EQUAL_HEX8(0xEF, _input[9]);
+        TEST_ASSERT_EQUAL_HEX16_MESSAGE(0, checksum, "checksum");
+
+        // The frame is complete when its last byte has arrived
+        unsigned long now = millis() + MODULE_FRAME_TIME;
+        if (!present)
+        {
+            return;
+        }
+        if (!_ready)
+        {
+            ignored++;
+            return;
+        }
+        if (_lastCommand != 0 && now - _lastCommand < MODULE_MIN_SPACING)
+        {
+            lost++;
+            return;
+        }
+        _lastCommand = now;
+
+        uint8_t command = _input[3];
+        bool feedback = _input[4];
+        uint16_t param = (_input[5] << 8) | _input[6];
+        if (command == 0x42)
+        {
+            answer(0x42, 0x0200 | status);
+            return;
+        }
+        if ((command == 0x03 || command == 0x0F) && busyErrors > 0)
+        {
+            busyErrors--;
+            answer(0x40, 0x01);
+            return;
+        }
+
+        executed.push_back({now, command, param});
+        switch (command)
+        {
+        case 0x01:
+            play(track + 1);
+            break;
+        case 0x02:
+            play(track > 1 ? track - 1 : 1);
+            break;
+        case 0x03:
+            play(param);
+            break;
+        case 0x0F:
+            play(param & 0xFF);
+            break;
+        case 0x06:
+            volume = param;
+            break;
+        case 0x0D:
+            status = 1;
+            break;
+        case 0x0E:
+            status = 2;
+            break;
+        case 0x16:
+            status = 0;
+            break;
+        }
+        if (feedback)
+        {
+            if (lostAcks > 0)
+            {
+                lostAcks--;
+            }
+            else
+            {
+                answer(0x41, 0);
+            }
+        }
+    }
+
+    void play(uint16_t number)
+    {
+        track = number;
+        status = 1;
+        _trackStart = millis();
+    }
+
+    void answer(uint8_t command, uint16_t param)
+    {
+        unsigned long at = millis() + MODULE_FRAME_TIME + MODULE_ANSWER_DELAY;
+        if (noise)
+        {
+            // A stray byte and a frame cut short, like after a brown out of the module
+            const uint8_t garbage[] = {0x00, 0x7E, 0xFF, 0x06, 0x41};
+            for (uint8_t b : garbage)
+            {
+                _output.push_back({at, b});
+            }
+        }
+        uint8_t frame[DFPLAYER_FRAME_LENGHT] = {0x7E, 0xFF, 0x06, command, 0, (uint8_t)(param >> 8), (uint8_t)param, 0, 0, 0xEF};
+        uint16_t checksum = 0;
+        for (uint8_t i = 1; i < 7; i++)
+        {
+            checksum -= frame[i];
+        }
+        frame[7] = checksum >> 8;
+        frame[8] = checksum;
+        for (uint8_t b : frame)
+        {
+            _output.push_back({at, b});
+        }
+    }
+};
+
+static SimulatedModule module;
+static DFPlayer player;
+static DFPlayerState states[16];
+static uint8_t stateCount;
+
+static void stateChanged(DFPlayerState state)
+{
+    if (stateCount < sizeof(states) / sizeof(states[0]))
+    {
+        states[stateCount++] = state;
+    }
+}
+
+// Module and main loop, one pass per millisecond
+static void run(uint32_t ms)
+{
+    for (uint32_t i = 0; i < ms; i++)
+    {
+        Host::advance(1);
+        module.loop();
+        player.loop();
+    }
+}
+
+static void checkSpacing()
+{
+    for (size_t i = 1; i < module.executed.size(); i++)
+    {
+        unsigned long gap = module.executed[i].time - module.executed[i - 1].time;
+        TEST_ASSERT_GREATER_OR_EQUAL(module.executed[i - 1].command == 0x06 ? DFPLAYER_VOLUME_SPACING : DFPLAYER_COMMAND_SPACING, gap);
+    }
+}
+
+void setUp()
+{
+    Host::setMicros(1000000);
+    module = SimulatedModule();
+    module.powerOn();
+    player = DFPlayer();
+    stateCount = 0;
+    player.setCallback(stateChanged);
+    player.begin(module);
+}
+
+void tearDown() {}
+
+void test_startup()
+{
+    // Queued at boot like in the sketch, the two volume changes become one
+    player.volume(10);
+    player.volume(20);
+    player.play(3);
+    TEST_ASSERT_TRUE(player.busy());
+    run(MODULE_READY - 10);
+    TEST_ASSERT_EQUAL(0, module.executed.size());
+
+    run(2000);
+    TEST_ASSERT_EQUAL(2, module.executed.size());
+    TEST_ASSERT_EQUAL_HEX8(0x06, module.executed[0].command);
+    TEST_ASSERT_EQUAL(20, module.volume);
+    TEST_ASSERT_EQUAL_HEX8(0x03, module.executed[1].command);
+    TEST_ASSERT_EQUAL(3, module.track);
+    TEST_ASSERT_EQUAL(DFPlayerState_Playing, player.state());
+    TEST_ASSERT_FALSE(player.busy());
+    TEST_ASSERT_EQUAL(0, module.lost);
+    TEST_ASSERT_EQUAL(0, player.errors());
+    checkSpacing();
+}
+
+void test_bursts_keep_the_spacing()
+{
+    run(2000);
+    // A burst from the web UI, nothing may get lost on the module
+    player.play(1);
+    player.volume(5);
+    player.pause();
+    player.resume();
+    player.playNext();
+    player.volume(15);
+    player.playPrevious();
+    run(2000);
+
+    TEST_ASSERT_EQUAL(0, module.lost);
+    TEST_ASSERT_EQUAL(0, player.dropped());
+    TEST_ASSERT_EQUAL(6, module.executed.size());
+    TEST_ASSERT_EQUAL(15, module.volume);
+    TEST_ASSERT_EQUAL(1, module.track);
+    TEST_ASSERT_EQUAL(DFPlayerState_Playing, player.state());
+    checkSpacing();
+
+    // More than the queue holds
+    for (uint8_t i = 0; i < DFPLAYER_QUEUE_LENGHT + 3; i++)
+    {
+        player.play(i + 1);
+    }
+    TEST_ASSERT_EQUAL(3, player.dropped());
+    run(3000);
+    TEST_ASSERT_EQUAL(DFPLAYER_QUEUE_LENGHT, module.track);
+    checkSpacing();
+}
+
+void test_busy_and_lost_acks_are_retried()
+{
+    run(2000);
+    // The status queries before the module was ready
+    uint16_t timeouts = player.timeouts();
+    module.busyErrors = 1;
+    player.play(7);
+    run(500);
+    TEST_ASSERT_EQUAL(1, player.errors());
+    TEST_ASSERT_EQUAL_HEX8(0x01, player.lastError());
+    TEST_ASSERT_EQUAL(7, module.track);
+    TEST_ASSERT_EQUAL(DFPlayerState_Playing, player.state());
+
+    // Executed but not acknowledged, sent again after the timeout
+    module.lostAcks = 1;
+    player.pause();
+    run(1000);
+    TEST_ASSERT_EQUAL(timeouts + 1, player.timeouts());
+    TEST_ASSERT_EQUAL(3, module.executed.size());
+    TEST_ASSERT_EQUAL_HEX8(0x0E, module.executed[1].command);
+    TEST_ASSERT_EQUAL_HEX8(0x0E, module.executed[2].command);
+    TEST_ASSERT_EQUAL(DFPlayerState_Paused, player.state());
+
+    // Next is not repeated, it would skip a track
+    module.lostAcks = 1;
+    player.playNext();
+    run(1000);
+    TEST_ASSERT_EQUAL(timeouts + 2, player.timeouts());
+    TEST_ASSERT_EQUAL(8, module.track);
+    TEST_ASSERT_FALSE(player.busy());
+    checkSpacing();
+}
+
+void test_track_end_and_noise()
+{
+    module.noise = true;
+    player.play(2);
+    run(2000);
+    uint16_t timeouts = player.timeouts();
+    TEST_ASSERT_EQUAL(DFPlayerState_Playing, player.state());
+    run(MODULE_TRACK_LENGHT);
+    TEST_ASSERT_EQUAL(DFPlayerState_Stopped, player.state());
+    TEST_ASSERT_EQUAL(0, player.errors());
+    TEST_ASSERT_EQUAL(timeouts, player.timeouts());
+
+    const DFPlayerState expected[] = {DFPlayerState_Stopped, DFPlayerState_Playing, DFPlayerState_Stopped};
+    TEST_ASSERT_EQUAL(3, stateCount);
+    TEST_ASSERT_EQUAL_INT_ARRAY(expected, states, 3);
+}
+
+void test_slow_sd_card()
+{
+    // Only the status queries go unanswered while the module reads the card
+    module.readyAfter = DFPLAYER_DETECT_TIMEOUT - 1000;
+    player.volume(10);
+    player.play(4);
+    run(module.readyAfter - 10);
+    TEST_ASSERT_EQUAL(0, stateCount);
+    TEST_ASSERT_GREATER_THAN(0, module.ignored);
+    TEST_ASSERT_EQUAL(0, module.executed.size());
+
+    run(1000);
+    TEST_ASSERT_EQUAL(2, module.executed.size());
+    TEST_ASSERT_EQUAL(4, module.track);
+    TEST_ASSERT_EQUAL(DFPlayerState_Playing, player.state());
+    TEST_ASSERT_EQUAL(0, module.lost);
+}
+
+void test_module_missing()
+{
+    module.present = false;
+    player.volume(10);
+    player.play(1);
+    run(DFPLAYER_DETECT_TIMEOUT - DFPLAYER_ACK_TIMEOUT);
+    TEST_ASSERT_EQUAL(0, stateCount);
+    TEST_ASSERT_TRUE(player.busy());
+
+    // Reported once, the queue is cleared and loop() has nothing to wait for
+    run(DFPLAYER_ACK_TIMEOUT * 2);
+    TEST_ASSERT_EQUAL(1, stateCount);
+    TEST_ASSERT_EQUAL(DFPlayerState_Offline, states[0]);
+    TEST_ASSERT_EQUAL(DFPlayerState_Offline, player.state());
+    TEST_ASSERT_FALSE(player.busy());
+
+    player.play(2);
+    run(1000);
+    TEST_ASSERT_FALSE(player.busy());
+    TEST_ASSERT_EQUAL(1, stateCount);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_startup);
+    RUN_TEST(test_bursts_keep_the_spacing);
+    RUN_TEST(test_busy_and_lost_acks_are_retried);
+    RUN_TEST(test_track_end_and_noise);
+    RUN_TEST(test_slow_sd_card);
+    RUN_TEST(test_module_missing);
+    return UNITY_END();
+}
@@ -0,0 +1,124 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <chrono>
+#include "EffectEngine.h"
+
+// Frame cost of every effect (step and draw) over the whole matrix, and the zone and
+// background rules. The host is far faster than the device, the µs/frame are for comparing
+// the effects and spotting regressions.
+
+#define FRAMES 5000
+
+static CRGB leds[Geometry::pixels];
+static FastLED_NeoMatrix matrix(leds, Geometry::panelWidth, Geometry::panelHeight, Geometry::panelsX, Geometry::panelsY,
+                                NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_COLUMNS + NEO_MATRIX_ZIGZAG + MATRIX_TILE_LAYOUT);
+static Blitter blitter;
+static EffectEngine effects;
+
+static void clear()
+{
+    std::fill(leds, leds + Geometry::pixels, CRGB(CRGB::Black));
+}
+
+void setUp()
+{
+    static bool started = false;
+    if (!started)
+    {
+        blitter.begin(&matrix, leds);
+        effects.begin(&blitter);
+        started = true;
+    }
+    Host::setMicros(1000000);
+    random16_set_seed(1337);
+    clear();
+}
+
+void tearDown()
+{
+    effects.stop();
+}
+
+void test_frame_cost_per_effect()
+{
+    uint8_t spectrum[16];
+    for (uint8_t i = 0; i < 16; i++)
+    {
+        spectrum[i] = i * 16;
+    }
+
+    for (int type = EffectType_None + 1; type < EffectType_Count; type++)
+    {
+        effects.start((EffectType)type, 0, 0, Geometry::width, Geometry::height);
+        std::chrono::steady_clock::duration total{};
+        std::chrono::steady_clock::duration worst{};
+        uint32_t lit = 0;
+        for (int frame = 0; frame < FRAMES; frame++)
+        {
+            Host::advance(effects.interval());
+            if (type == EffectType_Spectrum && frame % 3 == 0)
+            {
+                effects.setSpectrum(spectrum, sizeof(spectrum));
+            }
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            effects.step();
+            effects.draw();
+            std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+            total += elapsed;
+            worst = std::max(worst, elapsed);
+            for (const CRGB &led : leds)
+            {
+                lit += (bool)led;
+            }
+        }
+        double average = std::chrono::duration<double, std::micro>(total).count() / FRAMES;
+        printf("%-10s %ux%u: %7.2f us/frame, max %7.2f us, %3u%% lit\n", EffectEngine::typeName((EffectType)type), Geometry::width, Geometry::height,
+               average, std::chrono::duration<double, std::micro>(worst).count(), (unsigned)(lit * 100 / FRAMES / Geometry::pixels));
+
+        // Something is drawn, and far below the frame interval even scaled to the device
+        TEST_ASSERT_GREATER_THAN(0, lit);
+        TEST_ASSERT_LESS_THAN(EFFECT_DEFAULT_INTERVAL * 1000 / 50, average);
+    }
+}
+
+void test_zone_is_clipped_and_kept()
+{
+    effects.start(EffectType_Plasma, -4, 2, 12, 100);
+    effects.step();
+    effects.draw();
+    for (uint16_t y = 0; y < Geometry::height; y++)
+    {
+        for (uint16_t x = 0; x < Geometry::width; x++)
+        {
+            bool inside = x < 8 && y >= 2;
+            TEST_ASSERT_EQUAL_MESSAGE(inside, (bool)leds[blitter.index(x, y)], inside ? "inside" : "outside");
+        }
+    }
+
+    effects.start(EffectType_Fire, Geometry::width, 0, 8, 8);
+    TEST_ASSERT_FALSE(effects.active());
+}
+
+void test_background_keeps_the_foreground()
+{
+    effects.start(EffectType_Plasma, 0, 0, Geometry::width, Geometry::height);
+    effects.setBackground(true);
+    leds[blitter.index(3, 4)] = CRGB(1, 2, 3);
+    effects.capture();
+    for (int frame = 0; frame < 10; frame++)
+    {
+        effects.step();
+        effects.draw();
+        TEST_ASSERT_TRUE(leds[blitter.index(3, 4)] == CRGB(1, 2, 3));
+        TEST_ASSERT_TRUE((bool)leds[blitter.index(4, 4)]);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_frame_cost_per_effect);
+    RUN_TEST(test_zone_is_clipped_and_kept);
+    RUN_TEST(test_background_keeps_the_foreground);
+    return UNITY_END();
+}
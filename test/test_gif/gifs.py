@@ -0,0 +1,184 @@
+import random
+import struct
+
+# Writes the reference GIFs of test_gif.cpp and the frames they have to decode to
+# (<name>.rgb565: every frame composed on the full screen, RGB565 little endian).
+# The encoder and the compositing follow the GIF89a specification, independent of
+# src/GifDecoder.cpp.
+#
+# Usage (in test/test_gif): python gifs.py
+
+random.seed(30)
+
+
+def lzw(indices, min_code_size):
+    clear = 1 << min_code_size
+    table = {(i,): i for i in range(clear)}
+    next_code = clear + 2
+    size = min_code_size + 1
+    codes = [(clear, size)]
+    current = ()
+    for index in indices:
+        extended = current + (index,)
+        if extended in table:
+            current = extended
+            continue
+        codes.append((table[current], size))
+        if next_code < 4096:
+            table[extended] = next_code
+            next_code += 1
+            if next_code - 1 == 1 << size and size < 12:
+                size += 1
+        current = (index,)
+    codes.append((table[current], size))
+    codes.append((clear + 1, size))
+
+    data = bytearray()
+    bits = 0
+    count = 0
+    for code, size in codes:
+        bits |= code << count
+        count += size
+        while count >= 8:
+            data.append(bits & 0xFF)
+            bits >>= 8
+            count -= 8
+    if count > 0:
+        data.append(bits)
+    return bytes(data)
+
+
+def rgb565(color):
+    r, g, b = color
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)
+
+
+def table_bits(palette):
+    bits = 1
+    while 1 << bits < len(palette):
+        bits += 1
+    return bits
+
+
+def color_table(palette):
+    bits = table_bits(palette)
+    padded = palette + [(0, 0, 0)] * ((1 << bits) - len(palette))
+    return b''.join(bytes(c) for c in padded), bits
+
+
+def random_palette(count):
+    return [(random.randrange(256), random.randrange(256), random.randrange(256)) for _ in range(count)]
+
+
+class Gif:
+    def __init__(self, width, height, palette=None, version=b'GIF89a', loops=None):
+        self.width = width
+        self.height = height
+        self.palette = palette
+        self.data = bytearray(version)
+        flags = 0
+        table = b''
+        if palette is not None:
+            table, bits = color_table(palette)
+            flags = 0x80 | (bits - 1)
+        self.data += struct.pack('<HHBBB', width, height, flags, 0, 0) + table
+        if loops is not None:
+            self.data += b'\x21\xff\x0bNETSCAPE2.0\x03\x01' + struct.pack('<H', loops) + b'\x00'
+        # Spec compositing: the canvas, and the state to restore for disposal 3
+        self.canvas = [0] * (width * height)
+        self.frames = []
+        self.restore = None
+
+    def frame(self, x, y, w, h, pixels, palette=None, transparent=None, disposal=0, delay=0, interlaced=False):
+        if transparent is not None or disposal or delay:
+            flags = (disposal << 2) | (1 if transparent is not None else 0)
+            self.data += b'\x21\xf9\x04' + bytes([flags]) + struct.pack('<H', delay) + bytes([transparent or 0]) + b'\x00'
+        flags = 0x40 if interlaced else 0
+        table = b''
+        if palette is not None:
+            table, bits = color_table(palette)
+            flags |= 0x80 | (bits - 1)
+        self.data += b'\x2c' + struct.pack('<HHHHB', x, y, w, h, flags) + table
+
+        rows = list(range(h))
+        if interlaced:
+            rows = list(range(0, h, 8)) + list(range(4, h, 8)) + list(range(2, h, 4)) + list(range(1, h, 2))
+        stream = [index for row in rows for index in pixels[row * w:(row + 1) * w]]
+        colors = palette if palette is not None else self.palette
+        min_code_size = max(2, table_bits(colors))
+        packed = lzw(stream, min_code_size)
+        self.data += bytes([min_code_size])
+        for i in range(0, len(packed), 255):
+            chunk = packed[i:i + 255]
+            self.data += bytes([len(chunk)]) + chunk
+        self.data += b'\x00'
+
+        before = list(self.canvas)
+        for row in range(h):
+            for column in range(w):
+                index = pixels[row * w + column]
+                if index != transparent:
+                    self.canvas[(y + row) * self.width + x + column] = rgb565(colors[index])
+        self.frames.append((list(self.canvas), delay * 10))
+        if disposal == 2:
+            for row in range(h):
+                for column in range(w):
+                    self.canvas[(y + row) * self.width + x + column] = 0
+        elif disposal == 3:
+            self.canvas = before
+
+    def save(self, name, frames=True):
+        self.data += b'\x3b'
+        with open(name + '.gif', 'wb') as f:
+            f.write(self.data)
+        if frames:
+            with open(name + '.rgb565', 'wb') as f:
+                for canvas, delay in self.frames:
+                    f.write(struct.pack('<H', delay))
+                    f.write(struct.pack('<%dH' % len(canvas), *canvas))
+
+
+def pixels(count, colors, transparent=None):
+    return [random.randrange(colors) if transparent is None or random.randrange(3) else transparent for _ in range(count)]
+
+
+# Global palette only, GIF87a without extensions, the whole screen
+gif = Gif(8, 8, random_palette(4), version=b'GIF87a')
+gif.frame(0, 0, 8, 8, pixels(64, 4))
+gif.save('global')
+
+# Local palettes, the global one again for the last frame
+gif = Gif(8, 8, random_palette(2))
+gif.frame(0, 0, 8, 8, pixels(64, 2), disposal=1)
+gif.frame(2, 3, 4, 3, pixels(12, 8), palette=random_palette(8), disposal=1)
+gif.frame(5, 0, 3, 8, pixels(24, 32), palette=random_palette(32), disposal=1)
+gif.frame(0, 6, 8, 2, pixels(16, 2))
+gif.save('local')
+
+# Interlaced, all four passes and a part image that ends in the second pass
+gif = Gif(8, 8, random_palette(16))
+gif.frame(0, 0, 8, 8, pixels(64, 16), interlaced=True, disposal=1)
+gif.frame(1, 2, 6, 5, pixels(30, 16), interlaced=True)
+gif.save('interlaced')
+
+# Transparency with every disposal method
+gif = Gif(8, 8, random_palette(8))
+gif.frame(0, 0, 8, 8, pixels(64, 8), disposal=1, delay=10)
+gif.frame(1, 1, 5, 5, pixels(25, 8, 7), transparent=7, disposal=2, delay=20)
+gif.frame(0, 0, 8, 8, pixels(64, 8, 3), transparent=3, disposal=1, delay=5)
+gif.frame(2, 0, 6, 4, pixels(24, 8, 0), transparent=0, disposal=3, delay=7)
+gif.frame(0, 4, 8, 4, pixels(32, 8, 5), transparent=5, delay=100)
+gif.save('transparent')
+
+# More frames than the animation store holds (10), the rest is skipped
+gif = Gif(8, 8, random_palette(4), loops=3)
+gif.frame(0, 0, 8, 8, pixels(64, 4), disposal=1, delay=4)
+for i in range(11):
+    gif.frame(i % 8, i // 8, 1, 1, [i % 4], disposal=1, delay=4 + i)
+gif.frames = gif.frames[:10]
+gif.save('multiframe')
+
+# One pixel wider than square on the 16 row builds, also too large for 8 rows
+gif = Gif(17, 16, random_palette(2))
+gif.frame(0, 0, 17, 16, pixels(17 * 16, 2))
+gif.save('oversize', frames=False)
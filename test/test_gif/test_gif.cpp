@@ -0,0 +1,157 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "GifDecoder.h"
+
+// The GIF decoder against reference GIFs made by gifs.py, frame store and delays
+// sized like animationBmpList and animationBmpDelays in the sketch. Every <name>.rgb565
+// holds the delay and the composed RGB565 screen of each frame the decoder has to keep.
+
+#define FIXTURES "test/test_gif/"
+#define MAX_FRAMES 10
+
+static GifDecoder decoder;
+static uint16_t frames[MAX_FRAMES][Geometry::bitmapPixels];
+static uint16_t delays[MAX_FRAMES];
+
+static std::vector<uint8_t> readFile(const std::string &path)
+{
+    std::vector<uint8_t> data;
+    FILE *file = fopen(path.c_str(), "rb");
+    TEST_ASSERT_NOT_NULL_MESSAGE(file, path.c_str());
+    uint8_t buffer[4096];
+    for (size_t length; (length = fread(buffer, 1, sizeof(buffer), file)) > 0;)
+    {
+        data.insert(data.end(), buffer, buffer + length);
+    }
+    fclose(file);
+    return data;
+}
+
+// Fed in pieces of the given size, like the upload handler gets it. The decoder
+// works in its own arrays, the heap must not move while it runs.
+static GifDecoderStatus decode(const std::string &name, size_t piece)
+{
+    std::vector<uint8_t> gif = readFile(FIXTURES + name + ".gif");
+    memset(frames, 0xAA, sizeof(frames));
+    memset(delays, 0xAA, sizeof(delays));
+
+    Host::resetHeapPeak();
+    size_t live = Host::heap.live;
+    uint32_t allocations = Host::heap.allocations;
+
+    decoder.begin(&frames[0][0], Geometry::bitmapPixels, MAX_FRAMES, delays);
+    GifDecoderStatus status = GifDecoderStatus_Decoding;
+    for (size_t at = 0; at < gif.size() && status == GifDecoderStatus_Decoding; at += piece)
+    {
+        status = decoder.write(gif.data() + at, piece < gif.size() - at ? piece : gif.size() - at);
+    }
+
+    TEST_ASSERT_EQUAL_MESSAGE(allocations, Host::heap.allocations, "GifDecoder allocated");
+    TEST_ASSERT_EQUAL_MESSAGE(live, Host::heap.peak, "GifDecoder heap peak");
+    return status;
+}
+
+static void checkFrames(const std::string &name, uint16_t width, uint16_t height)
+{
+    std::vector<uint8_t> expected = readFile(FIXTURES + name + ".rgb565");
+    size_t frameBytes = 2 + width * height * 2;
+    TEST_ASSERT_EQUAL_MESSAGE(0, expected.size() % frameBytes, name.c_str());
+    uint8_t count = expected.size() / frameBytes;
+
+    static const size_t pieces[] = {1, 3, 16, 255, 4096};
+    for (size_t piece : pieces)
+    {
+        std::string message = name + " in pieces of " + std::to_string(piece);
+        TEST_ASSERT_EQUAL_MESSAGE(GifDecoderStatus_Done, decode(name, piece), message.c_str());
+        TEST_ASSERT_EQUAL_MESSAGE(width, decoder.width(), message.c_str());
+        TEST_ASSERT_EQUAL_MESSAGE(height, decoder.height(), message.c_str());
+        TEST_ASSERT_EQUAL_MESSAGE(count, decoder.frameCount(), message.c_str());
+
+        for (uint8_t frame = 0; frame < count; frame++)
+        {
+            const uint8_t *data = expected.data() + frame * frameBytes;
+            std::string frameMessage = message + ", frame " + std::to_string(frame);
+            TEST_ASSERT_EQUAL_MESSAGE(data[0] | (data[1] << 8), delays[frame], frameMessage.c_str());
+            for (uint16_t pixel = 0; pixel < width * height; pixel++)
+            {
+                uint16_t color = data[2 + pixel * 2] | (data[3 + pixel * 2] << 8);
+                std::string pixelMessage = frameMessage + ", pixel " + std::to_string(pixel);
+                TEST_ASSERT_EQUAL_HEX16_MESSAGE(color, frames[frame][pixel], pixelMessage.c_str());
+            }
+        }
+    }
+}
+
+static void test_global_palette()
+{
+    checkFrames("global", 8, 8);
+    TEST_ASSERT_EQUAL(0, decoder.loops());
+}
+
+static void test_local_palette()
+{
+    checkFrames("local", 8, 8);
+}
+
+static void test_interlaced()
+{
+    checkFrames("interlaced", 8, 8);
+}
+
+static void test_transparency_and_disposal()
+{
+    checkFrames("transparent", 8, 8);
+}
+
+// 12 frames, the two that do not fit the frame store are skipped
+static void test_multiple_frames()
+{
+    checkFrames("multiframe", 8, 8);
+    TEST_ASSERT_EQUAL(MAX_FRAMES, decoder.frameCount());
+    TEST_ASSERT_EQUAL(3, decoder.loops());
+}
+
+// 17x16 exceeds GIFDECODER_MAX_PIXELS of every matrix size, rejected at the screen descriptor
+static void test_too_large()
+{
+    TEST_ASSERT_GREATER_THAN(GIFDECODER_MAX_PIXELS, 17 * 16);
+    TEST_ASSERT_EQUAL(GifDecoderStatus_ErrorTooLarge, decode("oversize", 4096));
+    TEST_ASSERT_EQUAL(GifDecoderStatus_ErrorTooLarge, decoder.status());
+    TEST_ASSERT_EQUAL(0, decoder.frameCount());
+    TEST_ASSERT_EQUAL_HEX16(0xAAAA, frames[0][0]);
+
+    // Further data is ignored
+    static const uint8_t trailer[] = {0x3B};
+    TEST_ASSERT_EQUAL(GifDecoderStatus_ErrorTooLarge, decoder.write(trailer, sizeof(trailer)));
+}
+
+static void test_truncated()
+{
+    std::vector<uint8_t> gif = readFile(FIXTURES "transparent.gif");
+    decoder.begin(&frames[0][0], Geometry::bitmapPixels, MAX_FRAMES, delays);
+    TEST_ASSERT_EQUAL(GifDecoderStatus_Decoding, decoder.write(gif.data(), gif.size() - 1));
+
+    static const uint8_t png[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    decoder.begin(&frames[0][0], Geometry::bitmapPixels, MAX_FRAMES, delays);
+    TEST_ASSERT_EQUAL(GifDecoderStatus_ErrorFormat, decoder.write(png, sizeof(png)));
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_global_palette);
+    RUN_TEST(test_local_palette);
+    RUN_TEST(test_interlaced);
+    RUN_TEST(test_transparency_and_disposal);
+    RUN_TEST(test_multiple_frames);
+    RUN_TEST(test_too_large);
+    RUN_TEST(test_truncated);
+    return UNITY_END();
+}
@@ -0,0 +1,133 @@
+#include <unity.h>
+#include <stdio.h>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "Heatshrink.h"
+
+// The OTA decoder against images from the build. program.bin is the code section of a
+// native build of the firmware sources, program.bin.hs made from it by .github/heatshrink.py.
+// The firmware images of the board builds (.pio/build/*/firmware_*.bin.hs, written by
+// extra_script.py) are decoded as well when they are there, CI runs this after the build.
+
+#define FIXTURE "test/test_heatshrink/program.bin"
+
+static HeatshrinkDecoder decoder;
+static std::vector<uint8_t> decoded;
+static size_t largestCallback;
+
+static std::vector<uint8_t> readFile(const std::string &path)
+{
+    std::vector<uint8_t> data;
+    FILE *file = fopen(path.c_str(), "rb");
+    TEST_ASSERT_NOT_NULL_MESSAGE(file, path.c_str());
+    uint8_t buffer[4096];
+    for (size_t length; (length = fread(buffer, 1, sizeof(buffer), file)) > 0;)
+    {
+        data.insert(data.end(), buffer, buffer + length);
+    }
+    fclose(file);
+    return data;
+}
+
+static void onDecoded(const uint8_t *data, size_t length)
+{
+    decoded.insert(decoded.end(), data, data + length);
+    largestCallback = length > largestCallback ? length : largestCallback;
+}
+
+// Fed in pieces of the given size, 0 for random ones up to a TCP segment
+static void decode(const std::vector<uint8_t> &packed, size_t piece)
+{
+    decoder.reset();
+    decoded.clear();
+    largestCallback = 0;
+    srand(piece + 1);
+    for (size_t at = 0; at < packed.size();)
+    {
+        size_t length = piece > 0 ? piece : rand() % 1460 + 1;
+        length = length < packed.size() - at ? length : packed.size() - at;
+        decoder.write(packed.data() + at, length);
+        at += length;
+    }
+}
+
+static void checkImage(const std::string &binary, size_t piece)
+{
+    std::vector<uint8_t> image = readFile(binary);
+    decode(readFile(binary + ".hs"), piece);
+    TEST_ASSERT_EQUAL_MESSAGE(image.size(), decoder.total(), binary.c_str());
+    TEST_ASSERT_EQUAL_MESSAGE(image.size(), decoded.size(), binary.c_str());
+    TEST_ASSERT_TRUE_MESSAGE(decoded == image, binary.c_str());
+    TEST_ASSERT_LESS_OR_EQUAL(HEATSHRINK_WINDOW_LENGHT, largestCallback);
+}
+
+void setUp()
+{
+    decoder.setCallback(onDecoded);
+}
+
+void tearDown() {}
+
+void test_fixture_in_one_write()
+{
+    checkImage(FIXTURE, SIZE_MAX);
+}
+
+void test_fixture_byte_by_byte()
+{
+    checkImage(FIXTURE, 1);
+}
+
+void test_fixture_in_upload_pieces()
+{
+    // Odd sizes split the bit fields everywhere, 1460 is what an upload delivers per segment
+    checkImage(FIXTURE, 3);
+    checkImage(FIXTURE, 1460);
+    checkImage(FIXTURE, 0);
+}
+
+void test_reset_between_images()
+{
+    std::vector<uint8_t> packed = readFile(FIXTURE ".hs");
+    decode(std::vector<uint8_t>(packed.begin(), packed.begin() + packed.size() / 2), 512);
+    checkImage(FIXTURE, 512);
+}
+
+void test_firmware_images()
+{
+    std::vector<std::string> images;
+    std::error_code error;
+    for (const std::filesystem::directory_entry &build : std::filesystem::directory_iterator(".pio/build", error))
+    {
+        for (const std::filesystem::directory_entry &file : std::filesystem::directory_iterator(build.path(), error))
+        {
+            std::string name = file.path().filename().string();
+            if (name.rfind("firmware_", 0) == 0 && name.size() > 7 && name.compare(name.size() - 7, 7, ".bin.hs") == 0)
+            {
+                images.push_back(file.path().string());
+            }
+        }
+    }
+    if (images.empty())
+    {
+        TEST_IGNORE_MESSAGE("No firmware images, build the board environments first");
+    }
+    for (const std::string &packed : images)
+    {
+        std::string binary = packed.substr(0, packed.size() - 3);
+        checkImage(binary, 0);
+        printf("%s: %u bytes\n", binary.c_str(), (unsigned)decoded.size());
+    }
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_fixture_in_one_write);
+    RUN_TEST(test_fixture_byte_by_byte);
+    RUN_TEST(test_fixture_in_upload_pieces);
+    RUN_TEST(test_reset_between_images);
+    RUN_TEST(test_firmware_images);
+    return UNITY_END();
+}
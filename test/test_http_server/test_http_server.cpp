@@ -0,0 +1,272 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <chrono>
+#include <algorithm>
+#include <vector>
+#include "HttpServer.h"
+
+// Clients on the host TCP shim against the server, polled like from loop()
+
+static HttpServer server(80);
+static std::string fileContent;
+static int served;
+
+static void handleText()
+{
+    served++;
+    server.send(200, F("text/plain"), server.header(F("If-None-Match")));
+}
+
+static void handleFile()
+{
+    served++;
+    File file = Host::openFile(fileContent);
+    server.send(200, F("application/octet-stream"), file, file.size());
+    file.close();
+}
+
+static void collect()
+{
+    // Gone after the call, the server has to keep its own copy
+    char key[] = "If-None-Match";
+    const char *keys[] = {key};
+    server.collectHeaders(keys, 1);
+    memset(key, 'x', sizeof(key) - 1);
+}
+
+static std::string get(const char *path, const std::string &headers = "")
+{
+    return std::string("GET ") + path + " HTTP/1.1\r\nHost: pixelit\r\n" + headers + "\r\n";
+}
+
+static std::string statusLine(const std::string &response)
+{
+    return response.substr(0, response.find("\r\n"));
+}
+
+static std::string body(const std::string &response)
+{
+    size_t end = response.find("\r\n\r\n");
+    return end == std::string::npos ? std::string() : response.substr(end + 4);
+}
+
+static std::string roundTrip(const std::string &request)
+{
+    std::shared_ptr<Host::Peer> peer = Host::connect(80);
+    peer->send(request);
+    std::string response;
+    for (int i = 0; i < 200; i++)
+    {
+        server.loop();
+        response += peer->receive();
+    }
+    peer->clientOpen = false;
+    server.loop();
+    return response;
+}
+
+void setUp()
+{
+    static bool started = false;
+    if (!started)
+    {
+        server.on(F("/text"), HttpServerMethod_Get, handleText);
+        server.on(F("/file"), HttpServerMethod_Any, handleFile);
+        collect();
+        server.begin();
+        started = true;
+    }
+    Host::setMicros(1000000);
+    served = 0;
+    fileContent.clear();
+    for (int i = 0; i < 20000; i++)
+    {
+        fileContent += (char)('a' + i % 26);
+    }
+}
+
+void tearDown()
+{
+    // Every connection idle and closed
+    Host::advance(HTTPSERVER_KEEPALIVE_TIMEOUT);
+    server.loop();
+}
+
+void test_collected_header_keys_are_copied()
+{
+    std::string response = roundTrip(get("/text", "If-None-Match: \"abc\"\r\n"));
+    TEST_ASSERT_EQUAL_STRING("HTTP/1.1 200 OK", statusLine(response).c_str());
+    TEST_ASSERT_EQUAL_STRING("\"abc\"", body(response).c_str());
+}
+
+void test_long_headers_not_needed_are_skipped()
+{
+    std::string cookie = "Cookie: " + std::string(2000, 'c') + "\r\n";
+    std::string response = roundTrip(get("/text", cookie + "If-None-Match: 1\r\n" + cookie));
+    TEST_ASSERT_EQUAL_STRING("HTTP/1.1 200 OK", statusLine(response).c_str());
+    TEST_ASSERT_EQUAL_STRING("1", body(response).c_str());
+}
+
+void test_long_needed_headers_and_uris_are_rejected()
+{
+    std::string response = roundTrip(get("/text", "If-None-Match: " + std::string(HTTPSERVER_LINE_LENGHT, '1') + "\r\n"));
+    TEST_ASSERT_EQUAL_STRING("HTTP/1.1 431 Request Header Fields Too Large", statusLine(response).c_str());
+
+    response = roundTrip(get(("/text?" + std::string(HTTPSERVER_LINE_LENGHT, 'q')).c_str()));
+    TEST_ASSERT_EQUAL_STRING("HTTP/1.1 414 URI Too Long", statusLine(response).c_str());
+    TEST_ASSERT_EQUAL(0, served);
+}
+
+void test_file_is_sent_in_chunks_from_the_loop()
+{
+    std::shared_ptr<Host::Peer> peer = Host::connect(80);
+    peer->send(get("/file"));
+    server.loop();
+    std::string response = peer->receive();
+    TEST_ASSERT_EQUAL_STRING("HTTP/1.1 200 OK", statusLine(response).c_str());
+    TEST_ASSERT_EQUAL(1, Host::filesOpen);
+
+    // One chunk per pass, nothing while the client does not read
+    size_t before = body(response).size();
+    TEST_ASSERT_LESS_OR_EQUAL(HTTPSERVER_CHUNK_LENGHT, before);
+    for (int i = 0; i < 20; i++)
+    {
+        server.loop();
+    }
+    size_t buffered = peer->toClient.size();
+    TEST_ASSERT_LESS_OR_EQUAL(peer->sendBuffer, buffered);
+    server.loop();
+    TEST_ASSERT_EQUAL(buffered, peer->toClient.size());
+    TEST_ASSERT_TRUE(server.active());
+
+    // A pipelined request waits for the end of the file
+    peer->send(get("/text", "If-None-Match: 2\r\n"));
+    response += peer->receive();
+    while (Host::filesOpen > 0)
+    {
+        size_t length = response.size();
+        server.loop();
+        response += peer->receive();
+        TEST_ASSERT_LESS_OR_EQUAL(HTTPSERVER_CHUNK_LENGHT, response.size() - length);
+    }
+    TEST_ASSERT_TRUE(body(response) == fileContent);
+
+    server.loop();
+    response = peer->receive();
+    TEST_ASSERT_EQUAL_STRING("HTTP/1.1 200 OK", statusLine(response).c_str());
+    TEST_ASSERT_EQUAL_STRING("2", body(response).c_str());
+    TEST_ASSERT_EQUAL(2, served);
+}
+
+void test_stalled_download_is_closed()
+{
+    std::shared_ptr<Host::Peer> peer = Host::connect(80);
+    peer->send(get("/file"));
+    for (int i = 0; i < 10; i++)
+    {
+        server.loop();
+    }
+    TEST_ASSERT_EQUAL(1, Host::filesOpen);
+    Host::advance(HTTPSERVER_REQUEST_TIMEOUT);
+    server.loop();
+    TEST_ASSERT_EQUAL(0, Host::filesOpen);
+    TEST_ASSERT_FALSE(peer->serverOpen);
+}
+
+void test_head_sends_no_file()
+{
+    std::string response = roundTrip("HEAD /file HTTP/1.1\r\n\r\n");
+    TEST_ASSERT_EQUAL_STRING("HTTP/1.1 200 OK", statusLine(response).c_str());
+    TEST_ASSERT_TRUE(response.find("Content-Length: 20000\r\n") != std::string::npos);
+    TEST_ASSERT_EQUAL(0, body(response).size());
+    TEST_ASSERT_EQUAL(0, Host::filesOpen);
+}
+
+void test_load_and_loop_jitter()
+{
+    // Keep-alive clients request as fast as they can while one downloads the file over and
+    // over. Every pass of server.loop() is time the render loop waits for.
+    std::vector<std::shared_ptr<Host::Peer>> peers;
+    for (int i = 0; i < HTTPSERVER_MAX_CONNECTIONS; i++)
+    {
+        peers.push_back(Host::connect(80));
+        peers.back()->send(get(i == 0 ? "/file" : "/text"));
+    }
+
+    std::vector<double> passes;
+    size_t maxBytes = 0;
+    int files = 0;
+    std::string download;
+    std::chrono::steady_clock::duration total{};
+    for (int pass = 0; pass < 20000; pass++)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        server.loop();
+        std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+        total += elapsed;
+        passes.push_back(std::chrono::duration<double, std::micro>(elapsed).count());
+        Host::advanceMicros(100);
+
+        size_t bytes = 0;
+        for (size_t i = 0; i < peers.size(); i++)
+        {
+            std::string response = peers[i]->receive();
+            bytes += response.size();
+            if (i == 0)
+            {
+                download += response;
+                size_t end = download.find("\r\n\r\n");
+                if (end != std::string::npos && download.size() - end - 4 >= fileContent.size())
+                {
+                    TEST_ASSERT_TRUE(download.substr(end + 4) == fileContent);
+                    download.clear();
+                    files++;
+                    peers[i]->send(get("/file"));
+                }
+            }
+            else if (response.size() > 0)
+            {
+                peers[i]->send(get("/text"));
+            }
+
+            // Closed after HTTPSERVER_KEEPALIVE_MAX_REQUESTS, the last response was complete
+            if (!peers[i]->serverOpen)
+            {
+                peers[i] = Host::connect(80);
+                peers[i]->send(get(i == 0 ? "/file" : "/text"));
+                if (i == 0)
+                {
+                    download.clear();
+                }
+            }
+        }
+        maxBytes = std::max(maxBytes, bytes);
+    }
+
+    // Bounded work per pass: a header plus a chunk per connection
+    TEST_ASSERT_LESS_OR_EQUAL(HTTPSERVER_MAX_CONNECTIONS * (HTTPSERVER_CHUNK_LENGHT + 256), maxBytes);
+    TEST_ASSERT_GREATER_THAN(0, files);
+
+    std::sort(passes.begin(), passes.end());
+    double seconds = std::chrono::duration<double>(total).count();
+    printf("HttpServer load: %d requests, %.0f requests/s, loop pass p50 %.1f us, p99 %.1f us, max %.1f us, %d files, max %u bytes per pass\n",
+           served, served / seconds, passes[passes.size() / 2], passes[passes.size() * 99 / 100], passes.back(), files, (unsigned)maxBytes);
+
+    for (std::shared_ptr<Host::Peer> &peer : peers)
+    {
+        peer->clientOpen = false;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_collected_header_keys_are_copied);
+    RUN_TEST(test_long_headers_not_needed_are_skipped);
+    RUN_TEST(test_long_needed_headers_and_uris_are_rejected);
+    RUN_TEST(test_file_is_sent_in_chunks_from_the_loop);
+    RUN_TEST(test_stalled_download_is_closed);
+    RUN_TEST(test_head_sends_no_file);
+    RUN_TEST(test_load_and_loop_jitter);
+    return UNITY_END();
+}
@@ -0,0 +1,253 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <lwip/dns.h>
+#include <lwip/tcp.h>
+#include "HttpTask.h"
+
+// HttpTask against a stub server on the host lwIP: the test accepts, reads the request and answers
+
+static HttpTask http;
+static HttpTaskResponse response;
+static std::string body;
+static int responses;
+
+static void record(const HttpTaskResponse &result)
+{
+    response = result;
+    body.assign(result.body, result.bodyLength);
+    responses++;
+}
+
+static void loops(int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        Host::advance(1);
+        http.loop();
+    }
+}
+
+// Runs a request up to the point where the stub has the complete request
+static tcp_pcb *connectAndSend()
+{
+    loops(1);
+    tcp_pcb *pcb = Host::tcpLast;
+    TEST_ASSERT_NOT_NULL(pcb);
+    Host::tcpAccept(pcb);
+    loops(1);
+    return pcb;
+}
+
+static void answer(tcp_pcb *pcb, const std::string &text, size_t segment = 536)
+{
+    Host::tcpDeliver(pcb, text.data(), text.length(), segment);
+    Host::tcpRemoteClose(pcb);
+    loops(1);
+}
+
+void setUp()
+{
+    Host::tcpReset();
+    http.begin(1000);
+    responses = 0;
+    body.clear();
+}
+
+void tearDown()
+{
+}
+
+void test_get_request_and_response()
+{
+    TEST_ASSERT_TRUE(http.get("example.org", 80, "/api/lastversion", record));
+    tcp_pcb *pcb = connectAndSend();
+
+    TEST_ASSERT_EQUAL(80, pcb->port);
+    TEST_ASSERT_EQUAL_STRING("GET /api/lastversion HTTP/1.0\r\nHost: example.org\r\nUser-Agent: PixelIt\r\nConnection: close\r\n\r\n", pcb->written.c_str());
+
+    answer(pcb, "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n\r\n{\"version\":\"3.0.0\"}");
+    TEST_ASSERT_EQUAL(1, responses);
+    TEST_ASSERT_EQUAL(HttpTaskResult_Ok, response.result);
+    TEST_ASSERT_EQUAL(200, response.statusCode);
+    TEST_ASSERT_EQUAL_STRING("{\"version\":\"3.0.0\"}", body.c_str());
+    TEST_ASSERT_FALSE(response.truncated);
+    TEST_ASSERT_TRUE(pcb->closed);
+    TEST_ASSERT_FALSE(http.busy());
+}
+
+void test_post_is_sent_over_several_loops()
+{
+    String payload = "{\"data\":\"";
+    for (int i = 0; i < 600; i++)
+    {
+        payload += "x";
+    }
+    payload += "\"}";
+    TEST_ASSERT_TRUE(http.post("example.org", 8080, "/api/telemetry", payload, record));
+    Host::tcpSendBuffer = 256;
+    loops(1);
+    tcp_pcb *pcb = Host::tcpLast;
+    Host::tcpAccept(pcb);
+    loops(1);
+    TEST_ASSERT_EQUAL(256, pcb->written.length());
+    loops(5);
+
+    size_t bodyAt = pcb->written.find("\r\n\r\n");
+    TEST_ASSERT_TRUE(bodyAt != std::string::npos);
+    TEST_ASSERT_EQUAL_STRING(payload.c_str(), pcb->written.c_str() + bodyAt + 4);
+    TEST_ASSERT_TRUE(pcb->written.find("Content-Length: " + std::to_string(payload.length()) + "\r\n") != std::string::npos);
+
+    answer(pcb, "HTTP/1.0 204 No Content\r\n\r\n");
+    TEST_ASSERT_EQUAL(204, response.statusCode);
+    TEST_ASSERT_EQUAL(0, response.bodyLength);
+}
+
+void test_large_headers_do_not_push_the_body_out()
+{
+    // More header than the whole response buffer, in small segments that split the "\r\n\r\n"
+    std::string text = "HTTP/1.1 200 OK\r\nSet-Cookie: " + std::string(700, 'c') + "\r\nContent-Security-Policy: " + std::string(400, 'p') + "\r\n\r\n{\"version\":\"3.1.0\"}";
+    TEST_ASSERT_TRUE(HTTPTASK_RESPONSE_LENGHT < 1100);
+
+    http.get("example.org", 80, "/", record);
+    answer(connectAndSend(), text, 7);
+    TEST_ASSERT_EQUAL(200, response.statusCode);
+    TEST_ASSERT_EQUAL_STRING("{\"version\":\"3.1.0\"}", body.c_str());
+    TEST_ASSERT_FALSE(response.truncated);
+    TEST_ASSERT_EQUAL(body.length(), response.receivedLength);
+}
+
+void test_large_body_is_reported_as_truncated()
+{
+    std::string content(HTTPTASK_RESPONSE_LENGHT + 100, 'b');
+    http.get("example.org", 80, "/", record);
+    tcp_pcb *pcb = connectAndSend();
+    answer(pcb, "HTTP/1.1 200 OK\r\n\r\n" + content);
+
+    TEST_ASSERT_TRUE(response.truncated);
+    TEST_ASSERT_EQUAL(HTTPTASK_RESPONSE_LENGHT - 1, response.bodyLength);
+    TEST_ASSERT_EQUAL(content.length(), response.receivedLength);
+    // Everything was acknowledged, the window must not stall
+    TEST_ASSERT_EQUAL(19 + content.length(), pcb->recved);
+}
+
+void test_invalid_and_incomplete_responses()
+{
+    http.get("example.org", 80, "/", record);
+    answer(connectAndSend(), "SSH-2.0-OpenSSH\r\n\r\nbanner");
+    TEST_ASSERT_EQUAL(-1, response.statusCode);
+    TEST_ASSERT_EQUAL(0, response.bodyLength);
+
+    // Connection closed within the header
+    http.get("example.org", 80, "/", record);
+    answer(connectAndSend(), "HTTP/1.1 500 Internal Server Error\r\nServer: x");
+    TEST_ASSERT_EQUAL(500, response.statusCode);
+    TEST_ASSERT_EQUAL(0, response.bodyLength);
+
+    // Bare LF line ends
+    http.get("example.org", 80, "/", record);
+    answer(connectAndSend(), "HTTP/1.0 404 Not Found\nServer: x\n\nmissing");
+    TEST_ASSERT_EQUAL(404, response.statusCode);
+    TEST_ASSERT_EQUAL_STRING("missing", body.c_str());
+}
+
+void test_dns_pending_and_failed()
+{
+    Host::dnsMode = Host::DnsMode_Pending;
+    http.get("example.org", 80, "/", record);
+    loops(10);
+    TEST_ASSERT_NULL(Host::tcpLast);
+
+    ip_addr_t address = {0x0200000A};
+    Host::dnsAnswer(&address);
+    loops(1);
+    TEST_ASSERT_NOT_NULL(Host::tcpLast);
+    TEST_ASSERT_EQUAL_HEX32(0x0200000A, Host::tcpLast->remote.addr);
+    answer(connectAndSend(), "HTTP/1.1 200 OK\r\n\r\n");
+    TEST_ASSERT_EQUAL(HttpTaskResult_Ok, response.result);
+
+    http.get("unknown.invalid", 80, "/", record);
+    loops(1);
+    Host::dnsAnswer(nullptr);
+    loops(1);
+    TEST_ASSERT_EQUAL(HttpTaskResult_DnsFailed, response.result);
+
+    Host::dnsMode = Host::DnsMode_Error;
+    http.get("example.org", 80, "/", record);
+    loops(2);
+    TEST_ASSERT_EQUAL(HttpTaskResult_DnsFailed, response.result);
+    TEST_ASSERT_EQUAL(3, responses);
+}
+
+void test_timeout_and_connection_errors()
+{
+    // Never accepted
+    http.get("example.org", 80, "/", record);
+    loops(999);
+    TEST_ASSERT_EQUAL(0, responses);
+    loops(2);
+    TEST_ASSERT_EQUAL(1, responses);
+    TEST_ASSERT_EQUAL(HttpTaskResult_Timeout, response.result);
+    TEST_ASSERT_TRUE(Host::tcpLast->closed);
+
+    // Refused
+    http.get("example.org", 80, "/", record);
+    loops(1);
+    Host::tcpFail(Host::tcpLast, ERR_RST);
+    loops(1);
+    TEST_ASSERT_EQUAL(HttpTaskResult_ConnectFailed, response.result);
+
+    // Reset in the middle of the request
+    http.get("example.org", 80, "/", record);
+    tcp_pcb *pcb = connectAndSend();
+    Host::tcpDeliver(pcb, "HTTP/1.1 200 OK\r\n", 17);
+    Host::tcpFail(pcb, ERR_ABRT);
+    loops(1);
+    TEST_ASSERT_EQUAL(HttpTaskResult_Ok, response.result);
+    TEST_ASSERT_EQUAL(200, response.statusCode);
+}
+
+void test_queued_requests_run_one_after_another()
+{
+    TEST_ASSERT_TRUE(http.get("a.example.org", 80, "/1", record));
+    TEST_ASSERT_TRUE(http.get("b.example.org", 80, "/2", record));
+    for (int i = 2; i < HTTPTASK_QUEUE_SIZE; i++)
+    {
+        TEST_ASSERT_TRUE(http.get("c.example.org", 80, "/n", record));
+    }
+    TEST_ASSERT_FALSE(http.get("d.example.org", 80, "/full", record));
+
+    answer(connectAndSend(), "HTTP/1.1 201 Created\r\n\r\n1");
+    TEST_ASSERT_EQUAL(201, response.statusCode);
+    tcp_pcb *pcb = connectAndSend();
+    TEST_ASSERT_TRUE(pcb->written.find("GET /2 ") == 0);
+    answer(pcb, "HTTP/1.1 202 Accepted\r\n\r\n2");
+    TEST_ASSERT_EQUAL_STRING("2", body.c_str());
+    TEST_ASSERT_TRUE(http.busy());
+}
+
+void test_out_of_memory_retries_until_timeout()
+{
+    Host::tcpNewFails = true;
+    http.get("example.org", 80, "/", record);
+    loops(100);
+    TEST_ASSERT_EQUAL(0, responses);
+    Host::tcpNewFails = false;
+    loops(1);
+    answer(connectAndSend(), "HTTP/1.1 200 OK\r\n\r\nok");
+    TEST_ASSERT_EQUAL_STRING("ok", body.c_str());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_get_request_and_response);
+    RUN_TEST(test_post_is_sent_over_several_loops);
+    RUN_TEST(test_large_headers_do_not_push_the_body_out);
+    RUN_TEST(test_large_body_is_reported_as_truncated);
+    RUN_TEST(test_invalid_and_incomplete_responses);
+    RUN_TEST(test_dns_pending_and_failed);
+    RUN_TEST(test_timeout_and_connection_errors);
+    RUN_TEST(test_queued_requests_run_one_after_another);
+    RUN_TEST(test_out_of_memory_retries_until_timeout);
+    return UNITY_END();
+}
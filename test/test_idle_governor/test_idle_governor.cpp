@@ -0,0 +1,190 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <ESP8266WiFi.h>
+#include "IdleGovernor.h"
+
+// Duty cycle simulation: a loop with a fixed amount of work per pass, renders on its deadlines
+// and requests at random times. The governor sleeps on the virtual clock through delay().
+
+static IdleGovernor governor;
+
+struct Workload
+{
+    uint32_t work;          // ms per loop pass
+    uint32_t frameInterval; // 0 = static screen
+    uint32_t requestEvery;  // Average ms between requests, 0 = none
+    bool busy;              // Stream running
+    bool displayOff;
+};
+
+struct Result
+{
+    uint32_t frames;
+    uint32_t maxFrameLate;
+    uint32_t requests;
+    uint32_t maxRequestLatency;
+};
+
+static Result run(const Workload &workload, uint32_t ms)
+{
+    Result result = {0, 0, 0, 0};
+    uint32_t nextFrame = millis();
+    uint32_t nextRequest = workload.requestEvery > 0 ? millis() + random(2 * workload.requestEvery) : 0;
+    uint32_t end = millis() + ms;
+    while ((int32_t)(end - millis()) > 0)
+    {
+        // A request that arrived during the sleep is served at the start of the pass
+        if (workload.requestEvery > 0 && (int32_t)(millis() - nextRequest) >= 0)
+        {
+            result.maxRequestLatency = std::max(result.maxRequestLatency, (uint32_t)(millis() - nextRequest));
+            result.requests++;
+            nextRequest = millis() + random(2 * workload.requestEvery);
+        }
+        if (workload.frameInterval > 0 && (int32_t)(millis() - nextFrame) >= 0)
+        {
+            result.maxFrameLate = std::max(result.maxFrameLate, (uint32_t)(millis() - nextFrame));
+            result.frames++;
+            nextFrame += workload.frameInterval;
+        }
+        Host::advance(workload.work);
+
+        if (workload.busy)
+        {
+            governor.busy();
+        }
+        if (workload.frameInterval > 0)
+        {
+            governor.animating(nextFrame);
+        }
+        governor.setDisplayOff(workload.displayOff);
+        governor.loop();
+    }
+    return result;
+}
+
+static void report(const char *name, const Result &result)
+{
+    printf("%-28s residency %3u%%, %3u mA, %u frames (max %u ms late), %u requests (max %u ms)\n", name, governor.sleepResidency(), governor.currentEstimate(),
+           result.frames, result.maxFrameLate, result.requests, result.maxRequestLatency);
+}
+
+void setUp()
+{
+    Host::setMicros(1000000);
+    randomSeed(1);
+    Host::cpuMHz = F_CPU / 1000000L;
+    governor.begin(true, true);
+}
+
+void tearDown() {}
+
+void test_static_screen_sleeps_most_of_the_time()
+{
+    Workload workload = {1, 0, 0, false, false};
+    run(workload, IDLE_ENTER_DELAY + 2 * IDLE_STATISTICS_WINDOW);
+    report("static screen", Result());
+    TEST_ASSERT_EQUAL(IdleState_Idle, governor.state());
+    TEST_ASSERT_EQUAL(IDLE_MAX_SLEEP * 100 / (IDLE_MAX_SLEEP + 1), governor.sleepResidency());
+    TEST_ASSERT_EQUAL((IDLE_CURRENT_AWAKE + IDLE_MAX_SLEEP * IDLE_CURRENT_MODEM_SLEEP) / (IDLE_MAX_SLEEP + 1), governor.currentEstimate());
+    TEST_ASSERT_EQUAL(WIFI_MODEM_SLEEP, WiFi.getSleepMode());
+    TEST_ASSERT_EQUAL(IDLE_CPU_MHZ, ESP.getCpuFreqMHz());
+}
+
+void test_requests_wait_at_most_one_sleep()
+{
+    Workload workload = {1, 0, 300, false, false};
+    Result result = run(workload, IDLE_ENTER_DELAY + 2 * IDLE_STATISTICS_WINDOW);
+    report("static screen, requests", result);
+    TEST_ASSERT_GREATER_THAN(50, result.requests);
+    TEST_ASSERT_LESS_OR_EQUAL(IDLE_MAX_SLEEP + workload.work, result.maxRequestLatency);
+}
+
+void test_animation_frames_are_on_time()
+{
+    Workload workload = {3, 50, 0, false, false};
+    Result result = run(workload, IDLE_ENTER_DELAY + 2 * IDLE_STATISTICS_WINDOW);
+    report("animation 20 fps", result);
+    TEST_ASSERT_EQUAL(IdleState_Animating, governor.state());
+    // The sleep ends on the deadline, the frame is only late by the work of that pass
+    TEST_ASSERT_LESS_OR_EQUAL(workload.work, result.maxFrameLate);
+    TEST_ASSERT_EQUAL((IDLE_ENTER_DELAY + 2 * IDLE_STATISTICS_WINDOW) / 50, result.frames);
+    TEST_ASSERT_GREATER_THAN(80, governor.sleepResidency());
+    TEST_ASSERT_EQUAL(F_CPU / 1000000L, ESP.getCpuFreqMHz());
+}
+
+void test_busy_never_sleeps()
+{
+    Workload workload = {2, 20, 50, true, false};
+    Result result = run(workload, 2 * IDLE_STATISTICS_WINDOW);
+    report("stream", result);
+    TEST_ASSERT_EQUAL(IdleState_Busy, governor.state());
+    TEST_ASSERT_EQUAL(0, governor.sleepResidency());
+    TEST_ASSERT_EQUAL(IDLE_CURRENT_AWAKE, governor.currentEstimate());
+    TEST_ASSERT_EQUAL(WIFI_NONE_SLEEP, WiFi.getSleepMode());
+    TEST_ASSERT_LESS_OR_EQUAL(workload.work, result.maxRequestLatency);
+}
+
+void test_display_off_light_sleeps()
+{
+    Workload workload = {1, 0, 0, false, true};
+    run(workload, IDLE_ENTER_DELAY + 2 * IDLE_STATISTICS_WINDOW);
+    report("display off", Result());
+    TEST_ASSERT_EQUAL(IdleState_DisplayOff, governor.state());
+    TEST_ASSERT_EQUAL(WIFI_LIGHT_SLEEP, WiFi.getSleepMode());
+    TEST_ASSERT_EQUAL(IDLE_MAX_SLEEP_DISPLAY_OFF * 100 / (IDLE_MAX_SLEEP_DISPLAY_OFF + 1), governor.sleepResidency());
+    TEST_ASSERT_EQUAL((IDLE_CURRENT_AWAKE + IDLE_MAX_SLEEP_DISPLAY_OFF * IDLE_CURRENT_LIGHT_SLEEP) / (IDLE_MAX_SLEEP_DISPLAY_OFF + 1), governor.currentEstimate());
+}
+
+void test_activity_ends_the_idle_state_at_once()
+{
+    Workload idle = {1, 0, 0, false, false};
+    run(idle, IDLE_ENTER_DELAY + 100);
+    TEST_ASSERT_EQUAL(IdleState_Idle, governor.state());
+
+    governor.busy();
+    governor.loop();
+    TEST_ASSERT_EQUAL(IdleState_Busy, governor.state());
+    TEST_ASSERT_EQUAL(F_CPU / 1000000L, ESP.getCpuFreqMHz());
+
+    // Back to idle only after IDLE_ENTER_DELAY
+    run(idle, IDLE_ENTER_DELAY - 100);
+    TEST_ASSERT_EQUAL(IdleState_Busy, governor.state());
+    run(idle, 200);
+    TEST_ASSERT_EQUAL(IdleState_Idle, governor.state());
+}
+
+void test_battery_caps_the_frame_rate()
+{
+    TEST_ASSERT_EQUAL(0, governor.frameInterval());
+    governor.setBatteryLevel(80);
+    TEST_ASSERT_EQUAL(0, governor.frameInterval());
+    governor.setBatteryLevel(IDLE_BATTERY_MEDIUM);
+    TEST_ASSERT_EQUAL(IDLE_BATTERY_MEDIUM_FRAME_INTERVAL, governor.frameInterval());
+    governor.setBatteryLevel(IDLE_BATTERY_LOW);
+    TEST_ASSERT_EQUAL(IDLE_BATTERY_LOW_FRAME_INTERVAL, governor.frameInterval());
+}
+
+void test_disabled_does_nothing()
+{
+    governor.begin(false, false);
+    Workload workload = {1, 0, 0, false, true};
+    run(workload, IDLE_ENTER_DELAY + 2 * IDLE_STATISTICS_WINDOW);
+    TEST_ASSERT_EQUAL(0, governor.sleepResidency());
+    TEST_ASSERT_EQUAL(IDLE_CURRENT_AWAKE, governor.currentEstimate());
+    governor.setBatteryLevel(10);
+    TEST_ASSERT_EQUAL(0, governor.frameInterval());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_static_screen_sleeps_most_of_the_time);
+    RUN_TEST(test_requests_wait_at_most_one_sleep);
+    RUN_TEST(test_animation_frames_are_on_time);
+    RUN_TEST(test_busy_never_sleeps);
+    RUN_TEST(test_display_off_light_sleeps);
+    RUN_TEST(test_activity_ends_the_idle_state_at_once);
+    RUN_TEST(test_battery_caps_the_frame_rate);
+    RUN_TEST(test_disabled_does_nothing);
+    return UNITY_END();
+}
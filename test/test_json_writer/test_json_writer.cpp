@@ -0,0 +1,163 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <FS.h>
+#include "JsonWriter.h"
+
+// The status JSON is written on every change and for every client, so JsonWriter must not
+// touch the heap: every test counts the allocations around the writing.
+
+#define HEADROOM 10 // Like WEBSOCKETS_MAX_HEADER_SIZE
+
+static char buffer[1024];
+static uint32_t allocations;
+
+static void startCounting()
+{
+    allocations = Host::heap.allocations;
+}
+
+static void checkNoAllocation()
+{
+    TEST_ASSERT_EQUAL_MESSAGE(allocations, Host::heap.allocations, "JsonWriter allocated");
+}
+
+// Shaped like WriteMatrixInfo() and WriteSensor() in the sketch
+static void writeStatus(JsonWriter &json, const String &ssid)
+{
+    json.beginObject();
+    json.add("pixelitVersion", "3.1.0");
+    json.add("note", "Kitchen \"left\"\nshelf");
+    json.add("hostname", "PixelIt");
+    json.add("wifiSSID", ssid);
+    json.add("wifiRSSI", -67);
+    json.add("freeHeap", 23456UL);
+    json.add("heapFragmentation", (unsigned int)12);
+    json.add("uptime", 4294967295UL);
+    json.add("wallOffset", -2147483647L - 1);
+    json.add("sleepMode", false);
+    json.add("realtimeActive", true);
+    json.key("sensor");
+    json.beginObject();
+    json.add("temperature", 21.456);
+    json.add("humidity", 40.0);
+    json.add("pressure", 1013.1);
+    json.add("gas", NAN);
+    json.add("lux", -0.001);
+    json.key("voltage");
+    json.value(3.7049, 3);
+    json.endObject();
+    json.key("buttons");
+    json.beginArray();
+    json.value(true);
+    json.value(false);
+    json.null();
+    json.endArray();
+    json.key("matrixsize");
+    json.beginObject();
+    json.endObject();
+    json.endObject();
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_status_without_allocation()
+{
+    String ssid("Home\tNet\x01");
+    startCounting();
+    JsonWriter json(buffer, sizeof(buffer), HEADROOM);
+    writeStatus(json, ssid);
+    checkNoAllocation();
+
+    TEST_ASSERT_FALSE(json.overflowed());
+    TEST_ASSERT_EQUAL_STRING("{\"pixelitVersion\":\"3.1.0\",\"note\":\"Kitchen \\\"left\\\"\\nshelf\",\"hostname\":\"PixelIt\","
+                             "\"wifiSSID\":\"Home\\tNet\\u0001\",\"wifiRSSI\":-67,\"freeHeap\":23456,\"heapFragmentation\":12,"
+                             "\"uptime\":4294967295,\"wallOffset\":-2147483648,\"sleepMode\":false,\"realtimeActive\":true,"
+                             "\"sensor\":{\"temperature\":21.46,\"humidity\":40,\"pressure\":1013.1,\"gas\":null,\"lux\":0,\"voltage\":3.705},"
+                             "\"buttons\":[true,false,null],\"matrixsize\":{}}",
+                             json.c_str());
+    TEST_ASSERT_EQUAL(strlen(json.c_str()), json.length());
+    TEST_ASSERT_EQUAL_PTR(buffer, json.frame());
+    TEST_ASSERT_EQUAL_PTR(buffer + HEADROOM, json.c_str());
+}
+
+void test_envelope_and_raw()
+{
+    // The stored config is streamed from the file into the document
+    File config = Host::openFile("{\"matrixType\":1,\"note\":\"x\"}\r\n");
+    startCounting();
+    JsonWriter json(buffer, sizeof(buffer), HEADROOM);
+    json.beginEnvelope("config");
+    json.raw(config, config.size());
+    json.extend();
+    json.add("version", 3);
+    json.endObject();
+    json.endEnvelope();
+    checkNoAllocation();
+    config.close();
+
+    TEST_ASSERT_EQUAL_STRING("{\"config\":{\"matrixType\":1,\"note\":\"x\",\"version\":3}}", json.c_str());
+    TEST_ASSERT_EQUAL(strlen("{\"matrixType\":1,\"note\":\"x\",\"version\":3}"), json.documentLength());
+    TEST_ASSERT_EQUAL(0, strncmp("{\"matrixType\"", json.document(), 13));
+
+    // Written again into the same buffer, like the shared status buffer
+    startCounting();
+    json.reset();
+    json.beginEnvelope("buttons");
+    json.beginArray();
+    json.raw("1", 1);
+    json.raw("2", 1);
+    json.endArray();
+    json.endEnvelope();
+    checkNoAllocation();
+    TEST_ASSERT_EQUAL_STRING("{\"buttons\":[1,2]}", json.c_str());
+}
+
+void test_overflow_is_cut_off()
+{
+    String ssid("Home");
+    char small[64 + 1];
+    small[64] = 'X';
+    startCounting();
+    for (size_t size = HEADROOM + 1; size <= 64; size++)
+    {
+        JsonWriter json(small, size, HEADROOM);
+        writeStatus(json, ssid);
+        TEST_ASSERT_TRUE(json.overflowed());
+        TEST_ASSERT_EQUAL(size - HEADROOM - 1, json.length());
+        TEST_ASSERT_EQUAL(json.length(), strlen(json.c_str()));
+    }
+    checkNoAllocation();
+    // Nothing behind the buffer
+    TEST_ASSERT_EQUAL('X', small[64]);
+}
+
+void test_deep_nesting()
+{
+    startCounting();
+    JsonWriter json(buffer, sizeof(buffer));
+    for (uint8_t i = 0; i < JSONWRITER_MAX_DEPTH + 4; i++)
+    {
+        json.beginArray();
+        json.value(i);
+    }
+    for (uint8_t i = 0; i < JSONWRITER_MAX_DEPTH + 4; i++)
+    {
+        json.endArray();
+    }
+    checkNoAllocation();
+    TEST_ASSERT_FALSE(json.overflowed());
+    TEST_ASSERT_EQUAL(0, strncmp("[0,[1,[2,", json.c_str(), 9));
+    TEST_ASSERT_EQUAL(']', json.c_str()[json.length() - 1]);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_status_without_allocation);
+    RUN_TEST(test_envelope_and_raw);
+    RUN_TEST(test_overflow_is_cut_off);
+    RUN_TEST(test_deep_nesting);
+    return UNITY_END();
+}
@@ -0,0 +1,137 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <vector>
+#include "LedEncoder.h"
+
+// Both encoders are turned back into the waveform on the data line and compared with the
+// WS2812 reference: per bit the high and low time within the datasheet tolerance, and the
+// decoded bits equal to the input.
+
+// WS2812B datasheet, ns
+#define WS2812_T0H 400
+#define WS2812_T1H 800
+#define WS2812_T0L 850
+#define WS2812_T1L 450
+#define WS2812_TOLERANCE 150
+
+struct Pulse
+{
+    double high; // ns
+    double low;
+};
+
+static std::vector<uint8_t> pattern()
+{
+    // Every byte value, then a few pixels
+    std::vector<uint8_t> data;
+    for (int i = 0; i < 256; i++)
+    {
+        data.push_back(i);
+    }
+    const uint8_t pixels[] = {0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0x80, 0x01, 0x55, 0xAA, 0x0F, 0xF0};
+    data.insert(data.end(), pixels, pixels + sizeof(pixels));
+    return data;
+}
+
+static void assertReference(const std::vector<uint8_t> &data, const std::vector<Pulse> &pulses)
+{
+    TEST_ASSERT_EQUAL(data.size() * 8, pulses.size());
+    char message[48];
+    for (size_t i = 0; i < pulses.size(); i++)
+    {
+        bool one = data[i / 8] & (0x80 >> (i % 8));
+        snprintf(message, sizeof(message), "byte %u bit %u", (unsigned)(i / 8), (unsigned)(i % 8));
+        TEST_ASSERT_FLOAT_WITHIN_MESSAGE(WS2812_TOLERANCE, one ? WS2812_T1H : WS2812_T0H, pulses[i].high, message);
+        TEST_ASSERT_FLOAT_WITHIN_MESSAGE(WS2812_TOLERANCE, one ? WS2812_T1L : WS2812_T0L, pulses[i].low, message);
+        // Decoded at the middle of the bit like the LED does (about 600 ns after the rising edge)
+        TEST_ASSERT_EQUAL_MESSAGE(one, pulses[i].high > 600, message);
+    }
+}
+
+static std::vector<Pulse> levelsToPulses(const std::vector<bool> &levels, double slot)
+{
+    // High run and the following low run are one bit
+    std::vector<Pulse> pulses;
+    size_t i = 0;
+    while (i < levels.size())
+    {
+        TEST_ASSERT_TRUE_MESSAGE(levels[i], "bit has to start high");
+        Pulse pulse = {0, 0};
+        while (i < levels.size() && levels[i])
+        {
+            pulse.high += slot;
+            i++;
+        }
+        while (i < levels.size() && !levels[i])
+        {
+            pulse.low += slot;
+            i++;
+        }
+        pulses.push_back(pulse);
+    }
+    return pulses;
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_rmt_matches_the_reference()
+{
+    std::vector<uint8_t> data = pattern();
+    std::vector<uint32_t> items(data.size() * 8);
+    LedEncodeRmt(data.data(), data.size(), items.data());
+
+    std::vector<Pulse> pulses;
+    for (uint32_t item : items)
+    {
+        // duration0:15, level0:1, duration1:15, level1:1 at 25 ns per tick
+        TEST_ASSERT_EQUAL(1, (item >> 15) & 1);
+        TEST_ASSERT_EQUAL(0, item >> 31);
+        pulses.push_back({(item & 0x7FFF) * 25.0, ((item >> 16) & 0x7FFF) * 25.0});
+    }
+    assertReference(data, pulses);
+}
+
+void test_uart_matches_the_reference()
+{
+    std::vector<uint8_t> data = pattern();
+    std::vector<bool> levels;
+    for (uint8_t value : data)
+    {
+        uint8_t chars[LEDENCODER_UART_CHARS_PER_BYTE];
+        LedEncodeUart(value, chars);
+        for (uint8_t c : chars)
+        {
+            // 6N1 on the inverted line: start bit high, data LSB first inverted, stop bit low
+            TEST_ASSERT_EQUAL(0, c >> 6);
+            levels.push_back(true);
+            for (uint8_t bit = 0; bit < 6; bit++)
+            {
+                levels.push_back(!(c & (1 << bit)));
+            }
+            levels.push_back(false);
+        }
+    }
+    assertReference(data, levelsToPulses(levels, 1e9 / LEDENCODER_UART_BAUD));
+}
+
+void test_frame_time()
+{
+    // Same bit period for both, 1.25 µs +- 600 ns per the datasheet
+    double rmt = (LEDENCODER_RMT_T0H + LEDENCODER_RMT_T0L) * 25.0;
+    TEST_ASSERT_EQUAL_FLOAT(rmt, (LEDENCODER_RMT_T1H + LEDENCODER_RMT_T1L) * 25.0);
+    double uart = 8 * 1e9 / LEDENCODER_UART_BAUD / 2;
+    TEST_ASSERT_FLOAT_WITHIN(600, 1250, rmt);
+    TEST_ASSERT_FLOAT_WITHIN(600, 1250, uart);
+    printf("Bit period RMT %.1f ns, UART %.1f ns, 256 LEDs %.2f ms / %.2f ms\n", rmt, uart, rmt * 24 * 256 / 1e6, uart * 24 * 256 / 1e6);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_rmt_matches_the_reference);
+    RUN_TEST(test_uart_matches_the_reference);
+    RUN_TEST(test_frame_time);
+    return UNITY_END();
+}
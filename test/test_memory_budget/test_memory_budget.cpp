@@ -0,0 +1,278 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <vector>
+#include "MemoryBudget.h"
+
+// Soak test on the counting host heap: other consumers allocate and free blocks, the largest
+// free block wanders through all levels, and inbound messages of every size come in. The level
+// is checked against its definition on every sample, every buffer against the limit of the
+// level, and after the soak nothing may be left allocated but the message pool.
+
+#define HEAP_SIZE 40000 // Free after boot on an ESP8266
+#define PASS 20         // ms per loop pass
+#define SOAK_LENGHT (2 * 3600 * 1000UL)
+
+static MemoryBudget budget;
+static MemoryLevel changes[8];
+static uint16_t changeCount;
+
+static void levelChanged(MemoryLevel level)
+{
+    changes[changeCount++ % 8] = level;
+}
+
+// The level definition: the worse level at once, a better one only with the hysteresis
+static MemoryLevel expectedLevel(MemoryLevel current, uint32_t block)
+{
+    MemoryLevel level = block < MEMORY_CRITICAL_BLOCK ? MemoryLevel_Critical : (block < MEMORY_LOW_BLOCK ? MemoryLevel_Low : (block < MEMORY_TIGHT_BLOCK ? MemoryLevel_Tight : MemoryLevel_Normal));
+    if (level >= current)
+    {
+        return level;
+    }
+    uint32_t lower = block > MEMORY_HYSTERESIS ? block - MEMORY_HYSTERESIS : 0;
+    level = lower < MEMORY_CRITICAL_BLOCK ? MemoryLevel_Critical : (lower < MEMORY_LOW_BLOCK ? MemoryLevel_Low : (lower < MEMORY_TIGHT_BLOCK ? MemoryLevel_Tight : MemoryLevel_Normal));
+    return level < current ? level : current;
+}
+
+static uint32_t maxBlock()
+{
+    uint16_t block;
+    ESP.getHeapStats(nullptr, &block, nullptr);
+    return block;
+}
+
+struct Message
+{
+    char *buffer;
+    size_t length;
+    uint8_t passes; // Until the message is handled
+};
+
+void setUp()
+{
+    Host::setMicros(1000000);
+    Host::setHeapSize(HEAP_SIZE);
+    Host::setLargestBlock(0);
+    randomSeed(50);
+    budget = MemoryBudget();
+    changeCount = 0;
+    budget.setCallback(levelChanged);
+}
+
+void tearDown()
+{
+    Host::setHeapSize(64 * 1024 * 1024);
+    Host::setLargestBlock(0);
+}
+
+void test_soak()
+{
+    // The bookkeeping of the test is on the counted heap as well, reserved up front
+    std::vector<void *> blocks;
+    std::vector<size_t> sizes;
+    std::vector<Message> messages;
+    blocks.reserve(HEAP_SIZE / 32);
+    sizes.reserve(HEAP_SIZE / 32);
+    messages.reserve(16);
+
+    size_t baseline = Host::heap.live;
+    budget.begin();
+    size_t pool = Host::heap.live - baseline;
+    TEST_ASSERT_EQUAL(MEMORY_MESSAGE_POOL_LENGHT + 1, pool);
+    char *poolBuffer = budget.acquireMessage(1);
+    budget.releaseMessage(poolBuffer);
+
+    MemoryLevel level = MemoryLevel_Normal;
+    unsigned long lastSample = millis();
+    uint32_t freeHeapMin = UINT32_MAX;
+    uint32_t maxBlockMin = UINT32_MAX;
+    uint32_t fragmentTarget = 0;
+    uint32_t residency[MemoryLevel_Count] = {};
+    uint32_t offered = 0;
+    uint32_t accepted = 0;
+    uint32_t overLimit = 0;
+    uint32_t failed = 0;
+
+    for (unsigned long start = millis(); millis() - start < SOAK_LENGHT; Host::advance(PASS))
+    {
+        // Other consumers, about 60 % of the heap in use on average
+        if (random(4) == 0 && Host::heap.live < HEAP_SIZE * 6 / 10)
+        {
+            size_t size = random(32, 2048);
+            void *block = malloc(size);
+            if (block != nullptr)
+            {
+                memset(block, 0xA5, size);
+                blocks.push_back(block);
+                sizes.push_back(size);
+            }
+        }
+        if (random(5) == 0 && !blocks.empty())
+        {
+            size_t i = random(blocks.size());
+            free(blocks[i]);
+            blocks.erase(blocks.begin() + i);
+            sizes.erase(sizes.begin() + i);
+        }
+
+        // Fragmentation drifts towards a new target every minute, across all levels
+        if ((millis() - start) % 60000 == 0)
+        {
+            fragmentTarget = random(1000, 20000);
+        }
+        if ((millis() - start) % 1000 == 0)
+        {
+            uint32_t block = ESP.getMaxFreeBlockSize();
+            uint32_t step = random(50, 400);
+            block = block > fragmentTarget + step ? block - step : (block + step < fragmentTarget ? block + step : fragmentTarget);
+            Host::setLargestBlock(block);
+        }
+
+        // Inbound messages, mostly small, a few with large bitmaps
+        if (random(10) == 0)
+        {
+            size_t length = random(8) == 0 ? random(1024, 10000) : random(20, 1024);
+            size_t limit = budget.messageLimit();
+            bool poolFree = true;
+            for (const Message &message : messages)
+            {
+                poolFree = poolFree && message.buffer != poolBuffer;
+            }
+            offered++;
+            char *buffer = budget.acquireMessage(length);
+            if (length > limit)
+            {
+                TEST_ASSERT_NULL(buffer);
+                overLimit++;
+            }
+            else if (buffer == nullptr)
+            {
+                // The allocation failed, the level was sampled again at once
+                TEST_ASSERT_FALSE(poolFree && length <= MEMORY_MESSAGE_POOL_LENGHT);
+                failed++;
+                level = expectedLevel(level, maxBlock());
+                lastSample = millis();
+            }
+            else
+            {
+                // Writable to the terminating zero
+                memset(buffer, 'm', length);
+                buffer[length] = '\0';
+                accepted++;
+                messages.push_back({buffer, length, (uint8_t)random(1, 4)});
+            }
+        }
+        for (size_t i = 0; i < messages.size();)
+        {
+            if (--messages[i].passes == 0)
+            {
+                TEST_ASSERT_EQUAL(messages[i].length, strlen(messages[i].buffer));
+                budget.releaseMessage(messages[i].buffer);
+                messages.erase(messages.begin() + i);
+            }
+            else
+            {
+                i++;
+            }
+        }
+
+        budget.loop();
+        if (millis() - lastSample >= MEMORY_SAMPLE_INTERVAL)
+        {
+            lastSample = millis();
+            level = expectedLevel(level, maxBlock());
+            freeHeapMin = std::min(freeHeapMin, ESP.getFreeHeap());
+            maxBlockMin = std::min(maxBlockMin, maxBlock());
+            TEST_ASSERT_EQUAL(ESP.getFreeHeap(), budget.freeHeap());
+            TEST_ASSERT_EQUAL(maxBlock(), budget.maxBlock());
+            TEST_ASSERT_EQUAL(freeHeapMin, budget.freeHeapMin());
+            TEST_ASSERT_EQUAL(maxBlockMin, budget.maxBlockMin());
+        }
+        TEST_ASSERT_EQUAL(level, budget.level());
+        TEST_ASSERT_EQUAL(level < MemoryLevel_Tight, budget.liveviewAllowed());
+        TEST_ASSERT_EQUAL(level < MemoryLevel_Critical, budget.logStreamAllowed());
+        residency[level] += PASS;
+    }
+
+    for (const Message &message : messages)
+    {
+        budget.releaseMessage(message.buffer);
+    }
+    for (void *block : blocks)
+    {
+        free(block);
+    }
+
+    printf("%lu s: normal %u s, tight %u s, low %u s, critical %u s, %u level changes\n", SOAK_LENGHT / 1000, residency[0] / 1000, residency[1] / 1000,
+           residency[2] / 1000, residency[3] / 1000, budget.levelChanges());
+    printf("%u messages: %u accepted (%u allocated), %u over the limit, %u allocations failed, heap min %u, block min %u\n", offered, accepted,
+           budget.allocated(), overLimit, failed, budget.freeHeapMin(), budget.maxBlockMin());
+
+    // Nothing leaked, the pool stays for the next message
+    TEST_ASSERT_EQUAL(baseline + pool, Host::heap.live);
+    TEST_ASSERT_EQUAL(overLimit + failed, budget.rejected());
+    TEST_ASSERT_EQUAL(changeCount, budget.levelChanges());
+    TEST_ASSERT_LESS_THAN(accepted, budget.allocated());
+    for (uint8_t l = 0; l < MemoryLevel_Count; l++)
+    {
+        TEST_ASSERT_GREATER_THAN_MESSAGE(0, residency[l], MemoryBudget::levelName((MemoryLevel)l));
+    }
+}
+
+void test_no_flapping()
+{
+    budget.begin();
+    // The largest block hovers around a threshold by less than the hysteresis
+    for (uint16_t i = 0; i < 600; i++)
+    {
+        Host::setLargestBlock(MEMORY_TIGHT_BLOCK + (i % 2 == 0 ? -300 : 300));
+        Host::advance(MEMORY_SAMPLE_INTERVAL);
+        budget.loop();
+    }
+    TEST_ASSERT_EQUAL(1, budget.levelChanges());
+    TEST_ASSERT_EQUAL(MemoryLevel_Tight, budget.level());
+
+    Host::setLargestBlock(MEMORY_TIGHT_BLOCK + MEMORY_HYSTERESIS);
+    Host::advance(MEMORY_SAMPLE_INTERVAL);
+    budget.loop();
+    TEST_ASSERT_EQUAL(MemoryLevel_Normal, budget.level());
+    TEST_ASSERT_EQUAL(2, changeCount);
+    TEST_ASSERT_EQUAL(MemoryLevel_Tight, changes[0]);
+    TEST_ASSERT_EQUAL(MemoryLevel_Normal, changes[1]);
+}
+
+void test_failed_allocation_samples()
+{
+    budget.begin();
+    TEST_ASSERT_EQUAL(MemoryLevel_Normal, budget.level());
+    char *pool = budget.acquireMessage(100);
+    TEST_ASSERT_NOT_NULL(pool);
+
+    // Fragmented since the last sample, the level is out of date until the allocation fails
+    Host::setLargestBlock(MEMORY_LOW_BLOCK - 100);
+    TEST_ASSERT_NULL(budget.acquireMessage(MEMORY_LOW_BLOCK));
+    TEST_ASSERT_EQUAL(MemoryLevel_Low, budget.level());
+    TEST_ASSERT_EQUAL(1, budget.rejected());
+    TEST_ASSERT_EQUAL(MEMORY_LOW_MESSAGE_LENGHT, budget.messageLimit());
+    TEST_ASSERT_NULL(budget.acquireMessage(MEMORY_LOW_MESSAGE_LENGHT + 1));
+    TEST_ASSERT_EQUAL(2, budget.rejected());
+
+    // Pool busy, a second small message is allocated
+    char *buffer = budget.acquireMessage(MEMORY_LOW_MESSAGE_LENGHT);
+    TEST_ASSERT_NOT_NULL(buffer);
+    TEST_ASSERT_TRUE(buffer != pool);
+    TEST_ASSERT_EQUAL(1, budget.allocated());
+    budget.releaseMessage(buffer);
+    budget.releaseMessage(pool);
+    TEST_ASSERT_TRUE(budget.acquireMessage(10) == pool);
+    budget.releaseMessage(pool);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_soak);
+    RUN_TEST(test_no_flapping);
+    RUN_TEST(test_failed_allocation_samples);
+    return UNITY_END();
+}
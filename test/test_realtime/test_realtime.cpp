@@ -0,0 +1,289 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <ESP8266WiFi.h>
+#include <vector>
+#include <algorithm>
+#include "Blitter.h"
+#include "Realtime.h"
+
+// DDP and E1.31 sources on the host loopback network, latency from sending a frame until it is shown
+
+static CRGB leds[Geometry::pixels];
+static FastLED_NeoMatrix matrix(leds, Geometry::width, Geometry::height, 1, 1, NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_COLUMNS + NEO_MATRIX_ZIGZAG);
+static Blitter blitter;
+static Realtime realtime;
+static WiFiUDP source;
+static int activeChanges;
+static bool activeState;
+
+static void changed(bool active)
+{
+    activeChanges++;
+    activeState = active;
+}
+
+static void sendDDP(uint8_t sequence, uint32_t offset, const uint8_t *data, uint16_t length, bool push)
+{
+    uint8_t header[10] = {(uint8_t)(0x40 | (push ? 0x01 : 0x00)), sequence, 0x0B, 0x01};
+    header[4] = offset >> 24;
+    header[5] = offset >> 16;
+    header[6] = offset >> 8;
+    header[7] = offset;
+    header[8] = length >> 8;
+    header[9] = length;
+    source.beginPacket(WiFi.localIP(), REALTIME_DDP_PORT);
+    source.write(header, sizeof(header));
+    source.write(data, length);
+    source.endPacket();
+}
+
+// One frame, all pixels set to the frame number
+static void sendFrame(uint8_t sequence, uint8_t value)
+{
+    static uint8_t data[Geometry::pixels * 3];
+    memset(data, value, sizeof(data));
+    const uint16_t chunk = 480 * 3;
+    for (uint32_t offset = 0; offset < sizeof(data); offset += chunk)
+    {
+        uint16_t length = sizeof(data) - offset < chunk ? sizeof(data) - offset : chunk;
+        sendDDP(sequence, offset, data + offset, length, offset + length == sizeof(data));
+    }
+}
+
+static void sendE131(uint16_t universe, uint8_t sequence, uint16_t syncUniverse, uint8_t options, const uint8_t *data, uint16_t channels)
+{
+    uint8_t packet[126 + 512] = {0x00, 0x10, 0x00, 0x00, 'A', 'S', 'C', '-', 'E', '1', '.', '1', '7'};
+    packet[21] = 0x04; // Root vector data
+    packet[43] = 0x02; // Framing vector data
+    packet[109] = syncUniverse >> 8;
+    packet[110] = syncUniverse;
+    packet[111] = sequence;
+    packet[112] = options;
+    packet[113] = universe >> 8;
+    packet[114] = universe;
+    packet[117] = 0x02;
+    packet[123] = (channels + 1) >> 8;
+    packet[124] = channels + 1;
+    memcpy(packet + 126, data, channels);
+    source.beginPacket(WiFi.localIP(), REALTIME_E131_PORT);
+    source.write(packet, 126 + channels);
+    source.endPacket();
+}
+
+static void sendE131Sync(uint16_t syncUniverse)
+{
+    uint8_t packet[49] = {0x00, 0x10, 0x00, 0x00, 'A', 'S', 'C', '-', 'E', '1', '.', '1', '7'};
+    packet[21] = 0x08;
+    packet[43] = 0x01;
+    packet[45] = syncUniverse >> 8;
+    packet[46] = syncUniverse;
+    source.beginPacket(WiFi.localIP(), REALTIME_E131_PORT);
+    source.write(packet, sizeof(packet));
+    source.endPacket();
+}
+
+void setUp()
+{
+    Host::udpReset();
+    Host::setMicros(1000000);
+    std::fill(leds, leds + Geometry::pixels, CRGB(0, 0, 0));
+    blitter.begin(&matrix, leds);
+    realtime.begin(&matrix, leds, blitter.map(), true, true, 1, 2500);
+    realtime.setCallback(changed);
+    source.begin(50000);
+    activeChanges = 0;
+    activeState = false;
+}
+
+void tearDown()
+{
+}
+
+void test_ddp_frame_is_drawn_through_the_map()
+{
+    uint8_t data[] = {10, 20, 30, 40, 50, 60};
+    // Second pixel of the second row
+    sendDDP(1, (Geometry::width + 1) * 3, data, 3, false);
+    sendDDP(2, 0, data + 3, 3, true);
+    uint32_t shows = FastLED.shows;
+    realtime.loop(true);
+
+    TEST_ASSERT_TRUE(realtime.isActive());
+    TEST_ASSERT_EQUAL(1, activeChanges);
+    TEST_ASSERT_EQUAL(shows + 1, FastLED.shows);
+    TEST_ASSERT_EQUAL(1, realtime.frames());
+    TEST_ASSERT_TRUE(leds[matrix.XY(1, 1)] == CRGB(10, 20, 30));
+    TEST_ASSERT_TRUE(leds[matrix.XY(0, 0)] == CRGB(40, 50, 60));
+}
+
+// Frames at the rate of the source, the main loop runs every loopMicros, the network adds delayMicros.
+// Returns the latencies in µs from sending a frame until it is shown, lost frames have none.
+static std::vector<uint32_t> stream(uint32_t fps, uint32_t loopMicros, uint32_t delayMicros, uint32_t frames)
+{
+    Host::udpDelayMicros = delayMicros;
+    std::vector<uint32_t> sentAt;
+    std::vector<uint32_t> latencies;
+    uint32_t frameMicros = 1000000 / fps;
+    uint32_t start = micros();
+    uint32_t end = start + frames * frameMicros + delayMicros + loopMicros;
+    uint32_t nextLoop = start + loopMicros / 3;
+    uint32_t shows = FastLED.shows;
+
+    for (uint32_t t = start; t <= end; t += 100)
+    {
+        Host::setMicros(t);
+        if (sentAt.size() < frames && t - start >= sentAt.size() * frameMicros)
+        {
+            // The frame number is the pixel value
+            sendFrame(sentAt.size() % 15 + 1, sentAt.size());
+            sentAt.push_back(t);
+        }
+        if (t >= nextLoop)
+        {
+            realtime.loop(true);
+            nextLoop += loopMicros;
+            if (FastLED.shows != shows)
+            {
+                latencies.push_back(t - sentAt[leds[0].r]);
+                shows = FastLED.shows;
+            }
+        }
+    }
+    return latencies;
+}
+
+static uint32_t percentile(std::vector<uint32_t> values, uint8_t percent)
+{
+    std::sort(values.begin(), values.end());
+    return values[(values.size() - 1) * percent / 100];
+}
+
+void test_latency_is_bounded_by_the_loop_period()
+{
+    const uint32_t loops[] = {1000, 5000, 16000};
+    for (uint32_t loopMicros : loops)
+    {
+        setUp();
+        std::vector<uint32_t> latencies = stream(30, loopMicros, 2000, 200);
+        TEST_ASSERT_EQUAL(200, latencies.size());
+        TEST_ASSERT_EQUAL(0, realtime.dropped());
+
+        char report[120];
+        snprintf(report, sizeof(report), "loop %u us: latency p50 %u us, p99 %u us, max %u us", loopMicros, percentile(latencies, 50), percentile(latencies, 99), percentile(latencies, 100));
+        TEST_MESSAGE(report);
+        // Network delay plus at most one loop period, a frame never waits for a second loop
+        TEST_ASSERT_LESS_OR_EQUAL(2000 + loopMicros + 100, percentile(latencies, 100));
+    }
+}
+
+void test_packets_per_loop_are_bounded()
+{
+    uint8_t data[3] = {1, 2, 3};
+    for (uint8_t i = 0; i < 20; i++)
+    {
+        sendDDP(0, 0, data, 3, true);
+    }
+    realtime.loop(true);
+    TEST_ASSERT_EQUAL(REALTIME_MAX_PACKETS_PER_LOOP, realtime.frames());
+    realtime.loop(true);
+    realtime.loop(true);
+    TEST_ASSERT_EQUAL(20, realtime.frames());
+}
+
+void test_duplicate_and_late_ddp_packets_are_dropped()
+{
+    uint8_t data[3] = {1, 2, 3};
+    const uint8_t sequences[] = {1, 2, 2, 3, 1, 4, 15, 5};
+    for (uint8_t sequence : sequences)
+    {
+        sendDDP(sequence, 0, data, 3, true);
+    }
+    realtime.loop(true);
+    // 2 again, 1 after 3 and 15 after 4 are late or duplicates
+    TEST_ASSERT_EQUAL(3, realtime.dropped());
+    TEST_ASSERT_EQUAL(5, realtime.frames());
+}
+
+void test_lost_packets_do_not_stall_the_stream()
+{
+    Host::udpLossEvery = 7;
+    std::vector<uint32_t> latencies = stream(40, 5000, 1000, 200);
+    TEST_ASSERT_EQUAL(200 - Host::udpLost, latencies.size());
+    TEST_ASSERT_LESS_OR_EQUAL(1000 + 5000 + 100, percentile(latencies, 100));
+    // A gap in the sequence is no reason to drop the following frames
+    TEST_ASSERT_EQUAL(0, realtime.dropped());
+    TEST_ASSERT_TRUE(realtime.isActive());
+}
+
+void test_timeout_ends_the_stream()
+{
+    sendFrame(1, 1);
+    realtime.loop(true);
+    TEST_ASSERT_TRUE(activeState);
+    Host::advance(2499);
+    realtime.loop(true);
+    TEST_ASSERT_TRUE(realtime.isActive());
+    Host::advance(1);
+    realtime.loop(true);
+    TEST_ASSERT_FALSE(realtime.isActive());
+    TEST_ASSERT_EQUAL(2, activeChanges);
+    TEST_ASSERT_FALSE(activeState);
+}
+
+void test_e131_with_sync_universe()
+{
+    static uint8_t data[REALTIME_E131_CHANNELS_PER_UNIVERSE];
+    memset(data, 77, sizeof(data));
+    uint32_t shows = FastLED.shows;
+    sendE131(1, 1, 9, 0, data, sizeof(data));
+    sendE131(2, 1, 9, 0, data, Geometry::pixels * 3 - sizeof(data));
+    realtime.loop(true);
+    TEST_ASSERT_EQUAL(shows, FastLED.shows);
+
+    sendE131Sync(9);
+    realtime.loop(true);
+    TEST_ASSERT_EQUAL(shows + 1, FastLED.shows);
+    TEST_ASSERT_EQUAL(77, leds[matrix.XY(Geometry::width - 1, Geometry::height - 1)].b);
+}
+
+void test_e131_without_sync_shows_with_the_last_universe()
+{
+    static uint8_t data[REALTIME_E131_CHANNELS_PER_UNIVERSE];
+    uint32_t shows = FastLED.shows;
+    sendE131(1, 1, 0, 0, data, sizeof(data));
+    realtime.loop(true);
+    TEST_ASSERT_EQUAL(shows, FastLED.shows);
+    sendE131(2, 1, 0, 0, data, 100);
+    realtime.loop(true);
+    TEST_ASSERT_EQUAL(shows + 1, FastLED.shows);
+
+    // Terminated by the source
+    sendE131(1, 2, 0, 0x40, data, 3);
+    realtime.loop(true);
+    TEST_ASSERT_FALSE(realtime.isActive());
+}
+
+void test_no_rendering_keeps_the_stream_active()
+{
+    uint32_t shows = FastLED.shows;
+    sendFrame(1, 5);
+    realtime.loop(false);
+    TEST_ASSERT_TRUE(realtime.isActive());
+    TEST_ASSERT_EQUAL(shows, FastLED.shows);
+    TEST_ASSERT_EQUAL(0, leds[0].r);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_ddp_frame_is_drawn_through_the_map);
+    RUN_TEST(test_latency_is_bounded_by_the_loop_period);
+    RUN_TEST(test_packets_per_loop_are_bounded);
+    RUN_TEST(test_duplicate_and_late_ddp_packets_are_dropped);
+    RUN_TEST(test_lost_packets_do_not_stall_the_stream);
+    RUN_TEST(test_timeout_ends_the_stream);
+    RUN_TEST(test_e131_with_sync_universe);
+    RUN_TEST(test_e131_without_sync_shows_with_the_last_universe);
+    RUN_TEST(test_no_rendering_keeps_the_stream_active);
+    return UNITY_END();
+}
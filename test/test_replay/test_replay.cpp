@@ -0,0 +1,338 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <LittleFS.h>
+#include <ArduinoJson.h>
+#include <chrono>
+#include "CommandCapture.h"
+#include "EffectEngine.h"
+#include "GlyphFonts.h"
+#include "TextEngine.h"
+
+// Replays a recorded session on the virtual clock and checks the report. The capture in
+// test/captures/session.bin is a synthetic session in the format of GET /api/capture:
+// screens with bitmaps and text over HTTP and MQTT, a spectrum effect fed over the websocket
+// at 30 fps, an effect screen and a config command that the replay has to skip
+// (python .github/capture.py test/captures/session.bin prints it).
+// The sketch does not build on the host, so this is not a test of its handlers: the commands
+// are parsed with ArduinoJson and drawn with the same modules (Blitter, EffectEngine, TextEngine)
+// by a copy of ReplayCommand(), CreateFrames(), DrawSingleBitmap() and SetSpectrum() that only
+// knows the parts the session uses (no scrolling text, no classic font). Their render time is
+// taken from the host clock and added to the virtual one, so slow drawing shows up as dropped
+// frames, and the heap peak includes the JsonBuffer.
+
+#define SESSION "test/captures/session.bin"
+#define SESSION_RECORDS 191
+#define SESSION_SKIPPED 1 // setConfig
+#define SESSION_LENGHT 21000 // ms
+#define LOOP_PASS 2 // ms of the rest of the loop
+#define HEAP_PEAK_MAX 16384 // Bytes, the 32x8 bitmap with the JsonBuffer of a 64 bit host (24 bytes per array element)
+
+static CRGB leds[Geometry::pixels];
+static FastLED_NeoMatrix matrix(leds, Geometry::panelWidth, Geometry::panelHeight, Geometry::panelsX, Geometry::panelsY,
+                                NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_COLUMNS + NEO_MATRIX_ZIGZAG + MATRIX_TILE_LAYOUT);
+static Blitter blitter;
+static EffectEngine effects;
+static TextEngine textEngine;
+static CommandCapture capture;
+static unsigned long lastFrame;
+
+// HEXtoRGB() of the sketch
+static uint16_t hexColor(const char *hex)
+{
+    if (*hex == '#')
+    {
+        hex++;
+    }
+    if (strlen(hex) < 6)
+    {
+        return 0;
+    }
+    char digits[7] = "";
+    strncpy(digits, hex, 6);
+    long rgb = strtol(digits, nullptr, 16);
+    return matrix.Color(rgb >> 16, rgb >> 8, rgb);
+}
+
+static void startEffect(JsonObject &effect)
+{
+    const char *name = effect["name"].as<char *>();
+    int8_t type = EffectEngine::typeFromName(name != NULL ? name : "");
+    TEST_ASSERT_GREATER_THAN_MESSAGE(0, type, name);
+    int16_t x = effect["position"]["x"];
+    int16_t y = effect["position"]["y"];
+    int16_t width = effect["size"].is<JsonObject>() ? effect["size"]["width"].as<int16_t>() : Geometry::width;
+    int16_t height = effect["size"].is<JsonObject>() ? effect["size"]["height"].as<int16_t>() : Geometry::height;
+    effects.start(static_cast<EffectType>(type), x, y, width, height);
+    lastFrame = millis();
+}
+
+static void drawSingleBitmap(JsonObject &json)
+{
+    int16_t h = json["size"]["height"].as<int16_t>();
+    int16_t w = json["size"]["width"].as<int16_t>();
+    int16_t x = json["position"]["x"].as<int16_t>();
+    int16_t y = json["position"]["y"].as<int16_t>();
+
+    uint16_t row[Geometry::width];
+    int16_t start = x < 0 ? -x : 0;
+    int16_t visible = w - start > Geometry::width ? Geometry::width : w - start;
+    int16_t i = 0;
+    int16_t j = 0;
+    for (JsonVariant pixel : json["data"].as<JsonArray>())
+    {
+        if (i >= start && i - start < visible)
+        {
+            row[i - start] = pixel.as<uint16_t>();
+        }
+        if (++i == w)
+        {
+            blitter.drawRow(x + start, y + j, row, visible);
+            i = 0;
+            if (++j == h)
+            {
+                break;
+            }
+        }
+    }
+    TEST_ASSERT_EQUAL(h, j);
+}
+
+// DrawText() and DrawTextCenter() with the small font
+static void drawText(JsonObject &text)
+{
+    const char *string = text["textString"].as<char *>();
+    TEST_ASSERT_NOT_NULL(string);
+    TEST_ASSERT_EQUAL_MESSAGE(0, text["bigFont"].as<int>(), string);
+    int16_t x = text["position"]["x"];
+    int16_t y = text["position"]["y"].as<int16_t>() + 5;
+    uint16_t color = text["hexColor"].as<char *>() != NULL ? hexColor(text["hexColor"].as<char *>())
+                                                            : matrix.Color(text["color"]["r"].as<uint8_t>(), text["color"]["g"].as<uint8_t>(), text["color"]["b"].as<uint8_t>());
+
+    textEngine.setFont(&PixelItGlyphFont);
+    uint16_t width = textEngine.textWidth(string);
+    uint16_t available = Geometry::width - x;
+    // "auto" only scrolls what does not fit, scrolling is not replayed here
+    TEST_ASSERT_TRUE_MESSAGE(text["scrollText"] == "auto" || (text["scrollText"].is<bool>() && !text["scrollText"].as<bool>()), string);
+    TEST_ASSERT_TRUE_MESSAGE(width <= available, string);
+    if (text["centerText"].as<bool>() && width < available)
+    {
+        x += (available - width) / 2;
+    }
+    textEngine.setColor(color);
+    textEngine.drawText(x, y, string);
+}
+
+static void createFrames(JsonObject &json)
+{
+    effects.stop();
+    matrix.clear();
+    if (json.containsKey("effect"))
+    {
+        startEffect(json["effect"].as<JsonObject>());
+    }
+    if (json.containsKey("bitmap"))
+    {
+        drawSingleBitmap(json["bitmap"]);
+    }
+    if (json.containsKey("text"))
+    {
+        drawText(json["text"]);
+    }
+    if (effects.active())
+    {
+        effects.capture();
+        effects.draw();
+    }
+}
+
+static void setSpectrum(JsonObject &json)
+{
+    float max = json.containsKey("max") ? json["max"].as<float>() : 255;
+    TEST_ASSERT_TRUE(max > 0);
+
+    uint8_t values[EFFECT_MAX_BANDS];
+    uint8_t count = 0;
+    for (JsonVariant value : json["values"].as<JsonArray>())
+    {
+        if (count == EFFECT_MAX_BANDS)
+        {
+            break;
+        }
+        float level = value.as<float>() * 255 / max;
+        values[count++] = level <= 0 ? 0 : (level >= 255 ? 255 : level);
+    }
+    effects.setSpectrum(values, count);
+}
+
+// ReplayCommand() of the sketch
+static void replayCommand(CaptureRecord &record)
+{
+    unsigned long start = micros();
+    std::chrono::steady_clock::time_point hostStart = std::chrono::steady_clock::now();
+    DynamicJsonBuffer jsonBuffer;
+    JsonObject &json = jsonBuffer.parseObject((char *)record.payload.c_str());
+    bool replayed = true;
+    if (!json.success())
+    {
+        replayed = false;
+    }
+    else if ((record.transport == CaptureTransport_Http && strcmp(record.command, "/api/screen") == 0) ||
+             (record.transport == CaptureTransport_Mqtt && strcmp(record.command, "setScreen") == 0))
+    {
+        createFrames(json);
+    }
+    else if (record.transport == CaptureTransport_Mqtt && strcmp(record.command, "setSpectrum") == 0)
+    {
+        setSpectrum(json);
+    }
+    else if (record.transport == CaptureTransport_WebSocket && json.containsKey("setScreen"))
+    {
+        createFrames(json["setScreen"]);
+    }
+    else if (record.transport == CaptureTransport_WebSocket && json.containsKey("setSpectrum"))
+    {
+        setSpectrum(json["setSpectrum"]);
+    }
+    else
+    {
+        replayed = false;
+    }
+    Host::advanceMicros(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - hostStart).count());
+
+    if (replayed)
+    {
+        capture.renderTime(micros() - start);
+    }
+    else
+    {
+        capture.skipped();
+    }
+}
+
+// One pass of the sketch loop while replaying
+static void loopPass()
+{
+    capture.loop();
+    CaptureRecord record;
+    while (capture.next(record))
+    {
+        replayCommand(record);
+    }
+    if (effects.active() && millis() - lastFrame >= effects.interval())
+    {
+        std::chrono::steady_clock::time_point hostStart = std::chrono::steady_clock::now();
+        effects.step();
+        effects.draw();
+        Host::advanceMicros(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - hostStart).count());
+        lastFrame = millis();
+    }
+    Host::advance(LOOP_PASS);
+}
+
+static void loadSession()
+{
+    FILE *source = fopen(SESSION, "rb");
+    TEST_ASSERT_NOT_NULL_MESSAGE(source, SESSION);
+    File file = LittleFS.open(CAPTURE_PATH, "w");
+    uint8_t buffer[256];
+    for (size_t length; (length = fread(buffer, 1, sizeof(buffer), source)) > 0;)
+    {
+        file.write(buffer, length);
+    }
+    fclose(source);
+    file.close();
+}
+
+void setUp()
+{
+    static bool started = false;
+    if (!started)
+    {
+        blitter.begin(&matrix, leds);
+        effects.begin(&blitter);
+        textEngine.begin(&blitter);
+        started = true;
+    }
+    Host::setMicros(1000000);
+    effects.stop();
+}
+
+void tearDown()
+{
+    capture.stop();
+}
+
+void test_record_and_replay()
+{
+    TEST_ASSERT_TRUE(capture.record());
+    capture.add(CaptureTransport_Http, "/api/screen", "{\"a\":1}", 7);
+    Host::advance(300);
+    capture.add(CaptureTransport_Mqtt, "setScreen", "{\"text\":\"hello\"}", 16);
+    Host::advance(2000);
+    capture.add(CaptureTransport_WebSocket, "", "{}", 2);
+    capture.stop();
+    TEST_ASSERT_EQUAL(3, capture.records());
+
+    // Twice as fast, every command when its time has come and not earlier
+    TEST_ASSERT_TRUE(capture.replay(200));
+    unsigned long start = millis();
+    const uint32_t times[] = {0, 300, 2300};
+    const CaptureTransport transports[] = {CaptureTransport_Http, CaptureTransport_Mqtt, CaptureTransport_WebSocket};
+    const char *const commands[] = {"/api/screen", "setScreen", ""};
+    const char *const payloads[] = {"{\"a\":1}", "{\"text\":\"hello\"}", "{}"};
+    CaptureRecord record;
+    for (int i = 0; i < 3; i++)
+    {
+        while (!capture.next(record))
+        {
+            TEST_ASSERT_EQUAL(CaptureState_Replaying, capture.state());
+            Host::advance(1);
+        }
+        TEST_ASSERT_EQUAL(times[i], record.time);
+        TEST_ASSERT_EQUAL(times[i] / 2, millis() - start);
+        TEST_ASSERT_EQUAL(transports[i], record.transport);
+        TEST_ASSERT_EQUAL_STRING(commands[i], record.command);
+        TEST_ASSERT_EQUAL_STRING(payloads[i], record.payload.c_str());
+    }
+    TEST_ASSERT_FALSE(capture.next(record));
+    TEST_ASSERT_EQUAL(CaptureState_Idle, capture.state());
+}
+
+void test_replay_session()
+{
+    loadSession();
+    Host::resetHeapPeak();
+    TEST_ASSERT_TRUE(capture.replay(100));
+    unsigned long start = millis();
+    while (capture.state() == CaptureState_Replaying && millis() - start < SESSION_LENGHT * 2)
+    {
+        loopPass();
+    }
+    unsigned long duration = millis() - start;
+
+    String report = capture.report();
+    printf("%s\n", report.c_str());
+    DynamicJsonBuffer jsonBuffer;
+    JsonObject &json = jsonBuffer.parseObject((char *)report.c_str())["replay"];
+    TEST_ASSERT_TRUE(json.success());
+    printf("replayed %ld commands in %lu ms: render p50 %ld us, p90 %ld us, p99 %ld us, max %ld us, %ld dropped frames, heap peak %ld bytes\n",
+           json["commands"].as<long>(), duration, json["renderP50"].as<long>(), json["renderP90"].as<long>(), json["renderP99"].as<long>(),
+           json["renderMax"].as<long>(), json["droppedFrames"].as<long>(), json["heapPeak"].as<long>());
+
+    TEST_ASSERT_EQUAL(CaptureState_Idle, capture.state());
+    TEST_ASSERT_UINT32_WITHIN(LOOP_PASS * 2 + CAPTURE_FRAME_INTERVAL, SESSION_LENGHT, duration);
+    TEST_ASSERT_EQUAL(SESSION_RECORDS, json["commands"].as<long>());
+    TEST_ASSERT_EQUAL(SESSION_SKIPPED, json["skipped"].as<long>());
+    TEST_ASSERT_LESS_THAN(CAPTURE_FRAME_INTERVAL * 1000, json["renderP99"].as<long>());
+    // A stall of the host may cost a frame, more is the replay itself
+    TEST_ASSERT_LESS_OR_EQUAL(SESSION_RECORDS / 100, json["droppedFrames"].as<long>());
+    TEST_ASSERT_LESS_OR_EQUAL(HEAP_PEAK_MAX, json["heapPeak"].as<long>());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_record_and_replay);
+    RUN_TEST(test_replay_session);
+    return UNITY_END();
+}
@@ -0,0 +1,230 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "Rules.h"
+
+// Synthetic event streams through the rule engine, every fired action is recorded
+
+static RuleEngine rules;
+static int fired[8];
+static int firedCount;
+
+static void record(const RuleAction &action)
+{
+    if (firedCount < 8)
+    {
+        fired[firedCount] = action.value;
+    }
+    firedCount++;
+}
+
+static Rule makeRule(RuleSource source, int32_t value)
+{
+    Rule rule;
+    memset(&rule, 0, sizeof(rule));
+    rule.source = source;
+    rule.fromMinute = -1;
+    rule.toMinute = -1;
+    rule.action.type = RuleActionType_SetBrightness;
+    rule.action.value = value;
+    return rule;
+}
+
+void setUp()
+{
+    rules.begin();
+    rules.setCallback(record);
+    firedCount = 0;
+}
+
+void tearDown()
+{
+}
+
+void test_button_event_fires_matching_rule_only()
+{
+    Rule rule = makeRule(RuleSource_Button1, 1);
+    rule.buttonEvent = btnEvent_Double;
+    rules.add(rule);
+
+    rules.buttonEvent(1, btnEvent_Short);
+    rules.buttonEvent(0, btnEvent_Double);
+    TEST_ASSERT_EQUAL(0, firedCount);
+    rules.buttonEvent(1, btnEvent_Double);
+    rules.buttonEvent(1, btnEvent_Double);
+    TEST_ASSERT_EQUAL(2, firedCount);
+    // Out of range buttons are ignored
+    rules.buttonEvent(RULES_BUTTONS, btnEvent_Double);
+    TEST_ASSERT_EQUAL(2, firedCount);
+}
+
+void test_has_button_rules_per_event()
+{
+    Rule rule = makeRule(RuleSource_Button2, 1);
+    rule.buttonEvent = btnEvent_Long;
+    rules.add(rule);
+
+    TEST_ASSERT_TRUE(rules.hasButtonRules(2, btnEvent_Long));
+    // A long press rule must not enable the double press delay
+    TEST_ASSERT_FALSE(rules.hasButtonRules(2, btnEvent_Double));
+    TEST_ASSERT_FALSE(rules.hasButtonRules(0, btnEvent_Long));
+    TEST_ASSERT_FALSE(rules.hasButtonRules(RULES_BUTTONS, btnEvent_Long));
+}
+
+void test_rules_of_a_source_fire_in_configured_order()
+{
+    rules.add(makeRule(RuleSource_Button0, 1));
+    rules.add(makeRule(RuleSource_Temperature, 9));
+    rules.add(makeRule(RuleSource_Button0, 2));
+    rules.add(makeRule(RuleSource_Button0, 3));
+
+    rules.buttonEvent(0, btnEvent_Released);
+    TEST_ASSERT_EQUAL(3, firedCount);
+    TEST_ASSERT_EQUAL(1, fired[0]);
+    TEST_ASSERT_EQUAL(2, fired[1]);
+    TEST_ASSERT_EQUAL(3, fired[2]);
+    TEST_ASSERT_TRUE(rules.hasRules(RuleSource_Temperature));
+    TEST_ASSERT_FALSE(rules.hasRules(RuleSource_Humidity));
+}
+
+void test_sensor_threshold_fires_once_per_crossing_with_hysteresis()
+{
+    Rule rule = makeRule(RuleSource_Temperature, 1);
+    rule.compare = RuleCompare_Above;
+    rule.threshold = 25.0;
+    rule.hysteresis = 1.0;
+    rules.add(rule);
+
+    // Noise around the threshold must not fire again before the value dropped by the hysteresis
+    const float stream[] = {20.0, 24.9, 25.1, 26.0, 24.5, 25.2, 24.1, 25.3, NAN, 23.9, 25.5};
+    const int expected[] = {0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 2};
+    for (size_t i = 0; i < sizeof(stream) / sizeof(stream[0]); i++)
+    {
+        rules.sensorValue(RuleSource_Temperature, stream[i]);
+        TEST_ASSERT_EQUAL_MESSAGE(expected[i], firedCount, "after sample");
+    }
+}
+
+void test_sensor_below_threshold()
+{
+    Rule rule = makeRule(RuleSource_Battery, 1);
+    rule.compare = RuleCompare_Below;
+    rule.threshold = 20.0;
+    rule.hysteresis = 5.0;
+    rules.add(rule);
+
+    rules.sensorValue(RuleSource_Battery, 50.0);
+    rules.sensorValue(RuleSource_Battery, 19.0);
+    rules.sensorValue(RuleSource_Battery, 22.0);
+    rules.sensorValue(RuleSource_Battery, 18.0);
+    TEST_ASSERT_EQUAL(1, firedCount);
+    rules.sensorValue(RuleSource_Battery, 25.0);
+    rules.sensorValue(RuleSource_Battery, 18.0);
+    TEST_ASSERT_EQUAL(2, firedCount);
+}
+
+void test_time_window_limits_button_and_sensor_rules()
+{
+    Rule rule = makeRule(RuleSource_Button0, 1);
+    rule.fromMinute = 22 * 60;
+    rule.toMinute = 6 * 60; // Wraps around midnight
+    rules.add(rule);
+
+    // No time yet, windowed rules stay silent
+    rules.buttonEvent(0, btnEvent_Released);
+    TEST_ASSERT_EQUAL(0, firedCount);
+    rules.timeTick(12 * 60);
+    rules.buttonEvent(0, btnEvent_Released);
+    TEST_ASSERT_EQUAL(0, firedCount);
+    rules.timeTick(23 * 60);
+    rules.buttonEvent(0, btnEvent_Released);
+    rules.timeTick(5 * 60 + 59);
+    rules.buttonEvent(0, btnEvent_Released);
+    TEST_ASSERT_EQUAL(2, firedCount);
+    rules.timeTick(6 * 60);
+    rules.buttonEvent(0, btnEvent_Released);
+    TEST_ASSERT_EQUAL(2, firedCount);
+}
+
+void test_time_window_fires_on_entering_every_day()
+{
+    Rule rule = makeRule(RuleSource_Time, 1);
+    rule.fromMinute = 7 * 60;
+    rule.toMinute = 8 * 60;
+    rules.add(rule);
+
+    for (int day = 0; day < 3; day++)
+    {
+        for (int16_t minute = 0; minute < 24 * 60; minute++)
+        {
+            rules.timeTick(minute);
+        }
+    }
+    TEST_ASSERT_EQUAL(3, firedCount);
+}
+
+void test_time_rule_without_end_rearms_every_day()
+{
+    Rule rule = makeRule(RuleSource_Time, 1);
+    rule.fromMinute = 7 * 60;
+    rules.add(rule);
+    Rule same = makeRule(RuleSource_Time, 2);
+    same.fromMinute = 0;
+    same.toMinute = 0;
+    rules.add(same);
+
+    for (int day = 0; day < 3; day++)
+    {
+        for (int16_t minute = 0; minute < 24 * 60; minute++)
+        {
+            rules.timeTick(minute);
+        }
+    }
+    TEST_ASSERT_EQUAL(6, firedCount);
+
+    // The same minute twice is no new tick
+    firedCount = 0;
+    rules.timeTick(7 * 60);
+    rules.timeTick(7 * 60);
+    TEST_ASSERT_EQUAL(1, firedCount);
+}
+
+void test_time_rule_without_time_fires_every_minute()
+{
+    rules.add(makeRule(RuleSource_Time, 1));
+
+    rules.timeTick(-1);
+    TEST_ASSERT_EQUAL(0, firedCount);
+    for (int16_t minute = 0; minute < 10; minute++)
+    {
+        rules.timeTick(minute);
+    }
+    TEST_ASSERT_EQUAL(10, firedCount);
+}
+
+void test_capacity_and_invalid_rules()
+{
+    for (int i = 0; i < RULES_MAX; i++)
+    {
+        TEST_ASSERT_EQUAL(i, rules.add(makeRule(RuleSource_Lux, i)));
+    }
+    TEST_ASSERT_EQUAL(-1, rules.add(makeRule(RuleSource_Lux, 99)));
+    rules.clear();
+    TEST_ASSERT_EQUAL(-1, rules.add(makeRule(RuleSource_Count, 1)));
+    TEST_ASSERT_EQUAL(0, rules.count());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_button_event_fires_matching_rule_only);
+    RUN_TEST(test_has_button_rules_per_event);
+    RUN_TEST(test_rules_of_a_source_fire_in_configured_order);
+    RUN_TEST(test_sensor_threshold_fires_once_per_crossing_with_hysteresis);
+    RUN_TEST(test_sensor_below_threshold);
+    RUN_TEST(test_time_window_limits_button_and_sensor_rules);
+    RUN_TEST(test_time_window_fires_on_entering_every_day);
+    RUN_TEST(test_time_rule_without_end_rearms_every_day);
+    RUN_TEST(test_time_rule_without_time_fires_every_minute);
+    RUN_TEST(test_capacity_and_invalid_rules);
+    return UNITY_END();
+}
@@ -0,0 +1,360 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "TextEngine.h"
+#include "GlyphFonts.h"
+#include "PixelItFont.h"
+
+// TextEngine against the GFX font path it replaced: matrix->print() of the Utf8ToAscii()
+// copy with PixelItFont, drawn per glyph and pixel, and getTextBounds() for the width.
+// Both draw into their own LED buffer, the buffers have to be identical. Also the edge
+// cases of Utf8Decode() and the classic font mapping of Utf8ToAscii().
+
+#define BENCHMARK_ROUNDS 20000
+
+static CRGB reference[Geometry::pixels];
+static CRGB drawn[Geometry::pixels];
+static FastLED_NeoMatrix matrix(reference, Geometry::width, Geometry::height, 1, 1, NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS + NEO_MATRIX_PROGRESSIVE);
+static FastLED_NeoMatrix blitterMatrix(drawn, Geometry::width, Geometry::height, 1, 1, NEO_MATRIX_TOP + NEO_MATRIX_LEFT + NEO_MATRIX_ROWS + NEO_MATRIX_PROGRESSIVE);
+static Blitter blitter;
+static TextEngine textEngine;
+
+// Typical screens: clock, sensor values, a notification, a scrolling message
+static const char *const typicalTexts[] = {
+    "12:45",
+    "21.5\xC2\xB0"
+    "C 48%",
+    "Hello World!",
+    "Gr\xC3\xBC\xC3\x9F"
+    "e aus K\xC3\xB6ln",
+    "Garage door open since 17:05 - close it? \xE2\x82\xAC 0.32/kWh \xE2\x86\x91",
+};
+
+static std::string utf8(uint32_t codePoint)
+{
+    std::string text;
+    if (codePoint < 0x80)
+    {
+        text += (char)codePoint;
+    }
+    else if (codePoint < 0x800)
+    {
+        text += (char)(0xC0 | codePoint >> 6);
+        text += (char)(0x80 | (codePoint & 0x3F));
+    }
+    else if (codePoint < 0x10000)
+    {
+        text += (char)(0xE0 | codePoint >> 12);
+        text += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+        text += (char)(0x80 | (codePoint & 0x3F));
+    }
+    else
+    {
+        text += (char)(0xF0 | codePoint >> 18);
+        text += (char)(0x80 | ((codePoint >> 12) & 0x3F));
+        text += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+        text += (char)(0x80 | (codePoint & 0x3F));
+    }
+    return text;
+}
+
+static void clear()
+{
+    std::fill(reference, reference + Geometry::pixels, CRGB(CRGB::Black));
+    std::fill(drawn, drawn + Geometry::pixels, CRGB(CRGB::Black));
+}
+
+static void assertSame(const char *text, int16_t x)
+{
+    char message[96];
+    for (uint16_t i = 0; i < Geometry::pixels; i++)
+    {
+        snprintf(message, sizeof(message), "\"%s\" at x %d, led %u", text, x, i);
+        TEST_ASSERT_EQUAL_HEX32_MESSAGE(reference[i].r << 16 | reference[i].g << 8 | reference[i].b, drawn[i].r << 16 | drawn[i].g << 8 | drawn[i].b, message);
+    }
+}
+
+// As PrintText() draws it, and as it did before with the GFX font
+static void drawOld(int16_t x, int16_t y, const String &ascii)
+{
+    matrix.setCursor(x, y);
+    matrix.print(ascii);
+}
+
+static void drawNew(int16_t x, int16_t y, const char *text)
+{
+    textEngine.drawText(x, y, text);
+}
+
+void setUp()
+{
+    matrix.setTextWrap(false);
+    matrix.setFont(&PixelItFont);
+    matrix.setTextColor(0xFD20);
+    textEngine.setFont(&PixelItGlyphFont);
+    textEngine.setColor(0xFD20);
+    clear();
+}
+
+void tearDown() {}
+
+// Utf8Decode() until the end, into code points
+static std::vector<uint32_t> decodeAll(const char *text)
+{
+    std::vector<uint32_t> codePoints;
+    uint32_t codePoint;
+    while ((codePoint = Utf8Decode(text)) != 0)
+    {
+        codePoints.push_back(codePoint);
+    }
+    TEST_ASSERT_EQUAL(0, *text);
+    return codePoints;
+}
+
+static void checkDecode(const char *text, std::vector<uint32_t> expected)
+{
+    std::vector<uint32_t> codePoints = decodeAll(text);
+    std::string message;
+    for (const char *c = text; *c != 0; c++)
+    {
+        char hex[4];
+        snprintf(hex, sizeof(hex), "%02X ", (uint8_t)*c);
+        message += hex;
+    }
+    TEST_ASSERT_EQUAL_MESSAGE(expected.size(), codePoints.size(), message.c_str());
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        TEST_ASSERT_EQUAL_HEX32_MESSAGE(expected[i], codePoints[i], message.c_str());
+    }
+}
+
+void test_decode_valid()
+{
+    checkDecode("A~", {'A', '~'});
+    // First and last code point of every length, around the surrogates
+    checkDecode("\xC2\x80\xDF\xBF", {0x80, 0x7FF});
+    checkDecode("\xE0\xA0\x80\xEF\xBF\xBF", {0x800, 0xFFFF});
+    checkDecode("\xED\x9F\xBF\xEE\x80\x80", {0xD7FF, 0xE000});
+    checkDecode("\xF0\x90\x80\x80\xF4\x8F\xBF\xBF", {0x10000, 0x10FFFF});
+    checkDecode("\xE2\x82\xAC\xF0\x9F\x98\x80", {0x20AC, 0x1F600});
+    checkDecode("", {});
+}
+
+// Every invalid sequence gives one U+FFFD per byte, decoding goes on behind it
+void test_decode_overlong()
+{
+    checkDecode("\xC0\x80", {0xFFFD, 0xFFFD});
+    checkDecode("\xC1\xBF", {0xFFFD, 0xFFFD});
+    checkDecode("\xE0\x80\x80", {0xFFFD, 0xFFFD, 0xFFFD});
+    checkDecode("\xE0\x9F\xBF", {0xFFFD, 0xFFFD, 0xFFFD});
+    checkDecode("\xF0\x80\x80\x80", {0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD});
+    checkDecode("\xF0\x8F\xBF\xBFx", {0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 'x'});
+}
+
+void test_decode_surrogates()
+{
+    checkDecode("\xED\xA0\x80", {0xFFFD, 0xFFFD, 0xFFFD});
+    checkDecode("\xED\xBF\xBF", {0xFFFD, 0xFFFD, 0xFFFD});
+    // A CESU-8 pair (U+1F600) is two surrogates, not a code point
+    checkDecode("\xED\xA0\xBD\xED\xB8\x80", {0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD});
+}
+
+void test_decode_truncated()
+{
+    checkDecode("\xC3", {0xFFFD});
+    checkDecode("\xE2\x82", {0xFFFD, 0xFFFD});
+    checkDecode("\xF0\x9F\x98", {0xFFFD, 0xFFFD, 0xFFFD});
+    // Cut off by the next character
+    checkDecode("\xE2\x82" "A\xC3\xA4", {0xFFFD, 0xFFFD, 'A', 0xE4});
+    checkDecode("\xF0\x9F" "\xC3\xBC", {0xFFFD, 0xFFFD, 0xFC});
+}
+
+void test_decode_invalid_bytes()
+{
+    checkDecode("\x80\xBF", {0xFFFD, 0xFFFD});
+    checkDecode("\xF4\x90\x80\x80", {0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD});
+    checkDecode("\xF5\x80\x80\x80", {0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD});
+    checkDecode("a\xFE\xFF" "b", {'a', 0xFFFD, 0xFFFD, 'b'});
+}
+
+static void checkAscii(uint32_t codePoint, char expected)
+{
+    char message[32];
+    snprintf(message, sizeof(message), "U+%04X", (unsigned)codePoint);
+    String ascii = Utf8ToAscii(utf8(codePoint).c_str());
+    TEST_ASSERT_EQUAL_MESSAGE(1, ascii.length(), message);
+    TEST_ASSERT_EQUAL_HEX8_MESSAGE((uint8_t)expected, (uint8_t)ascii[0], message);
+}
+
+void test_ascii_mapping()
+{
+    for (uint32_t codePoint = 0x20; codePoint < 0x7F; codePoint++)
+    {
+        checkAscii(codePoint, codePoint);
+    }
+    checkAscii(0xA0, ' ');
+    // Latin-1 from slot 0x7F on, to 0xDD
+    for (uint32_t codePoint = 0xA1; codePoint <= 0xFF; codePoint++)
+    {
+        checkAscii(codePoint, codePoint - 34);
+    }
+    // The symbols behind it
+    static const uint32_t symbols[] = {0x20AC, 0x2190, 0x2191, 0x2192, 0x2193, 0x2605, 0x1F4C4, 0x2665, 0x21A7, 0x1F697, 0x1F600, 0x1F4C1};
+    for (uint8_t i = 0; i < sizeof(symbols) / sizeof(symbols[0]); i++)
+    {
+        checkAscii(symbols[i], 0xDE + i);
+    }
+    TEST_ASSERT_EQUAL(0xE9, 0xDE + sizeof(symbols) / sizeof(symbols[0]) - 1);
+
+    // Not in the classic font
+    checkAscii(0x80, '?');
+    checkAscii(0x9F, '?');
+    checkAscii(0x100, '?');
+    checkAscii(0x4E2D, '?');
+    checkAscii(0x1F642, '?');
+    TEST_ASSERT_EQUAL_STRING("a???b", Utf8ToAscii("a\xE2\x82" "\xFF" "b").c_str());
+    TEST_ASSERT_EQUAL_STRING("Gr\xDA\xBD" "e \xDE", Utf8ToAscii("Gr\xC3\xBC\xC3\x9F" "e \xE2\x82\xAC").c_str());
+}
+
+// Every character of the classic font looks as it did, U+00A0 is drawn as a space
+void test_glyphs_as_before()
+{
+    std::vector<uint32_t> codePoints;
+    for (uint32_t codePoint = 0x20; codePoint < 0x7F; codePoint++)
+    {
+        codePoints.push_back(codePoint);
+    }
+    for (uint32_t codePoint = 0xA0; codePoint <= 0xFF; codePoint++)
+    {
+        codePoints.push_back(codePoint);
+    }
+    for (uint32_t codePoint : {0x20AC, 0x2190, 0x2191, 0x2192, 0x2193, 0x2605, 0x1F4C4, 0x2665, 0x21A7, 0x1F697, 0x1F600, 0x1F4C1})
+    {
+        codePoints.push_back(codePoint);
+    }
+
+    for (uint32_t codePoint : codePoints)
+    {
+        std::string text = utf8(codePoint);
+        clear();
+        drawOld(1, 6, Utf8ToAscii(text.c_str()));
+        drawNew(1, 6, text.c_str());
+        assertSame(text.c_str(), 1);
+    }
+}
+
+// Scrolled through: the old width formulas, the text at every position of the scroll
+void test_texts_as_before()
+{
+    for (const char *text : typicalTexts)
+    {
+        // The advance of the GFX cursor. getTextBounds() width - 4 was only the same when
+        // the last glyph is 4 pixels wide (trimmed 3 + 1), "!" or "." ended 2 pixels later.
+        String ascii = Utf8ToAscii(text);
+        drawOld(0, 6, ascii);
+        int16_t width = textEngine.textWidth(text);
+        TEST_ASSERT_EQUAL_MESSAGE(matrix.getCursorX(), width, text);
+
+        for (int16_t x = Geometry::width; x >= -width; x--)
+        {
+            clear();
+            drawOld(x, 6, ascii);
+            drawNew(x, 6, text);
+            assertSame(text, x);
+        }
+    }
+
+    // The digit fonts of bigFont 2 and 3
+    static const struct
+    {
+        const GFXfont *gfx;
+        const GlyphFont *glyph;
+    } digitFonts[] = {{&LargePixels, &LargePixelsGlyphFont}, {&FatPixels, &FatPixelsGlyphFont}};
+    for (const auto &font : digitFonts)
+    {
+        matrix.setFont(font.gfx);
+        textEngine.setFont(font.glyph);
+        for (const char *text : {"12:45", "0123456789", "7:01"})
+        {
+            int16_t x1, y1;
+            uint16_t w, h;
+            matrix.getTextBounds(text, 0, 0, &x1, &y1, &w, &h);
+            TEST_ASSERT_EQUAL_MESSAGE(w, textEngine.textWidth(text) - 1, text);
+            clear();
+            drawOld(0, 7, text);
+            drawNew(0, 7, text);
+            assertSame(text, 0);
+        }
+    }
+}
+
+static double microsPerText(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / BENCHMARK_ROUNDS;
+}
+
+// Scrolling text is redrawn at every step, its width measured on every new text. Both ways
+// take the same UTF-8 text, the old one with the Utf8ToAscii() copy the sketch made.
+void test_timing()
+{
+    for (const char *text : typicalTexts)
+    {
+        int16_t width = textEngine.textWidth(text);
+        uint32_t sum = 0;
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (uint16_t round = 0; round < BENCHMARK_ROUNDS; round++)
+        {
+            drawOld(Geometry::width - round % (Geometry::width + width), 6, Utf8ToAscii(text));
+        }
+        double oldDraw = microsPerText(start);
+
+        start = std::chrono::steady_clock::now();
+        for (uint16_t round = 0; round < BENCHMARK_ROUNDS; round++)
+        {
+            drawNew(Geometry::width - round % (Geometry::width + width), 6, text);
+        }
+        double newDraw = microsPerText(start);
+
+        start = std::chrono::steady_clock::now();
+        for (uint16_t round = 0; round < BENCHMARK_ROUNDS; round++)
+        {
+            int16_t x1, y1;
+            uint16_t w, h;
+            matrix.getTextBounds(Utf8ToAscii(text), 0, 0, &x1, &y1, &w, &h);
+            sum += w;
+        }
+        double oldWidth = microsPerText(start);
+
+        start = std::chrono::steady_clock::now();
+        for (uint16_t round = 0; round < BENCHMARK_ROUNDS; round++)
+        {
+            sum += textEngine.textWidth(text);
+        }
+        double newWidth = microsPerText(start);
+        TEST_ASSERT_GREATER_THAN(0, sum);
+
+        printf("%-16.16s drawText %5.2f us (GFX %5.2f us), textWidth %5.2f us (GFX %5.2f us)\n", text, newDraw, oldDraw, newWidth, oldWidth);
+        TEST_ASSERT_TRUE_MESSAGE(newDraw < oldDraw, text);
+        TEST_ASSERT_TRUE_MESSAGE(newWidth < oldWidth, text);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    blitter.begin(&blitterMatrix, drawn);
+    textEngine.begin(&blitter);
+    RUN_TEST(test_decode_valid);
+    RUN_TEST(test_decode_overlong);
+    RUN_TEST(test_decode_surrogates);
+    RUN_TEST(test_decode_truncated);
+    RUN_TEST(test_decode_invalid_bytes);
+    RUN_TEST(test_ascii_mapping);
+    RUN_TEST(test_glyphs_as_before);
+    RUN_TEST(test_texts_as_before);
+    RUN_TEST(test_timing);
+    return UNITY_END();
+}
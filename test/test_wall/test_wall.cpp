@@ -0,0 +1,208 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <ESP8266WiFi.h>
+#include "Wall.h"
+
+// Leader and members on the host loopback network. A host tool plays the leader where the
+// leader clock has to differ from the shared virtual clock of the members.
+
+static Wall leader;
+static Wall members[3];
+static WiFiUDP tool;
+static int screens;
+static uint32_t screenStart;
+static char screen[64];
+
+static void received(const char *content, uint32_t start)
+{
+    screens++;
+    screenStart = start;
+    strncpy(screen, content, sizeof(screen) - 1);
+}
+
+static void loops(uint32_t ms)
+{
+    for (uint32_t i = 0; i < ms; i++)
+    {
+        Host::advance(1);
+        leader.loop();
+        for (Wall &member : members)
+        {
+            member.loop();
+        }
+    }
+}
+
+// Clock sync from a leader that is offset ahead of the virtual clock
+static void sendSync(uint32_t offset, uint8_t group = 1)
+{
+    uint8_t packet[10] = {'P', 'X', 'W', 1, 'S', group};
+    uint32_t leaderTime = millis() + offset;
+    packet[6] = leaderTime >> 24;
+    packet[7] = leaderTime >> 16;
+    packet[8] = leaderTime >> 8;
+    packet[9] = leaderTime;
+    tool.beginPacket(IPAddress(WALL_MULTICAST_ADDRESS), WALL_PORT);
+    tool.write(packet, sizeof(packet));
+    tool.endPacket();
+}
+
+// Syncs every WALL_SYNC_INTERVAL with a network delay of 0..jitter ms, checks that the wall
+// time of the member never jumps or runs backwards
+static void follow(Wall &member, uint32_t offset, uint32_t jitter, uint32_t ms)
+{
+    bool synced = member.isSynced();
+    uint32_t last = member.time();
+    for (uint32_t i = 0; i < ms; i++)
+    {
+        Host::advance(1);
+        if (i % WALL_SYNC_INTERVAL == 0)
+        {
+            Host::udpDelayMicros = random(jitter + 1) * 1000;
+            sendSync(offset);
+        }
+        member.loop();
+        uint32_t now = member.time();
+        // The first sample sets the clock
+        if (synced)
+        {
+            TEST_ASSERT_GREATER_OR_EQUAL(last, now);
+            TEST_ASSERT_LESS_OR_EQUAL(last + 2, now);
+        }
+        last = now;
+        synced = member.isSynced();
+    }
+}
+
+void setUp()
+{
+    Host::udpReset();
+    Host::setMicros(5000000);
+    WiFi.address = IPAddress(192, 168, 1, 10);
+    randomSeed(1);
+    screens = 0;
+    tool.begin(40000);
+}
+
+void tearDown()
+{
+    leader.begin(WallRole_Off, 1);
+    for (Wall &member : members)
+    {
+        member.begin(WallRole_Off, 1);
+    }
+}
+
+void test_members_get_the_screen_of_the_leader()
+{
+    leader.begin(WallRole_Leader, 1);
+    for (Wall &member : members)
+    {
+        member.begin(WallRole_Member, 1);
+        member.setCallback(received);
+    }
+    loops(WALL_SYNC_INTERVAL + 1);
+    for (Wall &member : members)
+    {
+        TEST_ASSERT_TRUE(member.isSynced());
+        TEST_ASSERT_INT_WITHIN(1, leader.time(), member.time());
+    }
+
+    TEST_ASSERT_TRUE(leader.publish("{\"text\":{}}"));
+    loops(1);
+    TEST_ASSERT_EQUAL(3, screens);
+    TEST_ASSERT_EQUAL_STRING("{\"text\":{}}", screen);
+    TEST_ASSERT_EQUAL(leader.time() - 1 + WALL_START_DELAY, screenStart);
+
+    // Repeated for late members, but only applied once
+    loops(WALL_CONTENT_INTERVAL * 2);
+    TEST_ASSERT_EQUAL(3, screens);
+}
+
+void test_other_groups_are_ignored()
+{
+    members[0].begin(WallRole_Member, 2);
+    sendSync(1000, 1);
+    loops(1);
+    TEST_ASSERT_FALSE(members[0].isSynced());
+    sendSync(1000, 2);
+    loops(1);
+    TEST_ASSERT_TRUE(members[0].isSynced());
+}
+
+void test_offset_converges_to_the_shortest_delay()
+{
+    members[0].begin(WallRole_Member, 1);
+    follow(members[0], 100000, 40, 60000);
+    // The window maximum is the sample with the least delay
+    TEST_ASSERT_INT_WITHIN(5, 100000, members[0].offset());
+}
+
+void test_small_corrections_are_slewed()
+{
+    members[0].begin(WallRole_Member, 1);
+    follow(members[0], 100000, 0, WALL_SYNC_INTERVAL * WALL_SYNC_WINDOW * 2);
+    TEST_ASSERT_EQUAL(100000, members[0].offset());
+
+    // The leader clock drifted 40 ms, corrected by 1 ms per WALL_SLEW_INTERVAL
+    follow(members[0], 100040, 0, WALL_SYNC_INTERVAL * WALL_SYNC_WINDOW + 10 * WALL_SLEW_INTERVAL);
+    TEST_ASSERT_GREATER_THAN(100000, members[0].offset());
+    TEST_ASSERT_LESS_THAN(100040, members[0].offset());
+    follow(members[0], 100040, 0, 40 * WALL_SLEW_INTERVAL);
+    TEST_ASSERT_EQUAL(100040, members[0].offset());
+
+    // Earlier samples of the window still count
+    follow(members[0], 99990, 0, WALL_SYNC_INTERVAL * WALL_SYNC_WINDOW * 2 + 50 * WALL_SLEW_INTERVAL);
+    TEST_ASSERT_EQUAL(99990, members[0].offset());
+}
+
+void test_leader_restart_is_a_step()
+{
+    members[0].begin(WallRole_Member, 1);
+    follow(members[0], 100000, 0, WALL_SYNC_INTERVAL * WALL_SYNC_WINDOW);
+    for (uint32_t i = 0; i < WALL_SYNC_WINDOW; i++)
+    {
+        sendSync(-4000);
+        members[0].loop();
+        loops(WALL_SYNC_INTERVAL);
+    }
+    TEST_ASSERT_EQUAL(-4000, members[0].offset());
+}
+
+void test_member_rebinds_after_reconnect_and_new_address()
+{
+    // Started before the WiFi was up, no group membership
+    WiFi.address = IPAddress();
+    members[0].begin(WallRole_Member, 1);
+    sendSync(1000);
+    Host::advance(1);
+    TEST_ASSERT_FALSE(members[0].isSynced());
+
+    WiFi.address = IPAddress(192, 168, 1, 10);
+    members[0].loop();
+    sendSync(1000);
+    loops(1);
+    TEST_ASSERT_TRUE(members[0].isSynced());
+
+    // New address from DHCP, the old membership is gone
+    WiFi.address = IPAddress(192, 168, 1, 77);
+    members[0].loop();
+    for (uint32_t i = 0; i < WALL_SYNC_WINDOW; i++)
+    {
+        sendSync(2000);
+        loops(WALL_SYNC_INTERVAL);
+    }
+    TEST_ASSERT_INT_WITHIN(1, 2000, members[0].offset());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_members_get_the_screen_of_the_leader);
+    RUN_TEST(test_other_groups_are_ignored);
+    RUN_TEST(test_offset_converges_to_the_shortest_delay);
+    RUN_TEST(test_small_corrections_are_slewed);
+    RUN_TEST(test_leader_restart_is_a_step);
+    RUN_TEST(test_member_rebinds_after_reconnect_and_new_address);
+    return UNITY_END();
+}